@@ -11,6 +11,7 @@
 #ifdef HAVE_HSEARCHR
 #include <search.h>
 #endif
+#include <inttypes.h>
 #include <sys/time.h>
 
 struct timeval start;
@@ -721,3 +722,486 @@ void printExit (const char * msg)
 	fprintf (stderr, "FATAL: %s\n", msg);
 	exit (EXIT_FAILURE);
 }
+
+
+/**
+ * Benchmark Harness
+ */
+
+BenchmarkOptions benchmarkOptions = { 2, 11, 0, 0 };
+BenchmarkDataset benchmarkDataset = { 100000, 3, 16, 2, 10, 1 };
+
+typedef struct
+{
+	char * group;
+	char * name;
+	size_t samples;
+	uint64_t min;
+	uint64_t median;
+	uint64_t p90;
+	uint64_t p99;
+	uint64_t max;
+	double mean;
+} BenchmarkResult;
+
+static BenchmarkResult * benchmarkResults;
+static size_t benchmarkResultsSize;
+static size_t benchmarkResultsAlloc;
+
+/**
+ * @return the current time in nanoseconds of a monotonic clock, if available
+ */
+static uint64_t benchmarkNanoseconds (void)
+{
+#ifdef CLOCK_MONOTONIC
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (uint64_t) now.tv_sec * 1000000000 + now.tv_nsec;
+#else
+	struct timeval now;
+	gettimeofday (&now, 0);
+	return (uint64_t) now.tv_sec * 1000000000 + (uint64_t) now.tv_usec * 1000;
+#endif
+}
+
+static int benchmarkParseSize (const char * arg, const char * option, size_t * value)
+{
+	size_t length = strlen (option);
+	if (strncmp (arg, option, length) != 0) return 0;
+
+	char * end;
+	unsigned long long parsed = strtoull (arg + length, &end, 10);
+	if (end == arg + length || *end != '\0')
+	{
+		fprintf (stderr, "invalid number in option %s\n", arg);
+		return -1;
+	}
+	*value = parsed;
+	return 1;
+}
+
+/**
+ * @brief Parse and remove the options of the harness from the arguments
+ *
+ * Arguments which are not options of the harness are kept in order.
+ *
+ * @param argc the number of arguments, will be updated
+ * @param argv the arguments, will be updated
+ *
+ * @retval 0 on success
+ * @retval -1 on invalid options
+ */
+int benchmarkParseOptions (int * argc, char ** argv)
+{
+	int kept = 1;
+	for (int i = 1; i < *argc; ++i)
+	{
+		const char * arg = argv[i];
+		size_t value = 0;
+		int found = 0;
+
+#define BENCHMARK_OPTION(option, target)                                                                                                   \
+	if (!found && (found = benchmarkParseSize (arg, option, &value)) == 1) target = value;
+
+		BENCHMARK_OPTION ("--warmup=", benchmarkOptions.warmups)
+		BENCHMARK_OPTION ("--repeat=", benchmarkOptions.repetitions)
+		BENCHMARK_OPTION ("--size=", benchmarkDataset.size)
+		BENCHMARK_OPTION ("--depth=", benchmarkDataset.depth)
+		BENCHMARK_OPTION ("--value=", benchmarkDataset.valueSize)
+		BENCHMARK_OPTION ("--meta=", benchmarkDataset.metaKeys)
+		BENCHMARK_OPTION ("--meta-ratio=", benchmarkDataset.metaRatio)
+		BENCHMARK_OPTION ("--seed=", benchmarkDataset.seed)
+#undef BENCHMARK_OPTION
+
+		if (found == -1) return -1;
+		if (!found && !strncmp (arg, "--json=", sizeof ("--json=") - 1))
+		{
+			benchmarkOptions.json = arg + sizeof ("--json=") - 1;
+			found = 1;
+		}
+		if (!found && !strncmp (arg, "--filter=", sizeof ("--filter=") - 1))
+		{
+			benchmarkOptions.filter = arg + sizeof ("--filter=") - 1;
+			found = 1;
+		}
+		if (!found)
+		{
+			argv[kept++] = argv[i];
+		}
+	}
+	*argc = kept;
+	argv[kept] = 0;
+
+	if (benchmarkOptions.repetitions == 0 || benchmarkDataset.depth == 0)
+	{
+		fprintf (stderr, "--repeat and --depth must be at least 1\n");
+		return -1;
+	}
+	if (benchmarkDataset.seed <= 0 || benchmarkDataset.seed >= ELEKTRARANDMAX)
+	{
+		fprintf (stderr, "--seed must be in ]0, %d[\n", ELEKTRARANDMAX);
+		return -1;
+	}
+	return 0;
+}
+
+/**
+ * @brief Generate a KeySet below KEY_ROOT
+ *
+ * The keys are evenly distributed on dataset->depth levels. Values
+ * and meta data are random, but the same seed gives the same KeySet.
+ *
+ * @param dataset the configuration of the KeySet
+ *
+ * @return the new KeySet
+ */
+KeySet * benchmarkGenerateDataset (const BenchmarkDataset * dataset)
+{
+	size_t depth = dataset->depth > 0 ? dataset->depth : 1;
+	// smallest fanout, which gives enough leaves
+	size_t fanout = 1;
+	for (size_t leaves = 1; leaves < dataset->size;)
+	{
+		++fanout;
+		leaves = 1;
+		for (size_t level = 0; level < depth && leaves < dataset->size; ++level)
+		{
+			leaves *= fanout;
+		}
+	}
+
+	int32_t seed = dataset->seed;
+	const size_t alphabetSize = strlen (alphabetnumbers);
+	char name[KEY_NAME_LENGTH + 1];
+	char * value = elektraMalloc (2 * dataset->valueSize + 1);
+	if (!value) printExit ("benchmarkGenerateDataset: malloc value");
+	KeySet * ks = ksNew (dataset->size, KS_END);
+
+	for (size_t i = 0; i < dataset->size; ++i)
+	{
+		size_t length = snprintf (name, KEY_NAME_LENGTH, "%s", KEY_ROOT);
+		size_t rest = i;
+		for (size_t level = depth; level > 0; --level)
+		{
+			size_t divisor = 1;
+			for (size_t l = 1; l < level; ++l)
+			{
+				divisor *= fanout;
+			}
+			length += snprintf (name + length, KEY_NAME_LENGTH - length, level > 1 ? "/dir%zu" : "/key%zu", rest / divisor);
+			rest %= divisor;
+		}
+
+		elektraRand (&seed);
+		size_t valueLength = dataset->valueSize > 0 ? (size_t) seed % (2 * dataset->valueSize + 1) : 0;
+		for (size_t v = 0; v < valueLength; ++v)
+		{
+			elektraRand (&seed);
+			value[v] = alphabetnumbers[seed % alphabetSize];
+		}
+		value[valueLength] = '\0';
+
+		Key * key = keyNew (name, KEY_VALUE, value, KEY_END);
+		if (!key) printExit ("benchmarkGenerateDataset: Can not create Key");
+
+		elektraRand (&seed);
+		if (dataset->metaRatio > 0 && seed % dataset->metaRatio == 0)
+		{
+			char metaName[BUF_SIZ];
+			for (size_t m = 0; m < dataset->metaKeys; ++m)
+			{
+				snprintf (metaName, BUF_SIZ, "benchmark/meta%zu", m);
+				keySetMeta (key, metaName, value);
+			}
+		}
+		ksAppendKey (ks, key);
+	}
+
+	elektraFree (value);
+	return ks;
+}
+
+static int benchmarkCompareSamples (const void * a, const void * b)
+{
+	uint64_t x = *(const uint64_t *) a;
+	uint64_t y = *(const uint64_t *) b;
+	return x < y ? -1 : x > y;
+}
+
+/**
+ * @return the sample with the given percentile of sorted samples (nearest rank)
+ */
+static uint64_t benchmarkPercentile (const uint64_t * samples, size_t size, size_t percentile)
+{
+	size_t rank = (percentile * size + 99) / 100;
+	return samples[rank > 0 ? rank - 1 : 0];
+}
+
+/**
+ * @brief Measure a benchmark case and collect its result
+ *
+ * Benchmarks not matching benchmarkOptions.filter are skipped.
+ *
+ * @param benchmark the benchmark to run
+ * @param data passed to all functions of the benchmark
+ *
+ * @retval 1 if the benchmark was run
+ * @retval 0 if the benchmark was skipped
+ */
+int benchmarkRun (const BenchmarkCase * benchmark, void * data)
+{
+	char id[KEY_NAME_LENGTH + 1];
+	snprintf (id, KEY_NAME_LENGTH, "%s/%s", benchmark->group, benchmark->name);
+	if (benchmarkOptions.filter && !strstr (id, benchmarkOptions.filter)) return 0;
+
+	const size_t repetitions = benchmarkOptions.repetitions;
+	uint64_t * samples = elektraMalloc (repetitions * sizeof (uint64_t));
+	if (!samples) printExit ("benchmarkRun: malloc samples");
+
+	for (size_t i = 0; i < benchmarkOptions.warmups + repetitions; ++i)
+	{
+		if (benchmark->setup) benchmark->setup (data);
+		uint64_t begin = benchmarkNanoseconds ();
+		benchmark->run (data);
+		uint64_t duration = benchmarkNanoseconds () - begin;
+		if (benchmark->teardown) benchmark->teardown (data);
+
+		if (i >= benchmarkOptions.warmups) samples[i - benchmarkOptions.warmups] = duration;
+	}
+
+	qsort (samples, repetitions, sizeof (uint64_t), benchmarkCompareSamples);
+
+	if (benchmarkResultsSize == benchmarkResultsAlloc)
+	{
+		benchmarkResultsAlloc = benchmarkResultsAlloc ? 2 * benchmarkResultsAlloc : 16;
+		if (elektraRealloc ((void **) &benchmarkResults, benchmarkResultsAlloc * sizeof (BenchmarkResult)) == -1)
+		{
+			printExit ("benchmarkRun: realloc results");
+		}
+	}
+
+	BenchmarkResult * result = &benchmarkResults[benchmarkResultsSize++];
+	result->group = elektraStrDup (benchmark->group);
+	result->name = elektraStrDup (benchmark->name);
+	result->samples = repetitions;
+	result->min = samples[0];
+	result->median = benchmarkPercentile (samples, repetitions, 50);
+	result->p90 = benchmarkPercentile (samples, repetitions, 90);
+	result->p99 = benchmarkPercentile (samples, repetitions, 99);
+	result->max = samples[repetitions - 1];
+
+	double sum = 0;
+	for (size_t i = 0; i < repetitions; ++i)
+	{
+		sum += samples[i];
+	}
+	result->mean = sum / repetitions;
+
+	elektraFree (samples);
+	fprintf (stderr, "%-50s %14" PRIu64 " ns\n", id, result->median);
+	return 1;
+}
+
+static void benchmarkWriteString (FILE * out, const char * str)
+{
+	fputc ('"', out);
+	for (; *str; ++str)
+	{
+		if (*str == '"' || *str == '\\') fputc ('\\', out);
+		fputc (*str, out);
+	}
+	fputc ('"', out);
+}
+
+static void benchmarkWriteJson (FILE * out)
+{
+	fprintf (out, "{\n");
+	fprintf (out, "\t\"unit\": \"ns\",\n");
+	fprintf (out, "\t\"warmups\": %zu,\n", benchmarkOptions.warmups);
+	fprintf (out, "\t\"repetitions\": %zu,\n", benchmarkOptions.repetitions);
+	fprintf (out,
+		 "\t\"dataset\": { \"size\": %zu, \"depth\": %zu, \"value\": %zu, \"meta\": %zu, \"meta-ratio\": %u, \"seed\": %" PRId32
+		 " },\n",
+		 benchmarkDataset.size, benchmarkDataset.depth, benchmarkDataset.valueSize, benchmarkDataset.metaKeys,
+		 benchmarkDataset.metaRatio, benchmarkDataset.seed);
+	fprintf (out, "\t\"results\": [\n");
+	for (size_t i = 0; i < benchmarkResultsSize; ++i)
+	{
+		const BenchmarkResult * result = &benchmarkResults[i];
+		// one result per line, benchmarkCompare () relies on it
+		fprintf (out, "\t\t{ \"group\": ");
+		benchmarkWriteString (out, result->group);
+		fprintf (out, ", \"name\": ");
+		benchmarkWriteString (out, result->name);
+		fprintf (out,
+			 ", \"samples\": %zu, \"min\": %" PRIu64 ", \"median\": %" PRIu64 ", \"p90\": %" PRIu64 ", \"p99\": %" PRIu64
+			 ", \"max\": %" PRIu64 ", \"mean\": %.1f }%s\n",
+			 result->samples, result->min, result->median, result->p90, result->p99, result->max, result->mean,
+			 i + 1 < benchmarkResultsSize ? "," : "");
+	}
+	fprintf (out, "\t]\n}\n");
+}
+
+/**
+ * @brief Print all collected results and free them
+ *
+ * Writes a table to stdout, or JSON if benchmarkOptions.json is set.
+ *
+ * @retval 0 on success
+ * @retval -1 if the JSON file could not be written
+ */
+int benchmarkReport (void)
+{
+	int ret = 0;
+	if (benchmarkOptions.json)
+	{
+		int toStdout = !strcmp (benchmarkOptions.json, "-");
+		FILE * out = toStdout ? stdout : fopen (benchmarkOptions.json, "w");
+		if (out)
+		{
+			benchmarkWriteJson (out);
+			if (!toStdout && fclose (out) != 0) ret = -1;
+		}
+		else
+		{
+			fprintf (stderr, "could not write %s\n", benchmarkOptions.json);
+			ret = -1;
+		}
+	}
+	else
+	{
+		fprintf (stdout, "%-40s %12s %12s %12s %12s %12s\n", "benchmark (ns)", "min", "median", "p90", "p99", "max");
+		for (size_t i = 0; i < benchmarkResultsSize; ++i)
+		{
+			const BenchmarkResult * result = &benchmarkResults[i];
+			char id[KEY_NAME_LENGTH + 1];
+			snprintf (id, KEY_NAME_LENGTH, "%s/%s", result->group, result->name);
+			fprintf (stdout, "%-40s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n", id, result->min,
+				 result->median, result->p90, result->p99, result->max);
+		}
+	}
+
+	for (size_t i = 0; i < benchmarkResultsSize; ++i)
+	{
+		elektraFree (benchmarkResults[i].group);
+		elektraFree (benchmarkResults[i].name);
+	}
+	elektraFree (benchmarkResults);
+	benchmarkResults = 0;
+	benchmarkResultsSize = benchmarkResultsAlloc = 0;
+	return ret;
+}
+
+/**
+ * @return the unescaped string value of field in the JSON line or NULL
+ */
+static char * benchmarkJsonString (const char * line, const char * field)
+{
+	const char * pos = strstr (line, field);
+	if (!pos) return 0;
+	pos = strchr (pos + strlen (field), '"');
+	if (!pos) return 0;
+
+	char * str = elektraMalloc (strlen (pos));
+	size_t length = 0;
+	for (++pos; *pos && *pos != '"'; ++pos)
+	{
+		if (*pos == '\\' && pos[1]) ++pos;
+		str[length++] = *pos;
+	}
+	str[length] = '\0';
+	return str;
+}
+
+static KeySet * benchmarkReadResults (const char * file)
+{
+	FILE * in = fopen (file, "r");
+	if (!in)
+	{
+		fprintf (stderr, "could not read %s\n", file);
+		return 0;
+	}
+
+	KeySet * results = ksNew (0, KS_END);
+	char line[4096];
+	while (fgets (line, sizeof (line), in))
+	{
+		char * group = benchmarkJsonString (line, "\"group\":");
+		char * name = benchmarkJsonString (line, "\"name\":");
+		const char * median = strstr (line, "\"median\":");
+		if (group && name && median)
+		{
+			// groups like storage/dump are kept as hierarchy, the name may contain any character
+			Key * result = keyNew ("/", KEY_VALUE, median + sizeof ("\"median\":") - 1, KEY_END);
+			keyAddName (result, group);
+			keyAddBaseName (result, name);
+			ksAppendKey (results, result);
+		}
+		elektraFree (group);
+		elektraFree (name);
+	}
+	fclose (in);
+	return results;
+}
+
+/**
+ * @brief Compare the medians of two JSON files written by benchmarkReport ()
+ *
+ * @param baseline the file with the old results
+ * @param current the file with the new results
+ * @param threshold the relative change in percent, which is considered noise
+ *
+ * @return the number of regressions, benchmarks slower than the threshold
+ * @retval -1 if a file could not be read
+ */
+int benchmarkCompare (const char * baseline, const char * current, double threshold)
+{
+	KeySet * old = benchmarkReadResults (baseline);
+	KeySet * new = old ? benchmarkReadResults (current) : 0;
+	if (!new)
+	{
+		ksDel (old);
+		return -1;
+	}
+
+	int regressions = 0;
+	fprintf (stdout, "%-40s %14s %14s %9s\n", "benchmark (median ns)", "baseline", "current", "change");
+	Key * cur;
+	ksRewind (new);
+	while ((cur = ksNext (new)))
+	{
+		const char * id = keyName (cur) + 1;
+		double now = strtod (keyString (cur), 0);
+		Key * before = ksLookup (old, cur, 0);
+		if (!before)
+		{
+			fprintf (stdout, "%-40s %14s %14.0f %9s\n", id, "-", now, "new");
+			continue;
+		}
+
+		double then = strtod (keyString (before), 0);
+		double change = then > 0 ? (now - then) / then * 100 : 0;
+		const char * verdict = "";
+		if (change > threshold)
+		{
+			verdict = "REGRESSION";
+			++regressions;
+		}
+		else if (change < -threshold)
+		{
+			verdict = "improved";
+		}
+		fprintf (stdout, "%-40s %14.0f %14.0f %+8.1f%% %s\n", id, then, now, change, verdict);
+	}
+
+	ksRewind (old);
+	while ((cur = ksNext (old)))
+	{
+		if (!ksLookup (new, cur, 0)) fprintf (stdout, "%-40s %14s %14s %9s\n", keyName (cur) + 1, "", "-", "missing");
+	}
+
+	fprintf (stdout, "%d regression(s) above %.1f%%\n", regressions, threshold);
+	ksDel (old);
+	ksDel (new);
+	return regressions;
+}
@@ -146,6 +146,65 @@ typedef struct
 
 KeySet * generateKeySet (const size_t size, int32_t * seed, KeySetShape * shape);
 
+/**
+ * Benchmark Harness
+ *
+ * benchmarkRun () times a BenchmarkCase with warm-up runs and repetitions
+ * and collects the results, which benchmarkReport () prints as table
+ * or JSON. The options below can be set by benchmarkParseOptions ():
+ *
+ *  * `--warmup=<n>`: untimed runs before the repetitions (default 2)
+ *  * `--repeat=<n>`: timed runs (default 11)
+ *  * `--json=<file>`: write the results as JSON to the file (`-` for stdout)
+ *  * `--filter=<text>`: only run benchmarks with the text in `<group>/<name>`
+ *  * `--size=<n>`, `--depth=<n>`, `--value=<n>`, `--meta=<n>`, `--meta-ratio=<n>`, `--seed=<n>`:
+ *    the BenchmarkDataset of benchmarkGenerateDataset ()
+ */
+typedef struct
+{
+	size_t warmups;
+	size_t repetitions;
+	const char * json;
+	const char * filter;
+} BenchmarkOptions;
+
+/**
+ * Configures the keys generated by benchmarkGenerateDataset ().
+ */
+typedef struct
+{
+	size_t size;	   /*!< number of keys */
+	size_t depth;	  /*!< number of levels below the root */
+	size_t valueSize;      /*!< mean length of the values, they are uniformly distributed in [0, 2 * valueSize] */
+	size_t metaKeys;       /*!< number of meta keys of a key with meta data */
+	unsigned int metaRatio; /*!< 1/metaRatio of the keys have meta data, 0 for none */
+	int32_t seed;	  /*!< seed for elektraRand (...), 0 < seed < ELEKTRARANDMAX */
+} BenchmarkDataset;
+
+/**
+ * A single operation to measure.
+ *
+ * Only run is timed. setup and teardown (may be NULL) are called
+ * before and after every run, also for warm-up runs.
+ */
+typedef struct
+{
+	const char * group;
+	const char * name;
+	void (*setup) (void * data);
+	void (*run) (void * data);
+	void (*teardown) (void * data);
+} BenchmarkCase;
+
+extern BenchmarkOptions benchmarkOptions;
+extern BenchmarkDataset benchmarkDataset;
+
+int benchmarkParseOptions (int * argc, char ** argv);
+KeySet * benchmarkGenerateDataset (const BenchmarkDataset * dataset);
+int benchmarkRun (const BenchmarkCase * benchmark, void * data);
+int benchmarkReport (void);
+int benchmarkCompare (const char * baseline, const char * current, double threshold);
+
 void printExit (const char * msg);
 
 #endif
@@ -26,6 +26,45 @@ int benchmarkIterate (void)
 	return c;
 }
 
+/**
+ * Renames a single key num_dir * num_key times, with names formatted
+ * by @p format from the indizes of the directory and the key.
+ */
+static int benchmarkSetName (const char * format)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	Key * key = keyNew ("", KEY_END);
+	int c = 0;
+	for (int i = 0; i < num_dir; i++)
+	{
+		for (int j = 0; j < num_key; j++)
+		{
+			snprintf (name, KEY_NAME_LENGTH, format, KEY_ROOT, i, j);
+			c += keySetName (key, name) > 0;
+		}
+	}
+	keyDel (key);
+	return c;
+}
+
+static int benchmarkAddName (void)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	Key * key = keyNew (KEY_ROOT, KEY_END);
+	int c = 0;
+	for (int i = 0; i < num_dir; i++)
+	{
+		for (int j = 0; j < num_key; j++)
+		{
+			snprintf (name, KEY_NAME_LENGTH, "dir%d/key%d", i, j);
+			keySetName (key, KEY_ROOT);
+			c += keyAddName (key, name) > 0;
+		}
+	}
+	keyDel (key);
+	return c;
+}
+
 int main (int argc, char ** argv)
 {
 	if (argc != 3)
@@ -53,4 +92,13 @@ int main (int argc, char ** argv)
 
 	benchmarkDel ();
 	timePrint ("Del large keyset");
+
+	benchmarkSetName ("%s/dir%d/key%d");
+	timePrint ("keySetName with canonical names");
+
+	benchmarkSetName ("%s//dir%d/./key%d/");
+	timePrint ("keySetName with non-canonical names");
+
+	benchmarkAddName ();
+	timePrint ("keySetName and keyAddName");
 }
@@ -0,0 +1,108 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for reading large files with the csvstorage plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <sys/stat.h>
+
+#define CSV_PARENT "user/benchmarks/csv"
+#define NUM_RUNS 5
+
+static int benchmarkCsvWriteFile (const char * filename, long rows, long columns)
+{
+	FILE * fp = fopen (filename, "w");
+	if (!fp) return -1;
+
+	for (long c = 0; c < columns; ++c)
+	{
+		fprintf (fp, c ? ",col%ld" : "col%ld", c);
+	}
+	fprintf (fp, "\n");
+	for (long r = 0; r < rows; ++r)
+	{
+		for (long c = 0; c < columns; ++c)
+		{
+			fprintf (fp, c ? ",value %ld/%ld" : "value %ld/%ld", r, c);
+		}
+		fprintf (fp, "\n");
+	}
+	fclose (fp);
+	return 0;
+}
+
+static void benchmarkCsvRead (const char * name, KeySet * conf, const char * filename)
+{
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("", KEY_END);
+	Plugin * plugin = elektraPluginOpen ("csvstorage", modules, conf, errorKey);
+	keyDel (errorKey);
+	if (!plugin)
+	{
+		printExit ("Could not open plugin: csvstorage");
+	}
+
+	struct stat buf;
+	if (stat (filename, &buf) != 0)
+	{
+		printExit ("stat");
+	}
+
+	Key * parentKey = keyNew (CSV_PARENT, KEY_VALUE, filename, KEY_END);
+	for (size_t run = 0; run < NUM_RUNS; ++run)
+	{
+		KeySet * returned = ksNew (0, KS_END);
+		timeInit ();
+		if (plugin->kdbGet (plugin, returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+		{
+			printExit ("Error reading with plugin: csvstorage");
+		}
+		int readTime = timeGetDiffMicroseconds ();
+		fprintf (stdout, "%s;%s;%d\n", name, "read microseconds", readTime);
+		if (readTime > 0)
+		{
+			// bytes per microsecond are megabytes per second
+			fprintf (stdout, "%s;%s;%.2f\n", name, "read MB/s", (double) buf.st_size / readTime);
+		}
+		fprintf (stdout, "%s;%s;%zd\n", name, "keys", ksGetSize (returned));
+		ksDel (returned);
+	}
+
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+}
+
+int main (int argc, char ** argv)
+{
+	long rows = argc > 1 ? atol (argv[1]) : 100000;
+	long columns = argc > 2 ? atol (argv[2]) : 10;
+
+	char filename[] = "/tmp/elektra-benchmark-csv.XXXXXX";
+	int fd = mkstemp (filename);
+	if (fd == -1)
+	{
+		printExit ("mkstemp");
+	}
+	close (fd);
+
+	if (benchmarkCsvWriteFile (filename, rows, columns) == -1)
+	{
+		printExit ("could not write csv file");
+	}
+
+	fprintf (stdout, "%s;%s;%s\n", "config", "operation", "value");
+	benchmarkCsvRead ("all columns", ksNew (1, keyNew ("system/header", KEY_VALUE, "colname", KEY_END), KS_END), filename);
+	benchmarkCsvRead ("one column",
+			  ksNew (3, keyNew ("system/header", KEY_VALUE, "colname", KEY_END), keyNew ("system/import", KEY_END),
+				 keyNew ("system/import/col0", KEY_END), KS_END),
+			  filename);
+
+	unlink (filename);
+}
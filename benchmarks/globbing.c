@@ -0,0 +1,48 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for filtering a large KeySet with many globbing patterns
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbglobbing.h>
+
+int main (int argc, char ** argv)
+{
+	num_dir = argc > 1 ? atoi (argv[1]) : 1000;
+	num_key = argc > 2 ? atoi (argv[2]) : 1000;
+
+	benchmarkCreate ();
+	benchmarkFillup ();
+
+	char pattern[KEY_NAME_LENGTH + 1];
+	KeySet * result = ksNew (0, KS_END);
+
+	fprintf (stdout, "%s;%s;%s\n", "patterns", "matches", "microseconds");
+
+	// every pattern has a literal prefix
+	timeInit ();
+	for (int i = 0; i < num_dir; i++)
+	{
+		snprintf (pattern, KEY_NAME_LENGTH, "%s/%s%d/%s", KEY_ROOT, "dir", i, "key1*");
+		elektraKsGlob (result, large, pattern);
+	}
+	int time = timeGetDiffMicroseconds ();
+	fprintf (stdout, "%d literal prefix;%zd;%d\n", num_dir, ksGetSize (result), time);
+	ksClear (result);
+
+	// patterns without literal prefix have to look at all keys
+	timeInit ();
+	for (int i = 0; i < 10; i++)
+	{
+		snprintf (pattern, KEY_NAME_LENGTH, "*/benchmark/%s%d/%s", "dir", i, "key1*");
+		elektraKsGlob (result, large, pattern);
+	}
+	time = timeGetDiffMicroseconds ();
+	fprintf (stdout, "%d wildcard namespace;%zd;%d\n", 10, ksGetSize (result), time);
+
+	ksDel (result);
+	ksDel (large);
+}
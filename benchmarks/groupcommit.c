@@ -0,0 +1,173 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for kdbSet of many backends
+ *
+ * Mounts many files with the sync plugin and measures kdbSet of
+ * all of them, once with and once without group commit.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbhelper.h>
+#include <kdbproposal.h>
+
+#include <limits.h>
+#include <unistd.h>
+
+#define GROUPCOMMIT_MOUNTPOINTS "system/elektra/mountpoints"
+#define GROUPCOMMIT_PARENT "system/benchmark/groupcommit"
+
+typedef struct
+{
+	KDB * handle;
+	KeySet * ks;
+	Key * parentKey;
+	const char * directory;
+	size_t size;
+	int groupCommit;
+	size_t run;
+} GroupCommitData;
+
+static void mountAddKey (KeySet * mountpoints, Key * mountpoint, const char * name, const char * value)
+{
+	Key * key = keyDup (mountpoint);
+	keyAddName (key, name);
+	keySetString (key, value);
+	ksAppendKey (mountpoints, key);
+}
+
+/**
+ * Mounts @p groupCommit->size files with resolver, quickdump and sync below
+ * system/benchmark/groupcommit, or removes the mountpoints if @p mount is 0.
+ */
+static void mountFiles (GroupCommitData * groupCommit, int mount)
+{
+	Key * parentKey = keyNew (GROUPCOMMIT_MOUNTPOINTS, KEY_END);
+	KDB * handle = kdbOpen (parentKey);
+	if (!handle) printExit ("kdbOpen failed");
+	KeySet * mountpoints = ksNew (0, KS_END);
+	if (kdbGet (handle, mountpoints, parentKey) == -1) printExit ("kdbGet of mountpoints failed");
+
+	char name[PATH_MAX];
+	for (size_t i = 0; i < groupCommit->size; ++i)
+	{
+		snprintf (name, sizeof (name), GROUPCOMMIT_PARENT "/mount%05zu", i);
+		Key * mountpoint = keyDup (parentKey);
+		keyAddBaseName (mountpoint, name);
+		ksDel (ksCut (mountpoints, mountpoint));
+		if (mount)
+		{
+			mountAddKey (mountpoints, mountpoint, "", "");
+			mountAddKey (mountpoints, mountpoint, "mountpoint", name);
+			mountAddKey (mountpoints, mountpoint, "config", "");
+			snprintf (name, sizeof (name), "%s/mount%05zu", groupCommit->directory, i);
+			mountAddKey (mountpoints, mountpoint, "config/path", name);
+			// the plugins are opened in the order of the keys, references follow their definition
+			mountAddKey (mountpoints, mountpoint, "errorplugins", "");
+			mountAddKey (mountpoints, mountpoint, "errorplugins/#5#" KDB_RESOLVER "#resolver#", "");
+			mountAddKey (mountpoints, mountpoint, "getplugins", "");
+			mountAddKey (mountpoints, mountpoint, "getplugins/#0#resolver", "");
+			mountAddKey (mountpoints, mountpoint, "getplugins/#5#quickdump#storage#", "");
+			mountAddKey (mountpoints, mountpoint, "setplugins", "");
+			mountAddKey (mountpoints, mountpoint, "setplugins/#0#resolver", "");
+			mountAddKey (mountpoints, mountpoint, "setplugins/#5#storage", "");
+			mountAddKey (mountpoints, mountpoint, "setplugins/#6#sync#sync#", "");
+			mountAddKey (mountpoints, mountpoint, "setplugins/#7#resolver", "");
+		}
+		keyDel (mountpoint);
+	}
+
+	if (kdbSet (handle, mountpoints, parentKey) == -1) printExit ("kdbSet of mountpoints failed");
+	ksDel (mountpoints);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+static void removeFiles (GroupCommitData * groupCommit)
+{
+	char name[PATH_MAX];
+	for (size_t i = 0; i < groupCommit->size; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/mount%05zu", groupCommit->directory, i);
+		unlink (name);
+	}
+}
+
+static void groupCommitOpen (void * data)
+{
+	GroupCommitData * groupCommit = data;
+	groupCommit->handle = kdbOpen (groupCommit->parentKey);
+	if (!groupCommit->handle) printExit ("kdbOpen failed");
+	elektraGroupCommitEnable (groupCommit->handle, groupCommit->groupCommit);
+	groupCommit->ks = ksNew (groupCommit->size, KS_END);
+	if (kdbGet (groupCommit->handle, groupCommit->ks, groupCommit->parentKey) == -1) printExit ("kdbGet failed");
+}
+
+static void groupCommitSet (void * data)
+{
+	GroupCommitData * groupCommit = data;
+	char name[64];
+	char value[32];
+	snprintf (value, sizeof (value), "%zu", ++groupCommit->run);
+	// change one key of every backend
+	for (size_t i = 0; i < groupCommit->size; ++i)
+	{
+		snprintf (name, sizeof (name), GROUPCOMMIT_PARENT "/mount%05zu/key", i);
+		ksAppendKey (groupCommit->ks, keyNew (name, KEY_VALUE, value, KEY_END));
+	}
+	if (kdbSet (groupCommit->handle, groupCommit->ks, groupCommit->parentKey) != 1) printExit ("kdbSet failed");
+}
+
+static void groupCommitClose (void * data)
+{
+	GroupCommitData * groupCommit = data;
+	ksDel (groupCommit->ks);
+	groupCommit->ks = 0;
+	kdbClose (groupCommit->handle, groupCommit->parentKey);
+	groupCommit->handle = 0;
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 50;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 2)
+	{
+		fprintf (stderr, "Usage: benchmark_groupcommit [--size=<number of mountpoints>] [--warmup=<n>] [--repeat=<n>] "
+				 "[--json=<file>] [--filter=<text>] [<directory on the file system to test>]\n");
+		return EXIT_FAILURE;
+	}
+
+	char directory[PATH_MAX];
+	snprintf (directory, sizeof (directory), "%s/elektra-benchmark-groupcommit.XXXXXX", argc == 2 ? argv[1] : "/tmp");
+	if (!mkdtemp (directory)) printExit ("mkdtemp");
+
+	GroupCommitData groupCommit = { 0 };
+	groupCommit.size = benchmarkDataset.size;
+	groupCommit.directory = directory;
+	groupCommit.parentKey = keyNew (GROUPCOMMIT_PARENT, KEY_END);
+	mountFiles (&groupCommit, 1);
+
+	char name[32];
+	snprintf (name, sizeof (name), "kdbSet/%zu", groupCommit.size);
+	const BenchmarkCase benchmarks[] = {
+		{ "single", name, groupCommitOpen, groupCommitSet, groupCommitClose },
+		{ "group", name, groupCommitOpen, groupCommitSet, groupCommitClose },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		groupCommit.groupCommit = i;
+		benchmarkRun (&benchmarks[i], &groupCommit);
+	}
+
+	int result = benchmarkReport ();
+
+	mountFiles (&groupCommit, 0);
+	removeFiles (&groupCommit);
+	keyDel (groupCommit.parentKey);
+	rmdir (directory);
+
+	return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
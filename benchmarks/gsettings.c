@@ -0,0 +1,166 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the GSettings backend
+ *
+ * Measures reads of the same settings object, the read bursts of a
+ * session startup, where many components create a settings object and
+ * read all of its keys, and writes of whole trees of changes.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#define G_SETTINGS_ENABLE_BACKEND
+#include <gio/gio.h>
+#include <gio/gsettingsbackend.h>
+
+#define BENCHMARK_SCHEMA "org.libelektra.benchmark.gsettings"
+
+typedef struct
+{
+	GSettings * settings;
+	GSettingsSchema * schema;
+	gchar ** keys;
+	size_t size;
+} GSettingsData;
+
+static GVariant * benchmarkValue (GSettingsData * gs, const gchar * name, guint round)
+{
+	GSettingsSchemaKey * key = g_settings_schema_get_key (gs->schema, name);
+	const GVariantType * type = g_settings_schema_key_get_value_type (key);
+	GVariant * value;
+	switch (g_variant_type_peek_string (type)[0])
+	{
+	case 'b':
+		value = g_variant_new_boolean (round % 2);
+		break;
+	case 'i':
+		value = g_variant_new_int32 (round);
+		break;
+	case 'd':
+		value = g_variant_new_double (round / 3.0);
+		break;
+	case 's':
+		value = g_variant_new_take_string (g_strdup_printf ("value %u", round));
+		break;
+	default:
+	{
+		const gchar * list[] = { "first", "second" };
+		value = g_variant_new_strv (list, round % 2 + 1);
+		break;
+	}
+	}
+	g_settings_schema_key_unref (key);
+	return value;
+}
+
+static void benchmarkWriteTree (GSettingsData * gs, guint round, guint step)
+{
+	// a delayed settings object writes all changes with one tree
+	for (size_t i = 0; gs->keys[i] != NULL; i += step)
+	{
+		g_settings_set_value (gs->settings, gs->keys[i], benchmarkValue (gs, gs->keys[i], round));
+	}
+	g_settings_apply (gs->settings);
+}
+
+static void gsettingsSetup (void * data)
+{
+	GSettingsData * gs = data;
+	gs->settings = g_settings_new (BENCHMARK_SCHEMA);
+	g_settings_delay (gs->settings);
+	// like in a session, only some keys have user values
+	benchmarkWriteTree (gs, 1, 2);
+	g_settings_sync ();
+}
+
+static void gsettingsTeardown (void * data)
+{
+	GSettingsData * gs = data;
+	for (size_t i = 0; gs->keys[i] != NULL; ++i)
+	{
+		g_settings_reset (gs->settings, gs->keys[i]);
+	}
+	g_settings_apply (gs->settings);
+	g_settings_sync ();
+	g_object_unref (gs->settings);
+	gs->settings = NULL;
+}
+
+static void readRepeat (void * data)
+{
+	GSettingsData * gs = data;
+	for (size_t i = 0, k = 0; i < gs->size; ++i, ++k)
+	{
+		if (gs->keys[k] == NULL) k = 0;
+		g_variant_unref (g_settings_get_value (gs->settings, gs->keys[k]));
+	}
+}
+
+static void readStartup (void * data)
+{
+	GSettingsData * gs = data;
+	for (size_t i = 0; i < gs->size;)
+	{
+		GSettings * settings = g_settings_new (BENCHMARK_SCHEMA);
+		for (size_t k = 0; gs->keys[k] != NULL && i < gs->size; ++k, ++i)
+		{
+			g_variant_unref (g_settings_get_value (settings, gs->keys[k]));
+		}
+		g_object_unref (settings);
+	}
+}
+
+static void writeTree (void * data)
+{
+	GSettingsData * gs = data;
+	size_t trees = gs->size / g_strv_length (gs->keys);
+	for (size_t i = 0; i < trees; ++i)
+	{
+		benchmarkWriteTree (gs, i, 1);
+	}
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 10000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_gsettings [--size=<number of reads>] [--warmup=<n>] [--repeat=<n>] [--json=<file>] "
+				 "[--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	// use the backend and the schema of the build tree
+	g_setenv ("GSETTINGS_SCHEMA_DIR", BENCHMARK_SCHEMA_DIR, TRUE);
+	g_setenv ("GIO_EXTRA_MODULES", BENCHMARK_MODULE_DIR, TRUE);
+	g_setenv ("GSETTINGS_BACKEND", "elektra", TRUE);
+
+	GSettingsBackend * backend = g_settings_backend_get_default ();
+	if (strcmp (G_OBJECT_TYPE_NAME (backend), "ElektraSettingsBackend") != 0) printExit ("Elektra GSettings backend not loaded");
+	g_object_unref (backend);
+
+	GSettingsData gs = { 0 };
+	gs.size = benchmarkDataset.size;
+	gs.schema = g_settings_schema_source_lookup (g_settings_schema_source_get_default (), BENCHMARK_SCHEMA, FALSE);
+	if (!gs.schema) printExit ("schema " BENCHMARK_SCHEMA " not found");
+	gs.keys = g_settings_schema_list_keys (gs.schema);
+
+	char name[32];
+	snprintf (name, sizeof (name), "%zu", gs.size);
+	const BenchmarkCase benchmarks[] = {
+		{ "read/repeat", name, gsettingsSetup, readRepeat, gsettingsTeardown },
+		{ "read/startup", name, gsettingsSetup, readStartup, gsettingsTeardown },
+		{ "write/tree", name, gsettingsSetup, writeTree, gsettingsTeardown },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &gs);
+	}
+
+	g_strfreev (gs.keys);
+	g_settings_schema_unref (gs.schema);
+	return benchmarkReport () == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
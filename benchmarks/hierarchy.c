@@ -0,0 +1,57 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for accessing subtrees of a large KeySet
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbproposal.h>
+
+#define NUM_SUBTREES 1000
+
+int main (int argc, char ** argv)
+{
+	num_dir = argc > 1 ? atoi (argv[1]) : 1000;
+	num_key = argc > 2 ? atoi (argv[2]) : 1000;
+
+	benchmarkCreate ();
+	benchmarkFillup ();
+
+	char name[KEY_NAME_LENGTH + 1];
+	size_t found = 0;
+
+	fprintf (stdout, "%s;%s;%s\n", "method", "keys", "microseconds");
+
+	timeInit ();
+	for (int i = 0; i < NUM_SUBTREES; i++)
+	{
+		snprintf (name, KEY_NAME_LENGTH, "%s/%s%d", KEY_ROOT, "dir", i % num_dir);
+		Key * root = keyNew (name, KEY_END);
+		KeySet * cut = ksCut (large, root);
+		found += ksGetSize (cut);
+		ksAppend (large, cut);
+		ksDel (cut);
+		keyDel (root);
+	}
+	fprintf (stdout, "%s;%zu;%d\n", "ksCut+ksAppend", found, timeGetDiffMicroseconds ());
+
+	found = 0;
+	timeInit ();
+	for (int i = 0; i < NUM_SUBTREES; i++)
+	{
+		snprintf (name, KEY_NAME_LENGTH, "%s/%s%d", KEY_ROOT, "dir", i % num_dir);
+		Key * root = keyNew (name, KEY_END);
+		size_t end;
+		for (ssize_t it = ksFindHierarchy (large, root, &end); it >= 0 && (size_t) it < end; ++it)
+		{
+			if (ksAtCursor (large, it) != NULL) ++found;
+		}
+		keyDel (root);
+	}
+	fprintf (stdout, "%s;%zu;%d\n", "ksFindHierarchy", found, timeGetDiffMicroseconds ());
+
+	ksDel (large);
+}
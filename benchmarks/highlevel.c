@@ -0,0 +1,160 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for reading values with the high-level API
+ *
+ * Reads scalar values and iterates arrays of an Elektra instance,
+ * whose configuration consists of default values only.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <elektra.h>
+#include <kdbease.h>
+
+#define BENCHMARK_PARENT "/sw/elektra/benchmark/#0/current"
+
+typedef struct
+{
+	KeySet * defaults;
+	Elektra * elektra;
+	char ** names;
+	size_t size;
+} HighlevelData;
+
+static void fatalErrorHandler (ElektraError * error)
+{
+	fprintf (stderr, "fatal error: %s\n", elektraErrorDescription (error));
+	exit (EXIT_FAILURE);
+}
+
+static KeySet * createDefaults (size_t size)
+{
+	KeySet * defaults = ksNew (3 * size + 2, KS_END);
+	char name[ELEKTRA_MAX_ARRAY_SIZE + 16];
+	char value[32];
+	for (size_t i = 0; i < size; ++i)
+	{
+		snprintf (name, sizeof (name), "/long/%zu", i);
+		snprintf (value, sizeof (value), "%zu", i);
+		ksAppendKey (defaults, keyNew (name, KEY_VALUE, value, KEY_META, "type", "long", KEY_END));
+
+		strcpy (name, "/longarray/");
+		elektraWriteArrayNumber (&name[strlen (name)], i);
+		ksAppendKey (defaults, keyNew (name, KEY_VALUE, value, KEY_META, "type", "long", KEY_END));
+
+		strcpy (name, "/stringarray/");
+		elektraWriteArrayNumber (&name[strlen (name)], i);
+		ksAppendKey (defaults, keyNew (name, KEY_VALUE, value, KEY_META, "type", "string", KEY_END));
+	}
+
+	elektraWriteArrayNumber (value, size - 1);
+	ksAppendKey (defaults, keyNew ("/longarray", KEY_META, "array", value, KEY_END));
+	ksAppendKey (defaults, keyNew ("/stringarray", KEY_META, "array", value, KEY_END));
+	return defaults;
+}
+
+static void highlevelOpen (void * data)
+{
+	HighlevelData * highlevel = data;
+	ElektraError * error = NULL;
+	highlevel->elektra = elektraOpen (BENCHMARK_PARENT, highlevel->defaults, &error);
+	if (highlevel->elektra == NULL)
+	{
+		fprintf (stderr, "elektraOpen failed: %s\n", elektraErrorDescription (error));
+		exit (EXIT_FAILURE);
+	}
+	elektraFatalErrorHandler (highlevel->elektra, fatalErrorHandler);
+}
+
+static void highlevelClose (void * data)
+{
+	HighlevelData * highlevel = data;
+	elektraClose (highlevel->elektra);
+	highlevel->elektra = NULL;
+}
+
+static void highlevelGetLong (void * data)
+{
+	HighlevelData * highlevel = data;
+	for (size_t i = 0; i < highlevel->size; ++i)
+	{
+		if (elektraGetLong (highlevel->elektra, highlevel->names[i]) != (kdb_long_t) i) printExit ("elektraGetLong: wrong value");
+	}
+}
+
+static void highlevelGetLongArrayElement (void * data)
+{
+	HighlevelData * highlevel = data;
+	kdb_long_long_t size = elektraArraySize (highlevel->elektra, "longarray");
+	for (kdb_long_long_t i = 0; i < size; ++i)
+	{
+		if (elektraGetLongArrayElement (highlevel->elektra, "longarray", i) != i) printExit ("elektraGetLongArrayElement: wrong value");
+	}
+}
+
+static void highlevelGetLongArray (void * data)
+{
+	HighlevelData * highlevel = data;
+	kdb_long_long_t size;
+	const kdb_long_t * array = elektraGetLongArray (highlevel->elektra, "longarray", &size);
+	for (kdb_long_long_t i = 0; i < size; ++i)
+	{
+		if (array[i] != i) printExit ("elektraGetLongArray: wrong value");
+	}
+	if (size != (kdb_long_long_t) highlevel->size) printExit ("elektraGetLongArray: wrong size");
+}
+
+static void highlevelGetStringArrayElement (void * data)
+{
+	HighlevelData * highlevel = data;
+	kdb_long_long_t size = elektraArraySize (highlevel->elektra, "stringarray");
+	size_t length = 0;
+	for (kdb_long_long_t i = 0; i < size; ++i)
+	{
+		length += strlen (elektraGetStringArrayElement (highlevel->elektra, "stringarray", i));
+	}
+	if (length == 0) printExit ("elektraGetStringArrayElement: no values");
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 10000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_highlevel [--size=<number of values and array elements>] [--warmup=<n>] [--repeat=<n>] "
+				 "[--json=<file>] [--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	HighlevelData highlevel = { 0 };
+	highlevel.size = benchmarkDataset.size;
+	highlevel.defaults = createDefaults (highlevel.size);
+	highlevel.names = elektraMalloc (highlevel.size * sizeof (char *));
+	for (size_t i = 0; i < highlevel.size; ++i)
+	{
+		highlevel.names[i] = elektraFormat ("long/%zu", i);
+	}
+
+	const BenchmarkCase benchmarks[] = {
+		{ "highlevel", "elektraOpen+elektraClose", 0, highlevelOpen, highlevelClose },
+		{ "highlevel", "elektraGetLong", highlevelOpen, highlevelGetLong, highlevelClose },
+		{ "highlevel", "elektraGetLongArrayElement", highlevelOpen, highlevelGetLongArrayElement, highlevelClose },
+		{ "highlevel", "elektraGetLongArray", highlevelOpen, highlevelGetLongArray, highlevelClose },
+		{ "highlevel", "elektraGetStringArrayElement", highlevelOpen, highlevelGetStringArrayElement, highlevelClose },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &highlevel);
+	}
+
+	for (size_t i = 0; i < highlevel.size; ++i)
+	{
+		elektraFree (highlevel.names[i]);
+	}
+	elektraFree (highlevel.names);
+	ksDel (highlevel.defaults);
+
+	return benchmarkReport () == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
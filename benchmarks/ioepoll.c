@@ -0,0 +1,217 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the epoll I/O binding
+ *
+ * Measures the latency of file descriptor callbacks in the background
+ * thread of the binding (round trips through two pipes) and the
+ * throughput of the timer wheel and of idle operations.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdbio/epoll.h>
+
+#include <unistd.h>
+
+#define FD_READ_END 0
+#define FD_WRITE_END 1
+
+typedef struct
+{
+	ElektraIoInterface * binding;
+	ElektraIoFdOperation * fdOp;
+	ElektraIoTimerOperation ** timerOps;
+	ElektraIoIdleOperation * idleOp;
+	int request[2];
+	int reply[2];
+	size_t size;
+	size_t called;
+} IoEpollData;
+
+static void ioEpollBinding (IoEpollData * io, size_t operations)
+{
+	io->binding = elektraIoEpollNew (operations);
+	if (!io->binding) printExit ("elektraIoEpollNew failed");
+	io->called = 0;
+}
+
+static void ioEpollCleanup (IoEpollData * io)
+{
+	if (!elektraIoBindingCleanup (io->binding)) printExit ("cleanup failed");
+	io->binding = NULL;
+}
+
+/* round trips: the background thread answers every byte written to the request pipe */
+
+static void roundTripCallback (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	IoEpollData * io = elektraIoFdGetData (fdOp);
+	char buffer;
+	if (read (io->request[FD_READ_END], &buffer, 1) != 1) printExit ("read of request failed");
+	if (write (io->reply[FD_WRITE_END], &buffer, 1) != 1) printExit ("write of reply failed");
+}
+
+static void roundTripSetup (void * data)
+{
+	IoEpollData * io = data;
+	if (pipe (io->request) == -1 || pipe (io->reply) == -1) printExit ("pipe");
+	ioEpollBinding (io, 1);
+	io->fdOp = elektraIoNewFdOperation (io->request[FD_READ_END], ELEKTRA_IO_READABLE, 1, roundTripCallback, io);
+	if (!elektraIoBindingAddFd (io->binding, io->fdOp)) printExit ("addFd failed");
+	if (!elektraIoEpollStartThread (io->binding)) printExit ("could not start thread");
+}
+
+static void roundTrip (void * data)
+{
+	IoEpollData * io = data;
+	char buffer = 'x';
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		if (write (io->request[FD_WRITE_END], &buffer, 1) != 1) printExit ("write of request failed");
+		if (read (io->reply[FD_READ_END], &buffer, 1) != 1) printExit ("read of reply failed");
+	}
+}
+
+static void roundTripTeardown (void * data)
+{
+	IoEpollData * io = data;
+	elektraIoEpollStopThread (io->binding);
+	elektraIoBindingRemoveFd (io->fdOp);
+	elektraFree (io->fdOp);
+	ioEpollCleanup (io);
+	close (io->request[FD_READ_END]);
+	close (io->request[FD_WRITE_END]);
+	close (io->reply[FD_READ_END]);
+	close (io->reply[FD_WRITE_END]);
+}
+
+/* timers */
+
+static void timerCallback (ElektraIoTimerOperation * timerOp)
+{
+	IoEpollData * io = elektraIoTimerGetData (timerOp);
+	elektraIoTimerSetEnabled (timerOp, 0);
+	elektraIoBindingUpdateTimer (timerOp);
+	if (++io->called == io->size)
+	{
+		elektraIoEpollStop (io->binding);
+	}
+}
+
+static void timerSetup (void * data)
+{
+	IoEpollData * io = data;
+	ioEpollBinding (io, io->size);
+	io->timerOps = elektraMalloc (io->size * sizeof (ElektraIoTimerOperation *));
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		// intervals of 1 to 16 ms, to measure the callbacks and not the waiting
+		io->timerOps[i] = elektraIoNewTimerOperation (1 + i % 16, 1, timerCallback, io);
+	}
+}
+
+static void timerAddRemove (void * data)
+{
+	IoEpollData * io = data;
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		if (!elektraIoBindingAddTimer (io->binding, io->timerOps[i])) printExit ("addTimer failed");
+	}
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		elektraIoBindingRemoveTimer (io->timerOps[i]);
+	}
+}
+
+static void timerExpire (void * data)
+{
+	IoEpollData * io = data;
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		if (!elektraIoBindingAddTimer (io->binding, io->timerOps[i])) printExit ("addTimer failed");
+	}
+	if (!elektraIoEpollRun (io->binding)) printExit ("elektraIoEpollRun failed");
+	if (io->called != io->size) printExit ("not all timers expired");
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		elektraIoBindingRemoveTimer (io->timerOps[i]);
+	}
+}
+
+static void timerTeardown (void * data)
+{
+	IoEpollData * io = data;
+	for (size_t i = 0; i < io->size; ++i)
+	{
+		elektraFree (io->timerOps[i]);
+	}
+	elektraFree (io->timerOps);
+	ioEpollCleanup (io);
+}
+
+/* idle operations, every iteration of the loop calls the idle operation once */
+
+static void idleCallback (ElektraIoIdleOperation * idleOp)
+{
+	IoEpollData * io = elektraIoIdleGetData (idleOp);
+	if (++io->called == io->size)
+	{
+		elektraIoEpollStop (io->binding);
+	}
+}
+
+static void idleSetup (void * data)
+{
+	IoEpollData * io = data;
+	ioEpollBinding (io, 1);
+	io->idleOp = elektraIoNewIdleOperation (1, idleCallback, io);
+	if (!elektraIoBindingAddIdle (io->binding, io->idleOp)) printExit ("addIdle failed");
+}
+
+static void idleRun (void * data)
+{
+	IoEpollData * io = data;
+	if (!elektraIoEpollRun (io->binding)) printExit ("elektraIoEpollRun failed");
+}
+
+static void idleTeardown (void * data)
+{
+	IoEpollData * io = data;
+	elektraIoBindingRemoveIdle (io->idleOp);
+	elektraFree (io->idleOp);
+	ioEpollCleanup (io);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 10000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_ioepoll [--size=<number of operations>] [--warmup=<n>] [--repeat=<n>] [--json=<file>] "
+				 "[--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	IoEpollData io = { 0 };
+	io.size = benchmarkDataset.size;
+
+	char name[32];
+	snprintf (name, sizeof (name), "%zu", io.size);
+	const BenchmarkCase benchmarks[] = {
+		{ "fd/roundtrip", name, roundTripSetup, roundTrip, roundTripTeardown },
+		{ "timer/addremove", name, timerSetup, timerAddRemove, timerTeardown },
+		{ "timer/expire", name, timerSetup, timerExpire, timerTeardown },
+		{ "idle", name, idleSetup, idleRun, idleTeardown },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &io);
+	}
+
+	return benchmarkReport () == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the throughput of the JSON storage plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <sys/stat.h>
+
+#define CSV_STR_FMT "%s;%s;%d\n"
+#define JSON_PARENT "user/benchmarks/json"
+#define NUM_RUNS 7
+
+static KeySet * benchmarkJsonCreate (void)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	KeySet * ks = ksNew (num_key * num_dir, KS_END);
+
+	for (int i = 0; i < num_dir; i++)
+	{
+		for (int j = 0; j < num_key; j++)
+		{
+			snprintf (name, KEY_NAME_LENGTH, "%s/%s%d/%s%d", JSON_PARENT, "dir", i, "key", j);
+			ksAppendKey (ks, keyNew (name, KEY_VALUE, "some string value", KEY_END));
+		}
+	}
+	return ks;
+}
+
+int main (int argc, char ** argv)
+{
+	const char * pluginName = argc > 1 ? argv[1] : "yajl";
+	if (argc > 2)
+	{
+		num_dir = atoi (argv[2]);
+	}
+
+	char filename[] = "/tmp/elektra-benchmark-json.XXXXXX";
+	int fd = mkstemp (filename);
+	if (fd == -1)
+	{
+		printExit ("mkstemp");
+	}
+	close (fd);
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("", KEY_END);
+	Plugin * plugin = elektraPluginOpen (pluginName, modules, ksNew (0, KS_END), errorKey);
+	keyDel (errorKey);
+	if (!plugin)
+	{
+		printf ("Could not open plugin: %s\n", pluginName);
+		return -1;
+	}
+
+	KeySet * ks = benchmarkJsonCreate ();
+	Key * parentKey = keyNew (JSON_PARENT, KEY_VALUE, filename, KEY_END);
+
+	fprintf (stdout, "%s;%s;%s\n", "plugin", "operation", "microseconds");
+	for (size_t run = 0; run < NUM_RUNS; ++run)
+	{
+		timeInit ();
+		if (plugin->kdbSet (plugin, ks, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+		{
+			printf ("Error writing with plugin: %s\n", pluginName);
+			return -1;
+		}
+		int writeTime = timeGetDiffMicroseconds ();
+		fprintf (stdout, CSV_STR_FMT, pluginName, "write keyset", writeTime);
+
+		KeySet * returned = ksNew (0, KS_END);
+		timeInit ();
+		if (plugin->kdbGet (plugin, returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+		{
+			printf ("Error reading with plugin: %s\n", pluginName);
+			return -1;
+		}
+		int readTime = timeGetDiffMicroseconds ();
+		fprintf (stdout, CSV_STR_FMT, pluginName, "read keyset", readTime);
+		ksDel (returned);
+
+		struct stat buf;
+		if (stat (filename, &buf) == 0 && readTime > 0 && writeTime > 0)
+		{
+			// bytes per microsecond are megabytes per second
+			fprintf (stdout, "%s;%s;%.2f\n", pluginName, "write MB/s", (double) buf.st_size / writeTime);
+			fprintf (stdout, "%s;%s;%.2f\n", pluginName, "read MB/s", (double) buf.st_size / readTime);
+		}
+	}
+
+	unlink (filename);
+	keyDel (parentKey);
+	ksDel (ks);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+}
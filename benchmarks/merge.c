@@ -0,0 +1,72 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for merging the KeySets of many backends into one KeySet
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#define NUM_BACKENDS 300
+
+static KeySet ** backends;
+
+static void benchmarkMergeCreate (size_t keysPerBackend)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	backends = elektraMalloc (NUM_BACKENDS * sizeof (KeySet *));
+
+	for (size_t b = 0; b < NUM_BACKENDS; ++b)
+	{
+		backends[b] = ksNew (keysPerBackend, KS_END);
+		for (size_t i = 0; i < keysPerBackend; ++i)
+		{
+			snprintf (name, KEY_NAME_LENGTH, "%s/backend%03zu/key%zu", KEY_ROOT, b, i);
+			ksAppendKey (backends[b], keyNew (name, KEY_END));
+		}
+	}
+}
+
+static void benchmarkMerge (const char * method, int reverse, int keyByKey)
+{
+	KeySet * result = ksNew (0, KS_END);
+
+	timeInit ();
+	for (size_t i = 0; i < NUM_BACKENDS; ++i)
+	{
+		KeySet * backend = backends[reverse ? NUM_BACKENDS - i - 1 : i];
+		if (keyByKey)
+		{
+			for (cursor_t c = 0; c < ksGetSize (backend); ++c)
+			{
+				ksAppendKey (result, ksAtCursor (backend, c));
+			}
+		}
+		else
+		{
+			ksAppend (result, backend);
+		}
+	}
+	fprintf (stdout, "%s;%zd;%d\n", method, ksGetSize (result), timeGetDiffMicroseconds ());
+
+	ksDel (result);
+}
+
+int main (int argc, char ** argv)
+{
+	size_t size = argc > 1 ? (size_t) atol (argv[1]) : 2000000;
+
+	benchmarkMergeCreate (size / NUM_BACKENDS);
+
+	fprintf (stdout, "%s;%s;%s\n", "method", "keys", "microseconds");
+	benchmarkMerge ("ksAppendKey", 0, 1);
+	benchmarkMerge ("ksAppend", 0, 0);
+	benchmarkMerge ("ksAppend (reverse)", 1, 0);
+
+	for (size_t b = 0; b < NUM_BACKENDS; ++b)
+	{
+		ksDel (backends[b]);
+	}
+	elektraFree (backends);
+}
@@ -0,0 +1,191 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for keys with the same metadata
+ *
+ * Gives many keys the metadata of one specification key, once with a
+ * meta KeySet per key and once with shared metadata, and measures the
+ * spec plugin, which copies the metadata of the specification.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbproposal.h>
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2
+#endif
+
+#define META_PARENT "user/benchmark/meta"
+#define META_SPEC "spec/benchmark/meta/*"
+
+typedef struct
+{
+	Plugin * spec;
+	Key * parentKey;
+	Key * specKey;
+	KeySet * ks;
+	KeySet * dup;
+	size_t size;
+} MetaData;
+
+static long metaHeapBytes (void)
+{
+#ifdef HAVE_MALLINFO2
+	return (long) mallinfo2 ().uordblks;
+#else
+	return -1;
+#endif
+}
+
+static Key * metaSpecKey (void)
+{
+	return keyNew (META_SPEC, KEY_META, "type", "long", KEY_META, "default", "0", KEY_META, "check/range", "0-1000000", KEY_META,
+		       "description", "an element of the benchmark configuration", KEY_META, "opt/help", "sets a benchmark value", KEY_END);
+}
+
+static void metaCreateKeys (void * data)
+{
+	MetaData * meta = data;
+	char name[64];
+	meta->ks = ksNew (meta->size, KS_END);
+	for (size_t i = 0; i < meta->size; ++i)
+	{
+		snprintf (name, sizeof (name), META_PARENT "/key%07zu", i);
+		ksAppendKey (meta->ks, keyNew (name, KEY_VALUE, "1", KEY_END));
+	}
+}
+
+/**
+ * Every key gets its own meta KeySet, like keys read by a storage plugin.
+ */
+static void metaSet (void * data)
+{
+	MetaData * meta = data;
+	for (cursor_t it = 0; it < ksGetSize (meta->ks); ++it)
+	{
+		Key * cur = ksAtCursor (meta->ks, it);
+		keyRewindMeta (meta->specKey);
+		const Key * m;
+		while ((m = keyNextMeta (meta->specKey)) != NULL)
+		{
+			keySetMeta (cur, keyName (m), keyString (m));
+		}
+	}
+}
+
+static void metaCopyAll (void * data)
+{
+	MetaData * meta = data;
+	for (cursor_t it = 0; it < ksGetSize (meta->ks); ++it)
+	{
+		keyCopyAllMeta (ksAtCursor (meta->ks, it), meta->specKey);
+	}
+}
+
+static void metaSetAndShare (void * data)
+{
+	MetaData * meta = data;
+	metaSet (meta);
+	if (ksShareMeta (meta->ks) == -1) printExit ("ksShareMeta failed");
+}
+
+static void metaSpecSetup (void * data)
+{
+	MetaData * meta = data;
+	metaCreateKeys (meta);
+	ksAppendKey (meta->ks, keyDup (meta->specKey));
+}
+
+static void metaSpecGet (void * data)
+{
+	MetaData * meta = data;
+	if (meta->spec->kdbGet (meta->spec, meta->ks, meta->parentKey) == -1) printExit ("spec kdbGet failed");
+}
+
+static void metaDupSetup (void * data)
+{
+	MetaData * meta = data;
+	metaSpecSetup (meta);
+	metaSpecGet (meta);
+}
+
+static void metaDup (void * data)
+{
+	MetaData * meta = data;
+	meta->dup = ksDeepDup (meta->ks);
+}
+
+static void metaDelete (void * data)
+{
+	MetaData * meta = data;
+	ksDel (meta->ks);
+	ksDel (meta->dup);
+	meta->ks = meta->dup = 0;
+}
+
+/**
+ * Prints the heap memory used by the keys after @p fill, as it is not a time.
+ */
+static void metaPrintHeap (MetaData * meta, const char * name, void (*setup) (void *), void (*fill) (void *))
+{
+	long before = metaHeapBytes ();
+	if (before < 0) return;
+	setup (meta);
+	fill (meta);
+	printf ("heap bytes of %zu keys with %s: %ld\n", meta->size, name, metaHeapBytes () - before);
+	metaDelete (meta);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 500000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_meta [--size=<number of keys>] [--warmup=<n>] [--repeat=<n>] [--json=<file>] "
+				 "[--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	MetaData meta = { 0 };
+	meta.size = benchmarkDataset.size;
+	meta.parentKey = keyNew (META_PARENT, KEY_END);
+	meta.specKey = metaSpecKey ();
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	meta.spec = elektraPluginOpen ("spec", modules, ksNew (0, KS_END), meta.parentKey);
+	if (!meta.spec) printExit ("could not open spec plugin");
+
+	char name[32];
+	snprintf (name, sizeof (name), "%zu", meta.size);
+	const BenchmarkCase benchmarks[] = {
+		{ "keySetMeta", name, metaCreateKeys, metaSet, metaDelete },
+		{ "keyCopyAllMeta", name, metaCreateKeys, metaCopyAll, metaDelete },
+		{ "ksShareMeta", name, metaCreateKeys, metaSetAndShare, metaDelete },
+		{ "spec/kdbGet", name, metaSpecSetup, metaSpecGet, metaDelete },
+		{ "ksDeepDup", name, metaDupSetup, metaDup, metaDelete },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &meta);
+	}
+
+	metaPrintHeap (&meta, "keySetMeta", metaCreateKeys, metaSet);
+	metaPrintHeap (&meta, "keyCopyAllMeta", metaCreateKeys, metaCopyAll);
+	metaPrintHeap (&meta, "ksShareMeta", metaCreateKeys, metaSetAndShare);
+	metaPrintHeap (&meta, "spec", metaSpecSetup, metaSpecGet);
+
+	int result = benchmarkReport ();
+
+	elektraPluginClose (meta.spec, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	keyDel (meta.specKey);
+	keyDel (meta.parentKey);
+
+	return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the reloads of the notification library
+ *
+ * A local publisher modifies the configuration file and reports a
+ * changed key for every modification, like a transport plugin does for
+ * remote changes. The storm of changes is handled with immediate reloads
+ * and with coalesced reloads.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <kdbio.h>
+#include <kdbnotification.h>
+#include <kdbnotificationinternal.h>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+
+#define BENCHMARK_PARENT "user/tests/benchmark/notification"
+#define BENCHMARK_KEYS 1000
+
+typedef struct
+{
+	Key * parentKey;
+	KDB * kdb;
+	ElektraIoInterface * binding;
+	ElektraIoTimerOperation * timer;
+	ElektraNotificationCallback publish;
+	ElektraNotificationCallbackContext * context;
+	unsigned int window;
+	size_t events;
+	size_t callbacks;
+	long long modification;
+} NotificationData;
+
+/* I/O binding, which only remembers the timer of the coalesced reload */
+
+static int addFd (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int updateFd (ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int addTimer (ElektraIoInterface * binding, ElektraIoTimerOperation * timerOp)
+{
+	NotificationData * notification = elektraIoBindingGetData (binding);
+	notification->timer = timerOp;
+	return 1;
+}
+
+static int updateTimer (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int removeTimer (ElektraIoTimerOperation * timerOp)
+{
+	NotificationData * notification = elektraIoBindingGetData (elektraIoTimerGetBinding (timerOp));
+	notification->timer = NULL;
+	return 1;
+}
+
+static int addIdle (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int updateIdle (ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int cleanup (ElektraIoInterface * binding)
+{
+	elektraFree (binding);
+	return 1;
+}
+
+static void changedCallback (Key * key ELEKTRA_UNUSED, void * context)
+{
+	NotificationData * notification = context;
+	++notification->callbacks;
+}
+
+static void createConfiguration (Key * parentKey)
+{
+	KDB * kdb = kdbOpen (parentKey);
+	if (!kdb) printExit ("kdbOpen failed");
+	KeySet * ks = ksNew (0, KS_END);
+	if (kdbGet (kdb, ks, parentKey) == -1) printExit ("kdbGet failed");
+
+	char name[64];
+	for (size_t i = 0; i < BENCHMARK_KEYS; ++i)
+	{
+		snprintf (name, sizeof (name), BENCHMARK_PARENT "/key%zu", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "value", KEY_END));
+	}
+	if (kdbSet (kdb, ks, parentKey) == -1) printExit ("kdbSet failed");
+	ksDel (ks);
+	kdbClose (kdb, parentKey);
+}
+
+static void removeConfiguration (Key * parentKey)
+{
+	KDB * kdb = kdbOpen (parentKey);
+	if (!kdb) printExit ("kdbOpen failed");
+	KeySet * ks = ksNew (0, KS_END);
+	if (kdbGet (kdb, ks, parentKey) == -1) printExit ("kdbGet failed");
+	ksDel (ksCut (ks, parentKey));
+	if (kdbSet (kdb, ks, parentKey) == -1) printExit ("kdbSet failed");
+	ksDel (ks);
+	kdbClose (kdb, parentKey);
+}
+
+static void notificationOpen (void * data)
+{
+	NotificationData * notification = data;
+	notification->kdb = kdbOpen (notification->parentKey);
+	if (!notification->kdb) printExit ("kdbOpen failed");
+
+	notification->binding = elektraIoNewBinding (addFd, updateFd, updateFd, addTimer, updateTimer, removeTimer, addIdle, updateIdle,
+						     updateIdle, cleanup);
+	elektraIoBindingSetData (notification->binding, notification);
+	elektraIoSetBinding (notification->kdb, notification->binding);
+
+	if (!elektraNotificationOpen (notification->kdb)) printExit ("elektraNotificationOpen failed");
+	if (!elektraNotificationSetReloadWindow (notification->kdb, notification->window))
+	{
+		printExit ("elektraNotificationSetReloadWindow failed");
+	}
+	if (!elektraNotificationRegisterCallbackSameOrBelow (notification->kdb, notification->parentKey, changedCallback, notification))
+	{
+		printExit ("elektraNotificationRegisterCallbackSameOrBelow failed");
+	}
+
+	// the publisher reports changes to the notification plugin, like transport plugins do
+	Plugin * plugin = elektraPluginFindGlobal (notification->kdb, "internalnotification");
+	notification->publish = (ElektraNotificationCallback) elektraPluginGetFunction (plugin, "notificationCallback");
+	Key * contextKey = ksLookupByName (plugin->config, "user/context", 0);
+	notification->context = *(ElektraNotificationCallbackContext **) keyValue (contextKey);
+
+	KeySet * ks = ksNew (0, KS_END);
+	if (kdbGet (notification->kdb, ks, notification->parentKey) == -1) printExit ("kdbGet failed");
+	ksDel (ks);
+	notification->callbacks = 0;
+}
+
+static void notificationClose (void * data)
+{
+	NotificationData * notification = data;
+	elektraNotificationClose (notification->kdb);
+	kdbClose (notification->kdb, notification->parentKey);
+	elektraIoBindingCleanup (notification->binding);
+	notification->kdb = NULL;
+	notification->binding = NULL;
+}
+
+static void notificationStorm (void * data)
+{
+	NotificationData * notification = data;
+	const char * file = keyString (notification->parentKey);
+	char name[64];
+	for (size_t i = 0; i < notification->events; ++i)
+	{
+		// every event is caused by a new modification of the file
+		++notification->modification;
+		struct timespec times[2] = { { 0, UTIME_OMIT },
+					     { notification->modification / 1000000000, notification->modification % 1000000000 } };
+		if (utimensat (AT_FDCWD, file, times, 0) != 0) printExit ("utimensat failed");
+
+		snprintf (name, sizeof (name), BENCHMARK_PARENT "/key%zu", i % BENCHMARK_KEYS);
+		notification->publish (keyNew (name, KEY_END), notification->context);
+	}
+
+	// the window has passed
+	if (notification->timer && elektraIoTimerIsEnabled (notification->timer))
+	{
+		elektraIoTimerGetCallback (notification->timer) (notification->timer);
+	}
+}
+
+static void notificationStormImmediate (void * data)
+{
+	NotificationData * notification = data;
+	notification->window = 0;
+	notificationOpen (notification);
+}
+
+static void notificationStormCoalesced (void * data)
+{
+	NotificationData * notification = data;
+	notification->window = 100;
+	notificationOpen (notification);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 1000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_notification [--size=<number of changes>] [--warmup=<n>] [--repeat=<n>] [--json=<file>] "
+				 "[--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	NotificationData notification = { 0 };
+	notification.events = benchmarkDataset.size;
+	notification.parentKey = keyNew (BENCHMARK_PARENT, KEY_END);
+	createConfiguration (notification.parentKey);
+	notification.modification = time (NULL) * 1000000000LL;
+
+	const BenchmarkCase benchmarks[] = {
+		{ "notification", "storm/immediate", notificationStormImmediate, notificationStorm, notificationClose },
+		{ "notification", "storm/coalesced", notificationStormCoalesced, notificationStorm, notificationClose },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &notification);
+	}
+
+	removeConfiguration (notification.parentKey);
+	keyDel (notification.parentKey);
+
+	return benchmarkReport () == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
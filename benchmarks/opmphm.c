@@ -25,7 +25,7 @@
 #include <search.h>
 #endif
 
-#ifdef USE_OPENMP
+#ifdef _OPENMP
 #include <omp.h>
 #endif
 
@@ -1529,6 +1529,182 @@ static void benchmarkBinarySearchTime (char * name)
  * END =================================================== Binary search Time ========================================================== END
  */
 
+/**
+ * START ==================================================== OPMPHM Compare ========================================================= START
+ *
+ * This benchmark compares for large KeySets:
+ * * the hash time of opmphmHashfunctionJenkins (...) and opmphmHashfunctionMxs (...)
+ * * the OPMPHM build time with one thread and with all threads (needs ENABLE_OPMPHM_PARALLEL)
+ * * the OPMPHM search time and the binary search time
+ * The OPMPHM uses the hash function selected with ENABLE_OPMPHM_FAST_HASH, run this benchmark
+ * with both settings to compare the build and search time of both hash functions.
+ * Uses all KeySet shapes except 6, for one n (KeySet size) one KeySet is used and n searches are made.
+ * Each measurement is repeated numberOfRepeats time and summarized with the median.
+ * The results are written out in the following format:
+ *
+ * n;hash_jenkins;hash_mxs;build_1;build_t;search_opmphm;search_binary
+ *
+ * Where t is the number of threads.
+ *
+ * The number of needed seeds for this benchmarks is: (numberOfShapes - 1) * nCount * 3
+ */
+
+/**
+ * @brief Measures the time to hash all Key names numberOfRepeats time and returns median
+ *
+ * @param ks the KeySet
+ * @param hashfunction the hash function
+ * @param repeats array to store repeated measurements
+ * @param numberOfRepeats fields in repeats
+ *
+ * @retval median time
+ */
+static size_t benchmarkCompareHashTimeMeasure (KeySet * ks, uint32_t (*hashfunction) (const void *, size_t, uint32_t), size_t * repeats,
+					       size_t numberOfRepeats)
+{
+	for (size_t repeatsI = 0; repeatsI < numberOfRepeats; ++repeatsI)
+	{
+		struct timeval start;
+		struct timeval end;
+		uint32_t sum = 0;
+
+		// START MEASUREMENT
+		__asm__("");
+		gettimeofday (&start, 0);
+		__asm__("");
+
+		for (size_t i = 0; i < ks->size; ++i)
+		{
+			const char * name = keyName (ks->array[i]);
+			sum += hashfunction (name, strlen (name), 1337);
+		}
+
+		__asm__("");
+		gettimeofday (&end, 0);
+		__asm__("");
+		// END MEASUREMENT
+
+		// use the hashes
+		if (sum == 1337) printf ("%c", 0);
+
+		repeats[repeatsI] = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_usec - start.tv_usec);
+	}
+	// sort repeats
+	qsort (repeats, numberOfRepeats, sizeof (size_t), cmpInteger);
+	return repeats[numberOfRepeats / 2]; // take median
+}
+
+static void benchmarkOPMPHMCompare (char * name)
+{
+	const size_t nCount = 4;
+	const size_t n[] = { 10000, 100000, 1000000, 2000000 };
+	const size_t numberOfRepeats = 5;
+	const size_t resultsPerN = 6;
+	int threads = 1;
+#ifdef _OPENMP
+	threads = omp_get_max_threads ();
+#endif
+
+	// init results
+	size_t * results = elektraMalloc (nCount * resultsPerN * sizeof (size_t));
+	if (!results)
+	{
+		printExit ("malloc");
+	}
+	// init repeats
+	size_t * repeats = elektraMalloc (numberOfRepeats * sizeof (size_t));
+	if (!repeats)
+	{
+		printExit ("malloc");
+	}
+
+	// get KeySet shapes
+	KeySetShape * keySetShapes = getKeySetShapes ();
+
+#ifdef ELEKTRA_OPMPHM_FAST_HASH
+	const char * hashfunction = "mxs";
+#else
+	const char * hashfunction = "jenkins";
+#endif
+	printf ("Run Benchmark %s with %d threads and the %s hash function:\n", name, threads, hashfunction);
+
+	// for all KeySet shapes except 6
+	for (size_t shapeI = 0; shapeI < numberOfShapes; ++shapeI)
+	{
+		if (shapeI == 6)
+		{
+			continue;
+		}
+		KeySetShape * usedKeySetShape = &keySetShapes[shapeI];
+
+		// for all Ns
+		for (size_t nI = 0; nI < nCount; ++nI)
+		{
+			printf ("now at: shape = %zu/%zu n = %zu\r", shapeI + 1, numberOfShapes, n[nI]);
+			fflush (stdout);
+
+			int32_t genSeed;
+			if (getRandomSeed (&genSeed) != &genSeed) printExit ("Seed Parsing Error or feed me more seeds");
+			KeySet * ks = generateKeySet (n[nI], &genSeed, usedKeySetShape);
+			int32_t buildSeed;
+			if (getRandomSeed (&buildSeed) != &buildSeed) printExit ("Seed Parsing Error or feed me more seeds");
+			int32_t searchSeed;
+			if (getRandomSeed (&searchSeed) != &searchSeed) printExit ("Seed Parsing Error or feed me more seeds");
+
+			size_t * result = &results[nI * resultsPerN];
+			result[0] = benchmarkCompareHashTimeMeasure (ks, opmphmHashfunctionJenkins, repeats, numberOfRepeats);
+			result[1] = benchmarkCompareHashTimeMeasure (ks, opmphmHashfunctionMxs, repeats, numberOfRepeats);
+			// binary search before the OPMPHM is build
+			result[5] = benchmarkSearchTimeMeasure (ks, n[nI], searchSeed, KDB_O_BINSEARCH | KDB_O_NOCASCADING, repeats,
+								numberOfRepeats);
+			// set seed to return by elektraRandGetInitSeed () in the lookup
+			elektraRandBenchmarkInitSeed = buildSeed;
+#ifdef _OPENMP
+			omp_set_num_threads (1);
+#endif
+			result[2] = benchmarkOPMPHMBuildTimeMeasure (ks, repeats, numberOfRepeats);
+#ifdef _OPENMP
+			omp_set_num_threads (threads);
+#endif
+			result[3] = benchmarkOPMPHMBuildTimeMeasure (ks, repeats, numberOfRepeats);
+			result[4] = benchmarkSearchTimeMeasure (ks, n[nI], searchSeed, KDB_O_OPMPHM | KDB_O_NOCASCADING, repeats,
+								numberOfRepeats);
+
+			ksDel (ks);
+		}
+
+		// write out
+		FILE * out = openOutFileWithRPartitePostfix ("benchmark_opmphm_compare", shapeI);
+		if (!out)
+		{
+			printExit ("open out file");
+		}
+		// print header
+		fprintf (out, "n;hash_jenkins;hash_mxs;build_1;build_%d;search_opmphm;search_binary\n", threads);
+		// print data
+		for (size_t nI = 0; nI < nCount; ++nI)
+		{
+			fprintf (out, "%zu", n[nI]);
+			for (size_t i = 0; i < resultsPerN; ++i)
+			{
+				fprintf (out, ";%zu", results[nI * resultsPerN + i]);
+			}
+			fprintf (out, "\n");
+		}
+
+		fclose (out);
+	}
+	printf ("\n");
+
+	elektraFree (repeats);
+	elektraFree (keySetShapes);
+	elektraFree (results);
+}
+
+/**
+ * END ====================================================== OPMPHM Compare =========================================================== END
+ */
+
 /**
  * START ================================================= hsearch Build Time ======================================================== START
  *
@@ -2102,7 +2278,7 @@ static void benchmarkPrintAllKeySetShapes (char * name)
 int main (int argc, char ** argv)
 {
 	// define all benchmarks
-	size_t benchmarksCount = 9;
+	size_t benchmarksCount = 10;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	++benchmarksCount;
@@ -2158,6 +2334,11 @@ int main (int argc, char ** argv)
 	benchmarks[8].name = benchmarkNamePredictionTime;
 	benchmarks[8].benchmarkF = benchmarkPredictionTime;
 	benchmarks[8].numberOfSeedsNeeded = 3496500;
+	// opmphmcompare
+	char * benchmarkNameOpmphmCompare = "opmphmcompare";
+	benchmarks[9].name = benchmarkNameOpmphmCompare;
+	benchmarks[9].benchmarkF = benchmarkOPMPHMCompare;
+	benchmarks[9].numberOfSeedsNeeded = 84;
 #ifdef HAVE_HSEARCHR
 	// hsearchbuildtime
 	char * benchmarkNameHsearchBuildTime = "hsearchbuildtime";
@@ -0,0 +1,139 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for reading subtrees of quickdump files
+ *
+ * Reads a subtree of 10 keys and the whole file for files of
+ * increasing size.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbhelper.h>
+
+#include <unistd.h>
+
+#define QUICKDUMP_PARENT "user/benchmark/quickdump"
+#define QUICKDUMP_SIZES 4
+#define QUICKDUMP_SUBTREE_SIZE 10
+
+typedef int (*getSubtreeFunc) (Plugin * handle, KeySet * returned, Key * parentKey, Key * subtreeKey);
+
+typedef struct
+{
+	Plugin * plugin;
+	getSubtreeFunc getSubtree;
+	Key * parentKey;
+	Key * subtreeKey;
+	size_t subtreeSize;
+} QuickdumpData;
+
+static void writeFile (QuickdumpData * quickdump, size_t size)
+{
+	KeySet * ks = ksNew (size, KS_END);
+	char name[64];
+	for (size_t i = 0; i < size; ++i)
+	{
+		snprintf (name, sizeof (name), QUICKDUMP_PARENT "/dir%07zu/key%zu", i / QUICKDUMP_SUBTREE_SIZE, i % QUICKDUMP_SUBTREE_SIZE);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "value", KEY_META, "type", "string", KEY_END));
+	}
+	if (quickdump->plugin->kdbSet (quickdump->plugin, ks, quickdump->parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		printExit ("Error writing with plugin: quickdump");
+	}
+	ksDel (ks);
+
+	// the subtree in the middle of the file
+	snprintf (name, sizeof (name), QUICKDUMP_PARENT "/dir%07zu", size / QUICKDUMP_SUBTREE_SIZE / 2);
+	keySetName (quickdump->subtreeKey, name);
+	quickdump->subtreeSize = size < QUICKDUMP_SUBTREE_SIZE ? size : QUICKDUMP_SUBTREE_SIZE;
+}
+
+static void quickdumpGetSubtree (void * data)
+{
+	QuickdumpData * quickdump = data;
+	KeySet * returned = ksNew (0, KS_END);
+	int ret = quickdump->getSubtree (quickdump->plugin, returned, quickdump->parentKey, quickdump->subtreeKey);
+	if (ret != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		printExit ("Error reading with plugin: quickdump");
+	}
+	if ((size_t) ksGetSize (returned) != quickdump->subtreeSize) printExit ("getsubtree: wrong number of keys");
+	ksDel (returned);
+}
+
+static void quickdumpGet (void * data)
+{
+	QuickdumpData * quickdump = data;
+	KeySet * returned = ksNew (0, KS_END);
+	if (quickdump->plugin->kdbGet (quickdump->plugin, returned, quickdump->parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+	{
+		printExit ("Error reading with plugin: quickdump");
+	}
+	ksDel (returned);
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 1000000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_quickdump [--size=<number of keys of the largest file>] [--warmup=<n>] [--repeat=<n>] "
+				 "[--json=<file>] [--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	char file[] = "/tmp/elektra-benchmark-quickdump.XXXXXX";
+	int fd = mkstemp (file);
+	if (fd == -1) printExit ("mkstemp");
+	close (fd);
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("", KEY_END);
+	QuickdumpData quickdump = { 0 };
+	quickdump.plugin = elektraPluginOpen ("quickdump", modules, ksNew (0, KS_END), errorKey);
+	keyDel (errorKey);
+	if (!quickdump.plugin) printExit ("Could not open plugin: quickdump");
+	quickdump.getSubtree = (getSubtreeFunc) elektraPluginGetFunction (quickdump.plugin, "getsubtree");
+	if (!quickdump.getSubtree) printExit ("Could not find function: getsubtree");
+	quickdump.parentKey = keyNew (QUICKDUMP_PARENT, KEY_VALUE, file, KEY_END);
+	quickdump.subtreeKey = keyNew (QUICKDUMP_PARENT, KEY_END);
+
+	// file sizes increase by factors of 10 up to --size
+	char subtreeName[32];
+	char getName[32];
+	size_t size = benchmarkDataset.size;
+	for (int i = 1; i < QUICKDUMP_SIZES && size >= 10; ++i)
+	{
+		size /= 10;
+	}
+	for (int i = 0; i < QUICKDUMP_SIZES; ++i, size *= 10)
+	{
+		writeFile (&quickdump, size);
+
+		snprintf (subtreeName, sizeof (subtreeName), "getsubtree/%zu", size);
+		snprintf (getName, sizeof (getName), "get/%zu", size);
+		const BenchmarkCase benchmarks[] = {
+			{ "quickdump", subtreeName, 0, quickdumpGetSubtree, 0 },
+			{ "quickdump", getName, 0, quickdumpGet, 0 },
+		};
+		for (size_t j = 0; j < sizeof (benchmarks) / sizeof (BenchmarkCase); ++j)
+		{
+			benchmarkRun (&benchmarks[j], &quickdump);
+		}
+	}
+
+	int result = benchmarkReport ();
+
+	keyDel (quickdump.subtreeKey);
+	keyDel (quickdump.parentKey);
+	elektraPluginClose (quickdump.plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	unlink (file);
+
+	return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
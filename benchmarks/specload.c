@@ -0,0 +1,128 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for loading specifications of many applications with specload
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbhelper.h>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#define SPECLOAD_PARENT "spec/benchmarks/specload"
+
+static Plugin ** openMounts (KeySet * modules, const char * app, const char * cacheDir, int mounts)
+{
+	Plugin ** plugins = elektraMalloc (mounts * sizeof (Plugin *));
+	for (int i = 0; i < mounts; ++i)
+	{
+		KeySet * conf = ksNew (2, keyNew ("system/app", KEY_VALUE, app, KEY_END), KS_END);
+		if (cacheDir != NULL)
+		{
+			ksAppendKey (conf, keyNew ("system/cache", KEY_VALUE, cacheDir, KEY_END));
+		}
+
+		Key * errorKey = keyNew ("", KEY_END);
+		plugins[i] = elektraPluginOpen ("specload", modules, conf, errorKey);
+		keyDel (errorKey);
+		if (!plugins[i])
+		{
+			printExit ("Could not open plugin: specload");
+		}
+	}
+	return plugins;
+}
+
+static void closeMounts (Plugin ** plugins, int mounts)
+{
+	for (int i = 0; i < mounts; ++i)
+	{
+		elektraPluginClose (plugins[i], 0);
+	}
+	elektraFree (plugins);
+}
+
+static void removeDirectory (const char * directory)
+{
+	DIR * dir = opendir (directory);
+	if (dir == NULL) return;
+
+	struct dirent * entry;
+	while ((entry = readdir (dir)) != NULL)
+	{
+		char * file = elektraFormat ("%s/%s", directory, entry->d_name);
+		unlink (file);
+		elektraFree (file);
+	}
+	closedir (dir);
+	rmdir (directory);
+}
+
+static void getAll (const char * name, Plugin ** plugins, int mounts, const char * overlayDir)
+{
+	char parentName[KEY_NAME_LENGTH + 1];
+	char overlayFile[KEY_NAME_LENGTH + 1];
+
+	timeInit ();
+	for (int i = 0; i < mounts; ++i)
+	{
+		snprintf (parentName, KEY_NAME_LENGTH, "%s/app%d", SPECLOAD_PARENT, i);
+		snprintf (overlayFile, KEY_NAME_LENGTH, "%s/app%d.overlay", overlayDir, i);
+		Key * parentKey = keyNew (parentName, KEY_VALUE, overlayFile, KEY_END);
+		KeySet * returned = ksNew (0, KS_END);
+		if (plugins[i]->kdbGet (plugins[i], returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
+		{
+			printExit ("Error reading with plugin: specload");
+		}
+		ksDel (returned);
+		keyDel (parentKey);
+	}
+	fprintf (stdout, "%s;%d;%d\n", name, mounts, timeGetDiffMicroseconds ());
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc < 2)
+	{
+		printExit ("usage: benchmark_specload <app> [mounts]");
+	}
+	const char * app = argv[1];
+	int mounts = argc > 2 ? atoi (argv[2]) : 40;
+
+	char tmpDir[] = "/tmp/elektra-benchmark-specload.XXXXXX";
+	if (mkdtemp (tmpDir) == NULL)
+	{
+		printExit ("mkdtemp");
+	}
+	char * cacheDir = elektraFormat ("%s/cache", tmpDir);
+	mkdir (cacheDir, 0700);
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+
+	fprintf (stdout, "%s;%s;%s\n", "cache", "mounts", "microseconds");
+
+	Plugin ** plugins = openMounts (modules, app, NULL, mounts);
+	getAll ("none (cold)", plugins, mounts, tmpDir);
+	getAll ("in-memory (warm)", plugins, mounts, tmpDir);
+	closeMounts (plugins, mounts);
+
+	plugins = openMounts (modules, app, cacheDir, mounts);
+	getAll ("persistent (cold)", plugins, mounts, tmpDir);
+	closeMounts (plugins, mounts);
+
+	plugins = openMounts (modules, app, cacheDir, mounts);
+	getAll ("persistent (warm)", plugins, mounts, tmpDir);
+	closeMounts (plugins, mounts);
+
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+
+	removeDirectory (cacheDir);
+	removeDirectory (tmpDir);
+	elektraFree (cacheDir);
+}
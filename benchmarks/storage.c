@@ -12,6 +12,11 @@
 #include <benchmarks.h>
 #include <tests.h>
 
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#include <malloc.h>
+#define HAVE_MALLINFO2
+#endif
+
 #define CSV_STR_FMT "%s;%s;%d\n"
 
 #define NUM_PLUGINS 4
@@ -55,6 +60,18 @@ static int benchmarkOpenPlugins (void)
 	return 0;
 }
 
+/**
+ * @return the bytes currently allocated on the heap, or -1 if unknown
+ */
+static long benchmarkHeapBytes (void)
+{
+#ifdef HAVE_MALLINFO2
+	return (long) mallinfo2 ().uordblks;
+#else
+	return -1;
+#endif
+}
+
 static void benchmarkIterate (KeySet * ks)
 {
 	ksRewind (ks);
@@ -104,7 +121,7 @@ int main (int argc, char ** argv)
 		init (argc, argv);
 
 		Plugin * plugin = plugins[i];
-		Key * parentKey = keyNew ("user/benchmarks/storage", KEY_VALUE, tmpfilename, KEY_END);
+		Key * parentKey = keyNew (KEY_ROOT, KEY_VALUE, tmpfilename, KEY_END);
 
 		for (size_t run = 0; run < NUM_RUNS; ++run)
 		{
@@ -116,6 +133,8 @@ int main (int argc, char ** argv)
 			}
 			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "write keyset", timeGetDiffMicroseconds ());
 
+			long heapBytes = benchmarkHeapBytes ();
+			timeInit ();
 			KeySet * returned = ksNew (0, KS_END);
 			if (plugin->kdbGet (plugin, returned, parentKey) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 			{
@@ -123,6 +142,12 @@ int main (int argc, char ** argv)
 				return -1;
 			}
 			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "read keyset", timeGetDiffMicroseconds ());
+			if (heapBytes >= 0)
+			{
+				// not a time, the heap memory used by the returned keyset
+				fprintf (stdout, "%s;%s;%ld\n", pluginNames[i], "heap bytes of keyset", benchmarkHeapBytes () - heapBytes);
+				timeInit ();
+			}
 			benchmarkIterate (returned);
 			fprintf (stdout, CSV_STR_FMT, pluginNames[i], "iterate keyset", timeGetDiffMicroseconds ());
 			ksDel (returned);
@@ -0,0 +1,187 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for kdbGet of subtrees of large mountpoints
+ *
+ * Mounts a file for every storage plugin that can read subtrees
+ * and reads 10 keys and the whole mountpoint with kdbGet.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#include <kdbhelper.h>
+
+#include <unistd.h>
+
+#define SUBTREE_MOUNTPOINTS "system/elektra/mountpoints"
+#define SUBTREE_PARENT "system/benchmark/subtree/"
+#define SUBTREE_SIZE 10
+
+static const char * const subtreePlugins[] = { "mmapstorage", "quickdump" };
+
+typedef struct
+{
+	KDB * handle;
+	KeySet * result;
+	Key * parentKey;
+	Key * subtreeKey;
+	size_t size;
+} SubtreeData;
+
+static void mountAddKey (KeySet * mountpoints, Key * mountpoint, const char * name, const char * value)
+{
+	Key * key = keyDup (mountpoint);
+	keyAddName (key, name);
+	keySetString (key, value);
+	ksAppendKey (mountpoints, key);
+}
+
+/**
+ * Mounts @p file with resolver and @p plugin at system/benchmark/subtree/<plugin>,
+ * or removes the mountpoint if @p file is 0.
+ */
+static void mountSubtree (const char * plugin, const char * file)
+{
+	Key * parentKey = keyNew (SUBTREE_MOUNTPOINTS, KEY_END);
+	KDB * handle = kdbOpen (parentKey);
+	if (!handle) printExit ("kdbOpen failed");
+	KeySet * mountpoints = ksNew (0, KS_END);
+	if (kdbGet (handle, mountpoints, parentKey) == -1) printExit ("kdbGet of mountpoints failed");
+
+	char name[64];
+	snprintf (name, sizeof (name), SUBTREE_PARENT "%s", plugin);
+	Key * mountpoint = keyDup (parentKey);
+	keyAddBaseName (mountpoint, name);
+	ksDel (ksCut (mountpoints, mountpoint));
+	if (file)
+	{
+		mountAddKey (mountpoints, mountpoint, "", "");
+		mountAddKey (mountpoints, mountpoint, "config", "");
+		mountAddKey (mountpoints, mountpoint, "config/path", file);
+		mountAddKey (mountpoints, mountpoint, "mountpoint", name);
+		// the plugins are opened in the order of the keys, references follow their definition
+		mountAddKey (mountpoints, mountpoint, "errorplugins", "");
+		mountAddKey (mountpoints, mountpoint, "errorplugins/#5#" KDB_RESOLVER "#resolver#", "");
+		mountAddKey (mountpoints, mountpoint, "getplugins", "");
+		mountAddKey (mountpoints, mountpoint, "getplugins/#0#resolver", "");
+		snprintf (name, sizeof (name), "getplugins/#5#%s#storage#", plugin);
+		mountAddKey (mountpoints, mountpoint, name, "");
+		mountAddKey (mountpoints, mountpoint, "setplugins", "");
+		mountAddKey (mountpoints, mountpoint, "setplugins/#0#resolver", "");
+		mountAddKey (mountpoints, mountpoint, "setplugins/#5#storage", "");
+		mountAddKey (mountpoints, mountpoint, "setplugins/#7#resolver", "");
+	}
+	keyDel (mountpoint);
+
+	if (kdbSet (handle, mountpoints, parentKey) == -1) printExit ("kdbSet of mountpoints failed");
+	ksDel (mountpoints);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+static void writeKeys (SubtreeData * subtree)
+{
+	KDB * handle = kdbOpen (subtree->parentKey);
+	if (!handle) printExit ("kdbOpen failed");
+	KeySet * ks = ksNew (subtree->size, KS_END);
+	if (kdbGet (handle, ks, subtree->parentKey) == -1) printExit ("kdbGet failed");
+
+	char name[128];
+	for (size_t i = 0; i < subtree->size; ++i)
+	{
+		snprintf (name, sizeof (name), "%s/dir%07zu/key%zu", keyName (subtree->parentKey), i / SUBTREE_SIZE, i % SUBTREE_SIZE);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "value", KEY_META, "type", "string", KEY_END));
+	}
+	if (kdbSet (handle, ks, subtree->parentKey) == -1) printExit ("kdbSet failed");
+	ksDel (ks);
+	kdbClose (handle, subtree->parentKey);
+
+	// the subtree in the middle of the file
+	snprintf (name, sizeof (name), "%s/dir%07zu", keyName (subtree->parentKey), subtree->size / SUBTREE_SIZE / 2);
+	keySetName (subtree->subtreeKey, name);
+}
+
+static void subtreeOpen (void * data)
+{
+	SubtreeData * subtree = data;
+	subtree->handle = kdbOpen (subtree->parentKey);
+	if (!subtree->handle) printExit ("kdbOpen failed");
+	subtree->result = ksNew (0, KS_END);
+}
+
+static void subtreeGetSubtree (void * data)
+{
+	SubtreeData * subtree = data;
+	if (kdbGet (subtree->handle, subtree->result, subtree->subtreeKey) == -1) printExit ("kdbGet failed");
+	if (ksGetSize (subtree->result) != SUBTREE_SIZE) printExit ("kdbGet: wrong number of keys");
+}
+
+static void subtreeGet (void * data)
+{
+	SubtreeData * subtree = data;
+	if (kdbGet (subtree->handle, subtree->result, subtree->parentKey) == -1) printExit ("kdbGet failed");
+}
+
+static void subtreeClose (void * data)
+{
+	SubtreeData * subtree = data;
+	ksDel (subtree->result);
+	subtree->result = 0;
+	kdbClose (subtree->handle, subtree->parentKey);
+	subtree->handle = 0;
+}
+
+int main (int argc, char ** argv)
+{
+	benchmarkDataset.size = 1000000;
+	if (benchmarkParseOptions (&argc, argv) == -1 || argc > 1)
+	{
+		fprintf (stderr, "Usage: benchmark_subtree [--size=<number of keys>] [--warmup=<n>] [--repeat=<n>] "
+				 "[--json=<file>] [--filter=<text>]\n");
+		return EXIT_FAILURE;
+	}
+
+	char directory[] = "/tmp/elektra-benchmark-subtree.XXXXXX";
+	if (!mkdtemp (directory)) printExit ("mkdtemp");
+
+	SubtreeData subtree = { 0 };
+	subtree.size = benchmarkDataset.size;
+	subtree.subtreeKey = keyNew (SUBTREE_PARENT, KEY_END);
+
+	char file[128];
+	char subtreeName[32];
+	char getName[32];
+	for (size_t i = 0; i < sizeof (subtreePlugins) / sizeof (subtreePlugins[0]); ++i)
+	{
+		const char * plugin = subtreePlugins[i];
+		snprintf (file, sizeof (file), "%s/%s", directory, plugin);
+		mountSubtree (plugin, file);
+		subtree.parentKey = keyNew (SUBTREE_PARENT, KEY_END);
+		keyAddBaseName (subtree.parentKey, plugin);
+		writeKeys (&subtree);
+
+		snprintf (subtreeName, sizeof (subtreeName), "kdbGet/%d", SUBTREE_SIZE);
+		snprintf (getName, sizeof (getName), "kdbGet/%zu", subtree.size);
+		const BenchmarkCase benchmarks[] = {
+			{ plugin, subtreeName, subtreeOpen, subtreeGetSubtree, subtreeClose },
+			{ plugin, getName, subtreeOpen, subtreeGet, subtreeClose },
+		};
+		for (size_t j = 0; j < sizeof (benchmarks) / sizeof (BenchmarkCase); ++j)
+		{
+			benchmarkRun (&benchmarks[j], &subtree);
+		}
+
+		keyDel (subtree.parentKey);
+		mountSubtree (plugin, 0);
+		unlink (file);
+	}
+
+	int result = benchmarkReport ();
+
+	keyDel (subtree.subtreeKey);
+	rmdir (directory);
+
+	return result == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
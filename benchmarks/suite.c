@@ -0,0 +1,342 @@
+/**
+ * @file
+ *
+ * @brief Benchmark suite with machine readable results
+ *
+ * Runs the KeySet, storage plugin and KDB benchmarks with the harness of
+ * benchmarks.c and compares result files of different runs.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+#include <tests.h>
+
+#define DEFAULT_THRESHOLD 10.0
+
+extern char * tmpfilename;
+
+static const char * storagePlugins[] = { "dump",   "quickdump", "mmapstorage", "mmapstorage_crc", "ni",	"ini",	  "dini",
+					 "mini",   "simpleini", "tcl",	       "xmltool",	  "xerces", "yajl",	  "yamlcpp",
+					 "yambi",  "yanlr",	"yawn",	       "yaypeg",	  "toml",   0 };
+
+typedef struct
+{
+	KeySet * dataset;
+	KeySet * result;
+	Key ** keys;
+	size_t size;
+	Plugin * plugin;
+	Key * parentKey;
+	KDB * handle;
+} SuiteData;
+
+static void suiteDelResult (void * data)
+{
+	SuiteData * suite = data;
+	ksDel (suite->result);
+	suite->result = 0;
+}
+
+/* KeySet */
+
+static void suiteGenerate (void * data)
+{
+	SuiteData * suite = data;
+	suite->result = benchmarkGenerateDataset (&benchmarkDataset);
+}
+
+static void suiteDup (void * data)
+{
+	SuiteData * suite = data;
+	suite->result = ksDup (suite->dataset);
+}
+
+static void suiteDeepDup (void * data)
+{
+	SuiteData * suite = data;
+	suite->result = ksDeepDup (suite->dataset);
+}
+
+static void suiteLookup (void * data)
+{
+	SuiteData * suite = data;
+	for (size_t i = 0; i < suite->size; ++i)
+	{
+		if (ksLookup (suite->dataset, suite->keys[i], 0) != suite->keys[i]) printExit ("ksLookup: key not found");
+	}
+}
+
+static void suiteLookupByName (void * data)
+{
+	SuiteData * suite = data;
+	for (size_t i = 0; i < suite->size; ++i)
+	{
+		if (!ksLookupByName (suite->dataset, keyName (suite->keys[i]), 0)) printExit ("ksLookupByName: key not found");
+	}
+}
+
+static void suiteIterate (void * data)
+{
+	SuiteData * suite = data;
+	size_t bytes = 0;
+	Key * cur;
+	ksRewind (suite->dataset);
+	while ((cur = ksNext (suite->dataset)))
+	{
+		bytes += keyGetValueSize (cur);
+	}
+	if (bytes == 0 && benchmarkDataset.valueSize > 0 && suite->size > 0) printExit ("iterate: no values");
+}
+
+static void suiteCutAppend (void * data)
+{
+	SuiteData * suite = data;
+	Key * dir = keyDup (suite->keys[suite->size / 2]);
+	keySetBaseName (dir, 0);
+	KeySet * cut = ksCut (suite->dataset, dir);
+	ksAppend (suite->dataset, cut);
+	ksDel (cut);
+	keyDel (dir);
+}
+
+static void suiteSetup (SuiteData * suite)
+{
+	suite->dataset = benchmarkGenerateDataset (&benchmarkDataset);
+	suite->size = ksGetSize (suite->dataset);
+	suite->keys = elektraMalloc ((suite->size + 1) * sizeof (Key *));
+	if (!suite->keys) printExit ("suiteSetup: malloc keys");
+	elektraKsToMemArray (suite->dataset, suite->keys);
+}
+
+static void suiteTeardown (SuiteData * suite)
+{
+	elektraFree (suite->keys);
+	ksDel (suite->dataset);
+	memset (suite, 0, sizeof (SuiteData));
+}
+
+static void benchmarkKeySet (void)
+{
+	SuiteData suite = { 0 };
+	suiteSetup (&suite);
+
+	const BenchmarkCase benchmarks[] = {
+		{ "keyset", "generate", 0, suiteGenerate, suiteDelResult },
+		{ "keyset", "ksDup", 0, suiteDup, suiteDelResult },
+		{ "keyset", "ksDeepDup", 0, suiteDeepDup, suiteDelResult },
+		{ "keyset", "ksLookup", 0, suiteLookup, 0 },
+		{ "keyset", "ksLookupByName", 0, suiteLookupByName, 0 },
+		{ "keyset", "iterate", 0, suiteIterate, 0 },
+		{ "keyset", "ksCut+ksAppend", 0, suiteCutAppend, 0 },
+	};
+
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &suite);
+	}
+
+	suiteTeardown (&suite);
+}
+
+/* storage plugins */
+
+static void suiteStorageWrite (void * data)
+{
+	SuiteData * suite = data;
+	if (suite->plugin->kdbSet (suite->plugin, suite->dataset, suite->parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		printExit ("kdbSet of storage plugin failed");
+	}
+}
+
+static void suiteStorageRead (void * data)
+{
+	SuiteData * suite = data;
+	suite->result = ksNew (0, KS_END);
+	if (suite->plugin->kdbGet (suite->plugin, suite->result, suite->parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		printExit ("kdbGet of storage plugin failed");
+	}
+}
+
+static void benchmarkStorage (const char * pluginName)
+{
+	char group[BUF_SIZ];
+	char id[2 * BUF_SIZ];
+	snprintf (group, BUF_SIZ, "storage/%s", pluginName);
+	if (benchmarkOptions.filter)
+	{
+		// avoid opening plugins, where neither write nor read would be run
+		snprintf (id, sizeof (id), "%s/write", group);
+		int write = strstr (id, benchmarkOptions.filter) != 0;
+		snprintf (id, sizeof (id), "%s/read", group);
+		if (!write && !strstr (id, benchmarkOptions.filter)) return;
+	}
+
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("", KEY_END);
+	Plugin * plugin = elektraPluginOpen (pluginName, modules, ksNew (0, KS_END), errorKey);
+	if (!plugin)
+	{
+		fprintf (stderr, "%-50s skipped, plugin not available\n", group);
+		keyDel (errorKey);
+		elektraModulesClose (modules, 0);
+		ksDel (modules);
+		return;
+	}
+
+	SuiteData suite = { 0 };
+	suiteSetup (&suite);
+	suite.plugin = plugin;
+	suite.parentKey = keyNew (KEY_ROOT, KEY_VALUE, tmpfilename, KEY_END);
+
+	// check that the plugin can store the dataset at all, before measuring it
+	KeySet * check = ksNew (0, KS_END);
+	if (plugin->kdbSet (plugin, suite.dataset, suite.parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR ||
+	    plugin->kdbGet (plugin, check, suite.parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR)
+	{
+		fprintf (stderr, "%-50s skipped, plugin can not store the dataset\n", group);
+	}
+	else
+	{
+		const BenchmarkCase benchmarks[] = {
+			{ group, "write", 0, suiteStorageWrite, 0 },
+			{ group, "read", 0, suiteStorageRead, suiteDelResult },
+		};
+		for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+		{
+			benchmarkRun (&benchmarks[i], &suite);
+		}
+	}
+	ksDel (check);
+
+	keyDel (suite.parentKey);
+	suiteTeardown (&suite);
+	elektraPluginClose (plugin, errorKey);
+	keyDel (errorKey);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+	unlink (tmpfilename);
+}
+
+/* KDB */
+
+static void suiteOpenClose (void * data)
+{
+	SuiteData * suite = data;
+	KDB * handle = kdbOpen (suite->parentKey);
+	if (!handle) printExit ("kdbOpen failed");
+	kdbClose (handle, suite->parentKey);
+}
+
+static void suiteKdbGet (void * data)
+{
+	SuiteData * suite = data;
+	suite->result = ksNew (0, KS_END);
+	if (kdbGet (suite->handle, suite->result, suite->parentKey) == -1) printExit ("kdbGet failed");
+}
+
+static void suiteKdbOpen (void * data)
+{
+	SuiteData * suite = data;
+	suite->handle = kdbOpen (suite->parentKey);
+	if (!suite->handle) printExit ("kdbOpen failed");
+}
+
+static void suiteKdbClose (void * data)
+{
+	SuiteData * suite = data;
+	suiteDelResult (suite);
+	kdbClose (suite->handle, suite->parentKey);
+	suite->handle = 0;
+}
+
+static void benchmarkKdb (void)
+{
+	SuiteData suite = { 0 };
+	suite.parentKey = keyNew (KEY_ROOT, KEY_END);
+
+	const BenchmarkCase benchmarks[] = {
+		{ "kdb", "kdbOpen+kdbClose", 0, suiteOpenClose, 0 },
+		{ "kdb", "kdbGet", suiteKdbOpen, suiteKdbGet, suiteKdbClose },
+	};
+	for (size_t i = 0; i < sizeof (benchmarks) / sizeof (BenchmarkCase); ++i)
+	{
+		benchmarkRun (&benchmarks[i], &suite);
+	}
+
+	keyDel (suite.parentKey);
+}
+
+static void usage (void)
+{
+	fprintf (stderr, "Usage: benchmark_suite [<options>] [keyset] [storage] [kdb]\n");
+	fprintf (stderr, "       benchmark_suite compare <baseline.json> <current.json> [<threshold in %%>]\n\n");
+	fprintf (stderr, "Options:\n");
+	fprintf (stderr, "  --warmup=<n>       untimed runs before measuring (default %zu)\n", benchmarkOptions.warmups);
+	fprintf (stderr, "  --repeat=<n>       timed runs (default %zu)\n", benchmarkOptions.repetitions);
+	fprintf (stderr, "  --json=<file>      write the results as JSON, - for stdout\n");
+	fprintf (stderr, "  --filter=<text>    only run benchmarks containing the text, e.g. storage/dump\n");
+	fprintf (stderr, "  --size=<n>         number of keys (default %zu)\n", benchmarkDataset.size);
+	fprintf (stderr, "  --depth=<n>        levels of the keys (default %zu)\n", benchmarkDataset.depth);
+	fprintf (stderr, "  --value=<n>        mean size of values (default %zu)\n", benchmarkDataset.valueSize);
+	fprintf (stderr, "  --meta=<n>         meta keys of keys with meta data (default %zu)\n", benchmarkDataset.metaKeys);
+	fprintf (stderr, "  --meta-ratio=<n>   1/n of the keys have meta data, 0 for none (default %u)\n", benchmarkDataset.metaRatio);
+	fprintf (stderr, "  --seed=<n>         seed of the dataset (default %" PRId32 ")\n", benchmarkDataset.seed);
+}
+
+static int suiteSelected (int argc, char ** argv, const char * suite)
+{
+	if (argc == 1) return 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		if (!strcmp (argv[i], suite)) return 1;
+	}
+	return 0;
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc >= 2 && !strcmp (argv[1], "compare"))
+	{
+		if (argc < 4 || argc > 5)
+		{
+			usage ();
+			return EXIT_FAILURE;
+		}
+		int regressions = benchmarkCompare (argv[2], argv[3], argc == 5 ? strtod (argv[4], 0) : DEFAULT_THRESHOLD);
+		return regressions == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	if (benchmarkParseOptions (&argc, argv) == -1)
+	{
+		usage ();
+		return EXIT_FAILURE;
+	}
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp (argv[i], "keyset") && strcmp (argv[i], "storage") && strcmp (argv[i], "kdb"))
+		{
+			fprintf (stderr, "unknown suite %s\n\n", argv[i]);
+			usage ();
+			return EXIT_FAILURE;
+		}
+	}
+
+	char * initArgv[] = { argv[0], 0 };
+	init (1, initArgv);
+
+	if (suiteSelected (argc, argv, "keyset")) benchmarkKeySet ();
+	if (suiteSelected (argc, argv, "storage"))
+	{
+		for (size_t i = 0; storagePlugins[i]; ++i)
+		{
+			benchmarkStorage (storagePlugins[i]);
+		}
+	}
+	if (suiteSelected (argc, argv, "kdb")) benchmarkKdb ();
+
+	return benchmarkReport () == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for validation plugins checking metadata of every key
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <benchmarks.h>
+
+#define VALIDATION_PARENT "user/benchmarks/validation"
+#define NUM_RUNS 5
+
+static KeySet * benchmarkValidationCreate (size_t size, const char * metaName, const char * metaValue, int allKeys)
+{
+	char name[KEY_NAME_LENGTH + 1];
+	KeySet * ks = ksNew (size * 2, KS_END);
+
+	for (size_t i = 0; i < size; i++)
+	{
+		snprintf (name, KEY_NAME_LENGTH, "%s/%zu/limit", VALIDATION_PARENT, i);
+		Key * limit = keyNew (name, KEY_VALUE, "100", KEY_END);
+		// the type plugin stops at the first key without a type
+		if (allKeys) keySetMeta (limit, metaName, metaValue);
+		ksAppendKey (ks, limit);
+		snprintf (name, KEY_NAME_LENGTH, "%s/%zu/value", VALIDATION_PARENT, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "42", KEY_META, metaName, metaValue, KEY_END));
+	}
+	return ks;
+}
+
+static void benchmarkValidation (const char * pluginName, size_t size, const char * metaName, const char * metaValue, int allKeys)
+{
+	KeySet * modules = ksNew (0, KS_END);
+	elektraModulesInit (modules, 0);
+	Key * errorKey = keyNew ("", KEY_END);
+	Plugin * plugin = elektraPluginOpen (pluginName, modules, ksNew (0, KS_END), errorKey);
+	keyDel (errorKey);
+	if (!plugin)
+	{
+		printf ("Could not open plugin: %s\n", pluginName);
+		exit (-1);
+	}
+
+	KeySet * ks = benchmarkValidationCreate (size, metaName, metaValue, allKeys);
+	Key * parentKey = keyNew (VALIDATION_PARENT, KEY_END);
+
+	for (size_t run = 0; run < NUM_RUNS; ++run)
+	{
+		ksRewind (ks);
+		timeInit ();
+		if (plugin->kdbSet (plugin, ks, parentKey) == -1)
+		{
+			printf ("Error validating with plugin: %s\n", pluginName);
+			exit (-1);
+		}
+		fprintf (stdout, "%s;%zu;%d\n", pluginName, size, timeGetDiffMicroseconds ());
+	}
+
+	keyDel (parentKey);
+	ksDel (ks);
+	elektraPluginClose (plugin, 0);
+	elektraModulesClose (modules, 0);
+	ksDel (modules);
+}
+
+int main (int argc, char ** argv)
+{
+	size_t size = argc > 1 ? (size_t) atol (argv[1]) : 50000;
+
+	fprintf (stdout, "%s;%s;%s\n", "plugin", "keys", "microseconds");
+	benchmarkValidation ("conditionals", size, "check/condition", "(../limit > '10') ? (./ < '100')", 0);
+	benchmarkValidation ("mathcheck", size, "check/math", "<= + ../limit '0'", 0);
+	benchmarkValidation ("type", size, "check/type", "long", 1);
+}
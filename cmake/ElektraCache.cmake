@@ -244,6 +244,8 @@ endif ()
 option (INSTALL_BUILD_TOOLS "Install build tools for cross-compilation" OFF)
 
 option (ENABLE_OPTIMIZATIONS "Turn on optimizations that trade memory for speed" ON)
+option (ENABLE_OPMPHM_FAST_HASH "Use the multiply-xorshift hash function in the OPMPHM, needs ENABLE_OPTIMIZATIONS" ON)
+option (ENABLE_OPMPHM_PARALLEL "Build the OPMPHM of large KeySets with OpenMP threads, needs ENABLE_OPTIMIZATIONS" OFF)
 
 #
 # Developer builds
@@ -179,6 +179,18 @@ endif (ENABLE_COVERAGE)
 set (CXX_EXTRA_FLAGS "${CXX_EXTRA_FLAGS} -Wno-missing-field-initializers")
 set (CXX_EXTRA_FLAGS "${CXX_EXTRA_FLAGS} -Woverloaded-virtual  -Wsign-promo")
 
+#
+# OpenMP flags for the parallel build of the OPMPHM, only used for the files including opmphm.c
+#
+if (ENABLE_OPTIMIZATIONS AND ENABLE_OPMPHM_PARALLEL)
+	find_package (OpenMP)
+	if (OPENMP_FOUND)
+		set (OPMPHM_PARALLEL_FLAGS "${OpenMP_C_FLAGS}")
+	else (OPENMP_FOUND)
+		message (WARNING "OpenMP not found, the OPMPHM will be built by one thread")
+	endif (OPENMP_FOUND)
+endif (ENABLE_OPTIMIZATIONS AND ENABLE_OPMPHM_PARALLEL)
+
 #
 # Merge all flags
 #
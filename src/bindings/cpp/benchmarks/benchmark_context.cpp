@@ -0,0 +1,144 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for layer activation with many contextual values
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbthread.hpp>
+#include <kdbtimer.hpp>
+
+long long iterations = 1000LL; // layer switches per benchmark
+// long long iterations = 10LL; // valgrind
+
+const int benchmarkIterations = 11; // is a good number to not need mean values for median
+
+const long long numberOfValues = 1000; // values depending on the switched layer
+const long long numberOfOtherValues = 1000; // values depending on other layers only
+
+const std::string filename = "check.txt";
+std::ofstream dump (filename);
+
+const char * s_value = "55";
+
+template <int N>
+class Layer : public kdb::Layer
+{
+public:
+	std::string id () const override
+	{
+		std::string ret ("layerX");
+		ret[5] = ('0' + N);
+		return ret;
+	}
+	std::string operator() () const override
+	{
+		std::string ret ("X");
+		ret[0] = '0' + N;
+		return ret;
+	}
+};
+
+template <typename ContextType>
+std::vector<std::shared_ptr<kdb::Value<uint32_t, kdb::ContextPolicyIs<ContextType>>>> createValues (kdb::KeySet & ks,
+													       ContextType & c)
+{
+	std::vector<std::shared_ptr<kdb::Value<uint32_t, kdb::ContextPolicyIs<ContextType>>>> values;
+	for (long long i = 0; i < numberOfValues + numberOfOtherValues; ++i)
+	{
+		std::ostringstream os;
+		if (i < numberOfValues)
+		{
+			os << "/%layer0%/%layer1 layer2%/value" << i;
+		}
+		else
+		{
+			os << "/%layer1%/%layer2%/other" << i;
+		}
+		values.push_back (std::make_shared<kdb::Value<uint32_t, kdb::ContextPolicyIs<ContextType>>> (
+			ks, c, kdb::Key (os.str (), KEY_CASCADING_NAME, KEY_META, "default", s_value, KEY_END)));
+	}
+	return values;
+}
+
+template <typename ContextType>
+__attribute__ ((noinline)) void benchmark_activation (ContextType & c, std::string const & name)
+{
+	kdb::KeySet ks;
+	auto values = createValues (ks, c);
+	c.template activate<Layer<1>> ();
+	uint32_t x = 0;
+
+	static Timer t (name);
+	t.start ();
+	for (long long i = 0; i < iterations; ++i)
+	{
+		// only the values with %layer0% are reevaluated
+		c.template activate<Layer<0>> ();
+		x ^= *values.front ();
+		c.template deactivate<Layer<0>> ();
+		x ^= *values.front ();
+	}
+	t.stop ();
+	std::cout << t;
+	dump << t.name << x << std::endl;
+}
+
+__attribute__ ((noinline)) void benchmark_evaluate_string (kdb::Context & c)
+{
+	c.activate<Layer<0>> ();
+	std::string const name = "/%layer0%/%layer1 layer2%/some/longer/name/of/a/value";
+	size_t x = 0;
+
+	static Timer t ("evaluate string");
+	t.start ();
+	for (long long i = 0; i < iterations * numberOfValues; ++i)
+	{
+		x += c.evaluate (name).size ();
+	}
+	t.stop ();
+	std::cout << t;
+	dump << t.name << x << std::endl;
+	c.deactivate<Layer<0>> ();
+}
+
+__attribute__ ((noinline)) void benchmark_evaluate_template (kdb::Context & c)
+{
+	c.activate<Layer<0>> ();
+	kdb::NameTemplate const name ("/%layer0%/%layer1 layer2%/some/longer/name/of/a/value");
+	size_t x = 0;
+
+	static Timer t ("evaluate template");
+	t.start ();
+	for (long long i = 0; i < iterations * numberOfValues; ++i)
+	{
+		x += c.evaluate (name).size ();
+	}
+	t.stop ();
+	std::cout << t;
+	dump << t.name << x << std::endl;
+	c.deactivate<Layer<0>> ();
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		iterations = atoll (argv[1]);
+	}
+
+	for (int i = 0; i < benchmarkIterations; ++i)
+	{
+		std::cout << i << std::endl;
+
+		kdb::Context c;
+		benchmark_evaluate_string (c);
+		benchmark_evaluate_template (c);
+		benchmark_activation (c, "activate context");
+
+		kdb::Coordinator coordinator;
+		kdb::ThreadContext tc (coordinator);
+		benchmark_activation (tc, "activate thread context");
+	}
+}
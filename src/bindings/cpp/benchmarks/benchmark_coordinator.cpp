@@ -0,0 +1,108 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the propagation of layer activations to many threads
+ *
+ * Reader threads sync their ThreadContext and read a contextual value
+ * in a loop, while one writer thread activates and deactivates a layer.
+ * Prints the syncs of all readers and the activations per second.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbthread.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+int maxThreads = 64;
+long long durationMs = 500;
+long long activationPauseUs = 100; // pause of the writer between two activations
+
+const char * s_value = "55";
+
+class ActivateLayer : public kdb::Layer
+{
+public:
+	std::string id () const override
+	{
+		return "activate";
+	}
+	std::string operator() () const override
+	{
+		return "active";
+	}
+};
+
+void reader (kdb::Coordinator & gc, kdb::KeySet & ks, std::atomic<bool> & stop, std::atomic<long long> & syncs)
+{
+	kdb::ThreadContext tc (gc);
+	kdb::ThreadInteger ti (ks, tc, kdb::Key ("/test/%activate%/value", KEY_CASCADING_NAME, KEY_META, "default", s_value, KEY_END));
+
+	long long count = 0;
+	kdb::ThreadInteger::type x = 0;
+	while (!stop.load (std::memory_order_relaxed))
+	{
+		tc.syncLayers ();
+		x ^= ti;
+		++count;
+	}
+	syncs += count + (x == 0xdeadbeef);
+}
+
+void benchmark_scaling (int threads)
+{
+	kdb::Coordinator gc;
+	kdb::KeySet ks;
+	std::atomic<bool> stop (false);
+	std::atomic<long long> syncs (0);
+
+	std::vector<std::thread> readers;
+	for (int i = 0; i < threads; ++i)
+	{
+		readers.push_back (std::thread (reader, std::ref (gc), std::ref (ks), std::ref (stop), std::ref (syncs)));
+	}
+
+	kdb::ThreadContext tc (gc);
+	long long activations = 0;
+	auto const start = std::chrono::steady_clock::now ();
+	auto const end = start + std::chrono::milliseconds (durationMs);
+	while (std::chrono::steady_clock::now () < end)
+	{
+		if (activations % 2 == 0)
+		{
+			tc.activate<ActivateLayer> ();
+		}
+		else
+		{
+			tc.deactivate<ActivateLayer> ();
+		}
+		++activations;
+		std::this_thread::sleep_for (std::chrono::microseconds (activationPauseUs));
+	}
+	stop = true;
+
+	for (auto & t : readers)
+	{
+		t.join ();
+	}
+	double const seconds = std::chrono::duration<double> (std::chrono::steady_clock::now () - start).count ();
+	std::cout << threads << "," << static_cast<long long> (syncs / seconds) << "," << static_cast<long long> (activations / seconds)
+		  << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc > 1) maxThreads = atoi (argv[1]);
+	if (argc > 2) durationMs = atoll (argv[2]);
+	if (argc > 3) activationPauseUs = atoll (argv[3]);
+
+	std::cout << "threads,syncs/s,activations/s" << std::endl;
+	for (int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		benchmark_scaling (threads);
+	}
+}
@@ -223,7 +223,18 @@ public:
 	 */
 	std::string evaluate (std::string const & key_name) const
 	{
-		return evaluate (key_name, [&](std::string const & current_id, std::string & ret, bool in_group) {
+		return evaluate (compile (key_name));
+	}
+
+	/**
+	 * Evaluate a precompiled specification (name) and return
+	 * a key name under current context
+	 *
+	 * @param key_name the precompiled name to be evaluated
+	 */
+	std::string evaluate (NameTemplate const & key_name) const
+	{
+		return key_name.evaluate ([&](std::string const & current_id, std::string & ret, bool in_group) {
 			auto f = m_active_layers.find (current_id);
 			bool left_group = true;
 			if (f != m_active_layers.end ())
@@ -266,70 +277,31 @@ public:
 	std::string evaluate (std::string const & key_name,
 			      std::function<bool(std::string const &, std::string &, bool in_group)> const & on_layer) const
 	{
-		size_t const & s = key_name.size ();
-		std::string ret;
-		std::string current_id;
-		bool capture_id = false; // we are currently within a % block (group or single layer)
-		bool left_group = false; // needed to omit layers that do not matter in a group anymore
-		bool is_in_group = false;
-
-		// heuristic how much too allocate
-		ret.reserve (s * 2);
-		current_id.reserve (32);
+		return compile (key_name).evaluate (on_layer);
+	}
 
-		for (std::string::size_type i = 0; i < s; ++i)
+	/**
+	 * @brief Precompile a specification (name)
+	 *
+	 * The templates are cached, so that evaluating the
+	 * same name as string again does not need to parse it.
+	 *
+	 * @param key_name the name with placeholders
+	 * @return the precompiled name, valid until the next call
+	 */
+	NameTemplate const & compile (std::string const & key_name) const
+	{
+		auto it = m_templates.find (key_name);
+		if (it != m_templates.end ())
 		{
-			if (key_name[i] == '%')
-			{
-				if (capture_id)
-				{
-					// finish capturing
-					if (!left_group)
-					{
-						on_layer (current_id, ret, is_in_group);
-					}
-					current_id.clear ();
-					capture_id = false;
-				}
-				else
-				{
-					// start capturing
-					capture_id = true;
-					left_group = false;
-					is_in_group = false;
-				}
-			}
-			else if (capture_id && key_name[i] == ' ' && !left_group)
-			{
-				// found group separator in active
-				// group
-				left_group = on_layer (current_id, ret, true);
-				if (!is_in_group && left_group)
-				{
-					ret += "%"; // empty groups
-				}
-				else
-				{
-					is_in_group = true;
-				}
-				current_id.clear ();
-			}
-			else // non % character
-			{
-				if (capture_id)
-				{
-					current_id += key_name[i];
-				}
-				else
-				{
-					ret += key_name[i];
-				}
-			}
+			return it->second;
 		}
 
-		assert (!capture_id && "number of % incorrect");
-
-		return ret;
+		if (m_templates.size () >= maxTemplates)
+		{
+			m_templates.clear ();
+		}
+		return m_templates.insert (std::make_pair (key_name, NameTemplate (key_name))).first->second;
 	}
 
 protected:
@@ -553,6 +525,9 @@ private:
 	}
 
 	std::unordered_map<std::string, std::shared_ptr<Layer>> m_active_layers;
+	// names evaluated as strings
+	mutable std::unordered_map<std::string, NameTemplate> m_templates;
+	static const size_t maxTemplates = 1024;
 	// the with stack holds all layers that were
 	// changed in the current .with().with()
 	// invocation chain
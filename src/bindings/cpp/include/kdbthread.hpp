@@ -14,8 +14,10 @@
 #include <kdb.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <functional>
+#include <limits>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
@@ -151,7 +153,7 @@ public:
 		return lock;
 	}
 
-	Coordinator ()
+	Coordinator () : m_epoch (0)
 	{
 		std::lock_guard<std::mutex> lock (m_mutex);
 		m_updates.insert (std::make_pair (nullptr, PerContext ()));
@@ -172,6 +174,23 @@ public:
 private:
 	friend class ThreadContext;
 
+	/**
+	 * @brief Changes whenever updates for the contexts were published
+	 *
+	 * Contexts remember the epoch of their last sync, so that
+	 * checking for new updates is a single atomic load.
+	 */
+	uint64_t epoch () const
+	{
+		return m_epoch.load (std::memory_order_acquire);
+	}
+
+	/// to be called with m_mutex locked, after the updates were published
+	void publish ()
+	{
+		m_epoch.fetch_add (1, std::memory_order_release);
+	}
+
 	void attach (ThreadSubject * c)
 	{
 		std::lock_guard<std::mutex> lock (m_mutex);
@@ -214,6 +233,7 @@ private:
 			{
 				i.second.toUpdate.append (Key (c.newKey, KEY_CASCADING_NAME, KEY_END));
 			}
+			publish ();
 		}
 	}
 
@@ -244,6 +264,7 @@ private:
 			if (cc == c.first) continue;
 			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (true, layer)));
 		}
+		publish ();
 	}
 
 	void runOnDeactivate (std::shared_ptr<Layer> layer)
@@ -267,6 +288,7 @@ private:
 			if (cc == c.first) continue;
 			c.second.toActivate.insert (std::make_pair (layer->id (), LayerAction (false, layer)));
 		}
+		publish ();
 	}
 
 	/**
@@ -288,6 +310,8 @@ private:
 	std::unordered_map<ThreadSubject *, PerContext> m_updates;
 	/// mutex protecting m_updates
 	std::mutex m_mutex;
+	/// incremented whenever m_updates got something new
+	std::atomic<uint64_t> m_epoch;
 	FunctionMap m_onActivate;
 	std::mutex m_mutexOnActivate;
 	FunctionMap m_onDeactivate;
@@ -299,7 +323,7 @@ class ThreadContext : public ThreadSubject, public Context
 public:
 	typedef std::reference_wrapper<ValueSubject> ValueRef;
 
-	explicit ThreadContext (Coordinator & gc) : m_gc (gc)
+	explicit ThreadContext (Coordinator & gc) : m_gc (gc), m_epoch (std::numeric_limits<uint64_t>::max ())
 	{
 		m_gc.attach (this);
 	}
@@ -378,6 +402,11 @@ public:
 
 	void syncLayers () override
 	{
+		// nothing was published since the last sync, no need to lock
+		uint64_t const epoch = m_gc.epoch ();
+		if (epoch == m_epoch) return;
+		m_epoch = epoch;
+
 		// now activate/deactive layers
 		Events e;
 		for (auto const & l : m_gc.fetchGlobalActivation (this))
@@ -444,6 +473,13 @@ public:
 
 private:
 	Coordinator & m_gc;
+	/**
+	 * @brief The epoch of the coordinator at the last sync
+	 *
+	 * Starts invalid, so that the first sync fetches
+	 * the history of the coordinator.
+	 */
+	uint64_t m_epoch;
 	/**
 	 * @brief A map of values this ThreadContext is responsible for.
 	 */
@@ -202,6 +202,137 @@ public:
 	std::string newKey; // new name after assignment
 };
 
+/**
+ * @brief A precompiled name with placeholders
+ *
+ * The name is tokenized once into literal parts and placeholders,
+ * so that a context only needs to look up the layers of the
+ * placeholders on evaluation.
+ *
+ * A placeholder is either a single layer (`%layer%`) or a group
+ * of layers separated by spaces (`%layer1 layer2%`).
+ */
+class NameTemplate
+{
+public:
+	typedef std::vector<std::string> Layers;
+
+	explicit NameTemplate (std::string name) : m_name (std::move (name)), m_parts (), m_hasLayers (false)
+	{
+		std::string literal;
+		Layers layers;
+		std::string current_id;
+		bool capture_id = false;
+
+		for (char c : m_name)
+		{
+			if (c == '%')
+			{
+				if (capture_id)
+				{
+					layers.push_back (current_id);
+					m_parts.push_back (Part{ std::move (literal), std::move (layers) });
+					literal.clear ();
+					layers.clear ();
+					current_id.clear ();
+					m_hasLayers = true;
+				}
+				capture_id = !capture_id;
+			}
+			else if (capture_id && c == ' ')
+			{
+				layers.push_back (current_id);
+				current_id.clear ();
+			}
+			else if (capture_id)
+			{
+				current_id += c;
+			}
+			else
+			{
+				literal += c;
+			}
+		}
+
+		assert (!capture_id && "number of % incorrect");
+
+		m_parts.push_back (Part{ std::move (literal), Layers () });
+	}
+
+	/**
+	 * @return the name with placeholders the template was created from
+	 */
+	std::string const & getName () const
+	{
+		return m_name;
+	}
+
+	/**
+	 * Allows contexts that only evaluate strings to be used with templates.
+	 */
+	operator std::string const & () const
+	{
+		return m_name;
+	}
+
+	/**
+	 * @brief Evaluate all placeholders
+	 *
+	 * @param on_layer is called for every layer of a placeholder with the
+	 *                 layer name, the result so far and if the layer is in a group.
+	 *                 It returns true if the rest of the group should be omitted.
+	 *
+	 * @return the evaluated string
+	 */
+	template <typename OnLayer>
+	std::string evaluate (OnLayer && on_layer) const
+	{
+		if (!m_hasLayers) return m_name;
+
+		std::string ret;
+		ret.reserve (m_name.size () * 2);
+
+		for (auto const & part : m_parts)
+		{
+			ret += part.literal;
+			if (part.layers.empty ()) continue;
+
+			bool left_group = false;
+			bool is_in_group = false;
+			for (size_t i = 0; i + 1 < part.layers.size () && !left_group; ++i)
+			{
+				left_group = on_layer (part.layers[i], ret, true);
+				if (!is_in_group && left_group)
+				{
+					ret += "%"; // empty groups
+				}
+				else
+				{
+					is_in_group = true;
+				}
+			}
+
+			if (!left_group)
+			{
+				on_layer (part.layers.back (), ret, is_in_group);
+			}
+		}
+
+		return ret;
+	}
+
+private:
+	struct Part
+	{
+		std::string literal; ///< the literal before the placeholder
+		Layers layers;       ///< the layers of the placeholder, empty for the last part
+	};
+
+	std::string m_name;
+	std::vector<Part> m_parts;
+	bool m_hasLayers;
+};
+
 // Default Policies for Value
 
 class NoContext
@@ -437,12 +568,13 @@ public:
 	// not to be constructed yourself
 	Value<T, PolicySetter1, PolicySetter2, PolicySetter3, PolicySetter4, PolicySetter5, PolicySetter6> (
 		KeySet & ks, typename Policies::ContextPolicy & context_, kdb::Key spec)
-	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec)
+	: m_cache (), m_hasChanged (false), m_ks (ks), m_context (context_), m_spec (spec), m_template (m_spec.getName ()), m_resolved (),
+	  m_resolvedGeneration (0)
 	{
 		assert (m_spec.getName ()[0] == '/' && "spec keys are not yet supported");
 		m_context.attachByName (m_spec.getName (), *this);
 		Command::Func fun = [this]() -> Command::Pair {
-			this->unsafeUpdateKeyUsingContext (m_context.evaluate (m_spec.getName ()));
+			this->unsafeUpdateKeyUsingContext (m_context.evaluate (m_template));
 			this->unsafeSyncCache (); // set m_cache
 			return std::make_pair ("", m_key.getName ());
 		};
@@ -649,10 +781,30 @@ public:
 private:
 	void unsafeUpdateKeyUsingContext (std::string const & evaluatedName) const
 	{
+		// keys were added, replaced or removed, the lookups might resolve differently now
+		if (ckdb::ksGetGeneration (m_ks.getKeySet ()) != m_resolvedGeneration)
+		{
+			m_resolved.clear ();
+		}
+
+		auto it = m_resolved.find (evaluatedName);
+		if (it != m_resolved.end ())
+		{
+			m_key = it->second;
+			return;
+		}
+
 		Key spec (m_spec.dup ());
 		spec.setName (evaluatedName);
 		m_key = Policies::GetPolicy::get (m_ks, spec);
 		assert (m_key);
+
+		if (m_resolved.size () >= maxResolved)
+		{
+			m_resolved.clear ();
+		}
+		m_resolved.insert (std::make_pair (evaluatedName, m_key));
+		m_resolvedGeneration = ckdb::ksGetGeneration (m_ks.getKeySet ());
 	}
 
 	void unsafeLookupKey () const
@@ -709,7 +861,7 @@ private:
 
 	virtual void updateContext (bool write) const override
 	{
-		std::string evaluatedName = m_context.evaluate (m_spec.getName ());
+		std::string evaluatedName = m_context.evaluate (m_template);
 #if DEBUG && VERBOSE
 		std::cout << "update context " << evaluatedName << " from " << m_spec.getName () << " with write " << write << std::endl;
 #endif
@@ -726,6 +878,10 @@ private:
 			{
 				this->unsafeSyncKeySet (); // flush out what currently is in cache
 			}
+			else
+			{
+				m_resolved.clear (); // the keyset was updated
+			}
 
 			this->unsafeUpdateKeyUsingContext (evaluatedName);
 			this->unsafeSyncCache (); // read what we have under new context
@@ -793,6 +949,22 @@ private:
 	 */
 	Key m_spec;
 
+	/**
+	 * @brief The name of the specification key, precompiled for evaluation
+	 */
+	NameTemplate m_template;
+
+	/**
+	 * @brief The keys already looked up for evaluated names
+	 *
+	 * Avoids lookups when layers are switched back and forth.
+	 * Only accessed using Command, every thread context has its own values.
+	 * Is invalid if the generation of m_ks is not m_resolvedGeneration.
+	 */
+	mutable std::unordered_map<std::string, Key> m_resolved;
+	mutable uint64_t m_resolvedGeneration;
+	static const size_t maxResolved = 64;
+
 	/**
 	 * @brief The current key the Value is bound to.
 	 *
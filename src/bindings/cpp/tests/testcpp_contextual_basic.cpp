@@ -768,6 +768,97 @@ TEST (test_contextual_basic, evaluate)
 }
 
 
+TEST (test_contextual_basic, nameTemplate)
+{
+	using namespace kdb;
+	Context c;
+	std::vector<std::string> names = { "/%language%/%country%/%dialect%/test",
+					   "/%language country dialect%/test",
+					   "/%language country%/%dialect%/test",
+					   "/%language%%country%%dialect%/test",
+					   "/%language%/%language%/%dialect%/test",
+					   "/%%/no/layer",
+					   "/no/layer/at/all",
+					   "" };
+
+	auto check = [&]() {
+		for (auto const & name : names)
+		{
+			NameTemplate t (name);
+			ASSERT_EQ (t.getName (), name);
+			ASSERT_EQ (c.evaluate (t), c.evaluate (name)) << name;
+		}
+	};
+
+	check ();
+	c.activate<LanguageGermanLayer> ();
+	check ();
+	ASSERT_EQ (c.evaluate (NameTemplate ("/%language country dialect%/test")), "/%german/test");
+	c.activate<CountryGermanyLayer> ();
+	check ();
+	ASSERT_EQ (c.evaluate (NameTemplate ("/%language country dialect%/test")), "/%german%germany/test");
+	c.deactivate<LanguageGermanLayer> ();
+	check ();
+	ASSERT_EQ (c.evaluate (NameTemplate ("/%language country dialect%/test")), "/%/test");
+
+	std::vector<std::string> layers;
+	NameTemplate ("/%a%/%b c%/x").evaluate ([&](std::string const & id, std::string &, bool) {
+		layers.push_back (id);
+		return false;
+	});
+	ASSERT_EQ (layers, (std::vector<std::string>{ "a", "b", "c" }));
+}
+
+TEST (test_contextual_basic, resolvedKeys)
+{
+	using namespace kdb;
+	KeySet ks;
+	Context c;
+	Integer i (ks, c, Key ("/%language%/test", KEY_CASCADING_NAME, KEY_META, "default", s_value, KEY_END));
+	ASSERT_EQ (i, i_value);
+
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i.getName (), "/german/test");
+	ASSERT_EQ (i, i_value);
+	c.deactivate<LanguageGermanLayer> ();
+	ASSERT_EQ (i.getName (), "/%/test");
+
+	// a key added meanwhile must be found when switching back
+	ks.append (Key ("user/german/test", KEY_VALUE, "77", KEY_END));
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i.getName (), "user/german/test");
+	ASSERT_EQ (i, 77);
+
+	c.deactivate<LanguageGermanLayer> ();
+	ASSERT_EQ (i, i_value);
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i, 77);
+
+	// a removed key must not be found, even if the size stays the same
+	c.deactivate<LanguageGermanLayer> ();
+	ks.lookup ("user/german/test", KDB_O_POP);
+	ks.append (Key ("system/german/test", KEY_VALUE, "66", KEY_END));
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i.getName (), "system/german/test");
+	ASSERT_EQ (i, 66);
+
+	// a key of a namespace with higher priority must be found
+	ks.append (Key ("user/unrelated", KEY_END));
+	c.deactivate<LanguageGermanLayer> ();
+	ks.lookup ("user/unrelated", KDB_O_POP);
+	ks.append (Key ("dir/german/test", KEY_VALUE, "55", KEY_END));
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i.getName (), "dir/german/test");
+	ASSERT_EQ (i, 55);
+
+	// a replaced key must be used
+	c.deactivate<LanguageGermanLayer> ();
+	ks.append (Key ("dir/german/test", KEY_VALUE, "44", KEY_END));
+	c.activate<LanguageGermanLayer> ();
+	ASSERT_EQ (i, 44);
+}
+
+
 struct MockObserver : kdb::ValueObserver
 {
 	MockObserver () : counter ()
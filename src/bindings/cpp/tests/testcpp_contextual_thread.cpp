@@ -259,6 +259,51 @@ TEST (test_contextual_thread, activateNoDependency)
 }
 
 
+TEST (test_contextual_thread, syncOnlyPublished)
+{
+	Key specKey ("/act/%activate%", KEY_CASCADING_NAME, KEY_END);
+
+	KeySet ks;
+	ks.append (Key ("user/act/%", KEY_VALUE, "10", KEY_END)); // not active layer
+	ks.append (Key ("user/act/active", KEY_VALUE, "22", KEY_END));
+
+	Coordinator gc;
+	ThreadContext c1 (gc);
+	ThreadContext c2 (gc);
+	ThreadValue<int> v1 (ks, c1, specKey);
+	ThreadValue<int> v2 (ks, c2, specKey);
+
+	c1.syncLayers ();
+	c1.syncLayers (); // nothing published
+	ASSERT_EQ (v1, 10);
+
+	c2.activate<Activate> ();
+	ASSERT_EQ (v1, 10);
+	c1.syncLayers ();
+	ASSERT_EQ (c1["activate"], "active");
+	ASSERT_EQ (v1, 22);
+	c1.syncLayers ();
+	ASSERT_EQ (v1, 22);
+
+	// assignments are published as well
+	v2 = 33;
+	ASSERT_EQ (v1, 22);
+	c1.syncLayers ();
+	ASSERT_EQ (v1, 33);
+
+	// new contexts get everything published before
+	ThreadContext c3 (gc);
+	c3.syncLayers ();
+	ASSERT_EQ (c3["activate"], "active");
+
+	c2.deactivate<Activate> ();
+	c1.syncLayers ();
+	c3.syncLayers ();
+	ASSERT_EQ (c1["activate"], "");
+	ASSERT_EQ (c3["activate"], "");
+	ASSERT_EQ (v1, 10);
+}
+
 TEST (test_contextual_thread, activateWithDependency)
 {
 	Key specKey ("/act/%activate%", KEY_CASCADING_NAME, KEY_END);
@@ -1,4 +1,5 @@
 #define G_SETTINGS_ENABLE_BACKEND
+#include <errno.h>
 #include <gio/gio.h>
 #include <gio/gsettingsbackend.h>
 #include <glib.h>
@@ -33,6 +34,12 @@ typedef struct
 	GElektraKdb * gkdb;
 	GElektraKeySet * gks;
 	GElektraKeySet * subscription_gks;
+	/* parsed values of read keys, NULL for keys that do not exist */
+	GHashTable * cache;
+	/* gks contains changes, which are not written with kdbSet yet */
+	gboolean changed;
+	/* the dbus plugin reported a change, gks has to be read again */
+	gint stale;
 
 	GDBusConnection * dbus_connections[2];
 } ElektraSettingsBackend;
@@ -75,71 +82,374 @@ typedef struct
 static GType elektra_settings_backend_get_type (void);
 G_DEFINE_TYPE (ElektraSettingsBackend, elektra_settings_backend, G_TYPE_SETTINGS_BACKEND)
 
-static GVariant * elektra_settings_read_string (GSettingsBackend * backend, gchar * keypathname, const GVariantType * expected_type)
+/* < private >
+ * Types of GVariant, which are stored in the format of Elektra's type system.
+ */
+static const struct
 {
-	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
-	gelektra_kdb_get (esb->gkdb, esb->gks, esb->gkey);
-	/* Lookup the requested key */
-	GElektraKey * gkey = gelektra_keyset_lookup_byname (esb->gks, keypathname, GELEKTRA_KDB_O_NONE);
-	/* free the passed path string */
-	g_free (keypathname);
-	if (gkey == NULL)
+	const gchar * gvariant_type;
+	const gchar * elektra_type;
+} elektra_settings_types[] = {
+	{ "b", "boolean" },
+	{ "y", "octet" },
+	{ "n", "short" },
+	{ "q", "unsigned_short" },
+	{ "i", "long" },
+	{ "u", "unsigned_long" },
+	{ "x", "long_long" },
+	{ "t", "unsigned_long_long" },
+	{ "d", "double" },
+	{ "s", "string" },
+};
+
+/* < private >
+ * elektra_settings_elektra_type:
+ * @type: a #GVariantType
+ *
+ * Returns: the type of Elektra's type system for @type, or %NULL
+ */
+static const gchar * elektra_settings_elektra_type (const GVariantType * type)
+{
+	for (gsize i = 0; i < G_N_ELEMENTS (elektra_settings_types); ++i)
 	{
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key with path could not be found in Elekras kdb");
+		if (g_variant_type_equal (type, G_VARIANT_TYPE (elektra_settings_types[i].gvariant_type)))
+		{
+			return elektra_settings_types[i].elektra_type;
+		}
+	}
+	return NULL;
+}
+
+/* < private >
+ * elektra_settings_value_to_string:
+ * @value: a #GVariant to store
+ * @elektra_type: (out): the type meta data of the stored value, or %NULL
+ *
+ * Values of basic types are stored in the format of Elektra's type system,
+ * so they are read without the GVariant parser and can be checked like other
+ * keys. All other values are stored in the GVariant text format.
+ *
+ * Returns: the string to store
+ */
+static gchar * elektra_settings_value_to_string (GVariant * value, const gchar ** elektra_type)
+{
+	gchar buffer[G_ASCII_DTOSTR_BUF_SIZE];
+	*elektra_type = elektra_settings_elektra_type (g_variant_get_type (value));
+	switch (g_variant_classify (value))
+	{
+	case G_VARIANT_CLASS_BOOLEAN:
+		return g_strdup (g_variant_get_boolean (value) ? "1" : "0");
+	case G_VARIANT_CLASS_BYTE:
+		return g_strdup_printf ("%u", (guint) g_variant_get_byte (value));
+	case G_VARIANT_CLASS_INT16:
+		return g_strdup_printf ("%d", (gint) g_variant_get_int16 (value));
+	case G_VARIANT_CLASS_UINT16:
+		return g_strdup_printf ("%u", (guint) g_variant_get_uint16 (value));
+	case G_VARIANT_CLASS_INT32:
+		return g_strdup_printf ("%" G_GINT32_FORMAT, g_variant_get_int32 (value));
+	case G_VARIANT_CLASS_UINT32:
+		return g_strdup_printf ("%" G_GUINT32_FORMAT, g_variant_get_uint32 (value));
+	case G_VARIANT_CLASS_INT64:
+		return g_strdup_printf ("%" G_GINT64_FORMAT, g_variant_get_int64 (value));
+	case G_VARIANT_CLASS_UINT64:
+		return g_strdup_printf ("%" G_GUINT64_FORMAT, g_variant_get_uint64 (value));
+	case G_VARIANT_CLASS_DOUBLE:
+		return g_strdup (g_ascii_dtostr (buffer, sizeof (buffer), g_variant_get_double (value)));
+	case G_VARIANT_CLASS_STRING:
+		return g_variant_dup_string (value, NULL);
+	default:
+		return g_variant_print (value, FALSE);
+	}
+}
+
+/* < private >
+ * elektra_settings_value_from_typed_string:
+ * @string_value: a value in the format of Elektra's type system
+ * @expected_type: the type string of a basic #GVariantType
+ *
+ * Reverses elektra_settings_value_to_string() for basic types.
+ *
+ * Returns: a floating #GVariant, or %NULL if @string_value is not valid
+ */
+static GVariant * elektra_settings_value_from_typed_string (const gchar * string_value, gchar expected_type)
+{
+	gchar * end = NULL;
+	gint64 number = 0;
+	guint64 unsigned_number = 0;
+	gdouble double_number = 0;
+	errno = 0;
+	switch (expected_type)
+	{
+	case 'b':
+		if (g_str_equal (string_value, "1")) return g_variant_new_boolean (TRUE);
+		if (g_str_equal (string_value, "0")) return g_variant_new_boolean (FALSE);
 		return NULL;
+	case 's':
+		return g_utf8_validate (string_value, -1, NULL) ? g_variant_new_string (string_value) : NULL;
+	case 'd':
+		double_number = g_ascii_strtod (string_value, &end);
+		break;
+	case 'n':
+	case 'i':
+	case 'x':
+		number = g_ascii_strtoll (string_value, &end, 10);
+		break;
+	default:
+		// strtoull silently negates negative numbers
+		if (!g_ascii_isdigit (string_value[0])) return NULL;
+		unsigned_number = g_ascii_strtoull (string_value, &end, 10);
+		break;
 	}
-	else
+	if (errno != 0 || end == string_value || *end != '\0') return NULL;
+
+	switch (expected_type)
 	{
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s ", "Key found");
-		GVariant * read_gvariant;
-		GError * err = NULL;
-		gchar * string_value = g_malloc (gelektra_key_getvaluesize (gkey));
-		if (gelektra_key_getstring (gkey, string_value, gelektra_key_getvaluesize (gkey)) == -1)
+	case 'd':
+		return g_variant_new_double (double_number);
+	case 'y':
+		return unsigned_number <= G_MAXUINT8 ? g_variant_new_byte ((guchar) unsigned_number) : NULL;
+	case 'n':
+		return number >= G_MININT16 && number <= G_MAXINT16 ? g_variant_new_int16 ((gint16) number) : NULL;
+	case 'q':
+		return unsigned_number <= G_MAXUINT16 ? g_variant_new_uint16 ((guint16) unsigned_number) : NULL;
+	case 'i':
+		return number >= G_MININT32 && number <= G_MAXINT32 ? g_variant_new_int32 ((gint32) number) : NULL;
+	case 'u':
+		return unsigned_number <= G_MAXUINT32 ? g_variant_new_uint32 ((guint32) unsigned_number) : NULL;
+	case 'x':
+		return g_variant_new_int64 (number);
+	case 't':
+		return g_variant_new_uint64 (unsigned_number);
+	default:
+		return NULL;
+	}
+}
+
+/* < private >
+ * elektra_settings_value_from_key:
+ * @gkey: the key to read
+ * @expected_type: a #GVariantType requested by GSettings
+ *
+ * The type meta data decides how the value is read: keys with type meta
+ * data are converted from the format of Elektra's type system and must
+ * match @expected_type, keys without it are parsed from the GVariant text
+ * format. A value is never tried in both formats, so a string like `'x'`
+ * or `true` always reads back as it was written.
+ *
+ * Returns: a non-floating #GVariant, or %NULL
+ */
+static GVariant * elektra_settings_value_from_key (GElektraKey * gkey, const GVariantType * expected_type)
+{
+	if (gelektra_key_isbinary (gkey))
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s!", "but we could not read the string from Elektra kdb");
+		return NULL;
+	}
+	const gchar * string_value = keyString (gkey->key);
+	const Key * type_meta = keyGetMeta (gkey->key, "type");
+	GVariant * read_gvariant;
+	if (type_meta != NULL)
+	{
+		const gchar * elektra_type = elektra_settings_elektra_type (expected_type);
+		if (g_strcmp0 (keyString (type_meta), elektra_type) != 0)
 		{
-			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s!", "but we could not read the string from Elektra kdb");
+			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s!", "but the key has a different type:", keyString (type_meta));
 			return NULL;
 		}
-		/* now parse it with the expected type from GSettings */
-		read_gvariant = g_variant_parse (expected_type, string_value, NULL, NULL, &err);
-		if (err != NULL)
+		read_gvariant = elektra_settings_value_from_typed_string (string_value, g_variant_type_peek_string (expected_type)[0]);
+		if (read_gvariant == NULL)
 		{
-			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s!", "but GVariant error on parsing string value:", err->message);
-			g_error_free (err);
+			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s %s!", "but the value is no valid", elektra_type, string_value);
 			return NULL;
 		}
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "and GVariant parsed value is:", string_value);
-		return read_gvariant;
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s %s %s.", "and", elektra_type, "value is:", string_value);
+		return g_variant_ref_sink (read_gvariant);
 	}
+	/* now parse it with the expected type from GSettings */
+	GError * err = NULL;
+	read_gvariant = g_variant_parse (expected_type, string_value, NULL, NULL, &err);
+	if (err != NULL)
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s!", "but GVariant error on parsing string value:", err->message);
+		g_error_free (err);
+		return NULL;
+	}
+	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "and GVariant parsed value is:", string_value);
+	return read_gvariant;
 }
 
-static gboolean elektra_settings_write_string (GSettingsBackend * backend, const gchar * key, gchar * keypathname, GVariant * value,
-					       gpointer origin_tag)
+static void elektra_settings_cache_value_free (gpointer value)
+{
+	if (value != NULL) g_variant_unref (value);
+}
+
+/* < private >
+ * elektra_settings_cache_invalidate:
+ * @esb: the #ElektraSettingsBackend
+ * @key: the GSettings path of the key
+ *
+ * Removes the parsed values of the cascading, user and system key of @key.
+ */
+static void elektra_settings_cache_invalidate (ElektraSettingsBackend * esb, const gchar * key)
+{
+	const gchar * namespaces[] = { "", G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_SYSTEM };
+	for (gsize i = 0; i < G_N_ELEMENTS (namespaces); ++i)
+	{
+		gchar * keypathname = g_strconcat (namespaces[i], G_ELEKTRA_SETTINGS_PATH, key, NULL);
+		g_hash_table_remove (esb->cache, keypathname);
+		g_free (keypathname);
+	}
+}
+
+/* < private >
+ * elektra_settings_get:
+ * @esb: the #ElektraSettingsBackend
+ *
+ * Updates the keyset with kdbGet, all parsed values are dropped if the
+ * configuration changed.
+ *
+ * Returns: the result of kdbGet
+ */
+static gint elektra_settings_get (ElektraSettingsBackend * esb)
+{
+	gint ret = gelektra_kdb_get (esb->gkdb, esb->gks, esb->gkey);
+	if (ret != 0)
+	{
+		g_hash_table_remove_all (esb->cache);
+	}
+	return ret;
+}
+
+/* < private >
+ * elektra_settings_reload:
+ * @esb: the #ElektraSettingsBackend
+ *
+ * Reads the keyset again if the dbus plugin reported a change since the
+ * last read. Otherwise the keyset and the parsed values are still up to
+ * date, so reads do not need kdbGet.
+ */
+static void elektra_settings_reload (ElektraSettingsBackend * esb)
+{
+	if (g_atomic_int_compare_and_exchange (&esb->stale, TRUE, FALSE))
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Reload changed configuration");
+		elektra_settings_get (esb);
+	}
+}
+
+/* < private >
+ * elektra_settings_commit:
+ * @esb: the #ElektraSettingsBackend
+ *
+ * Writes all changes of the keyset with a single kdbSet.
+ *
+ * Returns: %TRUE if there was nothing to write or the write succeeded
+ */
+static gboolean elektra_settings_commit (ElektraSettingsBackend * esb)
+{
+	if (!esb->changed) return TRUE;
+	if (gelektra_kdb_set (esb->gkdb, esb->gks, esb->gkey) == -1)
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Error on writing changes");
+		return FALSE;
+	}
+	esb->changed = FALSE;
+	return TRUE;
+}
+
+static GVariant * elektra_settings_read_string (GSettingsBackend * backend, gchar * keypathname, const GVariantType * expected_type)
 {
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
-	/* Lookup if key already exists */
+	elektra_settings_reload (esb);
+	/* Parsed values stay valid until the key is written or reported as changed */
+	GVariant * read_gvariant;
+	if (g_hash_table_lookup_extended (esb->cache, keypathname, NULL, (gpointer *) &read_gvariant) &&
+	    (read_gvariant == NULL || g_variant_is_of_type (read_gvariant, expected_type)))
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "Cached value of key", keypathname);
+		g_free (keypathname);
+		return read_gvariant != NULL ? g_variant_ref (read_gvariant) : NULL;
+	}
+	/* Lookup the requested key */
 	GElektraKey * gkey = gelektra_keyset_lookup_byname (esb->gks, keypathname, GELEKTRA_KDB_O_NONE);
-	gchar * string_value = (value != NULL ? g_variant_print ((GVariant *) value, FALSE) : NULL);
+	if (gkey == NULL)
+	{
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key with path could not be found in Elekras kdb");
+		/* the cache takes the path string */
+		g_hash_table_replace (esb->cache, keypathname, NULL);
+		return NULL;
+	}
+	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s ", "Key found");
+	read_gvariant = elektra_settings_value_from_key (gkey, expected_type);
+	g_object_unref (gkey);
+	if (read_gvariant == NULL)
+	{
+		g_free (keypathname);
+		return NULL;
+	}
+	g_hash_table_replace (esb->cache, keypathname, read_gvariant);
+	return g_variant_ref (read_gvariant);
+}
+
+/* < private >
+ * elektra_settings_set_value:
+ * @esb: the #ElektraSettingsBackend
+ * @keypathname: the name of the key in Elektra
+ * @value: the new #GVariant value, %NULL removes the key
+ *
+ * Changes the keyset of the backend without writing it.
+ *
+ * Returns: %TRUE if the keyset was changed
+ */
+static gboolean elektra_settings_set_value (ElektraSettingsBackend * esb, const gchar * keypathname, GVariant * value)
+{
+	GElektraKey * gkey =
+		gelektra_keyset_lookup_byname (esb->gks, keypathname, value != NULL ? GELEKTRA_KDB_O_NONE : GELEKTRA_KDB_O_POP);
+	if (value == NULL)
+	{
+		if (gkey == NULL) return FALSE;
+		/* drops the popped key */
+		g_object_unref (gkey);
+		return TRUE;
+	}
+	const gchar * elektra_type;
+	gchar * string_value = elektra_settings_value_to_string (value, &elektra_type);
 	if (gkey == NULL)
 	{
 		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s %s.", "Key not found, creating new key:", keypathname, string_value);
 		gkey = gelektra_key_new (keypathname, KEY_VALUE, string_value, KEY_END);
-		g_free (keypathname);
+		g_free (string_value);
 		if (gkey == NULL)
 		{
 			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Error douring key creation");
 			return FALSE;
 		}
+		gelektra_key_setmeta (gkey, "type", elektra_type);
 		if (gelektra_keyset_append (esb->gks, gkey) == -1)
 		{
 			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Could not append the new key!");
+			g_object_unref (gkey);
+			return FALSE;
 		}
+		return TRUE;
 	}
-	else
-	{
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s %s %s.", "Found key:", keypathname, "and set value to", string_value);
-		g_free (keypathname);
-		gelektra_key_setstring (gkey, string_value);
-	}
+	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s %s %s.", "Found key:", keypathname, "and set value to", string_value);
+	gelektra_key_setstring (gkey, string_value);
+	gelektra_key_setmeta (gkey, "type", elektra_type);
+	g_free (string_value);
+	g_object_unref (gkey);
+	return TRUE;
+}
+
+static gboolean elektra_settings_write_string (GSettingsBackend * backend, const gchar * key, gchar * keypathname, GVariant * value,
+					       gpointer origin_tag)
+{
+	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
+	gboolean written = elektra_settings_set_value (esb, keypathname, value);
+	g_free (keypathname);
+	if (!written) return FALSE;
+	esb->changed = TRUE;
+	elektra_settings_cache_invalidate (esb, key);
 	// Notify GSettings that the key has changed
 	g_settings_backend_changed (backend, key, origin_tag);
 	return TRUE;
@@ -237,41 +547,25 @@ static gboolean elektra_settings_backend_write (GSettingsBackend * backend, cons
  * elektra_settings_keyset_from_tree:
  * @key: path of the GSettings key
  * @value: GVariant value of the key
- * @data: GElektraKeySet to append/write the key
+ * @data: ElektraSettingsBackend to append/write the key
  *
- * Writes one or more keys from a GSettings GTree to a GElektraKeySet
+ * Writes one or more keys from a GSettings GTree to the GElektraKeySet of the backend
  *
  * A GSettings GTree consists of GSetting paths as keys and GVariants as values.
  *
- * Each key is looked up and created if needed.
+ * Each key is looked up and created if needed, a %NULL value resets the key.
  */
 static gint elektra_settings_keyset_from_tree (gpointer key, gpointer value, gpointer data)
 {
-	gchar * fullpathname = g_strconcat (G_ELEKTRA_SETTINGS_PATH, (gchar *) (key), NULL);
-	gchar * string_value = (value != NULL ? g_variant_print ((GVariant *) value, FALSE) : NULL);
-	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s: %s.", "Append to keyset ", fullpathname, string_value);
-	GElektraKeySet * gks = (GElektraKeySet *) data;
-	GElektraKey * gkey = gelektra_keyset_lookup_byname (gks, fullpathname, GELEKTRA_KDB_O_NONE);
-	if (gkey == NULL)
-	{
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key is new, need to create it");
-		gkey = gelektra_key_new (fullpathname, KEY_VALUE, string_value, KEY_END);
-		if (gkey == NULL)
-		{
-			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Error douring key creation");
-			return FALSE;
-		}
-		if (gelektra_keyset_append (gks, gkey) == -1)
-		{
-			g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Could not append the new key!");
-			return FALSE;
-		}
-	}
-	else
+	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) data;
+	gchar * keypathname = g_strconcat (G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_PATH, (gchar *) (key), NULL);
+	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "Append to keyset ", keypathname);
+	if (elektra_settings_set_value (esb, keypathname, (GVariant *) value))
 	{
-		gelektra_key_setstring (gkey, string_value);
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key was found and new value set");
+		esb->changed = TRUE;
 	}
+	elektra_settings_cache_invalidate (esb, (gchar *) key);
+	g_free (keypathname);
 	return FALSE;
 }
 
@@ -301,10 +595,12 @@ static gboolean elektra_settings_backend_write_tree (GSettingsBackend * backend,
 {
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "Function writeTree. ", "We have to loop the tree and add the keys");
-	g_tree_foreach (tree, elektra_settings_keyset_from_tree, esb->gks);
+	g_tree_foreach (tree, elektra_settings_keyset_from_tree, esb);
+	/* The tree is one batch of changes, it is written with a single kdbSet */
+	gboolean written = elektra_settings_commit (esb);
 	/* Notify the GSettings about the changed tree */
 	g_settings_backend_changed_tree (backend, tree, origin_tag);
-	return TRUE;
+	return written;
 }
 
 /* elektra_settings_backend_reset implements g_settings_backend_reset:
@@ -321,12 +617,13 @@ static void elektra_settings_backend_reset (GSettingsBackend * backend, const gc
 	g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s %s.", "Function reset:", key);
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
 	gchar * keypathname = g_strconcat (G_ELEKTRA_SETTINGS_USER, G_ELEKTRA_SETTINGS_PATH, key, NULL);
-	GElektraKey * gkey = gelektra_keyset_lookup_byname (esb->gks, keypathname, GELEKTRA_KDB_O_NONE);
+	gboolean removed = elektra_settings_set_value (esb, keypathname, NULL);
 	g_free (keypathname);
-	if (gkey != NULL)
+	if (removed)
 	{
-		gelektra_keyset_lookup (esb->gks, gkey, KDB_O_POP);
-		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key not found and reseted");
+		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s.", "Key found and reseted");
+		esb->changed = TRUE;
+		elektra_settings_cache_invalidate (esb, key);
 		g_settings_backend_changed (backend, key, origin_tag);
 	}
 	else
@@ -372,6 +669,8 @@ static void elektra_settings_key_changed (GDBusConnection * connection G_GNUC_UN
 	GVariant * variant = g_variant_get_child_value (parameters, 0);
 	gchar const * keypathname = g_variant_get_string (variant, NULL);
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) user_data;
+	/* The next read fetches the changed configuration with kdbGet */
+	g_atomic_int_set (&esb->stale, TRUE);
 	GElektraKeySet * ks = gelektra_keyset_dup (esb->subscription_gks);
 	gelektra_keyset_rewind (ks);
 	GElektraKey * key = gelektra_key_new (keypathname, KEY_VALUE, "", KEY_END);
@@ -491,13 +790,15 @@ static void elektra_settings_backend_unsubscribe (GSettingsBackend * backend, co
 /* elektra_settings_backend_sync implements g_settings_backend_sync:
  * @backend: a #GSettingsBackend
  *
- * Write and read changes.
+ * Write and read changes. All changes since the last write are written
+ * with a single kdbSet.
  */
 static void elektra_settings_backend_sync (GSettingsBackend * backend)
 {
 	// TODO conflict management
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) backend;
-	if (gelektra_kdb_set (esb->gkdb, esb->gks, esb->gkey) == -1 || gelektra_kdb_get (esb->gkdb, esb->gks, esb->gkey) == -1)
+	g_atomic_int_set (&esb->stale, FALSE);
+	if (!elektra_settings_commit (esb) || elektra_settings_get (esb) == -1)
 	{
 		g_log (G_LOG_DOMAIN, G_LOG_LEVEL_DEBUG, "%s\n", "Error on sync!");
 		return;
@@ -517,6 +818,9 @@ static void elektra_settings_backend_init (ElektraSettingsBackend * esb)
 	esb->gkdb = gelektra_kdb_open (esb->gkey);
 	esb->gks = gelektra_keyset_new (0, GELEKTRA_KEYSET_END);
 	esb->subscription_gks = gelektra_keyset_new (0, GELEKTRA_KEYSET_END);
+	esb->cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, elektra_settings_cache_value_free);
+	esb->changed = FALSE;
+	esb->stale = FALSE;
 	gelektra_kdb_get (esb->gkdb, esb->gks, esb->gkey);
 	elektra_settings_check_bus_connection (esb);
 }
@@ -530,6 +834,7 @@ static void elektra_settings_backend_finalize (GObject * object)
 	ElektraSettingsBackend * esb = (ElektraSettingsBackend *) object;
 	GElektraKey * errorkey = gelektra_key_new (0);
 	gelektra_kdb_close (esb->gkdb, errorkey);
+	g_hash_table_unref (esb->cache);
 	// TODO error handling
 	G_OBJECT_CLASS (elektra_settings_backend_parent_class)->finalize (object);
 }
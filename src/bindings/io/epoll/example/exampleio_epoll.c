@@ -0,0 +1,141 @@
+/**
+ * @file
+ *
+ * @brief Example program for io_epoll binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ * For an example of how I/O bindings are used please see src/libs/notification/example.
+ *
+ * This example uses two I/O operations, which are handled by a background thread:
+ * - The "input" operation is a file descriptor watcher that waits for
+ *   STDIN_FILENO (stdin) to become readable.
+ *   Since input is buffered, this typically happens when the user enters some
+ *   text and presses return.
+ * - The "output" operation is a timer that prints the last read data every
+ *   second.
+ *
+ * The main thread waits until "exit" was entered.
+ *
+ */
+#include <errno.h>   // error handling
+#include <pthread.h> // condition variable
+#include <stdio.h>   // printf
+#include <string.h>  // memset & memcpy
+#include <unistd.h>  // file descriptor numbers (STDIN_FILENO)
+
+#include <kdbassert.h>   // assertions (ELEKTRA_NOT_NULL)
+#include <kdbhelper.h>   // malloc & free
+#include <kdbio.h>       // I/O binding functions (elektraIo*)
+#include <kdbio/epoll.h> // I/O binding constructor for epoll (elektraIoEpollNew)
+
+#define BUFFER_LENGTH 255
+#define ONE_SECOND 1000
+#define OPERATIONS 2
+
+pthread_mutex_t exitMutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t exitCondition = PTHREAD_COND_INITIALIZER;
+int exitRequested = 0;
+
+int min (int a, int b)
+{
+	return (a > b) ? b : a;
+}
+
+void requestExit (void)
+{
+	pthread_mutex_lock (&exitMutex);
+	exitRequested = 1;
+	pthread_cond_signal (&exitCondition);
+	pthread_mutex_unlock (&exitMutex);
+}
+
+void readText (ElektraIoFdOperation * fdOp, int flags ELEKTRA_UNUSED)
+{
+	printf ("input: file descriptor became readable\n");
+
+	char * lastInput = elektraIoFdGetData (fdOp);
+	ELEKTRA_NOT_NULL (lastInput);
+
+	char buffer[BUFFER_LENGTH];
+	int bytesRead = read (elektraIoFdGetFd (fdOp), &buffer, BUFFER_LENGTH);
+	if (bytesRead > 0)
+	{
+		// make sure there is a null terminator in buffer
+		buffer[min (BUFFER_LENGTH - 1, bytesRead)] = 0;
+		// remove newline from string
+		buffer[strcspn (buffer, "\r\n")] = 0;
+		// copy to lastInput
+		memcpy (lastInput, buffer, BUFFER_LENGTH);
+	}
+	else if (bytesRead == 0 || errno != EINTR)
+	{
+		printf ("input: end of input or I/O error occurred - exiting\n");
+		// stop watching, stdin stays readable
+		elektraIoFdSetEnabled (fdOp, 0);
+		elektraIoBindingUpdateFd (fdOp);
+		requestExit ();
+	}
+}
+
+void printText (ElektraIoTimerOperation * timerOp)
+{
+	char * lastInput = elektraIoTimerGetData (timerOp);
+	ELEKTRA_NOT_NULL (lastInput);
+
+	if (strcmp (lastInput, "exit") == 0)
+	{
+		printf ("timer: stopping\n");
+		requestExit ();
+	}
+	else if (strlen (lastInput) > 0)
+	{
+		printf ("timer: last text was \"%s\"\n", lastInput);
+	}
+	else
+	{
+		printf ("timer: text is empty\n");
+	}
+}
+
+int main (void)
+{
+	// Initialize buffer
+	char lastInput[BUFFER_LENGTH];
+	memset (lastInput, 0, BUFFER_LENGTH);
+
+	printf ("Please enter some text and press return.\n");
+	printf ("Enter \"exit\" to stop and exit.\n");
+
+	// Initialize I/O binding with its own loop
+	ElektraIoInterface * binding = elektraIoEpollNew (OPERATIONS);
+	// Read lines from STDIN
+	ElektraIoFdOperation * input = elektraIoNewFdOperation (STDIN_FILENO, ELEKTRA_IO_READABLE, 1, readText, &lastInput);
+	// Print last read data every second
+	ElektraIoTimerOperation * output = elektraIoNewTimerOperation (ONE_SECOND, 1, printText, &lastInput);
+
+	// Add operations to binding
+	elektraIoBindingAddFd (binding, input);
+	elektraIoBindingAddTimer (binding, output);
+
+	// Handle the operations in a background thread
+	elektraIoEpollStartThread (binding);
+
+	// The main thread is free for other work, here it just waits
+	pthread_mutex_lock (&exitMutex);
+	while (!exitRequested)
+	{
+		pthread_cond_wait (&exitCondition, &exitMutex);
+	}
+	pthread_mutex_unlock (&exitMutex);
+
+	// Cleanup
+	elektraIoEpollStopThread (binding);
+	elektraIoBindingRemoveFd (input);
+	elektraIoBindingRemoveTimer (output);
+	elektraFree (input);
+	elektraFree (output);
+	elektraIoBindingCleanup (binding);
+
+	return 0;
+}
@@ -0,0 +1,1099 @@
+/**
+ * @file
+ *
+ * @brief I/O epoll binding.
+ *
+ * The binding has its own loop, so applications without an event loop can
+ * use asynchronous I/O (e.g. for notifications).
+ * File descriptors are watched with epoll. Timers are kept in a hierarchical
+ * timer wheel with a resolution of one millisecond, a single timerfd wakes
+ * up the loop when the next slot of the wheel is due. An eventfd wakes up
+ * the loop if other threads change operations.
+ *
+ * All memory is allocated by elektraIoEpollNew(): every operation uses one
+ * of the preallocated slots, which are linked into the lists of the wheel
+ * or of the idle operations.
+ *
+ * All callbacks are called by the thread running the loop while it holds
+ * the (recursive) lock of the binding. Adding, updating and removing
+ * operations also takes the lock, so it can be done from any thread and
+ * from callbacks. Once an operation was removed, its callback is neither
+ * running nor called again.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <kdbassert.h>
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdbio/epoll.h>
+#include <kdblogger.h>
+
+/** number of bits of a slot index in one level of the timer wheel */
+#define ELEKTRA_IO_EPOLL_WHEEL_BITS 6
+/** number of slots in one level of the timer wheel */
+#define ELEKTRA_IO_EPOLL_WHEEL_SIZE (1 << ELEKTRA_IO_EPOLL_WHEEL_BITS)
+#define ELEKTRA_IO_EPOLL_WHEEL_MASK (ELEKTRA_IO_EPOLL_WHEEL_SIZE - 1)
+/** levels of the timer wheel, timers due after more than 64^4 ms (~4.6 hours) are moved down several times */
+#define ELEKTRA_IO_EPOLL_WHEEL_LEVELS 4
+#define ELEKTRA_IO_EPOLL_WHEEL_SPAN ((uint64_t) 1 << (ELEKTRA_IO_EPOLL_WHEEL_BITS * ELEKTRA_IO_EPOLL_WHEEL_LEVELS))
+/** marks slots that are not in the timer wheel */
+#define ELEKTRA_IO_EPOLL_WHEEL_NONE UINT8_MAX
+
+/** maximum number of file descriptor events handled by one iteration of the loop */
+#define ELEKTRA_IO_EPOLL_EVENTS 64
+/** tick of timers that are never due */
+#define ELEKTRA_IO_EPOLL_NEVER UINT64_MAX
+/** epoll event index of the eventfd */
+#define ELEKTRA_IO_EPOLL_WAKEUP UINT32_MAX
+/** epoll event index of the timerfd */
+#define ELEKTRA_IO_EPOLL_TIMER (UINT32_MAX - 1)
+
+typedef enum
+{
+	EPOLL_SLOT_FREE,
+	EPOLL_SLOT_FD,
+	EPOLL_SLOT_TIMER,
+	EPOLL_SLOT_IDLE,
+} EpollSlotType;
+
+/**
+ * Preallocated binding data of a single operation
+ */
+typedef struct EpollSlot
+{
+	union
+	{
+		ElektraIoFdOperation * fd;
+		ElektraIoTimerOperation * timer;
+		ElektraIoIdleOperation * idle;
+	} operation;
+	struct EpollSlot * next;  /*!< next slot in the free list, the wheel or the idle list */
+	struct EpollSlot ** prev; /*!< pointer to this slot in the wheel or the idle list, NULL if not linked */
+	uint64_t expires;	 /*!< timer: tick of the next callback */
+	uint32_t generation;      /*!< fd: changed by removal, so that pending epoll events are ignored */
+	uint8_t type;		  /*!< one of EpollSlotType */
+	uint8_t registered;       /*!< fd: watched by epoll */
+	uint8_t level;		  /*!< timer: level in the wheel */
+	uint8_t index;		  /*!< timer: slot index in the level */
+} EpollSlot;
+
+typedef struct
+{
+	int epollFd;
+	int timerFd;
+	int wakeupFd;
+	pthread_mutex_t lock;
+
+	pthread_t loopThread; /*!< thread running the loop, valid if running */
+	pthread_t thread;     /*!< thread started by elektraIoEpollStartThread() */
+	int threadStarted;
+	int running;
+	int stop;
+
+	struct timespec start; /*!< tick 0 of the wheel */
+	uint64_t current;      /*!< last processed tick (milliseconds since start) */
+	uint64_t armed;	       /*!< tick the timerfd is armed for */
+	EpollSlot * wheel[ELEKTRA_IO_EPOLL_WHEEL_LEVELS][ELEKTRA_IO_EPOLL_WHEEL_SIZE];
+	uint64_t occupied[ELEKTRA_IO_EPOLL_WHEEL_LEVELS]; /*!< bit i is set if wheel[level][i] is not empty */
+
+	EpollSlot * idle;     /*!< enabled idle operations */
+	EpollSlot * idleNext; /*!< next idle operation called by the loop */
+
+	EpollSlot * free;
+	EpollSlot * slots;
+	size_t size;
+	struct epoll_event events[ELEKTRA_IO_EPOLL_EVENTS];
+} EpollBindingData;
+
+/**
+ * Convert I/O flags to epoll event bit mask
+ * @param  flags I/O flags bit mask
+ * @return       epoll events bit mask
+ */
+static uint32_t flagsToEvents (int flags)
+{
+	uint32_t events = 0;
+	if (flags & ELEKTRA_IO_READABLE)
+	{
+		events |= EPOLLIN;
+	}
+	if (flags & ELEKTRA_IO_WRITABLE)
+	{
+		events |= EPOLLOUT;
+	}
+	return events;
+}
+
+/**
+ * Convert epoll event bit mask to I/O flags.
+ * Errors and hang ups are reported as readable (and writable on errors),
+ * so that the next read or write returns them.
+ * @param  events epoll events bit mask
+ * @return        I/O flags bit mask
+ */
+static int eventsToFlags (uint32_t events)
+{
+	int flags = 0;
+	if (events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+	{
+		flags |= ELEKTRA_IO_READABLE;
+	}
+	if (events & (EPOLLOUT | EPOLLERR))
+	{
+		flags |= ELEKTRA_IO_WRITABLE;
+	}
+	return flags;
+}
+
+/**
+ * @internal
+ * Get milliseconds since the creation of the binding.
+ *
+ * @param  data binding data
+ * @return      current tick
+ */
+static uint64_t ioEpollNow (EpollBindingData * data)
+{
+	struct timespec now;
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	int64_t nanoseconds = (int64_t) (now.tv_sec - data->start.tv_sec) * 1000000000 + (now.tv_nsec - data->start.tv_nsec);
+	return (uint64_t) nanoseconds / 1000000;
+}
+
+/**
+ * @internal
+ * Wake up the loop if the calling thread is not the loop thread, so that the loop
+ * sees changed timers and idle operations.
+ *
+ * @param data binding data
+ */
+static void ioEpollWakeup (EpollBindingData * data)
+{
+	if (data->running && !pthread_equal (pthread_self (), data->loopThread))
+	{
+		if (eventfd_write (data->wakeupFd, 1) == -1)
+		{
+			ELEKTRA_LOG_WARNING ("could not wake up loop: %s", strerror (errno));
+		}
+	}
+}
+
+/**
+ * @internal
+ * Take a free slot.
+ *
+ * @param  data binding data
+ * @param  type type of the operation
+ * @return      slot or NULL if all slots are in use
+ */
+static EpollSlot * ioEpollSlotNew (EpollBindingData * data, EpollSlotType type)
+{
+	EpollSlot * slot = data->free;
+	if (slot == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("all %zu operations are in use", data->size);
+		return NULL;
+	}
+	data->free = slot->next;
+	slot->next = NULL;
+	slot->prev = NULL;
+	slot->type = type;
+	slot->registered = 0;
+	slot->level = ELEKTRA_IO_EPOLL_WHEEL_NONE;
+	return slot;
+}
+
+/**
+ * @internal
+ * Return a slot to the free list, the slot must not be linked.
+ *
+ * @param data binding data
+ * @param slot slot
+ */
+static void ioEpollSlotDel (EpollBindingData * data, EpollSlot * slot)
+{
+	ELEKTRA_ASSERT (slot->prev == NULL, "slot is still linked");
+	slot->type = EPOLL_SLOT_FREE;
+	++slot->generation;
+	slot->next = data->free;
+	data->free = slot;
+}
+
+/**
+ * @internal
+ * Insert a slot at the front of a list.
+ *
+ * @param head list
+ * @param slot slot
+ */
+static void ioEpollLink (EpollSlot ** head, EpollSlot * slot)
+{
+	slot->next = *head;
+	if (slot->next)
+	{
+		slot->next->prev = &slot->next;
+	}
+	slot->prev = head;
+	*head = slot;
+}
+
+/**
+ * @internal
+ * Remove a slot from the wheel or the idle list, does nothing if it is not linked.
+ *
+ * @param data binding data
+ * @param slot slot
+ */
+static void ioEpollUnlink (EpollBindingData * data, EpollSlot * slot)
+{
+	if (slot->prev == NULL)
+	{
+		return;
+	}
+	if (data->idleNext == slot)
+	{
+		data->idleNext = slot->next;
+	}
+	*slot->prev = slot->next;
+	if (slot->next)
+	{
+		slot->next->prev = slot->prev;
+	}
+	if (slot->level != ELEKTRA_IO_EPOLL_WHEEL_NONE && data->wheel[slot->level][slot->index] == NULL)
+	{
+		data->occupied[slot->level] &= ~((uint64_t) 1 << slot->index);
+	}
+	slot->next = NULL;
+	slot->prev = NULL;
+	slot->level = ELEKTRA_IO_EPOLL_WHEEL_NONE;
+}
+
+/**
+ * @internal
+ * Insert a timer into the wheel.
+ *
+ * Timers due within 64^(level+1) ticks are put into the slot of their tick in that level.
+ * Slots of the higher levels are moved down when the current tick reaches them.
+ *
+ * @param data binding data
+ * @param slot timer
+ */
+static void ioEpollWheelAdd (EpollBindingData * data, EpollSlot * slot)
+{
+	uint64_t due = slot->expires > data->current ? slot->expires : data->current;
+	uint64_t delta = due - data->current;
+	if (delta >= ELEKTRA_IO_EPOLL_WHEEL_SPAN)
+	{
+		due = data->current + ELEKTRA_IO_EPOLL_WHEEL_SPAN - 1;
+		delta = ELEKTRA_IO_EPOLL_WHEEL_SPAN - 1;
+	}
+	uint8_t level = 0;
+	while (delta >= (uint64_t) 1 << (ELEKTRA_IO_EPOLL_WHEEL_BITS * (level + 1)))
+	{
+		++level;
+	}
+	uint8_t index = (due >> (ELEKTRA_IO_EPOLL_WHEEL_BITS * level)) & ELEKTRA_IO_EPOLL_WHEEL_MASK;
+
+	ioEpollLink (&data->wheel[level][index], slot);
+	slot->level = level;
+	slot->index = index;
+	data->occupied[level] |= (uint64_t) 1 << index;
+}
+
+/**
+ * @internal
+ * Get the next tick after the current tick, where a slot of the wheel has to be processed.
+ *
+ * @param  data binding data
+ * @return      tick or ELEKTRA_IO_EPOLL_NEVER if the wheel is empty
+ */
+static uint64_t ioEpollWheelNext (EpollBindingData * data)
+{
+	uint64_t next = ELEKTRA_IO_EPOLL_NEVER;
+	for (uint8_t level = 0; level < ELEKTRA_IO_EPOLL_WHEEL_LEVELS; ++level)
+	{
+		uint64_t occupied = data->occupied[level];
+		if (!occupied)
+		{
+			continue;
+		}
+		unsigned int shift = ELEKTRA_IO_EPOLL_WHEEL_BITS * level;
+		uint64_t block = data->current >> shift;
+		// rotate, so that bit 0 is the slot after the current one
+		unsigned int first = (block + 1) & ELEKTRA_IO_EPOLL_WHEEL_MASK;
+		uint64_t rotated = (occupied >> first) | (occupied << ((ELEKTRA_IO_EPOLL_WHEEL_SIZE - first) & ELEKTRA_IO_EPOLL_WHEEL_MASK));
+		uint64_t tick = (block + __builtin_ctzll (rotated) + 1) << shift;
+		if (tick < next)
+		{
+			next = tick;
+		}
+	}
+	return next;
+}
+
+/**
+ * @internal
+ * Move the timers of a slot to lower levels.
+ *
+ * @param data  binding data
+ * @param level level of the slot
+ * @param index index of the slot
+ */
+static void ioEpollWheelCascade (EpollBindingData * data, uint8_t level, uint8_t index)
+{
+	EpollSlot * list = data->wheel[level][index];
+	if (list == NULL)
+	{
+		return;
+	}
+	data->wheel[level][index] = NULL;
+	data->occupied[level] &= ~((uint64_t) 1 << index);
+	list->prev = &list;
+	while (list)
+	{
+		EpollSlot * slot = list;
+		ioEpollUnlink (data, slot);
+		ioEpollWheelAdd (data, slot);
+	}
+}
+
+/**
+ * @internal
+ * Call the timers of the current tick and insert them again.
+ *
+ * Callbacks may remove or update timers of the same tick.
+ *
+ * @param data binding data
+ */
+static void ioEpollWheelExpire (EpollBindingData * data)
+{
+	uint8_t index = data->current & ELEKTRA_IO_EPOLL_WHEEL_MASK;
+	EpollSlot * expired = data->wheel[0][index];
+	if (expired == NULL)
+	{
+		return;
+	}
+	data->wheel[0][index] = NULL;
+	data->occupied[0] &= ~((uint64_t) 1 << index);
+	expired->prev = &expired;
+	while (expired)
+	{
+		EpollSlot * slot = expired;
+		ioEpollUnlink (data, slot);
+		ElektraIoTimerOperation * timerOp = slot->operation.timer;
+		unsigned int interval = elektraIoTimerGetInterval (timerOp);
+		slot->expires = data->current + (interval > 0 ? interval : 1);
+		ioEpollWheelAdd (data, slot);
+
+		elektraIoTimerGetCallback (timerOp) (timerOp);
+	}
+}
+
+/**
+ * @internal
+ * Process all ticks of the wheel up to @p now.
+ *
+ * Empty slots are skipped, so that the loop does not wake up every tick.
+ *
+ * @param data binding data
+ * @param now  current tick
+ */
+static void ioEpollWheelAdvance (EpollBindingData * data, uint64_t now)
+{
+	while (!data->stop)
+	{
+		uint64_t next = ioEpollWheelNext (data);
+		if (next > now)
+		{
+			data->current = now > data->current ? now : data->current;
+			return;
+		}
+		data->current = next;
+		// higher levels first, their timers might be due in a lower level at the same tick
+		for (uint8_t level = ELEKTRA_IO_EPOLL_WHEEL_LEVELS - 1; level > 0; --level)
+		{
+			unsigned int shift = ELEKTRA_IO_EPOLL_WHEEL_BITS * level;
+			if ((next & (((uint64_t) 1 << shift) - 1)) == 0)
+			{
+				ioEpollWheelCascade (data, level, (next >> shift) & ELEKTRA_IO_EPOLL_WHEEL_MASK);
+			}
+		}
+		ioEpollWheelExpire (data);
+	}
+}
+
+/**
+ * @internal
+ * Arm the timerfd for the next tick of the wheel.
+ *
+ * @param  data binding data
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+static int ioEpollTimerFdArm (EpollBindingData * data)
+{
+	uint64_t next = ioEpollWheelNext (data);
+	if (next == data->armed)
+	{
+		return 1;
+	}
+
+	struct itimerspec value = { { 0, 0 }, { 0, 0 } };
+	if (next != ELEKTRA_IO_EPOLL_NEVER)
+	{
+		value.it_value.tv_sec = data->start.tv_sec + next / 1000;
+		value.it_value.tv_nsec = data->start.tv_nsec + (next % 1000) * 1000000;
+		if (value.it_value.tv_nsec >= 1000000000)
+		{
+			value.it_value.tv_sec += 1;
+			value.it_value.tv_nsec -= 1000000000;
+		}
+	}
+	if (timerfd_settime (data->timerFd, TFD_TIMER_ABSTIME, &value, NULL) == -1)
+	{
+		ELEKTRA_LOG_WARNING ("could not arm timer: %s", strerror (errno));
+		return 0;
+	}
+	data->armed = next;
+	return 1;
+}
+
+/**
+ * @internal
+ * Call all enabled idle operations once.
+ *
+ * @param data binding data
+ */
+static void ioEpollIdleRun (EpollBindingData * data)
+{
+	EpollSlot * slot = data->idle;
+	while (slot && !data->stop)
+	{
+		data->idleNext = slot->next;
+		ElektraIoIdleOperation * idleOp = slot->operation.idle;
+		elektraIoIdleGetCallback (idleOp) (idleOp);
+		slot = data->idleNext;
+	}
+	data->idleNext = NULL;
+}
+
+/**
+ * @internal
+ * Handle an event returned by epoll_wait().
+ *
+ * @param data  binding data
+ * @param event epoll event
+ */
+static void ioEpollDispatch (EpollBindingData * data, struct epoll_event * event)
+{
+	uint32_t index = (uint32_t) event->data.u64;
+	uint32_t generation = (uint32_t) (event->data.u64 >> 32);
+	if (index == ELEKTRA_IO_EPOLL_WAKEUP)
+	{
+		eventfd_t value;
+		eventfd_read (data->wakeupFd, &value);
+		return;
+	}
+	if (index == ELEKTRA_IO_EPOLL_TIMER)
+	{
+		uint64_t expirations;
+		if (read (data->timerFd, &expirations, sizeof (expirations)) == -1 && errno != EAGAIN)
+		{
+			ELEKTRA_LOG_WARNING ("could not read timer: %s", strerror (errno));
+		}
+		data->armed = ELEKTRA_IO_EPOLL_NEVER;
+		return;
+	}
+
+	ELEKTRA_ASSERT (index < data->size, "invalid epoll event");
+	EpollSlot * slot = &data->slots[index];
+	// the operation might have been removed or disabled by a previous callback
+	if (slot->type != EPOLL_SLOT_FD || slot->generation != generation || !slot->registered)
+	{
+		return;
+	}
+	ElektraIoFdOperation * fdOp = slot->operation.fd;
+	int flags = eventsToFlags (event->events) & elektraIoFdGetFlags (fdOp);
+	if (flags)
+	{
+		elektraIoFdGetCallback (fdOp) (fdOp, flags);
+	}
+}
+
+/**
+ * @internal
+ * Run the loop until it is stopped, the lock must be held.
+ *
+ * @param  data binding data
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+static int ioEpollLoop (EpollBindingData * data)
+{
+	int result = 1;
+	while (!data->stop)
+	{
+		ioEpollWheelAdvance (data, ioEpollNow (data));
+		ioEpollIdleRun (data);
+		if (data->stop)
+		{
+			break;
+		}
+		if (!ioEpollTimerFdArm (data))
+		{
+			result = 0;
+			break;
+		}
+		// do not block if there are idle operations
+		int timeout = data->idle ? 0 : -1;
+
+		pthread_mutex_unlock (&data->lock);
+		int count = epoll_wait (data->epollFd, data->events, ELEKTRA_IO_EPOLL_EVENTS, timeout);
+		int error = errno;
+		pthread_mutex_lock (&data->lock);
+
+		if (count == -1)
+		{
+			if (error == EINTR)
+			{
+				continue;
+			}
+			ELEKTRA_LOG_WARNING ("epoll_wait failed: %s", strerror (error));
+			result = 0;
+			break;
+		}
+		for (int i = 0; i < count && !data->stop; ++i)
+		{
+			ioEpollDispatch (data, &data->events[i]);
+		}
+	}
+	data->stop = 0;
+	data->running = 0;
+	return result;
+}
+
+static void * ioEpollThread (void * arg)
+{
+	EpollBindingData * data = arg;
+	pthread_mutex_lock (&data->lock);
+	ioEpollLoop (data);
+	pthread_mutex_unlock (&data->lock);
+	return NULL;
+}
+
+/**
+ * Update information about a file descriptor watched by I/O binding.
+ * @see kdbio.h ::ElektraIoBindingUpdateFd
+ */
+static int ioEpollBindingUpdateFd (ElektraIoFdOperation * fdOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoFdGetBindingData (fdOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoFdGetBinding (fdOp));
+	EpollSlot * slot = elektraIoFdGetBindingData (fdOp);
+
+	pthread_mutex_lock (&data->lock);
+	int result = 0;
+	if (elektraIoFdIsEnabled (fdOp))
+	{
+		struct epoll_event event = { 0 };
+		event.events = flagsToEvents (elektraIoFdGetFlags (fdOp));
+		event.data.u64 = ((uint64_t) slot->generation << 32) | (uint64_t) (slot - data->slots);
+		result = epoll_ctl (data->epollFd, slot->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, elektraIoFdGetFd (fdOp), &event);
+		if (result == 0)
+		{
+			slot->registered = 1;
+		}
+	}
+	else if (slot->registered)
+	{
+		result = epoll_ctl (data->epollFd, EPOLL_CTL_DEL, elektraIoFdGetFd (fdOp), NULL);
+		slot->registered = 0;
+	}
+	pthread_mutex_unlock (&data->lock);
+
+	if (result != 0)
+	{
+		ELEKTRA_LOG_WARNING ("could not update poll: %s", strerror (errno));
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Add file descriptor to I/O binding
+ * @see kdbio.h ::ElektraIoBindingAddFd
+ */
+static int ioEpollBindingAddFd (ElektraIoInterface * binding, ElektraIoFdOperation * fdOp)
+{
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	ELEKTRA_NOT_NULL (data);
+
+	pthread_mutex_lock (&data->lock);
+	EpollSlot * slot = ioEpollSlotNew (data, EPOLL_SLOT_FD);
+	if (slot == NULL)
+	{
+		pthread_mutex_unlock (&data->lock);
+		return 0;
+	}
+	slot->operation.fd = fdOp;
+	elektraIoFdSetBindingData (fdOp, slot);
+
+	// Start polling if enabled
+	if (elektraIoFdIsEnabled (fdOp) && !ioEpollBindingUpdateFd (fdOp))
+	{
+		ioEpollSlotDel (data, slot);
+		elektraIoFdSetBindingData (fdOp, NULL);
+		pthread_mutex_unlock (&data->lock);
+		return 0;
+	}
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Remove file descriptor from I/O binding.
+ * @see kdbio.h ::ElektraIoBindingRemoveFd
+ */
+static int ioEpollBindingRemoveFd (ElektraIoFdOperation * fdOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoFdGetBindingData (fdOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoFdGetBinding (fdOp));
+	EpollSlot * slot = elektraIoFdGetBindingData (fdOp);
+
+	pthread_mutex_lock (&data->lock);
+	if (slot->registered && epoll_ctl (data->epollFd, EPOLL_CTL_DEL, elektraIoFdGetFd (fdOp), NULL) == -1)
+	{
+		// the file descriptor might have been closed already
+		ELEKTRA_LOG_WARNING ("could not stop polling: %s", strerror (errno));
+	}
+	ioEpollSlotDel (data, slot);
+	elektraIoFdSetBindingData (fdOp, NULL);
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Update timer in I/O binding.
+ * @see kdbio.h ::ElektraIoBindingUpdateTimer
+ */
+static int ioEpollBindingUpdateTimer (ElektraIoTimerOperation * timerOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoTimerGetBindingData (timerOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoTimerGetBinding (timerOp));
+	EpollSlot * slot = elektraIoTimerGetBindingData (timerOp);
+
+	pthread_mutex_lock (&data->lock);
+	ioEpollUnlink (data, slot);
+	if (elektraIoTimerIsEnabled (timerOp))
+	{
+		unsigned int interval = elektraIoTimerGetInterval (timerOp);
+		slot->expires = ioEpollNow (data) + (interval > 0 ? interval : 1);
+		ioEpollWheelAdd (data, slot);
+	}
+	ioEpollWakeup (data);
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Add timer for I/O binding.
+ * @see kdbio.h ::ElektraIoBindingAddTimer
+ */
+static int ioEpollBindingAddTimer (ElektraIoInterface * binding, ElektraIoTimerOperation * timerOp)
+{
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	ELEKTRA_NOT_NULL (data);
+
+	pthread_mutex_lock (&data->lock);
+	EpollSlot * slot = ioEpollSlotNew (data, EPOLL_SLOT_TIMER);
+	if (slot == NULL)
+	{
+		pthread_mutex_unlock (&data->lock);
+		return 0;
+	}
+	slot->operation.timer = timerOp;
+	elektraIoTimerSetBindingData (timerOp, slot);
+
+	// Start timer if enabled
+	if (elektraIoTimerIsEnabled (timerOp))
+	{
+		ioEpollBindingUpdateTimer (timerOp);
+	}
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Remove timer from I/O binding
+ * @see kdbio.h ::ElektraIoBindingRemoveTimer
+ */
+static int ioEpollBindingRemoveTimer (ElektraIoTimerOperation * timerOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoTimerGetBindingData (timerOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoTimerGetBinding (timerOp));
+	EpollSlot * slot = elektraIoTimerGetBindingData (timerOp);
+
+	pthread_mutex_lock (&data->lock);
+	ioEpollUnlink (data, slot);
+	ioEpollSlotDel (data, slot);
+	elektraIoTimerSetBindingData (timerOp, NULL);
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Update idle operation in I/O binding
+ * @see kdbio.h ::ElektraIoBindingUpdateIdle
+ */
+static int ioEpollBindingUpdateIdle (ElektraIoIdleOperation * idleOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoIdleGetBindingData (idleOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoIdleGetBinding (idleOp));
+	EpollSlot * slot = elektraIoIdleGetBindingData (idleOp);
+
+	pthread_mutex_lock (&data->lock);
+	if (elektraIoIdleIsEnabled (idleOp))
+	{
+		if (slot->prev == NULL)
+		{
+			ioEpollLink (&data->idle, slot);
+			ioEpollWakeup (data);
+		}
+	}
+	else
+	{
+		ioEpollUnlink (data, slot);
+	}
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Add idle operation to I/O binding
+ * @see kdbio.h ::ElektraIoBindingAddIdle
+ */
+static int ioEpollBindingAddIdle (ElektraIoInterface * binding, ElektraIoIdleOperation * idleOp)
+{
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	ELEKTRA_NOT_NULL (data);
+
+	pthread_mutex_lock (&data->lock);
+	EpollSlot * slot = ioEpollSlotNew (data, EPOLL_SLOT_IDLE);
+	if (slot == NULL)
+	{
+		pthread_mutex_unlock (&data->lock);
+		return 0;
+	}
+	slot->operation.idle = idleOp;
+	elektraIoIdleSetBindingData (idleOp, slot);
+
+	// Add idle to loop if enabled
+	if (elektraIoIdleIsEnabled (idleOp))
+	{
+		ioEpollBindingUpdateIdle (idleOp);
+	}
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Remove idle operation from I/O binding
+ * @see kdbio.h ::ElektraIoBindingRemoveIdle
+ */
+static int ioEpollBindingRemoveIdle (ElektraIoIdleOperation * idleOp)
+{
+	ELEKTRA_NOT_NULL (elektraIoIdleGetBindingData (idleOp));
+	EpollBindingData * data = elektraIoBindingGetData (elektraIoIdleGetBinding (idleOp));
+	EpollSlot * slot = elektraIoIdleGetBindingData (idleOp);
+
+	pthread_mutex_lock (&data->lock);
+	ioEpollUnlink (data, slot);
+	ioEpollSlotDel (data, slot);
+	elektraIoIdleSetBindingData (idleOp, NULL);
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * @internal
+ * Close file descriptors and free the binding data.
+ *
+ * @param data binding data, may be partially initialized
+ */
+static void ioEpollDataDel (EpollBindingData * data)
+{
+	if (data->epollFd != -1) close (data->epollFd);
+	if (data->timerFd != -1) close (data->timerFd);
+	if (data->wakeupFd != -1) close (data->wakeupFd);
+	pthread_mutex_destroy (&data->lock);
+	elektraFree (data->slots);
+	elektraFree (data);
+}
+
+/**
+ * Cleanup
+ * @param  binding I/O binding
+ * @see kdbio.h ::ElektraIoBindingCleanup
+ */
+static int ioEpollBindingCleanup (ElektraIoInterface * binding)
+{
+	ELEKTRA_NOT_NULL (binding);
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	ELEKTRA_NOT_NULL (data);
+
+	pthread_mutex_lock (&data->lock);
+	int running = data->running || data->threadStarted;
+	pthread_mutex_unlock (&data->lock);
+	if (running)
+	{
+		ELEKTRA_LOG_WARNING ("loop is still running");
+		return 0;
+	}
+
+	ioEpollDataDel (data);
+	elektraFree (binding);
+	return 1;
+}
+
+/**
+ * @internal
+ * Register the timerfd or eventfd with epoll.
+ *
+ * @param  data  binding data
+ * @param  fd    file descriptor
+ * @param  index ELEKTRA_IO_EPOLL_WAKEUP or ELEKTRA_IO_EPOLL_TIMER
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+static int ioEpollWatchInternal (EpollBindingData * data, int fd, uint32_t index)
+{
+	struct epoll_event event = { 0 };
+	event.events = EPOLLIN;
+	event.data.u64 = index;
+	return epoll_ctl (data->epollFd, EPOLL_CTL_ADD, fd, &event) == 0;
+}
+
+/**
+ * Create and initialize a new I/O binding.
+ * @param  maxOperations maximum number of operations added at the same time
+ * @return               Populated I/O interface
+ */
+ElektraIoInterface * elektraIoEpollNew (size_t maxOperations)
+{
+	if (maxOperations == 0 || maxOperations >= ELEKTRA_IO_EPOLL_TIMER)
+	{
+		ELEKTRA_LOG_WARNING ("invalid number of operations: %zu", maxOperations);
+		return NULL;
+	}
+
+	EpollBindingData * data = elektraCalloc (sizeof (*data));
+	if (data == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("elektraCalloc failed");
+		return NULL;
+	}
+	data->epollFd = epoll_create1 (EPOLL_CLOEXEC);
+	data->timerFd = timerfd_create (CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	data->wakeupFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+	data->slots = elektraCalloc (maxOperations * sizeof (EpollSlot));
+
+	pthread_mutexattr_t attributes;
+	pthread_mutexattr_init (&attributes);
+	// callbacks may add, update and remove operations
+	pthread_mutexattr_settype (&attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init (&data->lock, &attributes);
+	pthread_mutexattr_destroy (&attributes);
+
+	if (data->epollFd == -1 || data->timerFd == -1 || data->wakeupFd == -1 || data->slots == NULL ||
+	    !ioEpollWatchInternal (data, data->wakeupFd, ELEKTRA_IO_EPOLL_WAKEUP) ||
+	    !ioEpollWatchInternal (data, data->timerFd, ELEKTRA_IO_EPOLL_TIMER))
+	{
+		ELEKTRA_LOG_WARNING ("could not initialize epoll: %s", strerror (errno));
+		ioEpollDataDel (data);
+		return NULL;
+	}
+
+	data->size = maxOperations;
+	for (size_t i = maxOperations; i > 0; --i)
+	{
+		data->slots[i - 1].next = data->free;
+		data->free = &data->slots[i - 1];
+	}
+	data->armed = ELEKTRA_IO_EPOLL_NEVER;
+	clock_gettime (CLOCK_MONOTONIC, &data->start);
+
+	// Initialize I/O interface
+	ElektraIoInterface * binding = elektraIoNewBinding (
+		// file descriptors
+		ioEpollBindingAddFd, ioEpollBindingUpdateFd, ioEpollBindingRemoveFd,
+		// timers
+		ioEpollBindingAddTimer, ioEpollBindingUpdateTimer, ioEpollBindingRemoveTimer,
+		// idle
+		ioEpollBindingAddIdle, ioEpollBindingUpdateIdle, ioEpollBindingRemoveIdle,
+		// cleanup
+		ioEpollBindingCleanup);
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("elektraIoNewBinding failed");
+		ioEpollDataDel (data);
+		return NULL;
+	}
+
+	elektraIoBindingSetData (binding, data);
+
+	return binding;
+}
+
+/**
+ * Run the loop in the calling thread.
+ * @see kdbio/epoll.h ::elektraIoEpollRun
+ */
+int elektraIoEpollRun (ElektraIoInterface * binding)
+{
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("binding was NULL");
+		return 0;
+	}
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+
+	pthread_mutex_lock (&data->lock);
+	if (data->running)
+	{
+		pthread_mutex_unlock (&data->lock);
+		ELEKTRA_LOG_WARNING ("loop is already running");
+		return 0;
+	}
+	data->running = 1;
+	data->loopThread = pthread_self ();
+	int result = ioEpollLoop (data);
+	pthread_mutex_unlock (&data->lock);
+	return result;
+}
+
+/**
+ * Stop the loop.
+ * @see kdbio/epoll.h ::elektraIoEpollStop
+ */
+int elektraIoEpollStop (ElektraIoInterface * binding)
+{
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("binding was NULL");
+		return 0;
+	}
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+
+	pthread_mutex_lock (&data->lock);
+	if (data->running)
+	{
+		data->stop = 1;
+		ioEpollWakeup (data);
+	}
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Run the loop in a background thread.
+ * @see kdbio/epoll.h ::elektraIoEpollStartThread
+ */
+int elektraIoEpollStartThread (ElektraIoInterface * binding)
+{
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("binding was NULL");
+		return 0;
+	}
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+
+	pthread_mutex_lock (&data->lock);
+	if (data->running || data->threadStarted)
+	{
+		pthread_mutex_unlock (&data->lock);
+		ELEKTRA_LOG_WARNING ("loop is already running");
+		return 0;
+	}
+	// the thread waits for the lock, so loopThread is set before it runs callbacks
+	if (pthread_create (&data->thread, NULL, ioEpollThread, data) != 0)
+	{
+		pthread_mutex_unlock (&data->lock);
+		ELEKTRA_LOG_WARNING ("could not start thread");
+		return 0;
+	}
+	data->running = 1;
+	data->threadStarted = 1;
+	data->loopThread = data->thread;
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Stop the background thread.
+ * @see kdbio/epoll.h ::elektraIoEpollStopThread
+ */
+int elektraIoEpollStopThread (ElektraIoInterface * binding)
+{
+	if (binding == NULL)
+	{
+		ELEKTRA_LOG_WARNING ("binding was NULL");
+		return 0;
+	}
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+
+	pthread_mutex_lock (&data->lock);
+	if (!data->threadStarted || pthread_equal (pthread_self (), data->thread))
+	{
+		pthread_mutex_unlock (&data->lock);
+		ELEKTRA_LOG_WARNING ("no thread to stop");
+		return 0;
+	}
+	pthread_t thread = data->thread;
+	if (data->running)
+	{
+		data->stop = 1;
+		ioEpollWakeup (data);
+	}
+	pthread_mutex_unlock (&data->lock);
+
+	pthread_join (thread, NULL);
+
+	pthread_mutex_lock (&data->lock);
+	data->threadStarted = 0;
+	pthread_mutex_unlock (&data->lock);
+	return 1;
+}
+
+/**
+ * Prevent callbacks from running.
+ * @see kdbio/epoll.h ::elektraIoEpollLock
+ */
+void elektraIoEpollLock (ElektraIoInterface * binding)
+{
+	ELEKTRA_NOT_NULL (binding);
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	pthread_mutex_lock (&data->lock);
+}
+
+/**
+ * Allow callbacks again.
+ * @see kdbio/epoll.h ::elektraIoEpollUnlock
+ */
+void elektraIoEpollUnlock (ElektraIoInterface * binding)
+{
+	ELEKTRA_NOT_NULL (binding);
+	EpollBindingData * data = elektraIoBindingGetData (binding);
+	pthread_mutex_unlock (&data->lock);
+}
@@ -0,0 +1,174 @@
+/**
+ * @file
+ *
+ * @brief Tests for I/O epoll binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <kdbhelper.h>
+#include <kdbio.h>
+#include <kdbiotest.h>
+#include <tests.h>
+
+#include <kdbio/epoll.h>
+
+#define TEST_OPERATIONS 16
+#define TEST_THREAD_TIMER_INTERVAL 10
+#define TEST_THREAD_TIMER_TIMES 3
+// wait at most 2 seconds for the background thread
+#define TEST_THREAD_WAIT_STEP 10
+#define TEST_THREAD_WAIT_STEPS 200
+
+#define FD_READ_END 0
+#define FD_WRITE_END 1
+
+ElektraIoInterface * binding;
+
+int testThreadTimerCalled;
+int testThreadFdCalled;
+
+static ElektraIoInterface * createBinding (void)
+{
+	// the test suite runs the binding created last
+	binding = elektraIoEpollNew (TEST_OPERATIONS);
+	return binding;
+}
+
+static void startLoop (void)
+{
+	elektraIoEpollRun (binding);
+}
+
+static void stopLoop (void)
+{
+	elektraIoEpollStop (binding);
+}
+
+static void testCallbackDummy (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+}
+
+static void test_maxOperations (void)
+{
+	printf ("test max operations\n");
+
+	ElektraIoInterface * small = elektraIoEpollNew (2);
+	exit_if_fail (small != NULL, "could not create binding");
+
+	ElektraIoTimerOperation * timerOps[3];
+	for (int i = 0; i < 3; ++i)
+	{
+		timerOps[i] = elektraIoNewTimerOperation (1000, 1, testCallbackDummy, NULL);
+	}
+	succeed_if (elektraIoBindingAddTimer (small, timerOps[0]), "addTimer did not succeed");
+	succeed_if (elektraIoBindingAddTimer (small, timerOps[1]), "addTimer did not succeed");
+	succeed_if (elektraIoBindingAddTimer (small, timerOps[2]) == 0, "addTimer should fail without free operations");
+
+	succeed_if (elektraIoBindingRemoveTimer (timerOps[0]), "removeTimer did not succeed");
+	succeed_if (elektraIoBindingAddTimer (small, timerOps[2]), "addTimer should reuse removed operation");
+
+	succeed_if (elektraIoBindingRemoveTimer (timerOps[1]), "removeTimer did not succeed");
+	succeed_if (elektraIoBindingRemoveTimer (timerOps[2]), "removeTimer did not succeed");
+	succeed_if (elektraIoBindingCleanup (small), "cleanup did not succeed");
+	for (int i = 0; i < 3; ++i)
+	{
+		elektraFree (timerOps[i]);
+	}
+
+	succeed_if (elektraIoEpollNew (0) == NULL, "binding without operations created");
+}
+
+static void testThreadTimer (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	++testThreadTimerCalled;
+}
+
+static void testThreadFd (ElektraIoFdOperation * fdOp, int flags)
+{
+	succeed_if (flags & ELEKTRA_IO_READABLE, "file descriptor not readable");
+	char buffer;
+	succeed_if (read (elektraIoFdGetFd (fdOp), &buffer, 1) == 1, "read failed");
+	++testThreadFdCalled;
+}
+
+static int testThreadCalled (int * counter)
+{
+	elektraIoEpollLock (binding);
+	int called = *counter;
+	elektraIoEpollUnlock (binding);
+	return called;
+}
+
+static void testThreadWait (int * counter, int times)
+{
+	for (int i = 0; i < TEST_THREAD_WAIT_STEPS && testThreadCalled (counter) < times; ++i)
+	{
+		usleep (TEST_THREAD_WAIT_STEP * 1000);
+	}
+}
+
+static void test_thread (void)
+{
+	printf ("test background thread\n");
+
+	int fds[2];
+	exit_if_fail (pipe (fds) == 0, "pipe() failed");
+
+	createBinding ();
+	exit_if_fail (binding != NULL, "could not create binding");
+	succeed_if (elektraIoEpollStartThread (binding), "could not start thread");
+	succeed_if (elektraIoEpollStartThread (binding) == 0, "started second thread");
+	succeed_if (elektraIoEpollRun (binding) == 0, "loop runs twice");
+
+	// operations are added while the loop waits in the background thread
+	testThreadTimerCalled = 0;
+	testThreadFdCalled = 0;
+	ElektraIoTimerOperation * timerOp = elektraIoNewTimerOperation (TEST_THREAD_TIMER_INTERVAL, 1, testThreadTimer, NULL);
+	ElektraIoFdOperation * fdOp = elektraIoNewFdOperation (fds[FD_READ_END], ELEKTRA_IO_READABLE, 1, testThreadFd, NULL);
+	succeed_if (elektraIoBindingAddTimer (binding, timerOp), "addTimer did not succeed");
+	succeed_if (elektraIoBindingAddFd (binding, fdOp), "addFd did not succeed");
+
+	testThreadWait (&testThreadTimerCalled, TEST_THREAD_TIMER_TIMES);
+	succeed_if (testThreadCalled (&testThreadTimerCalled) >= TEST_THREAD_TIMER_TIMES, "timer was not called by background thread");
+
+	succeed_if (write (fds[FD_WRITE_END], "x", 1) == 1, "write failed");
+	testThreadWait (&testThreadFdCalled, 1);
+	succeed_if (testThreadCalled (&testThreadFdCalled) == 1, "file descriptor callback was not called by background thread");
+
+	// after removal the callback is not called anymore
+	succeed_if (elektraIoBindingRemoveTimer (timerOp), "removeTimer did not succeed");
+	int called = testThreadCalled (&testThreadTimerCalled);
+	usleep (TEST_THREAD_TIMER_INTERVAL * 5 * 1000);
+	succeed_if (testThreadCalled (&testThreadTimerCalled) == called, "removed timer was called");
+
+	succeed_if (elektraIoBindingCleanup (binding) == 0, "cleanup while thread is running");
+	succeed_if (elektraIoEpollStopThread (binding), "could not stop thread");
+	succeed_if (elektraIoEpollStopThread (binding) == 0, "stopped thread twice");
+
+	succeed_if (elektraIoBindingRemoveFd (fdOp), "removeFd did not succeed");
+	succeed_if (elektraIoBindingCleanup (binding), "cleanup did not succeed");
+	elektraFree (timerOp);
+	elektraFree (fdOp);
+	close (fds[FD_READ_END]);
+	close (fds[FD_WRITE_END]);
+}
+
+int main (int argc, char ** argv)
+{
+	init (argc, argv);
+
+	elektraIoTestSuite (createBinding, startLoop, stopLoop);
+
+	test_maxOperations ();
+	test_thread ();
+
+	print_result ("iowrapper_epoll");
+
+	return nbError;
+}
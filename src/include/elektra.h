@@ -195,6 +195,25 @@ kdb_long_double_t elektraGetLongDoubleArrayElement (Elektra * elektra, const cha
 
 #endif
 
+const char * const * elektraGetStringArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_boolean_t * elektraGetBooleanArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_char_t * elektraGetCharArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_octet_t * elektraGetOctetArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_short_t * elektraGetShortArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_unsigned_short_t * elektraGetUnsignedShortArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_long_t * elektraGetLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_unsigned_long_t * elektraGetUnsignedLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_long_long_t * elektraGetLongLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_unsigned_long_long_t * elektraGetUnsignedLongLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_float_t * elektraGetFloatArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+const kdb_double_t * elektraGetDoubleArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+const kdb_long_double_t * elektraGetLongDoubleArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size);
+
+#endif
+
 // endregion Array-Getters
 
 // region Array-Setters
@@ -0,0 +1,69 @@
+/**
+ * @file
+ *
+ * @brief Declarations for the epoll I/O binding.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+#ifndef KDB_IOWRAPPER_EPOLL_H_
+#define KDB_IOWRAPPER_EPOLL_H_
+
+#include <kdbio.h>
+
+/**
+ * Create and initialize a new I/O binding with its own loop.
+ * All memory is allocated here, adding more than @p maxOperations operations fails.
+ * @param  maxOperations maximum number of operations added at the same time
+ * @return               Populated I/O interface
+ */
+ElektraIoInterface * elektraIoEpollNew (size_t maxOperations);
+
+/**
+ * Run the loop of the I/O binding in the calling thread until elektraIoEpollStop() is called.
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ * @retval 1 on success
+ * @retval 0 on error or if the loop is already running
+ */
+int elektraIoEpollRun (ElektraIoInterface * binding);
+
+/**
+ * Stop the loop of the I/O binding after the current callback.
+ * Can be called from any thread and from callbacks.
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+int elektraIoEpollStop (ElektraIoInterface * binding);
+
+/**
+ * Run the loop of the I/O binding in a new background thread.
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ * @retval 1 on success
+ * @retval 0 on error or if the loop is already running
+ */
+int elektraIoEpollStartThread (ElektraIoInterface * binding);
+
+/**
+ * Stop the loop started by elektraIoEpollStartThread() and wait for its thread.
+ * Must not be called from callbacks.
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ * @retval 1 on success
+ * @retval 0 on error or if no thread was started
+ */
+int elektraIoEpollStopThread (ElektraIoInterface * binding);
+
+/**
+ * Prevent callbacks of the I/O binding from running.
+ * Needed by other threads than the loop thread to change operations
+ * (e.g. elektraIoTimerSetEnabled()) that were added to the binding.
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ */
+void elektraIoEpollLock (ElektraIoInterface * binding);
+
+/**
+ * Allow callbacks again after elektraIoEpollLock().
+ * @param  binding I/O binding created by elektraIoEpollNew()
+ */
+void elektraIoEpollUnlock (ElektraIoInterface * binding);
+
+#endif
@@ -110,6 +110,25 @@ int elektraNotificationOpen (KDB * kdb);
  */
 int elektraNotificationClose (KDB * kdb);
 
+/**
+ * @ingroup kdbnotification
+ * Set the time window for coalescing reloads of changed keys.
+ *
+ * Transport plugins report every changed key.
+ * With a window of 0 (the default) each changed key is reloaded
+ * immediately using kdbGet().
+ * Otherwise keys changed within the window are collapsed to their common
+ * parent keys and each of them is reloaded once, after the window has
+ * passed.
+ * Coalescing requires an I/O binding, see elektraIoSetBinding().
+ *
+ * @param  kdb    KDB instance
+ * @param  window time window in milliseconds
+ * @retval 1 on success
+ * @retval 0 on error
+ */
+int elektraNotificationSetReloadWindow (KDB * kdb, unsigned int window);
+
 #define ELEKTRA_NOTIFICATION_REGISTER_NAME(TYPE_NAME) elektraNotificationRegister##TYPE_NAME
 
 #define ELEKTRA_NOTIFICATION_REGISTER_SIGNATURE(TYPE, TYPE_NAME)                                                                           \
@@ -194,6 +213,9 @@ int elektraNotificationRegisterCallback (KDB * kdb, Key * key, ElektraNotificati
  * @ingroup kdbnotification
  * Subscribe for updates via callback when a given key or a key below changed.
  *
+ * The callback is called when a key below was added, changed or removed.
+ * Removed keys are only noticed when their part of the hierarchy is read.
+ *
  * @param  handle   plugin handle
  * @param  key      key to watch for changes
  * @param  callback callback function
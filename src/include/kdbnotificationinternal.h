@@ -14,6 +14,7 @@
 #define KDB_NOTIFICATION_PLUGIN_H_
 
 #include "kdb.h"
+#include "kdbio.h"
 #include "kdbnotification.h"
 #include "kdbplugin.h"
 
@@ -130,10 +131,13 @@ typedef void (*ElektraNotificationCloseNotification) (Plugin * handle, KeySet *
 /**
  * Used by notification plugins to get values from the key database.
  *
- * @param  kdb        kdb handle
+ * Depending on the reload window of the context the values are read
+ * immediately or the changed key is scheduled for a coalesced reload.
+ *
+ * @param  context    callback context
  * @param  changedKey which key was updated
  */
-typedef void (*ElektraNotificationKdbUpdate) (KDB * kdb, Key * changedKey);
+typedef void (*ElektraNotificationKdbUpdate) (ElektraNotificationCallbackContext * context, Key * changedKey);
 
 /**
  * Private struct with information about for ElektraNotificationCallback.
@@ -148,6 +152,10 @@ struct _ElektraNotificationCallbackContext
 	ElektraNotificationKdbUpdate kdbUpdate; /*!< The pointer to the update function.*/
 
 	Plugin * notificationPlugin; /*!< Notification plugin handle.*/
+
+	unsigned int reloadWindow;	       /*!< Time in milliseconds changed keys are collected before reloading.*/
+	KeySet * pendingReloads;	       /*!< Parents of changed keys waiting for the reload.*/
+	ElektraIoTimerOperation * reloadTimer; /*!< Timer of the coalesced reload, NULL until first needed.*/
 };
 
 #ifdef __cplusplus
@@ -8,6 +8,8 @@
 #ifndef OPMPHM_H
 #define OPMPHM_H
 
+#include <kdbconfig.h>
+
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -42,20 +44,25 @@
 #define KDB_OPMPHM_MAX_N 795364313 // bound by opmphm->size max value
 #endif
 
+/**
+ * Minimal number of elements to build the OPMPHM with several threads,
+ * if Elektra was built with ENABLE_OPMPHM_PARALLEL.
+ */
+#define KDB_OPMPHM_PARALLEL_MIN_N 16384
+
 /**
  * The r-uniform r-partite hypergraph
  */
 typedef struct
 {
 	uint32_t order;      /*!< desired hash map return value */
-	uint32_t * nextEdge; /*!< arary with Opmphm->rUniPar indices of the next edge in the lists */
 	uint32_t * vertices; /*!< array with Opmphm->rUniPar indices of vertices that the edge connects */
 } OpmphmEdge;
 
 typedef struct
 {
-	uint32_t firstEdge; /*!< first edge in the list of edges of a vertex */
-	uint32_t degree;    /*!< length of the list */
+	uint32_t edgesXor; /*!< xor of the indices of all edges of a vertex, the only edge if degree is 1 */
+	uint32_t degree;   /*!< number of edges */
 } OpmphmVertex;
 
 typedef struct
@@ -64,6 +71,7 @@ typedef struct
 	OpmphmVertex * vertices;   /*!< array of all vertices */
 	uint32_t * removeSequence; /*!< remove sequence of acyclic r-uniform r-partite hypergraph */
 	uint32_t removeIndex;      /*!< the index used for insertion in removeSequence */
+	uint8_t * removed;	 /*!< array with a flag for every edge that is in removeSequence */
 } OpmphmGraph;
 
 /**
@@ -123,6 +131,43 @@ int opmphmIsBuild (const Opmphm * opmphm);
 int opmphmCopy (Opmphm * dest, const Opmphm * source);
 void opmphmClear (Opmphm * opmphm);
 
+/**
+ * Hash functions
+ *
+ * The hash function of the OPMPHM is selected at build time with ENABLE_OPMPHM_FAST_HASH:
+ * opmphmHashfunctionMxs (...), which reads 8 bytes at once, or opmphmHashfunctionJenkins (...).
+ */
+#ifdef ELEKTRA_OPMPHM_FAST_HASH
+#define opmphmHashfunction opmphmHashfunctionMxs
+#else
+#define opmphmHashfunction opmphmHashfunctionJenkins
+#endif
+
+/**
+ * Multiply-xorshift hash function
+ * Mixes every 8 bytes with a multiplication and a xorshift, finalized like splitmix64
+ */
+
+#define OPMPHM_HASHFUNCTION_MXS_K1 UINT64_C (0x9e3779b97f4a7c15)
+#define OPMPHM_HASHFUNCTION_MXS_K2 UINT64_C (0xbf58476d1ce4e5b9)
+#define OPMPHM_HASHFUNCTION_MXS_K3 UINT64_C (0x94d049bb133111eb)
+
+#define OPMPHM_HASHFUNCTION_MXS_MIX(h, w)                                                                                                  \
+	{                                                                                                                                  \
+		h = (h ^ (w)) * OPMPHM_HASHFUNCTION_MXS_K2;                                                                                \
+		h ^= h >> 32;                                                                                                              \
+	}
+
+#define OPMPHM_HASHFUNCTION_MXS_FINAL(h)                                                                                                   \
+	{                                                                                                                                  \
+		h ^= h >> 30;                                                                                                              \
+		h *= OPMPHM_HASHFUNCTION_MXS_K2;                                                                                           \
+		h ^= h >> 27;                                                                                                              \
+		h *= OPMPHM_HASHFUNCTION_MXS_K3;                                                                                           \
+		h ^= h >> 31;                                                                                                              \
+	}
+uint32_t opmphmHashfunctionMxs (const void * key, size_t length, uint32_t initval);
+
 /**
  * Hash function
  * By Bob Jenkins, May 2006
@@ -170,6 +215,6 @@ void opmphmClear (Opmphm * opmphm);
 		c ^= OPMPHM_HASHFUNCTION_ROT (b, 4);                                                                                       \
 		b += a;                                                                                                                    \
 	}
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval);
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval);
 
 #endif
@@ -71,6 +71,7 @@ typedef enum
 	ELEKTRA_PLUGIN_GET=1<<2,	/*!< Next arg is backend for kdbGet() */
 	ELEKTRA_PLUGIN_SET=1<<3,	/*!< Next arg is backend for kdbSet() */
 	ELEKTRA_PLUGIN_ERROR=1<<4,	/*!< Next arg is backend for kdbError() */
+	ELEKTRA_PLUGIN_GET_SUBTREE=1<<5,	/*!< Next arg is backend for kdbGet() of a subtree */
 	ELEKTRA_PLUGIN_END=0		/*!< End of arguments */
 	// clang-format on
 } plugin_t;
@@ -105,6 +106,9 @@ void * elektraPluginGetData (Plugin * plugin);
 
 KeySet * elektraPluginGetGlobalKeySet (Plugin * plugin);
 
+int elektraPluginDeferSync (Plugin * plugin, const char * filename);
+int elektraPluginDeferDirectorySync (Plugin * plugin, const char * dirname);
+
 #define PLUGINVERSION "1"
 
 
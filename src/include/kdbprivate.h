@@ -28,12 +28,17 @@
 #include <kdbglobal.h>
 
 #include <limits.h>
+#include <stdint.h>
 
 /** The minimal allocation size of a keyset inclusive
 	NULL byte. ksGetAlloc() will return one less because
 	it says how much can actually be stored.*/
 #define KEYSET_SIZE 16
 
+/** From this size on ksAppend() merges the appended keyset
+	in one pass instead of inserting key by key. */
+#define KEYSET_MERGE_SIZE 16
+
 /** How many plugins can exist in an backend. */
 #define NR_OF_PLUGINS 10
 
@@ -81,6 +86,7 @@ typedef int (*kdbClosePtr) (Plugin *, Key * errorKey);
 typedef int (*kdbGetPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
 typedef int (*kdbSetPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
 typedef int (*kdbErrorPtr) (Plugin * handle, KeySet * returned, Key * parentKey);
+typedef int (*kdbGetSubtreePtr) (Plugin * handle, KeySet * returned, Key * parentKey, Key * subtreeKey);
 
 
 typedef Backend * (*OpenMapper) (const char *, const char *, KeySet *);
@@ -140,11 +146,17 @@ typedef enum {
 			 This flag is set once a Key name has been moved to a mapped region,
 			 and is removed if the name moves out of the mapped region.
 			 It prevents erroneous free() calls on these keys. */
-	KEY_FLAG_MMAP_DATA = 1 << 6	/*!<
+	KEY_FLAG_MMAP_DATA = 1 << 6,	/*!<
 			 Key value lies inside a mmap region.
 			 This flag is set once a Key value has been moved to a mapped region,
 			 and is removed if the value moves out of the mapped region.
 			 It prevents erroneous free() calls on these keys. */
+	KEY_FLAG_ARENA_STRUCT = 1 << 7	/*!<
+			 Key struct lies inside an arena.
+			 This flag is set for Keys created by elektraArenaKeyNew().
+			 Instead of freeing the struct, keyDel() releases the arena.
+			 Name and value inside the arena are flagged with
+			 KEY_FLAG_MMAP_KEY and KEY_FLAG_MMAP_DATA. */
 } keyflag_t;
 
 
@@ -177,6 +189,11 @@ typedef enum {
 		 This flag is set for KeySets where the array is in a mapped region,
 		 and is removed if the array is moved out from the mapped region.
 		 It prevents erroneous free() calls on these arrays. */
+	,KS_FLAG_SHARED_META = 1 << 4	/*!<
+		 KeySet is the metadata of keys and has a reference counter.
+		 This flag is set for meta KeySets created by elektraMetaNew().
+		 Keys with the same metadata refer to the same KeySet,
+		 which is copied before it is changed, see elektraMetaUnshare(). */
 } ksflag_t;
 
 
@@ -235,6 +252,14 @@ struct _Key
 	 */
 	keyflag_t flags;
 
+	/**
+	 * Position of keyNextMeta() in the meta KeySet.
+	 * The metadata may be shared by several keys, so
+	 * every key has its own cursor.
+	 * 0 after keyRewindMeta().
+	 */
+	unsigned int metaCursor;
+
 	/**
 	 * In how many keysets the key resists.
 	 * keySetName() is only allowed if ksReference is 0.
@@ -272,6 +297,8 @@ struct _KeySet
 	struct _Key * cursor; /**< Internal cursor */
 	size_t current;		  /**< Current position of cursor */
 
+	uint64_t generation; /**< Changes whenever keys are added, replaced or removed, see ksGetGeneration() */
+
 	/**
 	 * Some control and internal flags.
 	 */
@@ -290,6 +317,55 @@ struct _KeySet
 };
 
 
+/**
+ * Number of buckets of the latency histograms of ElektraStatsCounter.
+ *
+ * Bucket b counts calls that took less than 2^b microseconds,
+ * the last bucket counts all slower calls.
+ */
+#define ELEKTRA_STATS_BUCKETS 20
+
+/**
+ * The phases recorded by the statistics.
+ *
+ * Plugins only use the first ELEKTRA_STATS_PLUGIN_PHASES
+ * phases, split and cache are recorded for the whole handle.
+ */
+typedef enum {
+	ELEKTRA_STATS_GET,
+	ELEKTRA_STATS_SET,
+	ELEKTRA_STATS_ERROR,
+	ELEKTRA_STATS_PLUGIN_PHASES,
+	ELEKTRA_STATS_SPLIT = ELEKTRA_STATS_PLUGIN_PHASES,
+	ELEKTRA_STATS_CACHE,
+	ELEKTRA_STATS_PHASES
+} ElektraStatsPhase;
+
+/**
+ * Call counts, latencies and key counts of one phase.
+ *
+ * @see elektraStatsEnable()
+ */
+typedef struct _ElektraStatsCounter
+{
+	size_t calls;
+	size_t keysIn;			     /*!< sum of the sizes of the keysets passed in */
+	size_t keysOut;			     /*!< sum of the sizes of the keysets returned */
+	uint64_t nanoseconds;		     /*!< sum of the durations of all calls */
+	uint64_t maxNanoseconds;	     /*!< duration of the slowest call */
+	size_t histogram[ELEKTRA_STATS_BUCKETS]; /*!< see ELEKTRA_STATS_BUCKETS */
+} ElektraStatsCounter;
+
+/**
+ * Statistics of a KDB handle, only allocated if enabled.
+ *
+ * The counters of the plugins are in the plugins themselves.
+ */
+typedef struct _ElektraStats
+{
+	ElektraStatsCounter phases[ELEKTRA_STATS_PHASES - ELEKTRA_STATS_PLUGIN_PHASES]; /*!< split and cache */
+} ElektraStats;
+
 /**
  * The access point to the key database.
  *
@@ -329,6 +405,15 @@ struct _KDB
 	KeySet * global; /*!< This keyset can be used by plugins to pass data through
 			the KDB and communicate with other plugins. Plugins shall clean
 			up their parts of the global keyset, which they do not need any more.*/
+
+	ElektraStats * stats; /*!< Statistics of kdbGet() and kdbSet(), NULL if disabled.
+			@see elektraStatsEnable() */
+
+	int groupCommit; /*!< 1 if kdbSet() syncs the files of all backends together.
+			@see elektraGroupCommitEnable() */
+
+	KeySet * pendingSyncs; /*!< Files and directories to sync during the group commit of kdbSet(),
+			NULL otherwise. */
 };
 
 
@@ -375,6 +460,10 @@ struct _Backend
 		-1 if still uninitialized.
 		Needed to know if a key was removed from a keyset. */
 
+	KeySet * subtrees; /*!< The subtrees read by the previous get, at most one
+		key per namespace. The value of a key is the resolved file name.
+		Namespaces without key were read completely. */
+
 	size_t refcounter; /*!< This refcounter shows how often the backend
 	   is used.  Not cascading or default backends have 1 in it.
 	   More than three is not possible, because a backend
@@ -410,6 +499,9 @@ struct _Plugin
 	kdbSetPtr kdbSet;	  /*!< The pointer to kdbSet_template() of the backend. */
 	kdbErrorPtr kdbError; /*!< The pointer to kdbError_template() of the backend. */
 
+	kdbGetSubtreePtr kdbGetSubtree; /*!< The pointer to the get function for subtrees of storage plugins.
+	 It reads only the keys same or below its subtreeKey, 0 if not supported. */
+
 	const char * name; /*!< The name of the module responsible for that plugin. */
 
 	size_t refcounter; /*!< This refcounter shows how often the plugin
@@ -421,6 +513,12 @@ struct _Plugin
 	KeySet * global; /*!< This keyset can be used by plugins to pass data through
 			the KDB and communicate with other plugins. Plugins shall clean
 			up their parts of the global keyset, which they do not need any more.*/
+
+	ElektraStatsCounter * stats; /*!< Counters for get, set and error, only allocated if
+			statistics are enabled. @see elektraStatsEnable() */
+
+	KeySet * pendingSyncs; /*!< The pending syncs of the KDB during the group commit of kdbSet(),
+			NULL otherwise. @see elektraPluginDeferSync() */
 };
 
 
@@ -514,9 +612,12 @@ Backend * backendOpen (KeySet * elektra_config, KeySet * modules, KeySet * globa
 Backend * backendOpenDefault (KeySet * modules, KeySet * global, const char * file, Key * errorKey);
 Backend * backendOpenModules (KeySet * modules, KeySet * global, Key * errorKey);
 Backend * backendOpenVersion (KeySet * global, Key * errorKey);
+Backend * backendOpenStats (KDB * handle, Key * errorKey);
 int backendClose (Backend * backend, Key * errorKey);
 
 int backendUpdateSize (Backend * backend, Key * parent, int size);
+Key * backendGetSubtree (Backend * backend, Key * parent);
+void backendSetSubtree (Backend * backend, Key * parent, Key * subtree);
 
 /*Plugin handling*/
 Plugin * elektraPluginOpen (const char * backendname, KeySet * modules, KeySet * config, Key * errorKey);
@@ -529,6 +630,7 @@ Plugin * elektraPluginFindGlobal (KDB * handle, const char * pluginName);
 
 Plugin * elektraPluginMissing (void);
 Plugin * elektraPluginVersion (void);
+Plugin * elektraPluginStats (KDB * handle);
 
 /*Trie handling*/
 int trieClose (Trie * trie, Key * errorKey);
@@ -540,6 +642,7 @@ int mountOpen (KDB * kdb, KeySet * config, KeySet * modules, Key * errorKey);
 int mountDefault (KDB * kdb, KeySet * modules, int inFallback, Key * errorKey);
 int mountModules (KDB * kdb, KeySet * modules, Key * errorKey);
 int mountVersion (KDB * kdb, Key * errorKey);
+int mountStats (KDB * kdb, Key * errorKey);
 int mountGlobals (KDB * kdb, KeySet * keys, KeySet * modules, Key * errorKey);
 int mountBackend (KDB * kdb, Backend * backend, Key * errorKey);
 
@@ -566,12 +669,29 @@ int elektraKeyLock (Key * key, enum elektraLockOptions what);
 
 ssize_t ksSearchInternal (const KeySet * ks, const Key * toAppend);
 
+/*Shared metadata of keys*/
+KeySet * elektraMetaNew (void);
+KeySet * elektraMetaRef (KeySet * meta);
+int elektraMetaUnshare (Key * key);
+void elektraMetaUpdateCursor (Key * key);
+void elektraMetaDel (KeySet * meta);
+
+/*Arena allocation of keys, used by storage plugins*/
+typedef struct _ElektraArena ElektraArena;
+
+ElektraArena * elektraArenaNew (size_t blockSize);
+void elektraArenaDel (ElektraArena * arena);
+Key * elektraArenaKeyNew (ElektraArena * arena, const char * name, const void * value, size_t valueSize);
+void elektraArenaKeyRelease (Key * key);
+
 /*Used for internal memcpy/memmove*/
 ssize_t elektraMemcpy (Key ** array1, Key ** array2, size_t size);
 ssize_t elektraMemmove (Key ** array1, Key ** array2, size_t size);
 
 ssize_t elektraFinalizeName (Key * key);
 ssize_t elektraFinalizeEmptyName (Key * key);
+size_t elektraCanonicalKeyNameSize (const char * name);
+ssize_t elektraFinalizeCanonicalName (Key * key);
 
 char * elektraEscapeKeyNamePart (const char * source, char * dest);
 
@@ -606,6 +726,16 @@ int elektraGlobalGet (KDB * handle, KeySet * ks, Key * parentKey, int position,
 int elektraGlobalSet (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 int elektraGlobalError (KDB * handle, KeySet * ks, Key * parentKey, int position, int subPosition);
 
+/* statistics */
+int elektraStatsPluginGet (Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginSet (Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginError (Plugin * plugin, KeySet * ks, Key * parentKey);
+int elektraStatsPluginGetSubtree (Plugin * plugin, KeySet * ks, Key * parentKey, Key * subtreeKey);
+void elektraStatsAttach (KDB * handle);
+uint64_t elektraStatsStart (KDB * handle);
+void elektraStatsStop (KDB * handle, ElektraStatsPhase phase, uint64_t start);
+int elektraStatsToKeySet (KDB * handle, KeySet * returned, Key * parentKey);
+
 /** Test a bit. @see set_bit(), clear_bit() */
 #define test_bit(var, bit) ((var) & (bit))
 /** Set a bit. @see clear_bit() */
@@ -636,6 +766,49 @@ typedef enum
 typedef const char * ElektraKDBErrorGroup;
 typedef const char * ElektraKDBErrorModule;
 
+/**
+ * A value of the high-level API, which was already converted from its string.
+ */
+typedef union
+{
+	const char * stringValue;
+	kdb_boolean_t booleanValue;
+	kdb_char_t charValue;
+	kdb_octet_t octetValue;
+	kdb_short_t shortValue;
+	kdb_unsigned_short_t unsignedShortValue;
+	kdb_long_t longValue;
+	kdb_unsigned_long_t unsignedLongValue;
+	kdb_long_long_t longLongValue;
+	kdb_unsigned_long_long_t unsignedLongLongValue;
+	kdb_float_t floatValue;
+	kdb_double_t doubleValue;
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+	kdb_long_double_t longDoubleValue;
+#endif
+} ElektraDecodedValue;
+
+/**
+ * Entry of the decoded value cache of an Elektra instance.
+ *
+ * The type fields point to one of the KDB_TYPE_* constants, they are
+ * NULL, if the key (or array) was not decoded yet.
+ */
+typedef struct
+{
+	char * name; /*!< the name relative to the parent key, as passed to the getters */
+	size_t hash;
+	const Key * key; /*!< the key found for the name */
+	int precedence;	 /*!< namespace of @c key while the cache is built, -1 if a spec key exists */
+
+	KDBType type; /*!< type of the scalar value */
+	ElektraDecodedValue value;
+
+	KDBType arrayType; /*!< type of the array elements */
+	void * array;	   /*!< the elements one after another, NULL if they can't be decoded */
+	kdb_long_long_t arraySize;
+} ElektraCachedValue;
+
 struct _Elektra
 {
 	KDB * kdb;
@@ -646,6 +819,10 @@ struct _Elektra
 	ElektraErrorHandler fatalErrorHandler;
 	char * resolvedReference;
 	size_t parentKeyLength;
+
+	ElektraCachedValue * cache; /*!< hash table of decoded values, open addressing */
+	size_t cacheSize;
+	size_t cacheUsed;
 };
 
 struct _ElektraError
@@ -673,6 +850,11 @@ struct _ElektraKDBError
 void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error);
 void elektraSetLookupKey (Elektra * elektra, const char * name);
 void elektraSetArrayLookupKey (Elektra * elektra, const char * name, kdb_long_long_t index);
+
+void elektraValueCacheBuild (Elektra * elektra);
+void elektraValueCacheClear (Elektra * elektra);
+const ElektraCachedValue * elektraValueCacheGet (Elektra * elektra, const char * name, KDBType type);
+const ElektraCachedValue * elektraValueCacheGetArray (Elektra * elektra, const char * name, KDBType type);
 ElektraError * elektraErrorCreate (ElektraErrorCode code, const char * description, ElektraErrorSeverity severity);
 
 // error handling unstable/private for now
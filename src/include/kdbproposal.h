@@ -67,6 +67,9 @@ KeySet * elektraKeyGetMetaKeySet (const Key * key);
 
 Key * ksPrev (KeySet * ks);
 Key * ksPopAtCursor (KeySet * ks, cursor_t c);
+ssize_t ksFindHierarchy (const KeySet * ks, const Key * root, size_t * end);
+ssize_t ksShareMeta (KeySet * ks);
+uint64_t ksGetGeneration (const KeySet * ks);
 
 
 typedef enum
@@ -89,6 +92,9 @@ int keyRel2 (const Key * k1, const Key * k2, KeyRelType which);
 Key * keyAsCascading (const Key * key);
 int keyGetLevelsBelow (const Key * k1, const Key * k2);
 
+int elektraStatsEnable (KDB * handle, int enable);
+int elektraGroupCommitEnable (KDB * handle, int enable);
+
 #ifdef __cplusplus
 }
 }
@@ -0,0 +1,219 @@
+/**
+ * @file
+ *
+ * @brief Arena allocation of keys.
+ *
+ * Storage plugins create many keys at once, which all live until the
+ * KeySet they were returned in is deleted. An arena carves the key
+ * structs, names and values out of large blocks instead of doing
+ * several allocations per key.
+ *
+ * Keys of an arena stay fully mutable: names and values are copied out
+ * of the arena as soon as they are changed (they are flagged like keys
+ * in a mmap region). Every key holds a reference to the block it was
+ * allocated from, a block is freed when its last key was deleted and the
+ * arena does not allocate from it anymore. So a key that outlives the
+ * others only keeps its own block alive, which is at most
+ * ELEKTRA_ARENA_MAX_BLOCK_SIZE bytes. Keys of one arena may be deleted
+ * in different threads, the references are counted atomically.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "kdbconfig.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "kdbinternal.h"
+
+#define ELEKTRA_ARENA_BLOCK_SIZE (64 * 1024)
+#define ELEKTRA_ARENA_MAX_BLOCK_SIZE (256 * 1024)
+
+typedef struct _ElektraArenaBlock
+{
+	size_t size;
+	size_t used;
+	size_t references; /*!< one for every key and one for the arena, while it allocates from this block */
+} ElektraArenaBlock;
+
+struct _ElektraArena
+{
+	ElektraArenaBlock * current; /*!< the block new keys are allocated from */
+	size_t blockSize;
+};
+
+/**
+ * @internal
+ *
+ * Key struct of an arena, the key must stay the last member,
+ * so that the block can be found from a key.
+ */
+typedef struct
+{
+	ElektraArenaBlock * block;
+	struct _Key key;
+} ElektraArenaKey;
+
+#define ELEKTRA_ARENA_ALIGN(size) (((size) + sizeof (void *) - 1) & ~(sizeof (void *) - 1))
+
+/**
+ * @brief Create a new arena
+ *
+ * @param blockSize the size of the first block, 0 for the default
+ *
+ * @return the new arena, which has to be released with elektraArenaDel()
+ * @retval NULL on memory errors
+ */
+ElektraArena * elektraArenaNew (size_t blockSize)
+{
+	ElektraArena * arena = elektraCalloc (sizeof (ElektraArena));
+	if (!arena) return NULL;
+
+	arena->blockSize = blockSize > 0 ? blockSize : ELEKTRA_ARENA_BLOCK_SIZE;
+	return arena;
+}
+
+static void elektraArenaBlockRelease (ElektraArenaBlock * block)
+{
+	if (__atomic_sub_fetch (&block->references, 1, __ATOMIC_ACQ_REL) > 0) return;
+	elektraFree (block);
+}
+
+static ElektraArenaBlock * elektraArenaBlockNew (size_t size)
+{
+	ElektraArenaBlock * block = elektraMalloc (ELEKTRA_ARENA_ALIGN (sizeof (ElektraArenaBlock)) + size);
+	if (!block) return NULL;
+	block->size = size;
+	block->used = 0;
+	block->references = 1;
+	return block;
+}
+
+/**
+ * @brief Release the arena
+ *
+ * No further keys can be created. The memory of the keys created by
+ * elektraArenaKeyNew() is freed once they were deleted as well.
+ *
+ * @param arena the arena to release
+ */
+void elektraArenaDel (ElektraArena * arena)
+{
+	if (!arena) return;
+	if (arena->current) elektraArenaBlockRelease (arena->current);
+	elektraFree (arena);
+}
+
+/**
+ * @internal
+ *
+ * Allocates the memory of a key, its name and its value.
+ * All of it lies in one block and holds one reference on the block.
+ *
+ * @param size the number of bytes, already aligned
+ * @param [out] block the block the memory was allocated from
+ *
+ * @return the memory
+ * @retval NULL on memory errors
+ */
+static void * elektraArenaAlloc (ElektraArena * arena, size_t size, ElektraArenaBlock ** block)
+{
+	ElektraArenaBlock * current = arena->current;
+	if (!current || current->size - current->used < size)
+	{
+		if (size > arena->blockSize / 4)
+		{
+			// large keys get a block of their own, so the current block can still be used
+			*block = elektraArenaBlockNew (size);
+			if (!*block) return NULL;
+			(*block)->used = size;
+			return (char *) *block + ELEKTRA_ARENA_ALIGN (sizeof (ElektraArenaBlock));
+		}
+
+		current = elektraArenaBlockNew (arena->blockSize);
+		if (!current) return NULL;
+		if (arena->current) elektraArenaBlockRelease (arena->current);
+		arena->current = current;
+		if (arena->blockSize < ELEKTRA_ARENA_MAX_BLOCK_SIZE)
+		{
+			arena->blockSize *= 2;
+		}
+	}
+
+	__atomic_add_fetch (&current->references, 1, __ATOMIC_RELAXED);
+	void * memory = (char *) current + ELEKTRA_ARENA_ALIGN (sizeof (ElektraArenaBlock)) + current->used;
+	current->used += size;
+	*block = current;
+	return memory;
+}
+
+/**
+ * @brief Create a new key inside an arena
+ *
+ * The key behaves like a key created by keyNew() with the given name
+ * and keySetRaw() with the given value.
+ *
+ * @param arena the arena to allocate from
+ * @param name the name of the new key
+ * @param value the value of the new key, may be NULL
+ * @param valueSize the size of the value (including the null terminator of strings)
+ *
+ * @return the new key
+ * @retval NULL on invalid names or memory errors
+ */
+Key * elektraArenaKeyNew (ElektraArena * arena, const char * name, const void * value, size_t valueSize)
+{
+	if (!arena || !name) return NULL;
+
+	const size_t canonicalSize = elektraCanonicalKeyNameSize (name);
+	const size_t keySize = ELEKTRA_ARENA_ALIGN (sizeof (ElektraArenaKey));
+	const size_t nameSize = ELEKTRA_ARENA_ALIGN (canonicalSize * 2);
+	if (!value) valueSize = 0;
+
+	ElektraArenaBlock * block;
+	char * memory = elektraArenaAlloc (arena, keySize + nameSize + ELEKTRA_ARENA_ALIGN (valueSize), &block);
+	if (!memory) return NULL;
+
+	ElektraArenaKey * arenaKey = (ElektraArenaKey *) memory;
+	Key * key = &arenaKey->key;
+	keyInit (key);
+	arenaKey->block = block;
+	key->flags = KEY_FLAG_ARENA_STRUCT;
+
+	if (canonicalSize > 0)
+	{
+		key->keySize = canonicalSize;
+		key->key = memory + keySize;
+		memcpy (key->key, name, canonicalSize);
+		key->flags |= KEY_FLAG_MMAP_KEY;
+		elektraFinalizeCanonicalName (key);
+	}
+	else if (keySetName (key, name) == -1)
+	{
+		keyDel (key);
+		return NULL;
+	}
+
+	if (valueSize > 0)
+	{
+		key->data.v = memory + keySize + nameSize;
+		memcpy (key->data.v, value, valueSize);
+		key->dataSize = valueSize;
+		key->flags |= KEY_FLAG_MMAP_DATA;
+	}
+
+	return key;
+}
+
+/**
+ * @internal
+ *
+ * Releases the reference a key created by elektraArenaKeyNew()
+ * holds on its block. Called by keyDel().
+ */
+void elektraArenaKeyRelease (Key * key)
+{
+	ElektraArenaKey * arenaKey = (ElektraArenaKey *) ((char *) key - offsetof (ElektraArenaKey, key));
+	elektraArenaBlockRelease (arenaKey->block);
+}
@@ -400,6 +400,31 @@ Backend * backendOpenVersion (KeySet * global, Key * errorKey ELEKTRA_UNUSED)
 	return backend;
 }
 
+Backend * backendOpenStats (KDB * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	Backend * backend = elektraBackendAllocate ();
+
+	Plugin * plugin = elektraPluginStats (handle);
+	if (!plugin)
+	{
+		/* Could not allocate plugin */
+		elektraFree (backend);
+		return 0;
+	}
+	plugin->global = handle->global;
+
+	Key * mp = keyNew ("system/elektra/stats", KEY_VALUE, "stats", KEY_END);
+
+	backend->getplugins[0] = plugin;
+	backend->setplugins[0] = plugin;
+	plugin->refcounter = 2;
+
+	backend->mountpoint = mp;
+	keyIncRef (backend->mountpoint);
+
+	return backend;
+}
+
 
 /**
  * @brief Update internal size in backend
@@ -446,6 +471,47 @@ int backendUpdateSize (Backend * backend, Key * parent, int size)
 	return 0;
 }
 
+/**
+ * @brief Get the subtree the previous get read from a backend
+ *
+ * @param backend the backend to look in
+ * @param parent the namespace of this key is looked for
+ *
+ * @retval 0 if the namespace was read completely (or not at all)
+ * @return the key of the subtree, its value is the resolved file name
+ */
+Key * backendGetSubtree (Backend * backend, Key * parent)
+{
+	if (!backend->subtrees) return 0;
+
+	const elektraNamespace ns = keyGetNamespace (parent);
+	Key * subtree;
+	ksRewind (backend->subtrees);
+	while ((subtree = ksNext (backend->subtrees)) != 0)
+	{
+		if (keyGetNamespace (subtree) == ns) return subtree;
+	}
+	return 0;
+}
+
+/**
+ * @brief Remember the subtree a get read from a backend
+ *
+ * @param backend the backend to update
+ * @param parent the namespace of this key is updated
+ * @param subtree the subtree which was read, 0 if everything was read.
+ *        A duplicate is stored.
+ */
+void backendSetSubtree (Backend * backend, Key * parent, Key * subtree)
+{
+	Key * previous = backendGetSubtree (backend, parent);
+	if (previous) keyDel (ksLookup (backend->subtrees, previous, KDB_O_POP));
+	if (!subtree) return;
+
+	if (!backend->subtrees) backend->subtrees = ksNew (0, KS_END);
+	ksAppendKey (backend->subtrees, keyDup (subtree));
+}
+
 int backendClose (Backend * backend, Key * errorKey)
 {
 	int errorOccurred = 0;
@@ -460,6 +526,7 @@ int backendClose (Backend * backend, Key * errorKey)
 	keyDecRef (backend->mountpoint);
 	keySetName (errorKey, keyName (backend->mountpoint));
 	keyDel (backend->mountpoint);
+	ksDel (backend->subtrees);
 
 	for (int i = 0; i < NR_OF_PLUGINS; ++i)
 	{
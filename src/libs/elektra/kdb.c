@@ -6,6 +6,7 @@
  * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
  */
 
+#define _GNU_SOURCE // sync_file_range
 
 #ifdef HAVE_KDBCONFIG_H
 #include "kdbconfig.h"
@@ -45,6 +46,12 @@
 #include <errno.h>
 #endif
 
+#ifdef HAVE_UNISTD_H
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 #include <kdbinternal.h>
 
 
@@ -194,13 +201,12 @@ int elektraOpenBootstrap (KDB * handle, KeySet * keys, Key * errorKey)
 		fallbackret = kdbGet (handle, keys, errorKey);
 		keySetName (errorKey, "system/elektra/mountpoints");
 
-		KeySet * cutKeys = ksCut (keys, errorKey);
-		if (fallbackret == 1 && ksGetSize (cutKeys) != 0)
+		size_t end;
+		ssize_t start = ksFindHierarchy (keys, errorKey, &end);
+		if (fallbackret == 1 && start >= 0 && (size_t) start < end)
 		{
 			funret = 2;
 		}
-		ksAppend (keys, cutKeys);
-		ksDel (cutKeys);
 	}
 
 	if (ret == -1 && fallbackret == -1)
@@ -358,6 +364,9 @@ KDB * kdbOpen (Key * errorKey)
 	keySetString (errorKey, "kdbOpen(): mountVersion");
 	mountVersion (handle, errorKey);
 
+	keySetString (errorKey, "kdbOpen(): mountStats");
+	mountStats (handle, errorKey);
+
 	keySetString (errorKey, "kdbOpen(): mountModules");
 	if (mountModules (handle, handle->modules, errorKey) == -1)
 	{
@@ -438,6 +447,8 @@ int kdbClose (KDB * handle, Key * errorKey)
 
 	if (handle->global) ksDel (handle->global);
 
+	elektraFree (handle->stats);
+
 	elektraFree (handle);
 
 	keySetName (errorKey, keyName (initialParent));
@@ -447,6 +458,93 @@ int kdbClose (KDB * handle, Key * errorKey)
 	return 0;
 }
 
+/**
+ * @internal
+ *
+ * @brief The subtree of a backend, which is requested by kdbGet()
+ *
+ * Only storage plugins exporting a kdbGetSubtree() function can read
+ * subtrees. A cascading @p initialParent is resolved in the namespace
+ * of the backend.
+ *
+ * @retval 0 if the whole backend needs to be read
+ * @return a new key with the name of the subtree and the file name of the backend as value
+ */
+static Key * elektraGetSubtreeRequested (Split * split, size_t i, Key * initialParent)
+{
+	Plugin * storage = split->handles[i]->getplugins[STORAGE_PLUGIN];
+	if (!storage || !storage->kdbGetSubtree) return 0;
+
+	Key * subtree = 0;
+	if (keyGetNamespace (initialParent) == KEY_NS_CASCADING)
+	{
+		const char * parentName = keyName (split->parents[i]);
+		const size_t namespaceSize = strcspn (parentName, "/");
+		char * name = elektraMalloc (namespaceSize + keyGetNameSize (initialParent));
+		memcpy (name, parentName, namespaceSize);
+		strcpy (name + namespaceSize, keyName (initialParent));
+		subtree = keyNew (name, KEY_VALUE, keyString (split->parents[i]), KEY_END);
+		elektraFree (name);
+	}
+	else
+	{
+		subtree = keyNew (keyName (initialParent), KEY_VALUE, keyString (split->parents[i]), KEY_END);
+	}
+
+	if (!keyIsBelow (split->parents[i], subtree))
+	{
+		keyDel (subtree);
+		return 0;
+	}
+	return subtree;
+}
+
+/**
+ * @internal
+ *
+ * @brief Check if the keys of a backend, which kdbGet() requests, were read by the previous kdbGet()
+ *
+ * @retval 1 if the requested keys were read already
+ * @retval 0 if they need to be read
+ */
+static int elektraGetSubtreeCovered (Split * split, size_t i, Key * initialParent)
+{
+	Key * previous = backendGetSubtree (split->handles[i], split->parents[i]);
+	if (!previous) return 1;
+
+	Key * requested = elektraGetSubtreeRequested (split, i, initialParent);
+	int covered = requested && keyIsBelowOrSame (previous, requested);
+	keyDel (requested);
+	return covered;
+}
+
+/**
+ * @internal
+ *
+ * @brief Calls the storage plugin of a backend
+ *
+ * Only the requested subtree is read if the storage plugin supports it.
+ * The read subtree is remembered for the next kdbGet() and kdbSet().
+ *
+ * @param cacheData set to zero if only a subtree was read
+ *
+ * @return the return value of the storage plugin
+ */
+static int elektraGetStorage (Split * split, size_t i, Key * parentKey, Key * initialParent, int * cacheData)
+{
+	Backend * backend = split->handles[i];
+	Plugin * storage = backend->getplugins[STORAGE_PLUGIN];
+	Key * subtree = elektraGetSubtreeRequested (split, i, initialParent);
+	backendSetSubtree (backend, split->parents[i], subtree);
+	if (!subtree) return elektraStatsPluginGet (storage, split->keysets[i], parentKey);
+
+	// the cache always holds the complete backends
+	*cacheData = 0;
+	int ret = elektraStatsPluginGetSubtree (storage, split->keysets[i], parentKey, subtree);
+	keyDel (subtree);
+	return ret;
+}
+
 /**
  * @internal
  *
@@ -457,7 +555,7 @@ int kdbClose (KDB * handle, Key * errorKey)
  * @retval 0 no update needed
  * @retval number of plugins which need update
  */
-static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
+static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey, Key * initialParent)
 {
 	int updateNeededOccurred = 0;
 	size_t cacheHits = 0;
@@ -473,7 +571,7 @@ static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
 			ksRewind (split->keysets[i]);
 			keySetName (parentKey, keyName (split->parents[i]));
 			keySetString (parentKey, "");
-			ret = resolver->kdbGet (resolver, split->keysets[i], parentKey);
+			ret = elektraStatsPluginGet (resolver, split->keysets[i], parentKey);
 			// store resolved filename
 			keySetString (split->parents[i], keyString (parentKey));
 			// no keys in that backend
@@ -496,7 +594,12 @@ static int elektraGetCheckUpdateNeeded (Split * split, Key * parentKey)
 			++updateNeededOccurred;
 			break;
 		case ELEKTRA_PLUGIN_STATUS_NO_UPDATE:
-			// Nothing to do here
+			// Nothing to do here, unless the previous get only read another subtree
+			if (!elektraGetSubtreeCovered (split, i, initialParent))
+			{
+				set_bit (split->syncbits[i], SPLIT_FLAG_SYNC);
+				++updateNeededOccurred;
+			}
 			break;
 		default:
 			ELEKTRA_ASSERT (0, "resolver did not return 1 0 -1, but %d", ret);
@@ -529,7 +632,7 @@ typedef enum
  * @retval -1 on error
  * @retval 0 on success
  */
-static int elektraGetDoUpdate (Split * split, Key * parentKey, int * cacheData)
+static int elektraGetDoUpdate (Split * split, Key * parentKey, Key * initialParent, int * cacheData)
 {
 	const int bypassedSplits = 1;
 	for (size_t i = 0; i < split->size - bypassedSplits; i++)
@@ -552,7 +655,14 @@ static int elektraGetDoUpdate (Split * split, Key * parentKey, int * cacheData)
 				// TODO: cache is currently incompatible with ini (see #2592)
 				if (elektraStrCmp (backend->getplugins[p]->name, "ini") == 0) *cacheData = 0;
 
-				ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
+				if (p == STORAGE_PLUGIN)
+				{
+					ret = elektraGetStorage (split, i, parentKey, initialParent, cacheData);
+				}
+				else
+				{
+					ret = elektraStatsPluginGet (backend->getplugins[p], split->keysets[i], parentKey);
+				}
 			}
 
 			if (ret == -1)
@@ -641,24 +751,21 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 			{
 				keySetName (parentKey, keyName (initialParent));
 				ksRewind (ks);
-				handle->globalPlugins[PROCGETSTORAGE][FOREACH]->kdbGet (handle->globalPlugins[PROCGETSTORAGE][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle->globalPlugins[PROCGETSTORAGE][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 			if (p == (STORAGE_PLUGIN + 2) && handle->globalPlugins[POSTGETSTORAGE][FOREACH])
 			{
 				keySetName (parentKey, keyName (initialParent));
 				ksRewind (ks);
-				handle->globalPlugins[POSTGETSTORAGE][FOREACH]->kdbGet (handle->globalPlugins[POSTGETSTORAGE][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle->globalPlugins[POSTGETSTORAGE][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 			else if (p == (NR_OF_PLUGINS - 1) && handle->globalPlugins[POSTGETCLEANUP][FOREACH])
 			{
 				keySetName (parentKey, keyName (initialParent));
 				ksRewind (ks);
-				handle->globalPlugins[POSTGETCLEANUP][FOREACH]->kdbGet (handle->globalPlugins[POSTGETCLEANUP][FOREACH], ks,
-											parentKey);
+				elektraStatsPluginGet (handle->globalPlugins[POSTGETCLEANUP][FOREACH], ks, parentKey);
 				keySetName (parentKey, keyName (split->parents[i]));
 			}
 
@@ -675,12 +782,19 @@ static int elektraGetDoUpdateWithGlobalHooks (KDB * handle, Split * split, KeySe
 						continue;
 					}
 
-					ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], split->keysets[i], parentKey);
+					if (p == STORAGE_PLUGIN)
+					{
+						ret = elektraGetStorage (split, i, parentKey, initialParent, cacheData);
+					}
+					else
+					{
+						ret = elektraStatsPluginGet (backend->getplugins[p], split->keysets[i], parentKey);
+					}
 				}
 				else
 				{
 					KeySet * cutKS = prepareGlobalKS (ks, parentKey);
-					ret = backend->getplugins[p]->kdbGet (backend->getplugins[p], cutKS, parentKey);
+					ret = elektraStatsPluginGet (backend->getplugins[p], cutKS, parentKey);
 					ksAppend (ks, cutKS);
 					ksDel (cutKS);
 				}
@@ -804,6 +918,11 @@ static int elektraCacheLoadSplit (KDB * handle, Split * split, KeySet * ks, KeyS
 
 	ELEKTRA_LOG_DEBUG ("CACHE HIT");
 	if (splitCacheLoadState (split, handle->global) != 0) return -1;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		// the cache holds complete backends
+		backendSetSubtree (split->handles[i], split->parents[i], 0);
+	}
 
 	if (debugGlobalPositions)
 	{
@@ -954,6 +1073,7 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 	KeySet * cache = 0;
 	Key * cacheParent = 0;
 	int debugGlobalPositions = 0;
+	uint64_t statsStart = 0;
 
 #ifdef DEBUG
 	if (keyGetMeta (parentKey, "debugGlobalPositions") != 0)
@@ -969,29 +1089,39 @@ int kdbGet (KDB * handle, KeySet * ks, Key * parentKey)
 		goto error;
 	}
 
+	elektraStatsAttach (handle);
+
+	statsStart = elektraStatsStart (handle);
 	if (splitBuildup (split, handle, parentKey) == -1)
 	{
 		clearError (parentKey);
 		ELEKTRA_SET_ERROR (38, parentKey, "error in splitBuildup");
 		goto error;
 	}
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 	cache = ksNew (0, KS_END);
 	cacheParent = keyDup (mountGetMountpoint (handle, initialParent));
 	if (ns == KEY_NS_CASCADING) keySetMeta (cacheParent, "cascading", "");
 	if (handle->globalPlugins[PREGETCACHE][MAXONCE])
 	{
+		statsStart = elektraStatsStart (handle);
 		elektraCacheLoad (handle, cache, parentKey, initialParent, cacheParent);
+		elektraStatsStop (handle, ELEKTRA_STATS_CACHE, statsStart);
 	}
 
 	// Check if a update is needed at all
-	switch (elektraGetCheckUpdateNeeded (split, parentKey))
+	switch (elektraGetCheckUpdateNeeded (split, parentKey, initialParent))
 	{
 	case -2: // We have a cache hit
+		statsStart = elektraStatsStart (handle);
 		if (elektraCacheLoadSplit (handle, split, ks, &cache, &cacheParent, parentKey, initialParent, debugGlobalPositions) != 0)
 		{
+			// the time of the failed cache load is counted as well
+			elektraStatsStop (handle, ELEKTRA_STATS_CACHE, statsStart);
 			goto cachemiss;
 		}
+		elektraStatsStop (handle, ELEKTRA_STATS_CACHE, statsStart);
 
 		keySetName (parentKey, keyName (initialParent));
 		splitUpdateFileName (split, handle, parentKey);
@@ -1049,12 +1179,14 @@ cachemiss:
 	elektraGlobalGet (handle, ks, parentKey, PREGETSTORAGE, DEINIT);
 
 	// Appoint keys (some in the bypass)
+	statsStart = elektraStatsStart (handle);
 	if (splitAppoint (split, handle, ks) == -1)
 	{
 		clearError (parentKey);
 		ELEKTRA_SET_ERROR (38, parentKey, "error in splitAppoint");
 		goto error;
 	}
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 	int cacheData = 1; // zero if data can not be cached (e.g. ini incompatibility)
 	if (handle->globalPlugins[POSTGETSTORAGE][FOREACH] || handle->globalPlugins[POSTGETCLEANUP][FOREACH] ||
@@ -1073,6 +1205,7 @@ cachemiss:
 
 		keySetName (parentKey, keyName (initialParent));
 
+		statsStart = elektraStatsStart (handle);
 		if (splitGet (split, parentKey, handle) == -1)
 		{
 			ELEKTRA_ADD_WARNING (108, parentKey, keyName (ksCurrent (ks)));
@@ -1080,6 +1213,7 @@ cachemiss:
 		}
 		ksClear (ks);
 		splitMergeBackends (split, ks);
+		elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 		clearError (parentKey);
 		if (elektraGetDoUpdateWithGlobalHooks (handle, split, ks, parentKey, initialParent, LAST, &cacheData) == -1)
@@ -1098,7 +1232,7 @@ cachemiss:
 		   but not for bypassed keys in split->size-1 */
 		clearError (parentKey);
 		// do everything up to position get_storage
-		if (elektraGetDoUpdate (split, parentKey, &cacheData) == -1)
+		if (elektraGetDoUpdate (split, parentKey, initialParent, &cacheData) == -1)
 		{
 			goto error;
 		}
@@ -1108,6 +1242,7 @@ cachemiss:
 		}
 
 		/* Now post-process the updated keysets */
+		statsStart = elektraStatsStart (handle);
 		if (splitGet (split, parentKey, handle) == -1)
 		{
 			ELEKTRA_ADD_WARNING (108, parentKey, keyName (ksCurrent (ks)));
@@ -1116,6 +1251,7 @@ cachemiss:
 
 		ksClear (ks);
 		splitMergeBackends (split, ks);
+		elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 	}
 
 	keySetName (parentKey, keyName (initialParent));
@@ -1126,6 +1262,7 @@ cachemiss:
 
 	if (cacheData && handle->globalPlugins[POSTGETCACHE][MAXONCE])
 	{
+		statsStart = elektraStatsStart (handle);
 		splitCacheStoreState (handle, split, handle->global, cacheParent, initialParent);
 		if (elektraGlobalSet (handle, ks, cacheParent, POSTGETCACHE, MAXONCE) != ELEKTRA_PLUGIN_STATUS_SUCCESS)
 		{
@@ -1134,6 +1271,7 @@ cachemiss:
 			// if there was an error, otherwise we get erroneous cache hits
 			elektraCacheCutMeta (handle);
 		}
+		elektraStatsStop (handle, ELEKTRA_STATS_CACHE, statsStart);
 	}
 	else
 	{
@@ -1143,7 +1281,9 @@ cachemiss:
 	cacheParent = 0;
 
 	// the default split is not handled by POSTGETSTORAGE
+	statsStart = elektraStatsStart (handle);
 	splitMergeDefault (split, ks);
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 	ksRewind (ks);
 
@@ -1207,7 +1347,7 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 					keySetString (parentKey, "");
 				}
 				keySetName (parentKey, keyName (split->parents[i]));
-				ret = backend->setplugins[p]->kdbSet (backend->setplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginSet (backend->setplugins[p], split->keysets[i], parentKey);
 
 #if VERBOSE && DEBUG
 				printf ("Prepare %s with keys %zd in plugin: %zu, split: %zu, ret: %d\n", keyName (parentKey),
@@ -1233,7 +1373,7 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 				if (hooks[PRESETSTORAGE][FOREACH])
 				{
 					ksRewind (split->keysets[i]);
-					hooks[PRESETSTORAGE][FOREACH]->kdbSet (hooks[PRESETSTORAGE][FOREACH], split->keysets[i], parentKey);
+					elektraStatsPluginSet (hooks[PRESETSTORAGE][FOREACH], split->keysets[i], parentKey);
 				}
 			}
 			else if (p == (STORAGE_PLUGIN - 1))
@@ -1241,7 +1381,7 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 				if (hooks[PRESETCLEANUP][FOREACH])
 				{
 					ksRewind (split->keysets[i]);
-					hooks[PRESETCLEANUP][FOREACH]->kdbSet (hooks[PRESETCLEANUP][FOREACH], split->keysets[i], parentKey);
+					elektraStatsPluginSet (hooks[PRESETCLEANUP][FOREACH], split->keysets[i], parentKey);
 				}
 			}
 
@@ -1264,6 +1404,62 @@ static int elektraSetPrepare (Split * split, Key * parentKey, Key ** errorKey, P
 	return any_error;
 }
 
+/**
+ * @internal
+ * @brief Completes the keysets of backends of which the previous kdbGet() only read a subtree
+ *
+ * Storage plugins always write complete files. So the keys outside of the
+ * read subtree are read again and added, unless a key with the same name is
+ * already in the keyset. They are read with the subtree function of the
+ * storage plugin, for which a file removed since the kdbGet() has no keys.
+ *
+ * @param split all information for iteration
+ * @param parentKey to add warnings and errors
+ * @param [out] sizes the sizes of the keysets before they were completed
+ *
+ * @retval -1 on error
+ * @retval 0 on success
+ */
+static int elektraSetCompleteSubtrees (Split * split, Key * parentKey, ssize_t * sizes)
+{
+	for (size_t i = 0; i < split->size; i++)
+	{
+		sizes[i] = ksGetSize (split->keysets[i]);
+		Backend * backend = split->handles[i];
+		Key * subtree = backendGetSubtree (backend, split->parents[i]);
+		if (!subtree) continue;
+
+		KeySet * complete = ksNew (0, KS_END);
+		keySetName (parentKey, keyName (split->parents[i]));
+		keySetString (parentKey, keyString (subtree));
+		for (size_t p = 1; p < NR_OF_PLUGINS; ++p)
+		{
+			Plugin * plugin = backend->getplugins[p];
+			if (!plugin || !plugin->kdbGet) continue;
+
+			int ret = p == STORAGE_PLUGIN ? elektraStatsPluginGetSubtree (plugin, complete, parentKey, split->parents[i]) :
+							elektraStatsPluginGet (plugin, complete, parentKey);
+			if (ret == -1)
+			{
+				ksDel (complete);
+				return -1;
+			}
+		}
+
+		// the keys of the subtree were already returned by the subtree read
+		size_t end;
+		ssize_t start = ksFindHierarchy (complete, subtree, &end);
+		for (cursor_t it = 0; it < ksGetSize (complete); ++it)
+		{
+			if (start >= 0 && it >= start && (size_t) it < end) continue;
+			Key * cur = ksAtCursor (complete, it);
+			if (!ksLookup (split->keysets[i], cur, 0)) ksAppendKey (split->keysets[i], cur);
+		}
+		ksDel (complete);
+	}
+	return 0;
+}
+
 /**
  * @internal
  * @brief Does the commit
@@ -1292,7 +1488,7 @@ static void elektraSetCommit (Split * split, Key * parentKey)
 					keyString (parentKey));
 #endif
 				ksRewind (split->keysets[i]);
-				ret = backend->setplugins[p]->kdbSet (backend->setplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginSet (backend->setplugins[p], split->keysets[i], parentKey);
 				if (p == COMMIT_PLUGIN)
 				{
 					// name of non-temp file
@@ -1328,7 +1524,7 @@ static void elektraSetRollback (Split * split, Key * parentKey)
 			if (backend->errorplugins[p])
 			{
 				keySetName (parentKey, keyName (split->parents[i]));
-				ret = backend->errorplugins[p]->kdbError (backend->errorplugins[p], split->keysets[i], parentKey);
+				ret = elektraStatsPluginError (backend->errorplugins[p], split->keysets[i], parentKey);
 			}
 
 			if (ret == -1)
@@ -1340,6 +1536,146 @@ static void elektraSetRollback (Split * split, Key * parentKey)
 }
 
 
+#ifdef HAVE_UNISTD_H
+/**
+ * @internal
+ * @brief Syncs what plugins deferred during the group commit
+ *
+ * During the group commit, plugins do not sync files themselves, but
+ * leave it to kdbSet() with
+ * elektraPluginDeferSync() (to sync before the commit) or
+ * elektraPluginDeferDirectorySync() (to sync after the commit).
+ * So a kdbSet() of many backends syncs every directory only once.
+ *
+ * Every file is synced with its own fsync(), so that errors are reported
+ * for the file that failed. Before, the write back of all files is
+ * started, if sync_file_range() is available, so that the files are
+ * written concurrently and each fsync() only waits for its file.
+ *
+ * @param handle the handle with the pending syncs
+ * @param what `files` or `directories`
+ * @param parentKey to set the error (files) or to add warnings (directories)
+ *
+ * @retval 0 on success
+ * @retval -1 if a file could not be synced
+ */
+static int elektraGroupCommitSync (KDB * handle, const char * what, Key * parentKey)
+{
+	if (!handle->pendingSyncs) return 0;
+
+	Key * root = keyNew ("system", KEY_END);
+	keyAddBaseName (root, what);
+	KeySet * pending = ksCut (handle->pendingSyncs, root);
+	int files = !strcmp (what, "files");
+
+	size_t size = ksGetSize (pending);
+	int * fds = elektraMalloc ((size + 1) * sizeof (int));
+	int * errnos = elektraMalloc ((size + 1) * sizeof (int));
+	for (size_t i = 0; i < size; ++i)
+	{
+		Key * cur = ksAtCursor (pending, i);
+		fds[i] = open (keyBaseName (cur), O_RDONLY);
+		errnos[i] = errno;
+#ifdef HAVE_SYNC_FILE_RANGE
+		// only starts the write back, errors are reported by fsync() below
+		if (files && fds[i] != -1) sync_file_range (fds[i], 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+	}
+
+	int ret = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		const char * name = keyBaseName (ksAtCursor (pending, i));
+		if (fds[i] != -1 && fsync (fds[i]) == 0)
+		{
+			close (fds[i]);
+			continue;
+		}
+		if (fds[i] != -1) errnos[i] = errno;
+
+		if (files && ret == 0)
+		{
+			ELEKTRA_SET_ERRORF (89, parentKey, "Could not fsync config file %s because \"%s\"", name, strerror (errnos[i]));
+			ret = -1;
+		}
+		else if (!files)
+		{
+			ELEKTRA_ADD_WARNINGF (88, parentKey, "Could not sync directory \"%s\", because %s", name, strerror (errnos[i]));
+		}
+		if (fds[i] != -1) close (fds[i]);
+	}
+
+	elektraFree (errnos);
+	elektraFree (fds);
+	keyDel (root);
+	ksDel (pending);
+	return ret;
+}
+#endif
+
+/**
+ * @internal
+ * @brief Starts or ends the group commit
+ *
+ * Passes the pending syncs to all set plugins of the split.
+ *
+ * @see elektraGroupCommitSync()
+ *
+ * @param handle the handle to store the pending syncs
+ * @param split the backends of kdbSet()
+ * @param start 1 to start, 0 to end (also removes what was not synced)
+ */
+static void elektraGroupCommit (KDB * handle, Split * split, int start)
+{
+#ifdef HAVE_UNISTD_H
+	if (!handle->groupCommit) return;
+	KeySet * pendingSyncs = start ? ksNew (0, KS_END) : 0;
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		for (size_t p = 0; p < NR_OF_PLUGINS; ++p)
+		{
+			Plugin * plugin = split->handles[i]->setplugins[p];
+			if (plugin) plugin->pendingSyncs = pendingSyncs;
+		}
+	}
+	ksDel (handle->pendingSyncs);
+	handle->pendingSyncs = pendingSyncs;
+#else
+	(void) handle;
+	(void) split;
+	(void) start;
+#endif
+}
+
+/**
+ * @brief Enables or disables the group commit of kdbSet()
+ *
+ * With group commit, plugins like `sync` and the resolver do not sync
+ * their files themselves. Instead,
+ * kdbSet() syncs all temporary files after all backends are prepared
+ * and every directory once after all backends are committed.
+ * Every file still gets its own fsync().
+ *
+ * A failed sync of the temporary files is an error and rolls back all
+ * backends, like an error of the `sync` plugin.
+ *
+ * The group commit is disabled after kdbOpen(). It can also be enabled
+ * with the clause `system/elektra/ensure/groupcommit` of kdbEnsure().
+ *
+ * @param handle the handle of kdbOpen()
+ * @param enable 1 to enable, 0 to sync every backend on its own
+ *
+ * @retval 0 on success
+ * @retval -1 on NULL pointers
+ * @ingroup proposal
+ */
+int elektraGroupCommitEnable (KDB * handle, int enable)
+{
+	if (!handle) return -1;
+	handle->groupCommit = enable ? 1 : 0;
+	return 0;
+}
+
 /** @brief Set keys in an atomic and universal way.
  *
  * @pre kdbGet() must be called before kdbSet():
@@ -1450,6 +1786,8 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 
 	ELEKTRA_LOG ("now in new kdbSet (%s) %p %zd", keyName (parentKey), (void *) handle, ksGetSize (ks));
 
+	elektraStatsAttach (handle);
+
 	elektraGlobalSet (handle, ks, parentKey, PRESETSTORAGE, INIT);
 	elektraGlobalSet (handle, ks, parentKey, PRESETSTORAGE, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, PRESETSTORAGE, DEINIT);
@@ -1458,7 +1796,9 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 
 	Split * split = splitNew ();
 	Key * errorKey = 0;
+	ssize_t * sizes = 0;
 
+	uint64_t statsStart = elektraStatsStart (handle);
 	if (splitBuildup (split, handle, parentKey) == -1)
 	{
 		clearError (parentKey); // clear previous error to set new one
@@ -1480,6 +1820,7 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 
 	// 2.) Search for changed sizes
 	syncstate |= splitSync (split);
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 	ELEKTRA_ASSERT (syncstate <= 1, "syncstate not equal or below 1, but %d", syncstate);
 	if (syncstate != 1)
 	{
@@ -1507,31 +1848,59 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	ELEKTRA_ASSERT (syncstate == 1, "syncstate not 1, but %d", syncstate);
 	ELEKTRA_LOG ("after 2.) Search for changed sizes");
 
+	statsStart = elektraStatsStart (handle);
 	splitPrepare (split);
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 	clearError (parentKey); // clear previous error to set new one
-	if (elektraSetPrepare (split, parentKey, &errorKey, handle->globalPlugins) == -1)
+	sizes = elektraMalloc (split->size * sizeof (ssize_t));
+	if (elektraSetCompleteSubtrees (split, parentKey, sizes) == -1)
 	{
 		goto error;
 	}
-	else
+
+	elektraGroupCommit (handle, split, 1);
+	if (elektraSetPrepare (split, parentKey, &errorKey, handle->globalPlugins) == -1)
 	{
-		// no error, restore old error
-		copyError (parentKey, oldError);
+		goto error;
 	}
 	keySetName (parentKey, keyName (initialParent));
+#ifdef HAVE_UNISTD_H
+	// all temporary files are written, make them durable before any is renamed
+	if (elektraGroupCommitSync (handle, "files", parentKey) == -1)
+	{
+		goto error;
+	}
+#endif
+	// no error, restore old error
+	copyError (parentKey, oldError);
 
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, INIT);
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, PRECOMMIT, DEINIT);
 
 	elektraSetCommit (split, parentKey);
+#ifdef HAVE_UNISTD_H
+	keySetName (parentKey, keyName (initialParent));
+	elektraGroupCommitSync (handle, "directories", parentKey);
+#endif
+	elektraGroupCommit (handle, split, 0);
 
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, INIT);
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, MAXONCE);
 	elektraGlobalSet (handle, ks, parentKey, COMMIT, DEINIT);
 
+	statsStart = elektraStatsStart (handle);
 	splitUpdateSize (split);
+	for (size_t i = 0; i < split->size; ++i)
+	{
+		// the keyset still only holds the subtree
+		if (backendGetSubtree (split->handles[i], split->parents[i]))
+		{
+			backendUpdateSize (split->handles[i], split->parents[i], sizes[i]);
+		}
+	}
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, statsStart);
 
 	keySetName (parentKey, keyName (initialParent));
 
@@ -1548,6 +1917,7 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 	keySetName (parentKey, keyName (initialParent));
 	keyDel (initialParent);
 	splitDel (split);
+	elektraFree (sizes);
 
 	keyDel (oldError);
 	errno = errnosave;
@@ -1556,6 +1926,7 @@ int kdbSet (KDB * handle, KeySet * ks, Key * parentKey)
 
 error:
 	keySetName (parentKey, keyName (initialParent));
+	elektraGroupCommit (handle, split, 0);
 
 	elektraGlobalError (handle, ks, parentKey, PREROLLBACK, INIT);
 	elektraGlobalError (handle, ks, parentKey, PREROLLBACK, MAXONCE);
@@ -1581,6 +1952,7 @@ error:
 	keySetName (parentKey, keyName (initialParent));
 	keyDel (initialParent);
 	splitDel (split);
+	elektraFree (sizes);
 	errno = errnosave;
 	keyDel (oldError);
 	return -1;
@@ -1872,6 +2244,9 @@ static int ensurePluginState (KDB * handle ELEKTRA_UNUSED, const char * mountpoi
  *
  * If `<mountpoint>` is NOT `global`, currently only `unmounted` is supported (not `mounted` and `remounted`).
  *
+ * - `system/elektra/ensure/groupcommit` with the value `1` enables and `0` disables the group commit of kdbSet(),
+ *   see elektraGroupCommitEnable().
+ *
  * NOTE: This function only works properly, if the list plugin is mounted in all global positions.
  * If this is not the case, 1 will be returned, because this is seen as an implicit clause in the contract.
  * Additionally any contract that specifies clauses for the list plugin is rejected as malformed.
@@ -1899,6 +2274,21 @@ int kdbEnsure (KDB * handle, KeySet * contract, Key * parentKey)
 		return -1;
 	}
 
+	Key * groupCommit = ksLookupByName (contract, "system/elektra/ensure/groupcommit", 0);
+	if (groupCommit)
+	{
+		const char * groupCommitString = keyString (groupCommit);
+		if (elektraStrCmp (groupCommitString, "0") != 0 && elektraStrCmp (groupCommitString, "1") != 0)
+		{
+			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_MALFORMED_CONTRACT, parentKey,
+					    "The key '%s' contained the value '%s', but only '0' or '1' may be used.", keyName (groupCommit),
+					    groupCommitString);
+			ksDel (contract);
+			return -1;
+		}
+		elektraGroupCommitEnable (handle, groupCommitString[0] == '1');
+	}
+
 	Key * cutpoint = keyNew ("system/elektra/ensure/plugins", KEY_END);
 	KeySet * pluginsContract = ksCut (contract, cutpoint);
 
@@ -71,6 +71,15 @@
  * own data structures.
  * It can be a very powerful feature, e.g. if you need your own-defined
  * ordering or different Models of your configuration.
+ *
+ * @par Thread Safety
+ * Keys are not thread-safe, not even for functions taking a const Key.
+ * Reading a key also changes internal state, e.g. the reference counters
+ * of its metadata. Keys created with keyDup() or keyCopy(), or whose
+ * metadata was copied with keyCopyAllMeta(), share the metadata with the
+ * source key until one of them changes it. So such keys must not be used
+ * by several threads at once either, even if every thread uses only
+ * its own key.
  */
 
 
@@ -256,6 +265,10 @@ int g (const Key * source, KeySet * ks)
  * It can also be optimized in the checks, because the keyname
  * is known to be valid.
  *
+ * The duplicate shares the metadata of @p source until one of them
+ * changes it, so @p source and the duplicate must not be used by
+ * different threads at once (see @ref key "Thread Safety").
+ *
  * @param source has to be an initialized source Key
  * @retval 0 failure or on NULL pointer
  * @return a fully copy of source on success
@@ -308,9 +321,9 @@ Key * keyDup (const Key * source)
  * both keys. Affiliation to keysets
  * are also not affected.
  *
- * The metadata will be duplicated for the destination
- * key. So it will not take much additional space, even
- * with lots of metadata.
+ * The metadata will be shared with the destination
+ * key until one of them changes it. So it will not take
+ * much additional space, even with lots of metadata.
  *
  * When you pass a NULL-pointer as source the
  * data of dest will be cleaned completely
@@ -329,6 +342,8 @@ Key * keyDup (const Key * source)
  *
  * @snippet keyCopy.c Individual Copy
  *
+ * Like with keyDup(), @p dest shares the metadata of @p source
+ * afterwards (see @ref key "Thread Safety").
  *
  * @param dest the key which will be written to
  * @param source the key which should be copied
@@ -385,7 +400,8 @@ int keyCopy (Key * dest, const Key * source)
 
 	if (source->meta)
 	{
-		dest->meta = ksDup (source->meta);
+		// the metadata is shared until one of the keys changes it
+		dest->meta = elektraMetaRef (source->meta);
 		if (!dest->meta) goto memerror;
 	}
 	else
@@ -397,6 +413,7 @@ int keyCopy (Key * dest, const Key * source)
 	set_bit (dest->flags, KEY_FLAG_SYNC);
 
 	// copy sizes accordingly
+	dest->metaCursor = 0;
 	dest->keySize = source->keySize;
 	dest->keyUSize = source->keyUSize;
 	dest->dataSize = source->dataSize;
@@ -404,14 +421,16 @@ int keyCopy (Key * dest, const Key * source)
 	// free old resources of destination
 	if (!test_bit (dest->flags, KEY_FLAG_MMAP_KEY)) elektraFree (destKey);
 	if (!test_bit (dest->flags, KEY_FLAG_MMAP_DATA)) elektraFree (destData);
-	ksDel (destMeta);
+	clear_bit (dest->flags, KEY_FLAG_MMAP_KEY | KEY_FLAG_MMAP_DATA);
+	elektraMetaDel (destMeta);
 
 	return 1;
 
 memerror:
-	elektraFree (dest->key);
-	elektraFree (dest->data.v);
-	ksDel (dest->meta);
+	// only free what was already duplicated
+	if (dest->key != destKey) elektraFree (dest->key);
+	if (dest->data.v != destData) elektraFree (dest->data.v);
+	if (dest->meta != destMeta) elektraMetaDel (dest->meta);
 
 	dest->key = destKey;
 	dest->data.v = destData;
@@ -459,10 +478,15 @@ int keyDel (Key * key)
 	}
 
 	int keyInMmap = test_bit (key->flags, KEY_FLAG_MMAP_STRUCT);
+	int keyInArena = test_bit (key->flags, KEY_FLAG_ARENA_STRUCT);
 
 	rc = keyClear (key);
 
-	if (!keyInMmap)
+	if (keyInArena)
+	{
+		elektraArenaKeyRelease (key);
+	}
+	else if (!keyInMmap)
 	{
 		elektraFree (key);
 	}
@@ -511,14 +535,16 @@ int keyClear (Key * key)
 	ref = key->ksReference;
 
 	int keyStructInMmap = test_bit (key->flags, KEY_FLAG_MMAP_STRUCT);
+	int keyStructInArena = test_bit (key->flags, KEY_FLAG_ARENA_STRUCT);
 
 	if (key->key && !test_bit (key->flags, KEY_FLAG_MMAP_KEY)) elektraFree (key->key);
 	if (key->data.v && !test_bit (key->flags, KEY_FLAG_MMAP_DATA)) elektraFree (key->data.v);
-	if (key->meta) ksDel (key->meta);
+	if (key->meta) elektraMetaDel (key->meta);
 
 	keyInit (key);
 
 	if (keyStructInMmap) key->flags |= KEY_FLAG_MMAP_STRUCT;
+	if (keyStructInArena) key->flags |= KEY_FLAG_ARENA_STRUCT;
 
 	/* Set reference properties */
 	key->ksReference = ref;
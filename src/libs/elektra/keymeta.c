@@ -153,9 +153,9 @@ while ((meta = keyNextMeta (key))!=0)
 int keyRewindMeta (Key * key)
 {
 	if (!key) return -1;
-	if (!key->meta) return 0;
 
-	return ksRewind (key->meta);
+	key->metaCursor = 0;
+	return 0;
 }
 
 /** Iterate to the next meta information.
@@ -185,13 +185,13 @@ int keyRewindMeta (Key * key)
  **/
 const Key * keyNextMeta (Key * key)
 {
-	Key * ret;
 	if (!key) return 0;
 	if (!key->meta) return 0;
 
-	ret = ksNext (key->meta);
+	// the metadata may be shared, so the cursor is stored in the key
+	if (key->metaCursor > key->meta->size) return 0;
 
-	return ret;
+	return key->meta->array[key->metaCursor++];
 }
 
 /**Returns the value of a meta-information which is current.
@@ -212,13 +212,12 @@ const Key * keyNextMeta (Key * key)
  **/
 const Key * keyCurrentMeta (const Key * key)
 {
-	Key * ret;
 	if (!key) return 0;
 	if (!key->meta) return 0;
 
-	ret = ksCurrent (key->meta);
+	if (key->metaCursor == 0 || key->metaCursor > key->meta->size) return 0;
 
-	return ret;
+	return key->meta->array[key->metaCursor - 1];
 }
 
 /**Do a shallow copy of metadata from source to dest.
@@ -305,17 +304,27 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 	if (dest->meta)
 	{
 		Key * r;
-		r = ksLookup (dest->meta, ret, KDB_O_POP);
-		if (r && r != ret)
+		r = ksLookup (dest->meta, ret, 0);
+		if (r == ret)
+		{
+			/*Nothing to do, also keeps shared metadata shared*/
+			return 1;
+		}
+		if (elektraMetaUnshare (dest) == -1)
+		{
+			return -1;
+		}
+		if (r)
 		{
 			/*It was already there, so lets drop that one*/
+			r = ksLookup (dest->meta, ret, KDB_O_POP);
 			keyDel (r);
 		}
 	}
 	else
 	{
 		/*Create a new place for meta information.*/
-		dest->meta = ksNew (0, KS_END);
+		dest->meta = elektraMetaNew ();
 		if (!dest->meta)
 		{
 			return -1;
@@ -324,6 +333,7 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
 
 	// now we can simply append that key
 	ksAppendKey (dest->meta, ret);
+	elektraMetaUpdateCursor (dest);
 
 	return 1;
 }
@@ -353,6 +363,12 @@ int keyCopyMeta (Key * dest, const Key * source, const char * metaName)
  *
  * @snippet keyMeta.c Shared Meta All
  *
+ * If dest does not have any metadata, both keys share the same
+ * metadata afterwards, which takes constant time and memory. The
+ * metadata is copied as soon as one of the keys changes it.
+ * Keys sharing metadata must not be used by different threads at
+ * once (see @ref key "Thread Safety").
+ *
  * @post for every metaName present in source: keyGetMeta(source, metaName) == keyGetMeta(dest, metaName)
  *
  * @retval 1 if was successfully copied
@@ -371,14 +387,32 @@ int keyCopyAllMeta (Key * dest, const Key * source)
 
 	if (source->meta)
 	{
+		if (dest->meta == source->meta)
+		{
+			return 1;
+		}
+
 		/*Make sure that dest also does not have metaName*/
-		if (dest->meta)
+		if (dest->meta && ksGetSize (dest->meta) > 0)
 		{
+			if (elektraMetaUnshare (dest) == -1)
+			{
+				return -1;
+			}
 			ksAppend (dest->meta, source->meta);
+			elektraMetaUpdateCursor (dest);
 		}
 		else
 		{
-			dest->meta = ksDup (source->meta);
+			/*Share the metadata until one of the keys changes it*/
+			KeySet * meta = elektraMetaRef (source->meta);
+			if (!meta)
+			{
+				return -1;
+			}
+			elektraMetaDel (dest->meta);
+			dest->meta = meta;
+			dest->metaCursor = 0;
 		}
 		return 1;
 	}
@@ -473,6 +507,8 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	// optimization: we have nothing and want to remove something:
 	if (!key->meta && !newMetaString) return 0;
 
+	if (elektraMetaUnshare (key) == -1) return -1;
+
 	toSet = keyNew (0);
 	if (!toSet) return -1;
 
@@ -489,6 +525,7 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 			keyDel (ret);
 			key->flags |= KEY_FLAG_SYNC;
 		}
+		elektraMetaUpdateCursor (key);
 	}
 
 	if (newMetaString)
@@ -519,7 +556,7 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	if (!key->meta)
 	{
 		/*Create a new place for meta information.*/
-		key->meta = ksNew (0, KS_END);
+		key->meta = elektraMetaNew ();
 		if (!key->meta)
 		{
 			keyDel (toSet);
@@ -532,6 +569,7 @@ ssize_t keySetMeta (Key * key, const char * metaName, const char * newMetaString
 	set_bit (toSet->flags, KEY_FLAG_RO_META);
 
 	ksAppendKey (key->meta, toSet);
+	elektraMetaUpdateCursor (key);
 	key->flags |= KEY_FLAG_SYNC;
 	return metaStringSize;
 }
@@ -396,6 +396,96 @@ ssize_t elektraFinalizeEmptyName (Key * key)
 	return key->keySize;
 }
 
+/**
+ * @internal
+ *
+ * Checks if all parts of @p parts are plain, i.e. the name is already
+ * canonical and needs no unescaping.
+ *
+ * A plain part is not empty, not "." or ".." and contains neither
+ * \\ nor %. Parts are separated by exactly one /, there must be no
+ * leading or trailing /.
+ *
+ * The scan uses strcspn(), which is vectorized by common libcs.
+ *
+ * @return the length of @p parts or 0 if it is not plain
+ */
+static size_t elektraPlainKeyNameParts (const char * parts)
+{
+	const char * p = parts;
+	while (1)
+	{
+		size_t partSize = strcspn (p, "/\\%");
+		if (partSize == 0) return 0;
+		if (*p == '.' && (partSize == 1 || (partSize == 2 && p[1] == '.'))) return 0;
+
+		p += partSize;
+		if (*p == '\0') return p - parts;
+		if (*p != '/') return 0;
+		++p;
+	}
+}
+
+/**
+ * @internal
+ *
+ * Checks if @p name is a canonical key name without any escaping,
+ * as Elektra itself produces it for most keys.
+ *
+ * Such names can be copied as they are, keySetName() would not
+ * change them.
+ *
+ * @return the size of @p name including the null terminator or
+ *         0 if the name has to go through keySetName()
+ */
+size_t elektraCanonicalKeyNameSize (const char * name)
+{
+	if (!name || *name == '\0') return 0;
+
+	const size_t namespaceSize = strcspn (name, "/");
+	if (namespaceSize > 0)
+	{
+		// user:owner is not canonical, it has to go through keySetName()
+		if (!(namespaceSize == sizeof ("user") - 1 && !strncmp (name, "user", namespaceSize)) &&
+		    !(namespaceSize == sizeof ("system") - 1 && !strncmp (name, "system", namespaceSize)) &&
+		    !(namespaceSize == sizeof ("spec") - 1 && !strncmp (name, "spec", namespaceSize)) &&
+		    !(namespaceSize == sizeof ("proc") - 1 && !strncmp (name, "proc", namespaceSize)) &&
+		    !(namespaceSize == sizeof ("dir") - 1 && !strncmp (name, "dir", namespaceSize)))
+		{
+			return 0;
+		}
+		if (name[namespaceSize] == '\0') return namespaceSize + 1;
+	}
+
+	size_t partsSize = elektraPlainKeyNameParts (name + namespaceSize + 1);
+	if (partsSize == 0) return 0;
+	return namespaceSize + 1 + partsSize + 1;
+}
+
+/**
+ * @internal
+ *
+ * Like elektraFinalizeName(), but for names where
+ * elektraCanonicalKeyNameSize() was successful. The unescaped
+ * name is the same as the escaped one with / replaced by \\0.
+ */
+ssize_t elektraFinalizeCanonicalName (Key * key)
+{
+	char * unescaped = key->key + key->keySize;
+	memcpy (unescaped, key->key, key->keySize);
+
+	char * p = unescaped;
+	while ((p = memchr (p, '/', key->keySize - (p - unescaped))) != NULL)
+	{
+		*p++ = '\0';
+	}
+
+	key->keyUSize = key->keySize;
+	key->flags |= KEY_FLAG_SYNC;
+
+	return key->keySize;
+}
+
 static void elektraHandleUserName (Key * key, const char * newName)
 {
 	const size_t userLength = sizeof ("user");
@@ -427,6 +517,34 @@ static void elektraRemoveKeyName (Key * key)
 	key->keyUSize = 0;
 }
 
+/**
+ * @internal
+ *
+ * Resizes the buffer of the key name to newSize bytes.
+ *
+ * A name in a mmap region or an arena is copied to a new buffer
+ * instead of being reallocated.
+ *
+ * @retval -1 on memory error (key->key is NULL then)
+ */
+static int elektraResizeKeyName (Key * key, size_t newSize)
+{
+	if (test_bit (key->flags, KEY_FLAG_MMAP_KEY))
+	{
+		// key was in mmap region, clear flag and trigger malloc instead of realloc
+		char * mmapName = key->key;
+		key->key = elektraMalloc (newSize);
+		clear_bit (key->flags, KEY_FLAG_MMAP_KEY);
+		if (!key->key) return -1;
+
+		size_t oldSize = elektraStrLen (mmapName);
+		memcpy (key->key, mmapName, oldSize < newSize ? oldSize : newSize);
+		return 0;
+	}
+
+	return elektraRealloc ((void **) &key->key, newSize);
+}
+
 /**
  * @brief Checks if in name is something else other than slashes
  *
@@ -519,6 +637,17 @@ ssize_t elektraKeySetName (Key * key, const char * newName, option_t options)
 	elektraRemoveKeyName (key);
 	if (!(options & KEY_META_NAME)) keySetOwner (key, NULL);
 
+	const size_t canonicalSize = elektraCanonicalKeyNameSize (newName);
+	if (canonicalSize > 0)
+	{
+		// fast path: nothing to canonicalize or unescape
+		key->keySize = canonicalSize;
+		key->key = elektraMalloc (canonicalSize * 2);
+		if (!key->key) return -1;
+		memcpy (key->key, newName, canonicalSize);
+		return elektraFinalizeCanonicalName (key);
+	}
+
 	switch (keyGetNameNamespace (newName))
 	{
 	case KEY_NS_NONE:
@@ -857,18 +986,7 @@ ssize_t keyAddBaseName (Key * key, const char * baseName)
 	}
 
 	const size_t newSize = key->keySize * 2;
-	if (test_bit (key->flags, KEY_FLAG_MMAP_KEY))
-	{
-		// key was in mmap region, clear flag and trigger malloc instead of realloc
-		key->key = elektraMalloc (newSize);
-		clear_bit (key->flags, KEY_FLAG_MMAP_KEY);
-	}
-	else
-	{
-		if (-1 == elektraRealloc ((void **) &key->key, newSize)) return -1;
-	}
-
-	if (!key->key)
+	if (-1 == elektraResizeKeyName (key, newSize))
 	{
 		elektraFree (escaped);
 		return -1;
@@ -976,19 +1094,22 @@ ssize_t keyAddName (Key * key, const char * newName)
 	const size_t origSize = key->keySize;
 	const size_t newSize = (origSize + nameSize) * 2;
 
-	if (test_bit (key->flags, KEY_FLAG_MMAP_KEY))
-	{
-		// key was in mmap region, clear flag and trigger malloc instead of realloc
-		key->key = elektraMalloc (newSize);
-		clear_bit (key->flags, KEY_FLAG_MMAP_KEY);
-	}
-	else
+	if (-1 == elektraResizeKeyName (key, newSize)) return -1;
+
+	if (elektraPlainKeyNameParts (newName) == nameSize - 1)
 	{
-		if (-1 == elektraRealloc ((void **) &key->key, newSize)) return -1;
+		// fast path: no levels to skip or remove, append the name as it is
+		if (strcmp (key->key, "/"))
+		{
+			key->key[key->keySize - 1] = KDB_PATH_SEPARATOR;
+			++key->keySize;
+		}
+		memcpy (key->key + key->keySize - 1, newName, nameSize);
+		key->keySize += nameSize - 1;
+		elektraFinalizeName (key);
+		return key->keySize;
 	}
 
-	if (!key->key) return -1;
-
 	size_t size = 0;
 	const char * p = newName;
 	int avoidSlash = 0;
@@ -1124,18 +1245,7 @@ ssize_t keySetBaseName (Key * key, const char * baseName)
 	size_t sizeEscaped = elektraStrLen (escaped);
 
 	const size_t newSize = (key->keySize + sizeEscaped) * 2;
-	if (test_bit (key->flags, KEY_FLAG_MMAP_KEY))
-	{
-		// key was in mmap region, clear flag and trigger malloc instead of realloc
-		key->key = elektraMalloc (newSize);
-		clear_bit (key->flags, KEY_FLAG_MMAP_KEY);
-	}
-	else
-	{
-		if (-1 == elektraRealloc ((void **) &key->key, newSize)) return -1;
-	}
-
-	if (!key->key)
+	if (-1 == elektraResizeKeyName (key, newSize))
 	{
 		elektraFree (escaped);
 		return -1;
@@ -36,6 +36,12 @@
 #define ELEKTRA_MAX_PREFIX_SIZE sizeof ("namespace/")
 #define ELEKTRA_MAX_NAMESPACE_SIZE sizeof ("system")
 
+/* the generations of a keyset stay distinct from other keysets
+   for the first 2^32 changes */
+#define KS_GENERATION_START (UINT64_C (1) << 32)
+
+static uint64_t ksGenerations = 0;
+
 /**
  * @internal
  *
@@ -55,6 +61,22 @@ static void elektraOpmphmInvalidate (KeySet * ks ELEKTRA_UNUSED)
 #endif
 }
 
+/**
+ * @internal
+ *
+ * @brief Marks a KeySet as changed.
+ *
+ * Must be invoked by every function that adds a Key or removes a Key.
+ * Invalidates the OPMPHM and advances the generation.
+ *
+ * @param ks the KeySet
+ */
+static void elektraKsChanged (KeySet * ks)
+{
+	++ks->generation;
+	elektraOpmphmInvalidate (ks);
+}
+
 /**
  * @internal
  *
@@ -476,7 +498,7 @@ int ksClear (KeySet * ks)
 	}
 	ks->alloc = KEYSET_SIZE;
 
-	elektraOpmphmInvalidate (ks);
+	elektraKsChanged (ks);
 	return 0;
 }
 
@@ -748,6 +770,30 @@ ssize_t ksGetSize (const KeySet * ks)
 }
 
 
+/**
+ * @brief Return the generation of a keyset
+ *
+ * The generation changes whenever keys are added to, replaced in
+ * or removed from @p ks, so results derived from @p ks can be
+ * cached as long as its generation stays the same.
+ * Different keysets have different generations.
+ *
+ * Changes of the values or metadata of contained keys do not
+ * change the generation.
+ *
+ * @param ks the keyset object to work with
+ * @return the generation of @p ks
+ * @retval 0 on NULL pointer
+ * @see ksGetSize()
+ */
+uint64_t ksGetGeneration (const KeySet * ks)
+{
+	if (!ks) return 0;
+
+	return ks->generation;
+}
+
+
 /*******************************************
  *           Filling up KeySets            *
  *******************************************/
@@ -900,6 +946,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		if (toAppend == ks->array[result])
 		{
 			/* user tried to insert the same key again */
+			ksSetCursor (ks, result);
 			return ks->size;
 		}
 
@@ -911,6 +958,7 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 		keyIncRef (toAppend);
 		ks->array[result] = toAppend;
 		ksSetCursor (ks, result);
+		++ks->generation;
 	}
 	else
 	{
@@ -947,13 +995,105 @@ ssize_t ksAppendKey (KeySet * ks, Key * toAppend)
 			ks->array[insertpos] = toAppend;
 			ksSetCursor (ks, insertpos);
 		}
-		elektraOpmphmInvalidate (ks);
+		elektraKsChanged (ks);
 	}
 
 	return ks->size;
 }
 
 
+/**
+ * @internal
+ *
+ * Merges the sorted array of @p toAppend into the sorted array of @p ks.
+ *
+ * Both arrays are walked backwards once, so this needs O(n+m) instead of
+ * a binary search and a possible memmove for every key of @p toAppend.
+ * Runs of keys of @p ks between two appended keys are found by binary
+ * search and moved with a single memmove.
+ * Keys with the same name are replaced like ksAppendKey() does.
+ *
+ * @pre ks->alloc is large enough to hold ks->size + toAppend->size keys
+ * @pre ks != toAppend
+ *
+ * @return the size of the KeySet after the merge
+ */
+static ssize_t ksMergeInternal (KeySet * ks, const KeySet * toAppend)
+{
+	Key ** array = ks->array;
+	Key ** other = toAppend->array;
+	ssize_t i = ks->size - 1;
+	ssize_t j = toAppend->size - 1;
+	ssize_t k = ks->size + toAppend->size - 1;
+	ssize_t cursor = -1;
+	int inserted = 0;
+	int replaced = 0;
+
+	while (j >= 0)
+	{
+		int cmp = i >= 0 ? keyCompareByNameOwner (&array[i], &other[j]) : -1;
+
+		if (cmp > 0)
+		{
+			/* move the whole run of keys sorting after other[j] at once */
+			ssize_t left = 0;
+			ssize_t right = i;
+			while (left < right)
+			{
+				ssize_t middle = left + (right - left) / 2;
+				if (keyCompareByNameOwner (&array[middle], &other[j]) > 0)
+					right = middle;
+				else
+					left = middle + 1;
+			}
+			size_t n = i - left + 1;
+			memmove (array + k - n + 1, array + left, n * sizeof (struct _Key *));
+			k -= n;
+			i -= n;
+			continue;
+		}
+
+		elektraKeyLock (other[j], KEY_LOCK_NAME);
+		/* the cursor points to the last appended key, like after ksAppendKey() */
+		if (cursor == -1) cursor = k;
+		if (cmp == 0)
+		{
+			/* Seems like the key already exist. */
+			if (array[i] != other[j])
+			{
+				keyDecRef (array[i]);
+				keyDel (array[i]);
+				keyIncRef (other[j]);
+				replaced = 1;
+			}
+			--i;
+		}
+		else
+		{
+			keyIncRef (other[j]);
+			inserted = 1;
+		}
+		array[k--] = other[j--];
+	}
+
+	/* keys of ks before the first appended key are still in place,
+	   unless keys were replaced and the merged keys start later */
+	size_t gap = k - i;
+	if (gap > 0)
+	{
+		memmove (array + i + 1, array + k + 1, (ks->size + toAppend->size - k - 1) * sizeof (struct _Key *));
+		cursor -= gap;
+	}
+
+	ks->size = ks->size + toAppend->size - gap;
+	ks->array[ks->size] = 0;
+	ksSetCursor (ks, cursor);
+	if (inserted) elektraKsChanged (ks);
+	if (replaced) ++ks->generation;
+
+	return ks->size;
+}
+
 /**
  * Append all @p toAppend contained keys to the end of the @p ks.
  *
@@ -982,12 +1122,18 @@ ssize_t ksAppend (KeySet * ks, const KeySet * toAppend)
 
 	if (toAppend->size == 0) return ks->size;
 
+	if (ks == toAppend) return ks->size;
+
 	/* Do only one resize in advance */
 	for (toAlloc = ks->alloc; ks->size + toAppend->size >= toAlloc; toAlloc *= 2)
 		;
-	ksResize (ks, toAlloc - 1);
+	if (ksResize (ks, toAlloc - 1) == -1) return -1;
+
+	if (toAppend->size >= KEYSET_MERGE_SIZE)
+	{
+		return ksMergeInternal (ks, toAppend);
+	}
 
-	/* TODO: here is lots of room for optimizations */
 	for (size_t i = 0; i < toAppend->size; ++i)
 	{
 		ksAppendKey (ks, toAppend->array[i]);
@@ -1029,11 +1175,92 @@ ssize_t ksCopyInternal (KeySet * ks, size_t to, size_t from)
 
 	ks->array[ks->size] = 0;
 
-	if (ret) elektraOpmphmInvalidate (ks);
+	if (ret) elektraKsChanged (ks);
 
 	return ret;
 }
 
+/**
+ * @internal
+ *
+ * Checks whether @p key is below or the same as @p root, without
+ * treating a cascading @p root as matching keys of other namespaces.
+ */
+static int elektraKsIsInHierarchy (const Key * root, const Key * key)
+{
+	if (root->key[0] == '/' && key->key[0] != '/') return 0;
+	return keyIsBelowOrSame (root, key) == 1;
+}
+
+/**
+ * @internal
+ *
+ * Keys below @p root form a contiguous range in a sorted KeySet,
+ * so its end can be found with a binary search instead of
+ * comparing every key of the range.
+ *
+ * @param start index of the first key that could be below @p root
+ * @return index after the last key below or same as @p root
+ */
+static size_t elektraKsFindHierarchyEnd (const KeySet * ks, const Key * root, size_t start)
+{
+	size_t left = start;
+	size_t right = ks->size;
+	while (left < right)
+	{
+		size_t middle = left + (right - left) / 2;
+		if (elektraKsIsInHierarchy (root, ks->array[middle]))
+		{
+			left = middle + 1;
+		}
+		else
+		{
+			right = middle;
+		}
+	}
+	return left;
+}
+
+/**
+ * @brief Searches for the range of keys below a key
+ *
+ * Unlike ksCut() nothing is copied or removed: the keys below or same as
+ * @p root can be accessed with ksAtCursor() for all cursors from the returned
+ * index up to (excluding) @p end. The range only stays valid as long as
+ * @p ks is not modified.
+ *
+ * A cascading @p root only finds cascading keys, to find the keys of
+ * other namespaces call this function with a key in every namespace.
+ *
+ *@code
+size_t end;
+for (ssize_t it = ksFindHierarchy (ks, root, &end); it >= 0 && (size_t) it < end; ++it)
+{
+	Key * cur = ksAtCursor (ks, it);
+	// ...
+}
+ *@endcode
+ *
+ * @param ks   the keyset to search in
+ * @param root the key whose hierarchy should be found
+ * @param end  the index after the last key of the hierarchy will be stored here
+ *
+ * @return the index of the first key below or same as @p root
+ *         (equals @p end, if there is no such key)
+ * @retval -1 on NULL pointers or if @p root has no name
+ * @see ksCut() for cutting out the keys instead
+ */
+ssize_t ksFindHierarchy (const KeySet * ks, const Key * root, size_t * end)
+{
+	if (!ks || !root || !end) return -1;
+	if (!root->key) return -1;
+
+	ssize_t search = ksSearchInternal (ks, root);
+	size_t start = search < 0 ? -search - 1 : search;
+	*end = elektraKsFindHierarchyEnd (ks, root, start);
+	return start;
+}
+
 /**
  * Searches for the start and end indicies corresponding to the given cutpoint.
  *
@@ -1063,10 +1290,7 @@ static int elektraKsFindCutpoint (KeySet * ks, const Key * cutpoint, size_t * fr
 	size_t found = it;
 
 	// search the end of the keyset to cut
-	while (it < ks->size && keyIsBelowOrSame (cutpoint, ks->array[it]) == 1)
-	{
-		++it;
-	}
+	it = elektraKsFindHierarchyEnd (ks, cutpoint, it);
 
 	// correct cursor if cursor is in cut keyset
 	if (ks->current >= found && ks->current < it)
@@ -1175,7 +1399,7 @@ KeySet * ksCut (KeySet * ks, const Key * cutpoint)
 	if (!name) return 0;
 	// if (strcmp(name, "")) return 0;
 
-	elektraOpmphmInvalidate (ks);
+	elektraKsChanged (ks);
 
 	if (name[0] == '/')
 	{
@@ -1326,7 +1550,7 @@ Key * ksPop (KeySet * ks)
 
 	if (ks->size == 0) return 0;
 
-	elektraOpmphmInvalidate (ks);
+	elektraKsChanged (ks);
 
 	--ks->size;
 	if (ks->size + 1 < ks->alloc / 2) ksResize (ks, ks->alloc / 2 - 1);
@@ -2738,6 +2962,8 @@ int ksInit (KeySet * ks)
 	ks->size = 0;
 	ks->alloc = 0;
 	ks->flags = 0;
+	// every keyset starts with other generations
+	ks->generation = __atomic_add_fetch (&ksGenerations, KS_GENERATION_START, __ATOMIC_RELAXED);
 
 	ksRewind (ks);
 
@@ -2782,7 +3008,7 @@ int ksClose (KeySet * ks)
 
 	ks->size = 0;
 
-	elektraOpmphmInvalidate (ks);
+	elektraKsChanged (ks);
 
 	return 0;
 }
@@ -522,6 +522,21 @@ int mountVersion (KDB * kdb, Key * errorKey)
 	return 0;
 }
 
+/** Mount the stats backend
+ *
+ * @param kdb the handle to work with
+ * @param errorKey the key used to report warnings
+ * @ingroup mount
+ * @retval 0 on success
+ */
+int mountStats (KDB * kdb, Key * errorKey)
+{
+	Backend * backend = backendOpenStats (kdb, errorKey);
+	mountBackend (kdb, backend, errorKey);
+
+	return 0;
+}
+
 /**
  * Mounts a backend into the trie.
  *
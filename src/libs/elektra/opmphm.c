@@ -15,6 +15,16 @@
 
 #include <string.h>
 
+/**
+ * With OpenMP (ENABLE_OPMPHM_PARALLEL) the edges of large graphs are generated
+ * and peeled by several threads, otherwise the pragmas vanish.
+ */
+#ifdef _OPENMP
+#define OPMPHM_OMP(directive) _Pragma (#directive)
+#else
+#define OPMPHM_OMP(directive)
+#endif
+
 static int hasCycle (Opmphm * opmphm, OpmphmGraph * graph, size_t n);
 
 /**
@@ -150,6 +160,9 @@ int opmphmAssignment (Opmphm * opmphm, OpmphmGraph * graph, size_t n, int defaul
  * Inserts each element as edge in the r-uniform r-partite hypergraph and checks if the graph contains a cycle.
  * If there are cycles the `graph` will be cleaned
  *
+ * With at least KDB_OPMPHM_PARALLEL_MIN_N elements the edges are generated by several threads,
+ * so `OpmphmInit->getName` must be thread-safe.
+ *
  * @param opmphm the OPMPHM
  * @param graph the OpmphmGraph
  * @param init the OpmphmInit
@@ -174,25 +187,31 @@ int opmphmMapping (Opmphm * opmphm, OpmphmGraph * graph, OpmphmInit * init, size
 		elektraRand (&(init->initSeed));
 		opmphm->hashFunctionSeeds[r] = init->initSeed;
 	}
+#ifndef OPMPHM_TEST
+	// set edge.h[], hashing and inserting in separate loops keeps the random writes to the vertices from stalling the hashing
+	OPMPHM_OMP (omp parallel for if (n >= KDB_OPMPHM_PARALLEL_MIN_N))
 	for (size_t i = 0; i < n; ++i)
 	{
-#ifndef OPMPHM_TEST
 		const char * name = init->getName (init->data[i]);
-#endif
+		size_t nameLength = strlen (name);
 		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
 		{
-#ifndef OPMPHM_TEST
-			// set edge.h[]
 			graph->edges[i].vertices[r] =
-				opmphmHashfunction (name, strlen (name), opmphm->hashFunctionSeeds[r]) % opmphm->componentSize;
+				opmphmHashfunction (name, nameLength, opmphm->hashFunctionSeeds[r]) % opmphm->componentSize;
+		}
+	}
 #endif
-			// add edge to graph
-			// set edge.nextEdge[r]
+	// add edges to graph
+	OPMPHM_OMP (omp parallel for if (n >= KDB_OPMPHM_PARALLEL_MIN_N))
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+		{
 			size_t v = r * opmphm->componentSize + graph->edges[i].vertices[r];
-			graph->edges[i].nextEdge[r] = graph->vertices[v].firstEdge;
-			// set vertex.firstEdge
-			graph->vertices[v].firstEdge = i;
+			OPMPHM_OMP (omp atomic)
+			graph->vertices[v].edgesXor ^= (uint32_t) i;
 			// increment degree
+			OPMPHM_OMP (omp atomic)
 			++graph->vertices[v].degree;
 		}
 	}
@@ -209,43 +228,60 @@ int opmphmMapping (Opmphm * opmphm, OpmphmGraph * graph, OpmphmInit * init, size
 }
 
 /**
- * @brief Recursive function used by hasCycle
+ * @brief Peels off the edge of a vertex with degree 1, used by hasCycle
  *
- * `v` is a degree 1 vertex with edge `e`. The edge `e` will be removed completely from the graph and
- * inserted in the `OpmphmGraph->removeSequence`.
- * For all vertices connected through `e` with degree 1 the function will be called again.
+ * The only edge `e` of `v` is inserted in the `OpmphmGraph->removeSequence`, if it is not already there.
+ * The edge stays in the graph until removeEdges () of the next round.
  *
- * @param opmphm the OPMPHM
  * @param graph the OpmphmGraph
- * @param v a vertex with degree 1
+ * @param v a vertex
  */
-static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
+static inline void peelOff (OpmphmGraph * graph, size_t v)
 {
-	uint32_t e = graph->vertices[v].firstEdge;
-	// add it to graph->removeSequence
-	graph->removeSequence[graph->removeIndex] = e;
-	++graph->removeIndex;
-	// remove edge e from graph
-	for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+	if (graph->vertices[v].degree != 1)
 	{
-		// w is adjacent to v through e
-		size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
-		// remove e from w
-		uint32_t * j = &(graph->vertices[w].firstEdge);
-		for (; *j != e; j = &(graph->edges[*j].nextEdge[r]))
-			;
-		*j = graph->edges[*j].nextEdge[r];
-		// decrease degree
-		--graph->vertices[w].degree;
-	}
-	// all vertices adjacent to v through e
-	for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+		return;
+	}
+	uint32_t e = graph->vertices[v].edgesXor;
+	// other vertices of e might have degree 1 too
+	uint8_t removed;
+	OPMPHM_OMP (omp atomic capture)
 	{
-		size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
-		// if degree 1, go on
-		if (graph->vertices[w].degree == 1)
+		removed = graph->removed[e];
+		graph->removed[e] = 1;
+	}
+	if (removed)
+	{
+		return;
+	}
+	// add it to graph->removeSequence
+	uint32_t index;
+	OPMPHM_OMP (omp atomic capture)
+	index = graph->removeIndex++;
+	graph->removeSequence[index] = e;
+}
+
+/**
+ * @brief Removes the edges peeled off in one round, used by hasCycle
+ *
+ * @param opmphm the OPMPHM
+ * @param graph the OpmphmGraph
+ * @param start the index of the first edge of the round in `OpmphmGraph->removeSequence`
+ * @param end the index after the last edge of the round
+ */
+static void removeEdges (Opmphm * opmphm, OpmphmGraph * graph, size_t start, size_t end)
+{
+	OPMPHM_OMP (omp parallel for if (end - start >= KDB_OPMPHM_PARALLEL_MIN_N))
+	for (size_t i = start; i < end; ++i)
+	{
+		uint32_t e = graph->removeSequence[i];
+		for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
 		{
-			peel_off (opmphm, graph, w);
+			size_t w = r * opmphm->componentSize + graph->edges[e].vertices[r];
+			OPMPHM_OMP (omp atomic)
+			graph->vertices[w].edgesXor ^= e;
+			OPMPHM_OMP (omp atomic)
+			--graph->vertices[w].degree;
 		}
 	}
 }
@@ -257,6 +293,10 @@ static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
  * The sequence of removed edges will be saved in `OpmphmGraph->removeSequence`.
  * The passed OpmphmGraph is will be destroyed.
  *
+ * The edges are peeled off in rounds: first all edges with a degree 1 vertex, then the edges
+ * of the vertices that got degree 1 by removing the edges of the previous round.
+ * All edges of one round can be assigned in any order, so large rounds are handled by several threads.
+ *
  * @param opmphm the OPMPHM
  * @param graph the OpmphmGraph
  * @param n the number of elements
@@ -267,14 +307,31 @@ static void peel_off (Opmphm * opmphm, OpmphmGraph * graph, size_t v)
 static int hasCycle (Opmphm * opmphm, OpmphmGraph * graph, size_t n)
 {
 	graph->removeIndex = 0;
+	memset (graph->removed, 0, n);
 	// search all vertices
-	for (size_t v = 0; v < opmphm->componentSize * opmphm->rUniPar; ++v)
+	size_t vertices = opmphm->componentSize * opmphm->rUniPar;
+	OPMPHM_OMP (omp parallel for if (n >= KDB_OPMPHM_PARALLEL_MIN_N))
+	for (size_t v = 0; v < vertices; ++v)
+	{
+		peelOff (graph, v);
+	}
+	size_t start = 0;
+	size_t end = graph->removeIndex;
+	while (start < end)
 	{
-		// for a vertex with degree 1
-		if (graph->vertices[v].degree == 1)
+		removeEdges (opmphm, graph, start, end);
+		// search the vertices of the removed edges
+		OPMPHM_OMP (omp parallel for if (end - start >= KDB_OPMPHM_PARALLEL_MIN_N))
+		for (size_t i = start; i < end; ++i)
 		{
-			peel_off (opmphm, graph, v);
+			uint32_t e = graph->removeSequence[i];
+			for (uint8_t r = 0; r < opmphm->rUniPar; ++r)
+			{
+				peelOff (graph, r * opmphm->componentSize + graph->edges[e].vertices[r]);
+			}
 		}
+		start = end;
+		end = graph->removeIndex;
 	}
 	if (graph->removeIndex == n)
 	{
@@ -457,10 +514,10 @@ OpmphmGraph * opmphmGraphNew (Opmphm * opmphm, uint8_t r, size_t n, double c)
 	/* one malloc for:
 	 * - graph->removeSequence	n
 	 * - graph->edges[i].vertices	n * opmphm->rUniPar
-	 * - graph->edges[i].nextEdge	n * opmphm->rUniPar
+	 * - graph->removed		n bytes
 	 */
-	uint32_t * removeSequenceVerticesNextEdge = elektraMalloc ((n + 2 * n * opmphm->rUniPar) * sizeof (uint32_t));
-	if (!removeSequenceVerticesNextEdge)
+	uint32_t * removeSequenceVerticesRemoved = elektraMalloc ((n + n * opmphm->rUniPar) * sizeof (uint32_t) + n);
+	if (!removeSequenceVerticesRemoved)
 	{
 		opmphm->componentSize = 0;
 		elektraFree (graph->vertices);
@@ -468,13 +525,13 @@ OpmphmGraph * opmphmGraphNew (Opmphm * opmphm, uint8_t r, size_t n, double c)
 		elektraFree (graph);
 		return NULL;
 	}
-	// split removeSequenceVerticesNextEdge for graph->removeSequence, and for graph->edges[].vertices and graph->edges[].nextEdge
-	graph->removeSequence = &removeSequenceVerticesNextEdge[0];
+	// split removeSequenceVerticesRemoved for graph->removeSequence, graph->edges[].vertices and graph->removed
+	graph->removeSequence = &removeSequenceVerticesRemoved[0];
 	for (size_t i = 0; i < n; ++i)
 	{
-		graph->edges[i].vertices = &removeSequenceVerticesNextEdge[n + i * opmphm->rUniPar];
-		graph->edges[i].nextEdge = &removeSequenceVerticesNextEdge[(n + opmphm->rUniPar * n) + i * opmphm->rUniPar];
+		graph->edges[i].vertices = &removeSequenceVerticesRemoved[n + i * opmphm->rUniPar];
 	}
+	graph->removed = (uint8_t *) &removeSequenceVerticesRemoved[n + n * opmphm->rUniPar];
 	return graph;
 }
 
@@ -635,6 +692,37 @@ void opmphmClear (Opmphm * opmphm)
 	}
 }
 
+/**
+ * Multiply-xorshift hash function
+ *
+ * Reads 8 bytes at once, the last bytes are read without crossing the end of the key.
+ * The hash values depend on the byte order, they are not meant to be stored.
+ */
+// sanitize a hash function is silly, so ignore it!
+ELEKTRA_NO_SANITIZE_UNDEFINED
+ELEKTRA_NO_SANITIZE_INTEGER
+uint32_t opmphmHashfunctionMxs (const void * key, size_t length, uint32_t initval)
+{
+	uint64_t h = (((uint64_t) initval << 32) | (uint32_t) length) * OPMPHM_HASHFUNCTION_MXS_K1;
+	const uint8_t * k = (const uint8_t *) key;
+	uint64_t w;
+	while (length >= 8)
+	{
+		memcpy (&w, k, 8);
+		OPMPHM_HASHFUNCTION_MXS_MIX (h, w);
+		length -= 8;
+		k += 8;
+	}
+	if (length)
+	{
+		w = 0;
+		memcpy (&w, k, length);
+		OPMPHM_HASHFUNCTION_MXS_MIX (h, w);
+	}
+	OPMPHM_HASHFUNCTION_MXS_FINAL (h);
+	return (uint32_t) h;
+}
+
 /**
  * Hash function
  * By Bob Jenkins, May 2006
@@ -646,7 +734,7 @@ void opmphmClear (Opmphm * opmphm)
 // sanitize a hash function is silly, so ignore it!
 ELEKTRA_NO_SANITIZE_UNDEFINED
 ELEKTRA_NO_SANITIZE_INTEGER
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval)
 {
 	uint32_t a, b, c;
 	a = b = c = 0xdeadbeef + ((uint32_t) length) + initval;
@@ -721,7 +809,7 @@ uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
 // sanitize a hash function is silly, so ignore it!
 ELEKTRA_NO_SANITIZE_UNDEFINED
 ELEKTRA_NO_SANITIZE_INTEGER
-uint32_t opmphmHashfunction (const void * key, size_t length, uint32_t initval)
+uint32_t opmphmHashfunctionJenkins (const void * key, size_t length, uint32_t initval)
 {
 	uint32_t a, b, c;
 	a = b = c = 0xdeadbeef + ((uint32_t) length) + initval;
@@ -326,6 +326,7 @@ int elektraPluginClose (Plugin * handle, Key * errorKey)
 	}
 
 	ksDel (handle->config);
+	elektraFree (handle->stats);
 	elektraFree (handle);
 
 	return rc;
@@ -442,6 +443,68 @@ Plugin * elektraPluginVersion (void)
 	return returned;
 }
 
+/**
+ * @internal
+ *
+ * Data of the stats backend.
+ */
+typedef struct
+{
+	KDB * handle;
+	KeySet * returned; /*!< the statistics of the last kdbGet, to detect modifications in kdbSet */
+} ElektraStatsData;
+
+static int elektraStatsGet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	ElektraStatsData * data = handle->data;
+	KeySet * stats = ksNew (0, KS_END);
+	int ret = elektraStatsToKeySet (data->handle, stats, parentKey);
+	ksDel (data->returned);
+	data->returned = ksDeepDup (stats);
+	ksAppend (returned, stats);
+	ksDel (stats);
+	return ret;
+}
+
+static int elektraStatsSet (Plugin * handle, KeySet * returned, Key * error)
+{
+	ElektraStatsData * data = handle->data;
+	KeySet * info = data->returned ? ksDup (data->returned) : ksNew (0, KS_END);
+	ELEKTRA_SET_ERROR_READ_ONLY (info, returned, error);
+	return 0;
+}
+
+static int elektraStatsClose (Plugin * handle, Key * error ELEKTRA_UNUSED)
+{
+	ElektraStatsData * data = handle->data;
+	ksDel (data->returned);
+	elektraFree (data);
+	return 0;
+}
+
+Plugin * elektraPluginStats (KDB * handle)
+{
+	Plugin * returned;
+
+	returned = elektraCalloc (sizeof (struct _Plugin));
+	if (!returned) return 0;
+
+	ElektraStatsData * data = elektraCalloc (sizeof (ElektraStatsData));
+	if (!data)
+	{
+		elektraFree (returned);
+		return 0;
+	}
+	data->handle = handle;
+
+	returned->name = "stats";
+	returned->kdbGet = elektraStatsGet;
+	returned->kdbSet = elektraStatsSet;
+	returned->kdbClose = elektraStatsClose;
+	returned->data = data;
+	return returned;
+}
+
 /**
  * Searches the global plugins for a given plugin name.
  *
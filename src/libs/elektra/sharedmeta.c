@@ -0,0 +1,257 @@
+/**
+ * @file
+ *
+ * @brief Metadata shared by keys.
+ *
+ * Plugins like spec or glob copy the same metadata to many keys. Instead
+ * of a KeySet per key, keys with the same metadata refer to the same
+ * meta KeySet, which counts its references. keyDup(), keyCopy() and
+ * keyCopyAllMeta() only add a reference, keySetMeta() and keyCopyMeta()
+ * copy the KeySet first if other keys still use it (copy on write).
+ * Every key has its own cursor for keyNextMeta().
+ *
+ * ksShareMeta() finds keys with equal, but separately created metadata
+ * and lets them share one KeySet.
+ *
+ * The reference counter is not synchronized: like the keys in a KeySet,
+ * keys sharing metadata must not be used by several threads at once.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "kdbconfig.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "kdbinternal.h"
+
+/**
+ * @internal
+ *
+ * Meta KeySet with reference counter, the KeySet must stay the first
+ * member, so that ksDel() frees the whole struct.
+ */
+typedef struct
+{
+	KeySet ks;
+	size_t references; /*!< number of keys using the metadata */
+} ElektraSharedMeta;
+
+static KeySet * elektraMetaAdopt (KeySet * ks)
+{
+	if (!ks) return NULL;
+	if (elektraRealloc ((void **) &ks, sizeof (ElektraSharedMeta)) == -1)
+	{
+		ksDel (ks);
+		return NULL;
+	}
+	ks->flags |= KS_FLAG_SHARED_META;
+	((ElektraSharedMeta *) ks)->references = 1;
+	return ks;
+}
+
+/**
+ * @brief Create a new meta KeySet for a key
+ *
+ * @return a new meta KeySet with one reference, release it with elektraMetaDel()
+ * @retval NULL on memory errors
+ */
+KeySet * elektraMetaNew (void)
+{
+	return elektraMetaAdopt (ksNew (0, KS_END));
+}
+
+/**
+ * @brief Use the meta KeySet of a key for another key
+ *
+ * Meta KeySets inside a mmap region cannot be shared, they are copied.
+ *
+ * @param meta the meta KeySet of the other key
+ *
+ * @return @p meta with an additional reference, or a copy of it
+ * @retval NULL on NULL pointer or memory errors
+ */
+KeySet * elektraMetaRef (KeySet * meta)
+{
+	if (!meta) return NULL;
+	if (!test_bit (meta->flags, KS_FLAG_SHARED_META)) return elektraMetaAdopt (ksDup (meta));
+
+	++((ElektraSharedMeta *) meta)->references;
+	return meta;
+}
+
+/**
+ * @brief Make sure the metadata of a key is not shared before changing it
+ *
+ * If other keys use the meta KeySet of @p key, the key gets its own copy.
+ * The cursor of the meta KeySet is set to the cursor of the key, so that
+ * changes move it like before, call elektraMetaUpdateCursor() afterwards.
+ *
+ * @param key the key whose metadata will be changed
+ *
+ * @retval 1 if the metadata was copied
+ * @retval 0 if the metadata was not shared
+ * @retval -1 on memory errors
+ */
+int elektraMetaUnshare (Key * key)
+{
+	KeySet * meta = key->meta;
+	if (!meta) return 0;
+
+	int ret = 0;
+	if (test_bit (meta->flags, KS_FLAG_SHARED_META) && ((ElektraSharedMeta *) meta)->references > 1)
+	{
+		KeySet * copy = elektraMetaAdopt (ksDup (meta));
+		if (!copy) return -1;
+
+		--((ElektraSharedMeta *) meta)->references;
+		key->meta = meta = copy;
+		ret = 1;
+	}
+
+	if (key->metaCursor == 0 || key->metaCursor > meta->size)
+	{
+		meta->current = key->metaCursor == 0 ? 0 : meta->size;
+		meta->cursor = 0;
+	}
+	else
+	{
+		meta->current = key->metaCursor - 1;
+		meta->cursor = meta->array[meta->current];
+	}
+	return ret;
+}
+
+/**
+ * @brief Set the cursor of a key to the cursor of its changed meta KeySet
+ *
+ * @param key the key whose metadata was changed
+ */
+void elektraMetaUpdateCursor (Key * key)
+{
+	KeySet * meta = key->meta;
+	key->metaCursor = meta->cursor ? meta->current + 1 : meta->current;
+}
+
+/**
+ * @brief Release the reference of a key to its meta KeySet
+ *
+ * The KeySet is deleted with the last reference.
+ *
+ * @param meta the meta KeySet, may be NULL
+ */
+void elektraMetaDel (KeySet * meta)
+{
+	if (!meta) return;
+	if (test_bit (meta->flags, KS_FLAG_SHARED_META) && --((ElektraSharedMeta *) meta)->references > 0) return;
+
+	ksDel (meta);
+}
+
+static size_t elektraMetaHash (const KeySet * meta)
+{
+	// FNV-1a over names and values
+	uint64_t hash = UINT64_C (14695981039346656037);
+	for (size_t i = 0; i < meta->size; ++i)
+	{
+		const Key * cur = meta->array[i];
+		for (const char * c = cur->key; c && *c; ++c)
+		{
+			hash = (hash ^ (unsigned char) *c) * UINT64_C (1099511628211);
+		}
+		hash = (hash ^ '=') * UINT64_C (1099511628211);
+		const unsigned char * value = cur->data.v;
+		for (size_t j = 0; value && j < cur->dataSize; ++j)
+		{
+			hash = (hash ^ value[j]) * UINT64_C (1099511628211);
+		}
+	}
+	return (size_t) hash;
+}
+
+static int elektraMetaEqual (const KeySet * meta1, const KeySet * meta2)
+{
+	if (meta1->size != meta2->size) return 0;
+
+	// metadata is sorted by name
+	for (size_t i = 0; i < meta1->size; ++i)
+	{
+		const Key * m1 = meta1->array[i];
+		const Key * m2 = meta2->array[i];
+		if (m1 == m2) continue;
+		if (strcmp (keyName (m1), keyName (m2)) != 0) return 0;
+		if (m1->dataSize != m2->dataSize) return 0;
+		if (m1->dataSize > 0 && memcmp (m1->data.v, m2->data.v, m1->dataSize) != 0) return 0;
+	}
+	return 1;
+}
+
+/**
+ * @brief Let keys with equal metadata share their meta KeySet
+ *
+ * Storage plugins create the metadata of every key on its own, even if
+ * many keys have the same metadata (e.g. type and check/ of all elements
+ * of an array). Afterwards, all keys of @p ks with equal metadata use
+ * the same meta KeySet, the other meta KeySets are freed. The metadata
+ * of every key stays the same, only keys that got another meta KeySet
+ * are rewound (see keyRewindMeta()).
+ *
+ * Keys whose metadata is inside a mmap region are skipped.
+ *
+ * @param ks the keys whose metadata should be shared
+ *
+ * @return the number of keys whose meta KeySet was replaced
+ * @retval -1 on NULL pointer or memory errors
+ * @ingroup proposal
+ */
+ssize_t ksShareMeta (KeySet * ks)
+{
+	if (!ks) return -1;
+
+	size_t tableSize = 16;
+	while (tableSize < 2 * ks->size)
+	{
+		tableSize *= 2;
+	}
+
+	KeySet ** table = elektraCalloc (tableSize * sizeof (KeySet *));
+	size_t * hashes = elektraMalloc (tableSize * sizeof (size_t));
+	if (!table || !hashes)
+	{
+		elektraFree (table);
+		elektraFree (hashes);
+		return -1;
+	}
+
+	ssize_t replaced = 0;
+	for (size_t i = 0; i < ks->size; ++i)
+	{
+		Key * cur = ks->array[i];
+		if (!cur->meta || !test_bit (cur->meta->flags, KS_FLAG_SHARED_META)) continue;
+
+		size_t hash = elektraMetaHash (cur->meta);
+		size_t slot = hash & (tableSize - 1);
+		while (table[slot] && (hashes[slot] != hash || !elektraMetaEqual (table[slot], cur->meta)))
+		{
+			slot = (slot + 1) & (tableSize - 1);
+		}
+
+		if (!table[slot])
+		{
+			table[slot] = cur->meta;
+			hashes[slot] = hash;
+		}
+		else if (table[slot] != cur->meta)
+		{
+			elektraMetaDel (cur->meta);
+			cur->meta = elektraMetaRef (table[slot]);
+			cur->metaCursor = 0;
+			++replaced;
+		}
+	}
+
+	elektraFree (table);
+	elektraFree (hashes);
+	return replaced;
+}
@@ -0,0 +1,411 @@
+/**
+ * @file
+ *
+ * @brief Statistics of kdbGet() and kdbSet().
+ *
+ * If enabled with elektraStatsEnable(), every call of a plugin is
+ * counted and timed with a monotonic clock, together with the sizes
+ * of the keysets passed in and returned. The counters live in the
+ * plugins, so no lookup is needed per call. Disabled statistics cost
+ * one branch per plugin call.
+ *
+ * The statistics are exposed below system/elektra/stats by the
+ * stats backend, see elektraStatsToKeySet().
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include "kdbconfig.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <time.h>
+
+#include <kdbprivate.h>
+
+static const char * const elektraStatsPhaseNames[ELEKTRA_STATS_PHASES] = { "get", "set", "error", "split", "cache" };
+
+static uint64_t elektraStatsNow (void)
+{
+#ifdef HAVE_CLOCK_GETTIME
+	struct timespec ts;
+	clock_gettime (CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000 + (uint64_t) ts.tv_nsec;
+#else
+	return (uint64_t) clock () * (1000000000 / CLOCKS_PER_SEC);
+#endif
+}
+
+static void elektraStatsRecord (ElektraStatsCounter * counter, uint64_t start, size_t keysIn, size_t keysOut)
+{
+	const uint64_t duration = elektraStatsNow () - start;
+
+	++counter->calls;
+	counter->keysIn += keysIn;
+	counter->keysOut += keysOut;
+	counter->nanoseconds += duration;
+	if (duration > counter->maxNanoseconds) counter->maxNanoseconds = duration;
+
+	size_t bucket = 0;
+	for (uint64_t us = duration / 1000; us > 0 && bucket < ELEKTRA_STATS_BUCKETS - 1; us >>= 1)
+	{
+		++bucket;
+	}
+	++counter->histogram[bucket];
+}
+
+/**
+ * @internal
+ *
+ * Calls kdbGet of @p plugin and records it, if statistics are enabled.
+ *
+ * @return the return value of the plugin
+ */
+int elektraStatsPluginGet (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	if (!plugin->stats) return plugin->kdbGet (plugin, ks, parentKey);
+
+	const size_t keysIn = ksGetSize (ks);
+	const uint64_t start = elektraStatsNow ();
+	int ret = plugin->kdbGet (plugin, ks, parentKey);
+	elektraStatsRecord (&plugin->stats[ELEKTRA_STATS_GET], start, keysIn, ksGetSize (ks));
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * Calls kdbSet of @p plugin and records it, if statistics are enabled.
+ *
+ * @return the return value of the plugin
+ */
+int elektraStatsPluginSet (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	if (!plugin->stats) return plugin->kdbSet (plugin, ks, parentKey);
+
+	const size_t keysIn = ksGetSize (ks);
+	const uint64_t start = elektraStatsNow ();
+	int ret = plugin->kdbSet (plugin, ks, parentKey);
+	elektraStatsRecord (&plugin->stats[ELEKTRA_STATS_SET], start, keysIn, ksGetSize (ks));
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * Calls kdbError of @p plugin and records it, if statistics are enabled.
+ *
+ * @return the return value of the plugin
+ */
+int elektraStatsPluginError (Plugin * plugin, KeySet * ks, Key * parentKey)
+{
+	if (!plugin->stats) return plugin->kdbError (plugin, ks, parentKey);
+
+	const size_t keysIn = ksGetSize (ks);
+	const uint64_t start = elektraStatsNow ();
+	int ret = plugin->kdbError (plugin, ks, parentKey);
+	elektraStatsRecord (&plugin->stats[ELEKTRA_STATS_ERROR], start, keysIn, ksGetSize (ks));
+	return ret;
+}
+
+/**
+ * @internal
+ *
+ * Calls kdbGetSubtree of @p plugin and records it as get, if statistics are enabled.
+ *
+ * @return the return value of the plugin
+ */
+int elektraStatsPluginGetSubtree (Plugin * plugin, KeySet * ks, Key * parentKey, Key * subtreeKey)
+{
+	if (!plugin->stats) return plugin->kdbGetSubtree (plugin, ks, parentKey, subtreeKey);
+
+	const size_t keysIn = ksGetSize (ks);
+	const uint64_t start = elektraStatsNow ();
+	int ret = plugin->kdbGetSubtree (plugin, ks, parentKey, subtreeKey);
+	elektraStatsRecord (&plugin->stats[ELEKTRA_STATS_GET], start, keysIn, ksGetSize (ks));
+	return ret;
+}
+
+static void elektraStatsAttachPlugin (Plugin * plugin)
+{
+	if (plugin && !plugin->stats)
+	{
+		plugin->stats = elektraCalloc (ELEKTRA_STATS_PLUGIN_PHASES * sizeof (ElektraStatsCounter));
+	}
+}
+
+static void elektraStatsDetachPlugin (Plugin * plugin)
+{
+	if (plugin)
+	{
+		elektraFree (plugin->stats);
+		plugin->stats = NULL;
+	}
+}
+
+static void elektraStatsForEachPlugin (KDB * handle, void (*callback) (Plugin *))
+{
+	for (size_t i = 0; handle->split && i < handle->split->size; ++i)
+	{
+		Backend * backend = handle->split->handles[i];
+		for (size_t p = 0; p < NR_OF_PLUGINS; ++p)
+		{
+			callback (backend->getplugins[p]);
+			callback (backend->setplugins[p]);
+			callback (backend->errorplugins[p]);
+		}
+	}
+
+	for (int i = 0; i < NR_GLOBAL_POSITIONS; ++i)
+	{
+		for (int j = 0; j < NR_GLOBAL_SUBPOSITIONS; ++j)
+		{
+			callback (handle->globalPlugins[i][j]);
+		}
+	}
+}
+
+/**
+ * @brief Enable or disable statistics of kdbGet() and kdbSet()
+ *
+ * While enabled, every plugin call of @p handle is counted and timed.
+ * The statistics can be read below `system/elektra/stats` with
+ * kdbGet(). Disabling them discards all statistics collected so far.
+ *
+ * @param handle the handle to instrument
+ * @param enable 1 to enable, 0 to disable the statistics
+ *
+ * @retval 0 on success
+ * @retval -1 on NULL pointers or memory errors
+ * @ingroup proposal
+ */
+int elektraStatsEnable (KDB * handle, int enable)
+{
+	if (!handle) return -1;
+
+	if (!enable)
+	{
+		elektraStatsForEachPlugin (handle, elektraStatsDetachPlugin);
+		elektraFree (handle->stats);
+		handle->stats = NULL;
+		return 0;
+	}
+
+	if (!handle->stats)
+	{
+		handle->stats = elektraCalloc (sizeof (ElektraStats));
+		if (!handle->stats) return -1;
+	}
+	elektraStatsAttach (handle);
+	return 0;
+}
+
+/**
+ * @internal
+ *
+ * Allocates the counters of plugins mounted since the statistics were
+ * enabled. Does nothing if statistics are disabled.
+ */
+void elektraStatsAttach (KDB * handle)
+{
+	if (!handle || !handle->stats) return;
+	elektraStatsForEachPlugin (handle, elektraStatsAttachPlugin);
+}
+
+/**
+ * @internal
+ *
+ * Starts timing a phase of @p handle.
+ *
+ * @return the start time to pass to elektraStatsStop()
+ */
+uint64_t elektraStatsStart (KDB * handle)
+{
+	if (!handle || !handle->stats) return 0;
+	return elektraStatsNow ();
+}
+
+/**
+ * @internal
+ *
+ * Records a phase of @p handle started with elektraStatsStart().
+ */
+void elektraStatsStop (KDB * handle, ElektraStatsPhase phase, uint64_t start)
+{
+	if (!handle || !handle->stats) return;
+	elektraStatsRecord (&handle->stats->phases[phase - ELEKTRA_STATS_PLUGIN_PHASES], start, 0, 0);
+}
+
+static void elektraStatsAppendValue (KeySet * returned, const Key * base, const char * name, uint64_t value)
+{
+	char buffer[21];
+	snprintf (buffer, sizeof (buffer), "%" PRIu64, value);
+
+	Key * key = keyDup (base);
+	keyAddName (key, name);
+	keySetString (key, buffer);
+	ksAppendKey (returned, key);
+}
+
+static void elektraStatsAppendCounter (KeySet * returned, const Key * base, ElektraStatsPhase phase, const ElektraStatsCounter * counter)
+{
+	if (counter->calls == 0) return;
+
+	Key * key = keyDup (base);
+	keyAddBaseName (key, elektraStatsPhaseNames[phase]);
+	ksAppendKey (returned, key);
+
+	elektraStatsAppendValue (returned, key, "calls", counter->calls);
+	elektraStatsAppendValue (returned, key, "keys/in", counter->keysIn);
+	elektraStatsAppendValue (returned, key, "keys/out", counter->keysOut);
+	elektraStatsAppendValue (returned, key, "time/total", counter->nanoseconds);
+	elektraStatsAppendValue (returned, key, "time/max", counter->maxNanoseconds);
+
+	char name[32];
+	for (size_t b = 0; b < ELEKTRA_STATS_BUCKETS; ++b)
+	{
+		if (counter->histogram[b] == 0) continue;
+
+		if (b == ELEKTRA_STATS_BUCKETS - 1)
+		{
+			snprintf (name, sizeof (name), "histogram/inf");
+		}
+		else
+		{
+			snprintf (name, sizeof (name), "histogram/%" PRIu64, (uint64_t) 1 << b);
+		}
+		elektraStatsAppendValue (returned, key, name, counter->histogram[b]);
+	}
+}
+
+static void elektraStatsAppendPlugin (KeySet * returned, const Key * base, Plugin * plugin, uint64_t * totals)
+{
+	Key * key = keyDup (base);
+	keyAddBaseName (key, plugin->name);
+	ksAppendKey (returned, key);
+
+	for (int phase = 0; phase < ELEKTRA_STATS_PLUGIN_PHASES; ++phase)
+	{
+		elektraStatsAppendCounter (returned, key, phase, &plugin->stats[phase]);
+		if (totals) totals[phase] += plugin->stats[phase].nanoseconds;
+	}
+}
+
+static void elektraStatsAppendBackend (KeySet * returned, const Key * base, Backend * backend)
+{
+	Key * key = keyDup (base);
+	const char * mountpoint = keyName (backend->mountpoint);
+	// one level per part of the mountpoint, so that the names are not escaped
+	if (*mountpoint)
+		keyAddName (key, mountpoint);
+	else
+		keyAddBaseName (key, "default");
+	if (ksLookup (returned, key, 0))
+	{
+		// cascading backends are in the split once per namespace
+		keyDel (key);
+		return;
+	}
+	ksAppendKey (returned, key);
+
+	// the same plugin is usually in several lists, e.g. the resolver
+	Plugin * seen[NR_OF_PLUGINS * 3];
+	size_t nrSeen = 0;
+	Plugin ** lists[] = { backend->getplugins, backend->setplugins, backend->errorplugins };
+
+	Key * pluginsKey = keyDup (key);
+	keyAddBaseName (pluginsKey, "plugins");
+
+	uint64_t totals[ELEKTRA_STATS_PLUGIN_PHASES] = { 0 };
+	for (size_t l = 0; l < sizeof (lists) / sizeof (lists[0]); ++l)
+	{
+		for (size_t p = 0; p < NR_OF_PLUGINS; ++p)
+		{
+			Plugin * plugin = lists[l][p];
+			if (!plugin || !plugin->stats) continue;
+
+			size_t s = 0;
+			while (s < nrSeen && seen[s] != plugin)
+			{
+				++s;
+			}
+			if (s < nrSeen) continue;
+			seen[nrSeen++] = plugin;
+
+			elektraStatsAppendPlugin (returned, pluginsKey, plugin, totals);
+		}
+	}
+	keyDel (pluginsKey);
+
+	for (int phase = 0; phase < ELEKTRA_STATS_PLUGIN_PHASES; ++phase)
+	{
+		if (totals[phase] == 0) continue;
+
+		Key * phaseKey = keyDup (key);
+		keyAddBaseName (phaseKey, elektraStatsPhaseNames[phase]);
+		elektraStatsAppendValue (returned, phaseKey, "time/total", totals[phase]);
+		keyDel (phaseKey);
+	}
+}
+
+/**
+ * @internal
+ *
+ * Appends the statistics of @p handle below @p parentKey to @p returned.
+ *
+ * The layout is:
+ *
+ * - `enabled`: 1 if statistics are enabled, 0 otherwise
+ * - `phases/<split|cache>`: the split and cache phases of kdbGet() and kdbSet()
+ * - `backends/<mountpoint>/<get|set|error>/time/total`: time spent in plugins of a backend
+ * - `backends/<mountpoint>/plugins/<plugin>/<get|set|error>`: the plugins of a backend
+ * - `global/<plugin>/<get|set|error>`: the global plugins
+ *
+ * Every phase has the keys `calls`, `keys/in`, `keys/out`, `time/total`,
+ * `time/max` (in nanoseconds) and `histogram/<bound>`, the number of calls
+ * that took less than bound microseconds (only non-empty buckets).
+ *
+ * @retval 1 on success
+ */
+int elektraStatsToKeySet (KDB * handle, KeySet * returned, Key * parentKey)
+{
+	Key * root = keyNew (keyName (parentKey), KEY_END);
+	ksAppendKey (returned, root);
+	elektraStatsAppendValue (returned, root, "enabled", handle && handle->stats);
+	if (!handle || !handle->stats) return 1;
+
+	Key * base = keyDup (root);
+	keyAddBaseName (base, "phases");
+	for (int phase = ELEKTRA_STATS_PLUGIN_PHASES; phase < ELEKTRA_STATS_PHASES; ++phase)
+	{
+		elektraStatsAppendCounter (returned, base, phase, &handle->stats->phases[phase - ELEKTRA_STATS_PLUGIN_PHASES]);
+	}
+
+	keySetBaseName (base, "backends");
+	for (size_t i = 0; handle->split && i < handle->split->size; ++i)
+	{
+		elektraStatsAppendBackend (returned, base, handle->split->handles[i]);
+	}
+
+	keySetBaseName (base, "global");
+	for (int i = 0; i < NR_GLOBAL_POSITIONS; ++i)
+	{
+		for (int j = 0; j < NR_GLOBAL_SUBPOSITIONS; ++j)
+		{
+			Plugin * plugin = handle->globalPlugins[i][j];
+			if (!plugin || !plugin->stats) continue;
+
+			// plugins like list are mounted in many positions
+			Key * lookup = keyDup (base);
+			keyAddBaseName (lookup, plugin->name);
+			Key * found = ksLookup (returned, lookup, 0);
+			keyDel (lookup);
+			if (found) continue;
+
+			elektraStatsAppendPlugin (returned, base, plugin, NULL);
+		}
+	}
+	keyDel (base);
+
+	return 1;
+}
@@ -10,6 +10,7 @@
 #include <kdbease.h>
 #include <kdbglobbing.h>
 #include <kdbhelper.h>
+#include <kdbprivate.h>
 
 #include <ctype.h>
 #include <fnmatch.h>
@@ -80,74 +81,60 @@ static int checkElektraExtensions (const char * name, const char * pattern)
 }
 
 /**
- * @brief checks whether a given Key matches a given globbing pattern
- *
- * WARNING: this method will not work correctly, if key parts contain embedded (escaped) slashes.
- *
- * The globbing patterns for this function are a superset of those from glob(7)
- * used with the FNM_PATHNAME flag:
- * <ul>
- * 	<li> '*' matches any series of characters other than '/'</li>
- * 	<li> '?' matches any single character except '/' </li>
- * 	<li> '#', when used as "/#/" (or "/#" at the end of @p pattern), matches a valid array item </li>
- * 	<li> '_', when used as "/_/"(or "/_" at the end of @p pattern), matches a key part that is <b>not</b> a valid array item </li>
- * 	<li>
- * 		everything between '[' and ']' is treated as a character class, matching exactly one of the
- * 		given characters (see glob(7) for details)
- * 	</li>
- * 	<li> if the pattern ends with "/__", matching key names may contain arbitrary suffixes </li>
- * </ul>
+ * @brief a globbing pattern prepared for matching many keys
  *
- * @note '*' cannot match an empty key name part. This also means patterns like "something&#47;*" will
- * not match the key "something". This is because each slash ('/') in the pattern has to correspond to
- * a slash in the canonical key name, which neither end in a slash nor contain multiple slashes in sequence.
- *
- * @note use "[_]", "[#]", "[*]", "[?]" and "[[]" to match the literal characters '_', '#', '*', '?' and '['.
- * Using backslash ('\') for escaping is not supported.
- *
- * @param key the Key to match against the globbing pattern
- * @param pattern the globbing pattern used
- * @retval 0 if @p key is not NULL, @p pattern is not NULL and @p pattern matches @p key
- * @retval ELEKTRA_GLOB_NOMATCH otherwise
- *
- * @see isArrayName(), for info on valid array items
+ * The conversion to a fnmatch(3) pattern and the analysis of the
+ * pattern are done once in compilePattern(), instead of for every key.
  */
-int elektraKeyGlob (const Key * key, const char * pattern)
+typedef struct
 {
-	if (key == NULL || pattern == NULL)
-	{
-		return ELEKTRA_GLOB_NOMATCH;
-	}
-
-	size_t nameSize = (size_t) keyGetNameSize (key);
-	char * name = elektraMalloc (nameSize);
-	keyGetName (key, name, nameSize);
+	const char * pattern;
+	char * fnmPattern;
+	size_t patternSlashes;
+	bool prefixMode;
+} GlobPattern;
 
+static void compilePattern (GlobPattern * glob, const char * pattern)
+{
 	size_t len = strlen (pattern);
-	bool prefixMode = len >= 2 && elektraStrCmp (pattern + len - 3, "/__") == 0;
-
-	size_t patternSlashes = strcnt (pattern, '/');
+	glob->pattern = pattern;
+	glob->prefixMode = len >= 2 && elektraStrCmp (pattern + len - 3, "/__") == 0;
+	glob->patternSlashes = strcnt (pattern, '/');
 
-	if (prefixMode)
+	if (glob->prefixMode)
 	{
 		// last slash in pattern is treated specially
-		patternSlashes--;
+		glob->patternSlashes--;
 	}
 
+	glob->fnmPattern = elektraToFnmatchGlob (elektraStrDup (pattern));
+	if (glob->prefixMode)
+	{
+		// remove __ from end
+		*(glob->fnmPattern + len - 3) = '\0';
+	}
+}
+
+static int matchPattern (const GlobPattern * glob, const Key * key)
+{
+	size_t nameSize = (size_t) keyGetNameSize (key);
+	char * name = elektraMalloc (nameSize);
+	keyGetName (key, name, nameSize);
+
 	char * patternEnd = name;
-	for (size_t i = 0; i < patternSlashes; ++i)
+	for (size_t i = 0; i < glob->patternSlashes; ++i)
 	{
 		patternEnd = strchr (patternEnd + 1, '/');
 
 		if (patternEnd == NULL)
 		{
 			// more slashes in pattern, cannot match
-			free (name);
+			elektraFree (name);
 			return ELEKTRA_GLOB_NOMATCH;
 		}
 	}
 
-	if (prefixMode)
+	if (glob->prefixMode)
 	{
 		// mark end of relevant part
 		char * next = strchr (patternEnd + 1, '/');
@@ -159,29 +146,130 @@ int elektraKeyGlob (const Key * key, const char * pattern)
 	else if (strchr (patternEnd + 1, '/') != NULL)
 	{
 		// more slashes in name, cannot match
-		free (name);
+		elektraFree (name);
 		return ELEKTRA_GLOB_NOMATCH;
 	}
 
-	char * fnmPattern = elektraToFnmatchGlob (elektraStrDup (pattern));
-	if (prefixMode)
+	int rc = fnmatch (glob->fnmPattern, name, FNM_PATHNAME | FNM_NOESCAPE);
+
+	if (rc == FNM_NOMATCH)
 	{
-		// remove __ from end
-		*(fnmPattern + len - 3) = '\0';
+		elektraFree (name);
+		return ELEKTRA_GLOB_NOMATCH;
 	}
 
-	int rc = fnmatch (fnmPattern, name, FNM_PATHNAME | FNM_NOESCAPE);
-	elektraFree (fnmPattern);
+	rc = checkElektraExtensions (name, glob->pattern);
 
-	if (rc == FNM_NOMATCH)
+	elektraFree (name);
+
+	return rc;
+}
+
+/**
+ * @brief extracts the part of a pattern, which contains no wildcards
+ *
+ * All keys matching @p glob are below or the same as the returned key.
+ * Because a KeySet is sorted, they form a contiguous range, and keys
+ * outside of it do not need to be checked at all.
+ *
+ * @return a new key for the literal prefix, or NULL if the whole KeySet
+ *         has to be searched (no literal prefix, cascading pattern or
+ *         escape sequences, which might be interpreted differently by
+ *         fnmatch and the key name parser)
+ */
+static Key * literalPrefix (const GlobPattern * glob)
+{
+	const char * pattern = glob->pattern;
+	if (*pattern == '/' || strchr (pattern, '\\') != NULL)
 	{
-		free (name);
-		return ELEKTRA_GLOB_NOMATCH;
+		return NULL;
 	}
 
-	rc = checkElektraExtensions (name, pattern);
+	const char * end = pattern;
+	const char * part = pattern;
+	while (*part != '\0')
+	{
+		const char * partEnd = strchr (part, '/');
+		if (partEnd == NULL)
+		{
+			partEnd = part + strlen (part);
+		}
 
-	free (name);
+		size_t partSize = partEnd - part;
+		bool isWildcard = strcspn (part, "*?[") < partSize || (partSize == 1 && (*part == '#' || *part == '_')) ||
+				  (glob->prefixMode && *partEnd == '\0');
+		if (isWildcard)
+		{
+			break;
+		}
+
+		end = partEnd;
+		part = *partEnd == '\0' ? partEnd : partEnd + 1;
+	}
+
+	if (end == pattern)
+	{
+		return NULL;
+	}
+
+	char * prefix = elektraMalloc (end - pattern + 1);
+	strncpy (prefix, pattern, end - pattern);
+	prefix[end - pattern] = '\0';
+	Key * prefixKey = keyNew (prefix, KEY_END);
+	elektraFree (prefix);
+	if (keyGetNameSize (prefixKey) <= 1)
+	{
+		// not a valid key name, fall back to search everything
+		keyDel (prefixKey);
+		return NULL;
+	}
+	return prefixKey;
+}
+
+/**
+ * @brief checks whether a given Key matches a given globbing pattern
+ *
+ * WARNING: this method will not work correctly, if key parts contain embedded (escaped) slashes.
+ *
+ * The globbing patterns for this function are a superset of those from glob(7)
+ * used with the FNM_PATHNAME flag:
+ * <ul>
+ * 	<li> '*' matches any series of characters other than '/'</li>
+ * 	<li> '?' matches any single character except '/' </li>
+ * 	<li> '#', when used as "/#/" (or "/#" at the end of @p pattern), matches a valid array item </li>
+ * 	<li> '_', when used as "/_/"(or "/_" at the end of @p pattern), matches a key part that is <b>not</b> a valid array item </li>
+ * 	<li>
+ * 		everything between '[' and ']' is treated as a character class, matching exactly one of the
+ * 		given characters (see glob(7) for details)
+ * 	</li>
+ * 	<li> if the pattern ends with "/__", matching key names may contain arbitrary suffixes </li>
+ * </ul>
+ *
+ * @note '*' cannot match an empty key name part. This also means patterns like "something&#47;*" will
+ * not match the key "something". This is because each slash ('/') in the pattern has to correspond to
+ * a slash in the canonical key name, which neither end in a slash nor contain multiple slashes in sequence.
+ *
+ * @note use "[_]", "[#]", "[*]", "[?]" and "[[]" to match the literal characters '_', '#', '*', '?' and '['.
+ * Using backslash ('\') for escaping is not supported.
+ *
+ * @param key the Key to match against the globbing pattern
+ * @param pattern the globbing pattern used
+ * @retval 0 if @p key is not NULL, @p pattern is not NULL and @p pattern matches @p key
+ * @retval ELEKTRA_GLOB_NOMATCH otherwise
+ *
+ * @see isArrayName(), for info on valid array items
+ */
+int elektraKeyGlob (const Key * key, const char * pattern)
+{
+	if (key == NULL || pattern == NULL)
+	{
+		return ELEKTRA_GLOB_NOMATCH;
+	}
+
+	GlobPattern glob;
+	compilePattern (&glob, pattern);
+	int rc = matchPattern (&glob, key);
+	elektraFree (glob.fnmPattern);
 
 	return rc;
 }
@@ -205,20 +293,35 @@ int elektraKsGlob (KeySet * result, KeySet * input, const char * pattern)
 
 	if (!pattern) return ELEKTRA_GLOB_NOMATCH;
 
+	GlobPattern glob;
+	compilePattern (&glob, pattern);
+
+	cursor_t start = 0;
+	Key * prefix = literalPrefix (&glob);
+	if (prefix != NULL)
+	{
+		ssize_t pos = ksSearchInternal (input, prefix);
+		start = pos < 0 ? -pos - 1 : pos;
+	}
+
 	int ret = 0;
 	Key * current;
-
-	cursor_t cursor = ksGetCursor (input);
-	ksRewind (input);
-	while ((current = ksNext (input)) != 0)
+	for (cursor_t it = start; (current = ksAtCursor (input, it)) != NULL; ++it)
 	{
-		int rc = elektraKeyGlob (current, pattern);
-		if (rc == 0)
+		if (prefix != NULL && !keyIsBelowOrSame (prefix, current))
+		{
+			// keys are sorted, no more keys below prefix
+			break;
+		}
+
+		if (matchPattern (&glob, current) == 0)
 		{
 			++ret;
 			ksAppendKey (result, keyDup (current));
 		}
 	}
-	ksSetCursor (input, cursor);
+
+	keyDel (prefix);
+	elektraFree (glob.fnmPattern);
 	return ret;
 }
@@ -88,6 +88,8 @@ Elektra * elektraOpen (const char * application, KeySet * defaults, ElektraError
 	elektra->fatalErrorHandler = &defaultFatalErrorHandler;
 	elektra->defaults = ksDup (defaults);
 
+	elektraValueCacheBuild (elektra);
+
 	return elektra;
 }
 
@@ -113,6 +115,7 @@ void elektraEnsure (Elektra * elektra, KeySet * contract, ElektraError ** error)
 	Key * parentKey = keyDup (elektra->parentKey);
 
 	kdbClose (elektra->kdb, parentKey);
+	elektraValueCacheClear (elektra);
 	ksClear (elektra->config);
 	KDB * const kdb = kdbOpen (parentKey);
 
@@ -135,6 +138,8 @@ void elektraEnsure (Elektra * elektra, KeySet * contract, ElektraError ** error)
 			*error = elektraErrorCreateFromKey (parentKey);
 			return;
 		}
+
+		elektraValueCacheBuild (elektra);
 	}
 	else if (rc == 1)
 	{
@@ -204,6 +209,7 @@ void elektraClose (Elektra * elektra)
 	keyDel (elektra->parentKey);
 	ksDel (elektra->config);
 	keyDel (elektra->lookupKey);
+	elektraValueCacheClear (elektra);
 
 	if (elektra->resolvedReference != NULL)
 	{
@@ -255,6 +261,9 @@ void elektraSetArrayLookupKey (Elektra * elektra, const char * name, kdb_long_lo
 
 void elektraSaveKey (Elektra * elektra, Key * key, ElektraError ** error)
 {
+	// the cached strings point into keys, which might be replaced
+	elektraValueCacheClear (elektra);
+
 	int ret = 0;
 	do
 	{
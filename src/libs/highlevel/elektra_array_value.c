@@ -240,6 +240,12 @@ void elektraSetRawStringArrayElement (Elektra * elektra, const char * name, kdb_
 }
 
 #define ELEKTRA_GET_ARRAY_ELEMENT_VALUE(KEY_TO_VALUE, KDB_TYPE, elektra, keyname, index, result)                                           \
+	const ElektraCachedValue * cached = elektraValueCacheGetArray (elektra, keyname, KDB_TYPE);                                        \
+	if (cached != NULL && index >= 0 && index < cached->arraySize)                                                                     \
+	{                                                                                                                                  \
+		memcpy (&result, &((const char *) cached->array)[index * sizeof (result)], sizeof (result));                               \
+		return result;                                                                                                             \
+	}                                                                                                                                  \
 	const Key * key = elektraFindArrayElementKey (elektra, keyname, index, KDB_TYPE);                                                  \
 	if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                                   \
 	{                                                                                                                                  \
@@ -446,6 +452,233 @@ kdb_long_double_t elektraGetLongDoubleArrayElement (Elektra * elektra, const cha
 
 #endif // ELEKTRA_HAVE_KDB_LONG_DOUBLE
 
+#define ELEKTRA_GET_ARRAY_VALUES(GET_ARRAY_ELEMENT, KDB_TYPE, elektra, keyname, size)                                                      \
+	const ElektraCachedValue * cached = elektraValueCacheGetArray (elektra, keyname, KDB_TYPE);                                        \
+	if (cached != NULL)                                                                                                                \
+	{                                                                                                                                  \
+		*size = cached->arraySize;                                                                                                 \
+		return cached->array;                                                                                                      \
+	}                                                                                                                                  \
+	/* raises the error of the first element, which can't be read */                                                                  \
+	for (kdb_long_long_t i = 0; i < elektraArraySize (elektra, keyname); ++i)                                                          \
+	{                                                                                                                                  \
+		GET_ARRAY_ELEMENT (elektra, keyname, i);                                                                                   \
+	}                                                                                                                                  \
+	*size = 0;                                                                                                                         \
+	return NULL;
+
+/**
+ * Gets all elements of a string array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the strings stored in the array, NULL if the array is empty
+ */
+const char * const * elektraGetStringArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetStringArrayElement, KDB_TYPE_STRING, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a boolean array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the booleans stored in the array, NULL if the array is empty
+ */
+const kdb_boolean_t * elektraGetBooleanArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetBooleanArrayElement, KDB_TYPE_BOOLEAN, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a char array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the chars stored in the array, NULL if the array is empty
+ */
+const kdb_char_t * elektraGetCharArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetCharArrayElement, KDB_TYPE_CHAR, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of an octet array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the octets stored in the array, NULL if the array is empty
+ */
+const kdb_octet_t * elektraGetOctetArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetOctetArrayElement, KDB_TYPE_OCTET, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a short array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the shorts stored in the array, NULL if the array is empty
+ */
+const kdb_short_t * elektraGetShortArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetShortArrayElement, KDB_TYPE_SHORT, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of an unsigned short array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the unsigned shorts stored in the array, NULL if the array is empty
+ */
+const kdb_unsigned_short_t * elektraGetUnsignedShortArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetUnsignedShortArrayElement, KDB_TYPE_UNSIGNED_SHORT, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a long array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the longs stored in the array, NULL if the array is empty
+ */
+const kdb_long_t * elektraGetLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetLongArrayElement, KDB_TYPE_LONG, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of an unsigned long array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the unsigned longs stored in the array, NULL if the array is empty
+ */
+const kdb_unsigned_long_t * elektraGetUnsignedLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetUnsignedLongArrayElement, KDB_TYPE_UNSIGNED_LONG, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a long long array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the long longs stored in the array, NULL if the array is empty
+ */
+const kdb_long_long_t * elektraGetLongLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetLongLongArrayElement, KDB_TYPE_LONG_LONG, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of an unsigned long long array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the unsigned long longs stored in the array, NULL if the array is empty
+ */
+const kdb_unsigned_long_long_t * elektraGetUnsignedLongLongArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetUnsignedLongLongArrayElement, KDB_TYPE_UNSIGNED_LONG_LONG, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a float array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the floats stored in the array, NULL if the array is empty
+ */
+const kdb_float_t * elektraGetFloatArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetFloatArrayElement, KDB_TYPE_FLOAT, elektra, keyname, size);
+}
+
+/**
+ * Gets all elements of a double array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the doubles stored in the array, NULL if the array is empty
+ */
+const kdb_double_t * elektraGetDoubleArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetDoubleArrayElement, KDB_TYPE_DOUBLE, elektra, keyname, size);
+}
+
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
+/**
+ * Gets all elements of a long double array.
+ *
+ * The elements are decoded only once and stay valid until the next call of a setter,
+ * elektraEnsure() or elektraClose() on @p elektra.
+ *
+ * @param elektra The elektra instance to use.
+ * @param keyname The (relative) name of the array to look up.
+ * @param size    Will be set to the number of elements.
+ * @return the long doubles stored in the array, NULL if the array is empty
+ */
+const kdb_long_double_t * elektraGetLongDoubleArray (Elektra * elektra, const char * keyname, kdb_long_long_t * size)
+{
+	ELEKTRA_GET_ARRAY_VALUES (elektraGetLongDoubleArrayElement, KDB_TYPE_LONG_DOUBLE, elektra, keyname, size);
+}
+
+#endif // ELEKTRA_HAVE_KDB_LONG_DOUBLE
+
 #define ELEKTRA_SET_ARRAY_ELEMENT_VALUE(VALUE_TO_STRING, KDB_TYPE, elektra, keyname, index, value, error)                                  \
 	CHECK_ERROR (elektra, error);                                                                                                      \
 	char * string = VALUE_TO_STRING (value);                                                                                           \
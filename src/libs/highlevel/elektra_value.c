@@ -162,7 +162,12 @@ void elektraSetRawString (Elektra * elektra, const char * name, const char * val
 	elektraSaveKey (elektra, key, error);
 }
 
-#define ELEKTRA_GET_VALUE(KEY_TO_VALUE, KDB_TYPE, elektra, keyname, result)                                                                \
+#define ELEKTRA_GET_VALUE(KEY_TO_VALUE, KDB_TYPE, FIELD, elektra, keyname, result)                                                         \
+	const ElektraCachedValue * cached = elektraValueCacheGet (elektra, keyname, KDB_TYPE);                                             \
+	if (cached != NULL)                                                                                                                \
+	{                                                                                                                                  \
+		return cached->value.FIELD;                                                                                                \
+	}                                                                                                                                  \
 	const Key * key = elektraFindKey (elektra, keyname, KDB_TYPE);                                                                     \
 	if (key == NULL || !KEY_TO_VALUE (key, &result))                                                                                   \
 	{                                                                                                                                  \
@@ -180,7 +185,7 @@ void elektraSetRawString (Elektra * elektra, const char * name, const char * val
 const char * elektraGetString (Elektra * elektra, const char * keyname)
 {
 	const char * result;
-	ELEKTRA_GET_VALUE (elektraKeyToString, KDB_TYPE_STRING, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToString, KDB_TYPE_STRING, stringValue, elektra, keyname, result);
 	return result;
 }
 
@@ -194,7 +199,7 @@ const char * elektraGetString (Elektra * elektra, const char * keyname)
 kdb_boolean_t elektraGetBoolean (Elektra * elektra, const char * keyname)
 {
 	kdb_boolean_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToBoolean, KDB_TYPE_BOOLEAN, booleanValue, elektra, keyname, result);
 	return result;
 }
 
@@ -208,7 +213,7 @@ kdb_boolean_t elektraGetBoolean (Elektra * elektra, const char * keyname)
 kdb_char_t elektraGetChar (Elektra * elektra, const char * keyname)
 {
 	kdb_char_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToChar, KDB_TYPE_CHAR, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToChar, KDB_TYPE_CHAR, charValue, elektra, keyname, result);
 	return result;
 }
 
@@ -222,7 +227,7 @@ kdb_char_t elektraGetChar (Elektra * elektra, const char * keyname)
 kdb_octet_t elektraGetOctet (Elektra * elektra, const char * keyname)
 {
 	kdb_octet_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToOctet, KDB_TYPE_OCTET, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToOctet, KDB_TYPE_OCTET, octetValue, elektra, keyname, result);
 	return result;
 }
 
@@ -236,7 +241,7 @@ kdb_octet_t elektraGetOctet (Elektra * elektra, const char * keyname)
 kdb_short_t elektraGetShort (Elektra * elektra, const char * keyname)
 {
 	kdb_short_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToShort, KDB_TYPE_SHORT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToShort, KDB_TYPE_SHORT, shortValue, elektra, keyname, result);
 	return result;
 }
 
@@ -250,7 +255,7 @@ kdb_short_t elektraGetShort (Elektra * elektra, const char * keyname)
 kdb_unsigned_short_t elektraGetUnsignedShort (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_short_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedShort, KDB_TYPE_UNSIGNED_SHORT, unsignedShortValue, elektra, keyname, result);
 	return result;
 }
 
@@ -264,7 +269,7 @@ kdb_unsigned_short_t elektraGetUnsignedShort (Elektra * elektra, const char * ke
 kdb_long_t elektraGetLong (Elektra * elektra, const char * keyname)
 {
 	kdb_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLong, KDB_TYPE_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLong, KDB_TYPE_LONG, longValue, elektra, keyname, result);
 	return result;
 }
 
@@ -278,7 +283,7 @@ kdb_long_t elektraGetLong (Elektra * elektra, const char * keyname)
 kdb_unsigned_long_t elektraGetUnsignedLong (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLong, KDB_TYPE_UNSIGNED_LONG, unsignedLongValue, elektra, keyname, result);
 	return result;
 }
 
@@ -292,7 +297,7 @@ kdb_unsigned_long_t elektraGetUnsignedLong (Elektra * elektra, const char * keyn
 kdb_long_long_t elektraGetLongLong (Elektra * elektra, const char * keyname)
 {
 	kdb_long_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLongLong, KDB_TYPE_LONG_LONG, longLongValue, elektra, keyname, result);
 	return result;
 }
 
@@ -306,7 +311,7 @@ kdb_long_long_t elektraGetLongLong (Elektra * elektra, const char * keyname)
 kdb_unsigned_long_long_t elektraGetUnsignedLongLong (Elektra * elektra, const char * keyname)
 {
 	kdb_unsigned_long_long_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToUnsignedLongLong, KDB_TYPE_UNSIGNED_LONG_LONG, unsignedLongLongValue, elektra, keyname, result);
 	return result;
 }
 
@@ -320,7 +325,7 @@ kdb_unsigned_long_long_t elektraGetUnsignedLongLong (Elektra * elektra, const ch
 kdb_float_t elektraGetFloat (Elektra * elektra, const char * keyname)
 {
 	kdb_float_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToFloat, KDB_TYPE_FLOAT, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToFloat, KDB_TYPE_FLOAT, floatValue, elektra, keyname, result);
 	return result;
 }
 
@@ -334,7 +339,7 @@ kdb_float_t elektraGetFloat (Elektra * elektra, const char * keyname)
 kdb_double_t elektraGetDouble (Elektra * elektra, const char * keyname)
 {
 	kdb_double_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToDouble, KDB_TYPE_DOUBLE, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToDouble, KDB_TYPE_DOUBLE, doubleValue, elektra, keyname, result);
 	return result;
 }
 
@@ -350,7 +355,7 @@ kdb_double_t elektraGetDouble (Elektra * elektra, const char * keyname)
 kdb_long_double_t elektraGetLongDouble (Elektra * elektra, const char * keyname)
 {
 	kdb_long_double_t result;
-	ELEKTRA_GET_VALUE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, elektra, keyname, result);
+	ELEKTRA_GET_VALUE (elektraKeyToLongDouble, KDB_TYPE_LONG_DOUBLE, longDoubleValue, elektra, keyname, result);
 	return result;
 }
 
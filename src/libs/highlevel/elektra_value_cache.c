@@ -0,0 +1,553 @@
+/**
+ * @file
+ *
+ * @brief Cache of decoded values for the Elektra High Level API.
+ *
+ * The getters of the high-level API would otherwise build a lookup key,
+ * look it up and convert the string of the key on every call. Instead the
+ * converted values are stored in a hash table indexed by the name passed
+ * to the getters. Arrays are stored as contiguous vectors of their elements.
+ *
+ * The table is built, whenever the configuration is (re)read, and cleared,
+ * whenever a value is written. Values not found in the table are decoded
+ * and added on their first access.
+ *
+ * @copyright BSD License (see doc/LICENSE.md or http://www.libelektra.org)
+ */
+
+#include "elektra.h"
+#include "elektra/conversion.h"
+#include "kdbease.h"
+#include "kdbhelper.h"
+#include "kdbprivate.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ELEKTRA_VALUE_CACHE_MIN_SIZE 64
+
+static size_t cacheHash (const char * name)
+{
+	// FNV-1a
+	size_t hash = 2166136261u;
+	for (const unsigned char * c = (const unsigned char *) name; *c != '\0'; ++c)
+	{
+		hash ^= *c;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * @param key     The key to check.
+ * @param isArray If not NULL, set to 1 if @p key has array metadata, otherwise to 0.
+ * @return the KDB_TYPE_* constant matching the type metadata of @p key,
+ * or NULL if the key has no type the cache can decode
+ */
+static KDBType cacheType (const Key * key, int * isArray)
+{
+	// iterating the few metakeys is much cheaper than keyGetMeta (), which allocates a key for every lookup
+	const Key * metaKey = NULL;
+	if (isArray != NULL) *isArray = 0;
+	for (cursor_t it = 0; key->meta != NULL && it < ksGetSize (key->meta); ++it)
+	{
+		const Key * cur = ksAtCursor (key->meta, it);
+		if (strcmp (keyName (cur), "type") == 0)
+		{
+			metaKey = cur;
+		}
+		else if (isArray != NULL && strcmp (keyName (cur), "array") == 0)
+		{
+			*isArray = 1;
+		}
+	}
+	if (metaKey == NULL)
+	{
+		return NULL;
+	}
+
+	const KDBType types[] = {
+		KDB_TYPE_STRING,	 KDB_TYPE_BOOLEAN,	 KDB_TYPE_CHAR,		    KDB_TYPE_OCTET, KDB_TYPE_SHORT,
+		KDB_TYPE_UNSIGNED_SHORT, KDB_TYPE_LONG,		 KDB_TYPE_UNSIGNED_LONG,    KDB_TYPE_LONG_LONG,
+		KDB_TYPE_UNSIGNED_LONG_LONG, KDB_TYPE_FLOAT, KDB_TYPE_DOUBLE,
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+		KDB_TYPE_LONG_DOUBLE,
+#endif
+	};
+
+	const char * type = keyString (metaKey);
+	for (size_t i = 0; i < sizeof (types) / sizeof (KDBType); ++i)
+	{
+		if (strcmp (type, types[i]) == 0)
+		{
+			return types[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+ * Converts the string of @p key to a value of @p type.
+ *
+ * @return the size of the converted value, 0 if the conversion failed
+ */
+static size_t cacheDecode (KDBType type, const Key * key, ElektraDecodedValue * value)
+{
+	if (type == KDB_TYPE_STRING) return elektraKeyToString (key, &value->stringValue) ? sizeof (value->stringValue) : 0;
+	if (type == KDB_TYPE_BOOLEAN) return elektraKeyToBoolean (key, &value->booleanValue) ? sizeof (value->booleanValue) : 0;
+	if (type == KDB_TYPE_CHAR) return elektraKeyToChar (key, &value->charValue) ? sizeof (value->charValue) : 0;
+	if (type == KDB_TYPE_OCTET) return elektraKeyToOctet (key, &value->octetValue) ? sizeof (value->octetValue) : 0;
+	if (type == KDB_TYPE_SHORT) return elektraKeyToShort (key, &value->shortValue) ? sizeof (value->shortValue) : 0;
+	if (type == KDB_TYPE_UNSIGNED_SHORT)
+		return elektraKeyToUnsignedShort (key, &value->unsignedShortValue) ? sizeof (value->unsignedShortValue) : 0;
+	if (type == KDB_TYPE_LONG) return elektraKeyToLong (key, &value->longValue) ? sizeof (value->longValue) : 0;
+	if (type == KDB_TYPE_UNSIGNED_LONG)
+		return elektraKeyToUnsignedLong (key, &value->unsignedLongValue) ? sizeof (value->unsignedLongValue) : 0;
+	if (type == KDB_TYPE_LONG_LONG) return elektraKeyToLongLong (key, &value->longLongValue) ? sizeof (value->longLongValue) : 0;
+	if (type == KDB_TYPE_UNSIGNED_LONG_LONG)
+		return elektraKeyToUnsignedLongLong (key, &value->unsignedLongLongValue) ? sizeof (value->unsignedLongLongValue) : 0;
+	if (type == KDB_TYPE_FLOAT) return elektraKeyToFloat (key, &value->floatValue) ? sizeof (value->floatValue) : 0;
+	if (type == KDB_TYPE_DOUBLE) return elektraKeyToDouble (key, &value->doubleValue) ? sizeof (value->doubleValue) : 0;
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+	if (type == KDB_TYPE_LONG_DOUBLE)
+		return elektraKeyToLongDouble (key, &value->longDoubleValue) ? sizeof (value->longDoubleValue) : 0;
+#endif
+	return 0;
+}
+
+/**
+ * @return the size of a value of @p type, which is one of the types cacheType() returns
+ */
+static size_t cacheTypeSize (KDBType type)
+{
+	if (type == KDB_TYPE_STRING) return sizeof (const char *);
+	if (type == KDB_TYPE_BOOLEAN) return sizeof (kdb_boolean_t);
+	if (type == KDB_TYPE_CHAR) return sizeof (kdb_char_t);
+	if (type == KDB_TYPE_OCTET) return sizeof (kdb_octet_t);
+	if (type == KDB_TYPE_SHORT) return sizeof (kdb_short_t);
+	if (type == KDB_TYPE_UNSIGNED_SHORT) return sizeof (kdb_unsigned_short_t);
+	if (type == KDB_TYPE_LONG) return sizeof (kdb_long_t);
+	if (type == KDB_TYPE_UNSIGNED_LONG) return sizeof (kdb_unsigned_long_t);
+	if (type == KDB_TYPE_LONG_LONG) return sizeof (kdb_long_long_t);
+	if (type == KDB_TYPE_UNSIGNED_LONG_LONG) return sizeof (kdb_unsigned_long_long_t);
+	if (type == KDB_TYPE_FLOAT) return sizeof (kdb_float_t);
+	if (type == KDB_TYPE_DOUBLE) return sizeof (kdb_double_t);
+#ifdef ELEKTRA_HAVE_KDB_LONG_DOUBLE
+	if (type == KDB_TYPE_LONG_DOUBLE) return sizeof (kdb_long_double_t);
+#endif
+	return 0;
+}
+
+static ElektraCachedValue * cacheFind (Elektra * elektra, const char * name, size_t hash)
+{
+	if (elektra->cacheSize == 0)
+	{
+		return NULL;
+	}
+
+	const size_t mask = elektra->cacheSize - 1;
+	for (size_t i = hash & mask; elektra->cache[i].name != NULL; i = (i + 1) & mask)
+	{
+		if (elektra->cache[i].hash == hash && strcmp (elektra->cache[i].name, name) == 0)
+		{
+			return &elektra->cache[i];
+		}
+	}
+	return NULL;
+}
+
+static ElektraCachedValue * cacheSlot (ElektraCachedValue * cache, size_t size, size_t hash)
+{
+	size_t i = hash & (size - 1);
+	while (cache[i].name != NULL)
+	{
+		i = (i + 1) & (size - 1);
+	}
+	return &cache[i];
+}
+
+/**
+ * Grows the table, so that @p entries fit in without exceeding a load factor of 0.5.
+ * Pointers to entries are invalid afterwards.
+ *
+ * @retval 0 on success
+ * @retval -1 if no memory is available
+ */
+static int cacheReserve (Elektra * elektra, size_t entries)
+{
+	size_t size = elektra->cacheSize == 0 ? ELEKTRA_VALUE_CACHE_MIN_SIZE : elektra->cacheSize;
+	while (entries * 2 > size)
+	{
+		size *= 2;
+	}
+	if (size == elektra->cacheSize)
+	{
+		return 0;
+	}
+
+	ElektraCachedValue * cache = elektraCalloc (size * sizeof (ElektraCachedValue));
+	if (cache == NULL)
+	{
+		return -1;
+	}
+	for (size_t i = 0; i < elektra->cacheSize; ++i)
+	{
+		if (elektra->cache[i].name != NULL)
+		{
+			*cacheSlot (cache, size, elektra->cache[i].hash) = elektra->cache[i];
+		}
+	}
+	elektraFree (elektra->cache);
+	elektra->cache = cache;
+	elektra->cacheSize = size;
+	return 0;
+}
+
+/**
+ * Adds an empty entry for @p name. Pointers to other entries are invalid afterwards.
+ *
+ * @return the new entry, NULL if no memory is available
+ */
+static ElektraCachedValue * cacheInsert (Elektra * elektra, const char * name, size_t hash)
+{
+	if (cacheReserve (elektra, elektra->cacheUsed + 1) != 0)
+	{
+		return NULL;
+	}
+
+	ElektraCachedValue * entry = cacheSlot (elektra->cache, elektra->cacheSize, hash);
+	entry->name = elektraStrDup (name);
+	if (entry->name == NULL)
+	{
+		return NULL;
+	}
+	entry->hash = hash;
+	++elektra->cacheUsed;
+	return entry;
+}
+
+/**
+ * Decodes an array element of @p type.
+ *
+ * @return the size of the decoded value, 0 if the element does not exist, has another type or can't be converted
+ */
+typedef size_t (*ElementDecode) (Elektra * elektra, const char * name, kdb_long_long_t index, KDBType type, ElektraDecodedValue * value);
+
+static size_t lookupElement (Elektra * elektra, const char * name, kdb_long_long_t index, KDBType type, ElektraDecodedValue * value)
+{
+	elektraSetArrayLookupKey (elektra, name, index);
+	const Key * key = ksLookup (elektra->config, elektra->lookupKey, 0);
+	return key == NULL || cacheType (key, NULL) != type ? 0 : cacheDecode (type, key, value);
+}
+
+static ElektraCachedValue * findElementEntry (Elektra * elektra, const char * name, kdb_long_long_t index)
+{
+	const size_t length = strlen (name);
+	char elementName[length + ELEKTRA_MAX_ARRAY_SIZE + 1];
+	memcpy (elementName, name, length);
+	elementName[length] = '/';
+	elektraWriteArrayNumber (&elementName[length + 1], index);
+
+	return cacheFind (elektra, elementName, cacheHash (elementName));
+}
+
+/**
+ * Like lookupElement(), but uses the entries of the elements created by elektraValueCacheBuild().
+ */
+static size_t findElement (Elektra * elektra, const char * name, kdb_long_long_t index, KDBType type, ElektraDecodedValue * value)
+{
+	const ElektraCachedValue * entry = findElementEntry (elektra, name, index);
+	if (entry == NULL || entry->type != type)
+	{
+		return 0;
+	}
+	*value = entry->value;
+	return cacheTypeSize (type);
+}
+
+static kdb_long_long_t cacheArraySize (const Key * arrayParent)
+{
+	const Key * metaKey = keyGetMeta (arrayParent, "array");
+	if (metaKey == NULL)
+	{
+		return 0;
+	}
+
+	const char * sizeString = keyString (metaKey);
+	int digitStart = elektraArrayValidateBaseNameString (sizeString);
+	return digitStart <= 0 ? 0 : strtoll (&sizeString[digitStart], NULL, 10) + 1;
+}
+
+/**
+ * Decodes all elements of an array into @c array of @p entry.
+ *
+ * If an element can't be decoded, this is remembered by setting @c arrayType,
+ * but leaving @c array NULL, so that the getters of single elements don't retry
+ * it for every element.
+ */
+static void cacheDecodeArray (Elektra * elektra, ElektraCachedValue * entry, KDBType type, kdb_long_long_t size, ElementDecode element)
+{
+	entry->arrayType = type;
+	entry->array = NULL;
+	entry->arraySize = 0;
+	if (size <= 0 || size > (kdb_long_long_t) ksGetSize (elektra->config))
+	{
+		return;
+	}
+
+	char * array = NULL;
+	size_t elementSize = 0;
+	for (kdb_long_long_t i = 0; i < size; ++i)
+	{
+		ElektraDecodedValue value;
+		const size_t decodedSize = element (elektra, entry->name, i, type, &value);
+		if (decodedSize == 0)
+		{
+			elektraFree (array);
+			return;
+		}
+		if (array == NULL)
+		{
+			elementSize = decodedSize;
+			array = elektraMalloc (size * elementSize);
+			if (array == NULL) return;
+		}
+		memcpy (&array[i * elementSize], &value, elementSize);
+	}
+
+	entry->array = array;
+	entry->arraySize = size;
+}
+
+/**
+ * Decodes @c key of @p entry, while the cache is built.
+ * Array parents are marked with an @c arraySize of -1.
+ */
+static void cacheDecodeEntry (ElektraCachedValue * entry)
+{
+	int isArray = 0;
+	entry->type = entry->key == NULL ? NULL : cacheType (entry->key, &isArray);
+	if (entry->type != NULL && cacheDecode (entry->type, entry->key, &entry->value) == 0)
+	{
+		entry->type = NULL;
+	}
+	entry->arraySize = isArray ? -1 : 0;
+}
+
+/**
+ * Adds the keys of the configuration below @p root to the cache.
+ *
+ * @param precedence of the keys below @p root, lower values win, -1 for keys of the spec namespace
+ *
+ * @retval 0 on success
+ * @retval -1 if an entry could not be inserted
+ */
+static int cacheAddHierarchy (Elektra * elektra, const Key * root, int precedence)
+{
+	size_t end;
+	ssize_t start = ksFindHierarchy (elektra->config, root, &end);
+	if (start < 0) return 0;
+
+	const size_t rootLength = keyGetNameSize (root) - 1;
+	for (size_t it = start; it < end; ++it)
+	{
+		Key * key = ksAtCursor (elektra->config, it);
+		const char * name = keyName (key);
+		if (name[rootLength] != '/')
+		{
+			continue;
+		}
+		const char * relativeName = &name[rootLength + 1];
+
+		const size_t hash = cacheHash (relativeName);
+		ElektraCachedValue * entry = cacheFind (elektra, relativeName, hash);
+		if (entry == NULL)
+		{
+			if ((entry = cacheInsert (elektra, relativeName, hash)) == NULL) return -1;
+		}
+		else if (entry->precedence < 0 || (precedence >= 0 && precedence > entry->precedence))
+		{
+			continue;
+		}
+		entry->precedence = precedence;
+		entry->key = key;
+		if (precedence >= 0)
+		{
+			// decode in the order of the configuration, which is much more cache friendly than the order of the table
+			cacheDecodeEntry (entry);
+		}
+	}
+	return 0;
+}
+
+/**
+ * Decodes all keys below the parent key of @p elektra with known type metadata
+ * and all arrays, whose elements have the same known type.
+ *
+ * Called whenever the configuration of @p elektra was read.
+ *
+ * Instead of a cascading lookup for every key, the key which the lookup would
+ * return is determined while iterating the configuration once. Only names with
+ * a spec key are looked up, because the spec key can redirect the lookup.
+ *
+ * @param elektra The Elektra instance to use.
+ */
+void elektraValueCacheBuild (Elektra * elektra)
+{
+	elektraValueCacheClear (elektra);
+
+	if (cacheReserve (elektra, ksGetSize (elektra->config)) != 0)
+	{
+		return;
+	}
+
+	if (keyName (elektra->parentKey)[0] != '/')
+	{
+		if (cacheAddHierarchy (elektra, elektra->parentKey, 0) != 0) return;
+	}
+	else
+	{
+		// same order as the cascading lookup: proc, dir, user, system and the cascading key itself
+		static const char * const namespaces[] = { "spec", "proc", "dir", "user", "system", "/" };
+		Key * root = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+		for (size_t i = 0; i < sizeof (namespaces) / sizeof (namespaces[0]); ++i)
+		{
+			keySetName (root, namespaces[i]);
+			keyAddName (root, keyName (elektra->parentKey));
+			if (cacheAddHierarchy (elektra, root, (int) i - 1) != 0)
+			{
+				keyDel (root);
+				return;
+			}
+		}
+		keyDel (root);
+	}
+
+	for (size_t i = 0; i < elektra->cacheSize; ++i)
+	{
+		ElektraCachedValue * entry = &elektra->cache[i];
+		if (entry->name != NULL && entry->precedence < 0)
+		{
+			elektraSetLookupKey (elektra, entry->name);
+			entry->key = ksLookup (elektra->config, elektra->lookupKey, 0);
+			cacheDecodeEntry (entry);
+		}
+	}
+
+	// all elements are resolved now
+	for (size_t i = 0; i < elektra->cacheSize; ++i)
+	{
+		ElektraCachedValue * entry = &elektra->cache[i];
+		if (entry->name == NULL || entry->arraySize != -1) continue;
+
+		entry->arraySize = 0;
+		const ElektraCachedValue * firstElement = findElementEntry (elektra, entry->name, 0);
+		if (firstElement != NULL && firstElement->type != NULL)
+		{
+			cacheDecodeArray (elektra, entry, firstElement->type, cacheArraySize (entry->key), findElement);
+		}
+	}
+}
+
+/**
+ * Removes all decoded values of @p elektra.
+ *
+ * Called whenever the configuration of @p elektra changes, because the
+ * decoded strings point into the keys of the configuration.
+ *
+ * @param elektra The Elektra instance to use.
+ */
+void elektraValueCacheClear (Elektra * elektra)
+{
+	for (size_t i = 0; i < elektra->cacheSize; ++i)
+	{
+		elektraFree (elektra->cache[i].name);
+		elektraFree (elektra->cache[i].array);
+	}
+	elektraFree (elektra->cache);
+	elektra->cache = NULL;
+	elektra->cacheSize = 0;
+	elektra->cacheUsed = 0;
+}
+
+/**
+ * Gets the decoded value of a key, decodes it, if it is not cached yet.
+ *
+ * Does not raise any errors, getters have to fall back to the uncached
+ * lookup to report them.
+ *
+ * @param elektra The Elektra instance to use.
+ * @param name    The (relative) name of the key.
+ * @param type    The KDB_TYPE_* constant of the expected type.
+ * @return the entry with the decoded value of @p type, NULL if the key does not exist,
+ * has another type or can't be converted
+ */
+const ElektraCachedValue * elektraValueCacheGet (Elektra * elektra, const char * name, KDBType type)
+{
+	const size_t hash = cacheHash (name);
+	ElektraCachedValue * entry = cacheFind (elektra, name, hash);
+	if (entry != NULL && entry->type != NULL)
+	{
+		return entry->type == type ? entry : NULL;
+	}
+
+	elektraSetLookupKey (elektra, name);
+	const Key * key = ksLookup (elektra->config, elektra->lookupKey, 0);
+	ElektraDecodedValue value;
+	if (key == NULL || cacheType (key, NULL) != type || cacheDecode (type, key, &value) == 0)
+	{
+		return NULL;
+	}
+
+	if (entry == NULL && (entry = cacheInsert (elektra, name, hash)) == NULL)
+	{
+		return NULL;
+	}
+	entry->key = key;
+	entry->type = type;
+	entry->value = value;
+	return entry;
+}
+
+/**
+ * Gets the decoded elements of an array, decodes them, if they are not cached yet.
+ *
+ * Does not raise any errors, getters have to fall back to the uncached
+ * lookup to report them.
+ *
+ * @param elektra The Elektra instance to use.
+ * @param name    The (relative) name of the array.
+ * @param type    The KDB_TYPE_* constant of the expected type of the elements.
+ * @return the entry with @c arraySize elements of @p type in @c array, NULL if the array
+ * is empty, or an element does not exist, has another type or can't be converted
+ */
+const ElektraCachedValue * elektraValueCacheGetArray (Elektra * elektra, const char * name, KDBType type)
+{
+	const size_t hash = cacheHash (name);
+	ElektraCachedValue * entry = cacheFind (elektra, name, hash);
+	if (entry != NULL && entry->arrayType != NULL)
+	{
+		return entry->arrayType == type && entry->array != NULL ? entry : NULL;
+	}
+
+	const kdb_long_long_t size = elektraArraySize (elektra, name);
+	if (size <= 0)
+	{
+		return NULL;
+	}
+
+	if (entry == NULL && (entry = cacheInsert (elektra, name, hash)) == NULL)
+	{
+		return NULL;
+	}
+	cacheDecodeArray (elektra, entry, type, size, lookupElement);
+	return entry->array == NULL ? NULL : entry;
+}
+
+#ifdef __cplusplus
+};
+#endif
@@ -12,6 +12,7 @@
 #include <kdbease.h>
 #include <kdbhelper.h>
 #include <kdbinvoke.h>
+#include <kdbio.h>
 #include <kdbioprivate.h>
 #include <kdblogger.h>
 #include <kdbnotification.h>
@@ -20,6 +21,7 @@
 #include <kdbprivate.h> // for elektraGetPluginFunction, elektraPluginFindGlobal, kdb->globalPlugins and plugin->config
 
 #include <stdio.h>
+#include <string.h>
 
 static void pluginsOpenNotification (KDB * kdb, ElektraNotificationCallback callback, ElektraNotificationCallbackContext * context)
 {
@@ -69,15 +71,174 @@ static void pluginsCloseNotification (KDB * kdb)
 }
 
 /**
- * @see kdbnotificationinternal.h ::ElektraNotificationKdbUpdate
+ * @internal
+ * Read the values below the given key.
+ *
+ * On kdbGet the notification plugin updates registered variables
+ * and calls callbacks of changed keys.
+ *
+ * @param kdb    kdb handle
+ * @param parent key to reload
  */
-static void elektraNotificationKdbUpdate (KDB * kdb, Key * changedKey)
+static void reload (KDB * kdb, Key * parent)
 {
 	KeySet * ks = ksNew (0, KS_END);
-	kdbGet (kdb, ks, changedKey);
+	kdbGet (kdb, ks, parent);
 	ksDel (ks);
 }
 
+/**
+ * @internal
+ * Check if a key is the root of its namespace, e.g. `user` or `/`.
+ *
+ * Changed keys are never collapsed into such a key, since it would
+ * reload the whole namespace.
+ *
+ * @param  key key
+ * @retval 1 if the key is a root key
+ * @retval 0 otherwise
+ */
+static int isRootKey (Key * key)
+{
+	const char * name = keyName (key);
+	return name[0] == '\0' || strchr (name + 1, '/') == NULL;
+}
+
+/**
+ * @internal
+ * Add a changed key to the pending reloads.
+ *
+ * The pending reloads are kept minimal:
+ * - a key is dropped if it is the same or below a pending key,
+ * - pending keys below the new key are replaced by the new key and
+ * - siblings are replaced by their common parent key.
+ *
+ * @param pending    pending reloads
+ * @param changedKey changed key
+ */
+static void addPendingReload (KeySet * pending, Key * changedKey)
+{
+	Key * parent = keyDup (changedKey);
+	keySetBaseName (parent, 0);
+	int collapse = 0;
+
+	Key * current;
+	ksRewind (pending);
+	while ((current = ksNext (pending)) != NULL)
+	{
+		if (keyIsBelowOrSame (current, changedKey) == 1)
+		{
+			keyDel (parent);
+			return;
+		}
+		if (!isRootKey (parent) && keyIsDirectBelow (parent, current) == 1)
+		{
+			collapse = 1;
+		}
+	}
+
+	Key * added = collapse ? parent : keyDup (changedKey);
+	if (!collapse)
+	{
+		keyDel (parent);
+	}
+
+	// remove pending keys covered by the added key
+	for (cursor_t it = 0; it < ksGetSize (pending);)
+	{
+		current = ksAtCursor (pending, it);
+		if (keyIsBelowOrSame (added, current) == 1)
+		{
+			keyDel (elektraKsPopAtCursor (pending, it));
+		}
+		else
+		{
+			++it;
+		}
+	}
+	ksAppendKey (pending, added);
+}
+
+/**
+ * @internal
+ * Reload all pending keys.
+ *
+ * Called by the reload timer once the reload window has passed.
+ *
+ * @param timerOp reload timer
+ */
+static void reloadPending (ElektraIoTimerOperation * timerOp)
+{
+	ElektraNotificationCallbackContext * context = elektraIoTimerGetData (timerOp);
+
+	// one-shot: the next changed key starts a new window
+	elektraIoTimerSetEnabled (timerOp, 0);
+	elektraIoBindingUpdateTimer (timerOp);
+
+	// callbacks may cause new changes, so reload a detached set
+	KeySet * pending = context->pendingReloads;
+	context->pendingReloads = ksNew (0, KS_END);
+
+	Key * current;
+	ksRewind (pending);
+	while ((current = ksNext (pending)) != NULL)
+	{
+		reload (context->kdb, current);
+	}
+	ksDel (pending);
+}
+
+/**
+ * @see kdbnotificationinternal.h ::ElektraNotificationKdbUpdate
+ *
+ * Without I/O binding or reload window the changed key is reloaded
+ * immediately.
+ * Otherwise the reload timer starts with the first changed key and all
+ * keys changed until it fires are reloaded together.
+ */
+static void elektraNotificationKdbUpdate (ElektraNotificationCallbackContext * context, Key * changedKey)
+{
+	ElektraIoInterface * binding = elektraIoGetBinding (context->kdb);
+	if (binding == NULL || context->reloadWindow == 0)
+	{
+		reload (context->kdb, changedKey);
+		return;
+	}
+
+	addPendingReload (context->pendingReloads, changedKey);
+
+	if (context->reloadTimer == NULL)
+	{
+		context->reloadTimer = elektraIoNewTimerOperation (context->reloadWindow, 1, reloadPending, context);
+		if (context->reloadTimer == NULL || !elektraIoBindingAddTimer (binding, context->reloadTimer))
+		{
+			ELEKTRA_LOG_WARNING ("could not add reload timer, reloading immediately");
+			elektraFree (context->reloadTimer);
+			context->reloadTimer = NULL;
+			reload (context->kdb, changedKey);
+			ksClear (context->pendingReloads);
+		}
+	}
+	else if (!elektraIoTimerIsEnabled (context->reloadTimer))
+	{
+		elektraIoTimerSetEnabled (context->reloadTimer, 1);
+		elektraIoBindingUpdateTimer (context->reloadTimer);
+	}
+}
+
+/**
+ * @internal
+ * Get the callback context of the notification plugin.
+ *
+ * @param  notificationPlugin notification plugin handle
+ * @return                    callback context
+ */
+static ElektraNotificationCallbackContext * getContext (Plugin * notificationPlugin)
+{
+	Key * contextKey = ksLookupByName (notificationPlugin->config, "user/context", 0);
+	return *(ElektraNotificationCallbackContext **) keyValue (contextKey);
+}
+
 int elektraNotificationOpen (KDB * kdb)
 {
 	// Make sure kdb is not null
@@ -103,6 +264,9 @@ int elektraNotificationOpen (KDB * kdb)
 	}
 	context->kdb = kdb;
 	context->kdbUpdate = &elektraNotificationKdbUpdate;
+	context->reloadWindow = 0;
+	context->pendingReloads = ksNew (0, KS_END);
+	context->reloadTimer = NULL;
 
 	Key * parent = keyNew ("", KEY_END);
 	KeySet * contract = ksNew (2, keyNew ("system/elektra/ensure/plugins/global/internalnotification", KEY_VALUE, "mounted", KEY_END),
@@ -166,8 +330,14 @@ int elektraNotificationClose (KDB * kdb)
 		return 0;
 	}
 
-	Key * contextKey = ksLookupByName (notificationPlugin->config, "user/context", 0);
-	ElektraNotificationCallbackContext * context = *(ElektraNotificationCallbackContext **) keyValue (contextKey);
+	ElektraNotificationCallbackContext * context = getContext (notificationPlugin);
+	if (context->reloadTimer != NULL)
+	{
+		// pending reloads are discarded
+		elektraIoBindingRemoveTimer (context->reloadTimer);
+		elektraFree (context->reloadTimer);
+	}
+	ksDel (context->pendingReloads);
 	elektraFree (context);
 
 	// Unmount the plugin
@@ -212,6 +382,30 @@ static Plugin * getNotificationPlugin (KDB * kdb)
 	}
 }
 
+int elektraNotificationSetReloadWindow (KDB * kdb, unsigned int window)
+{
+	if (!kdb)
+	{
+		ELEKTRA_LOG_WARNING ("kdb was not set");
+		return 0;
+	}
+
+	Plugin * notificationPlugin = getNotificationPlugin (kdb);
+	if (!notificationPlugin)
+	{
+		return 0;
+	}
+
+	ElektraNotificationCallbackContext * context = getContext (notificationPlugin);
+	context->reloadWindow = window;
+	if (context->reloadTimer != NULL && window > 0)
+	{
+		elektraIoTimerSetInterval (context->reloadTimer, window);
+		elektraIoBindingUpdateTimer (context->reloadTimer);
+	}
+	return 1;
+}
+
 ELEKTRA_NOTIFICATION_TYPE_DEFINITION (int, Int)
 ELEKTRA_NOTIFICATION_TYPE_DEFINITION (unsigned int, UnsignedInt)
 ELEKTRA_NOTIFICATION_TYPE_DEFINITION (long, Long)
@@ -12,10 +12,14 @@
 
 #include <kdbio.h>
 #include <kdbnotification.h>
+#include <kdbnotificationinternal.h>
+#include <kdbprivate.h>
 #include <tests.h>
 
 int callback_called;
 
+ElektraIoTimerOperation * testTimer;
+
 static void test_openclose (void)
 {
 	printf ("test open & close\n");
@@ -105,6 +109,132 @@ static void test_registerCallback (void)
 	keyDel (valueKey);
 }
 
+static int testAddFd (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int testUpdateFd (ElektraIoFdOperation * fdOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int testAddTimer (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoTimerOperation * timerOp)
+{
+	testTimer = timerOp;
+	return 1;
+}
+
+static int testUpdateTimer (ElektraIoTimerOperation * timerOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int testRemoveTimer (ElektraIoTimerOperation * timerOp)
+{
+	if (timerOp == testTimer) testTimer = NULL;
+	return 1;
+}
+
+static int testAddIdle (ElektraIoInterface * binding ELEKTRA_UNUSED, ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int testUpdateIdle (ElektraIoIdleOperation * idleOp ELEKTRA_UNUSED)
+{
+	return 1;
+}
+
+static int testCleanup (ElektraIoInterface * binding)
+{
+	elektraFree (binding);
+	return 1;
+}
+
+static ElektraNotificationCallbackContext * getCallbackContext (KDB * kdb)
+{
+	Plugin * notificationPlugin = elektraPluginFindGlobal (kdb, "internalnotification");
+	exit_if_fail (notificationPlugin, "notification plugin not mounted");
+	Key * contextKey = ksLookupByName (notificationPlugin->config, "user/context", 0);
+	return *(ElektraNotificationCallbackContext **) keyValue (contextKey);
+}
+
+static void changed (ElektraNotificationCallbackContext * context, const char * name)
+{
+	Key * changedKey = keyNew (name, KEY_END);
+	context->kdbUpdate (context, changedKey);
+	keyDel (changedKey);
+}
+
+static void test_coalescedReload (void)
+{
+	printf ("test coalesced reload\n");
+
+	Key * key = keyNew ("system/elektra/version", KEY_END);
+	Key * valueKey = keyNew ("system/elektra/version/constants/KDB_VERSION_MAJOR", KEY_END);
+	callback_called = 0;
+	testTimer = NULL;
+
+	KDB * kdb = kdbOpen (key);
+	ElektraIoInterface * binding = elektraIoNewBinding (testAddFd, testUpdateFd, testUpdateFd, testAddTimer, testUpdateTimer,
+							    testRemoveTimer, testAddIdle, testUpdateIdle, testUpdateIdle, testCleanup);
+	elektraIoSetBinding (kdb, binding);
+
+	succeed_if (elektraNotificationSetReloadWindow (kdb, 10) == 0, "setting window should fail before open");
+	elektraNotificationOpen (kdb);
+	succeed_if (elektraNotificationRegisterCallback (kdb, valueKey, testCallback, NULL), "register failed");
+	ElektraNotificationCallbackContext * context = getCallbackContext (kdb);
+
+	// without window keys are reloaded immediately
+	changed (context, "system/elektra/version/constants/KDB_VERSION_MAJOR");
+	succeed_if (callback_called, "callback was not called without window");
+	succeed_if (testTimer == NULL, "timer was added without window");
+
+	succeed_if (elektraNotificationSetReloadWindow (kdb, 10), "could not set window");
+
+	// siblings are collapsed to their parent, keys below a pending key are dropped
+	changed (context, "system/elektra/version/constants/KDB_VERSION_MAJOR");
+	changed (context, "system/elektra/version/constants/KDB_VERSION_MINOR");
+	changed (context, "system/elektra/version/constants/KDB_VERSION_MINOR/below");
+	changed (context, "system/elektra/other");
+	changed (context, "user/sw/a/b");
+	changed (context, "user/sw/c/d");
+	changed (context, "user/sw/c");
+	succeed_if (ksGetSize (context->pendingReloads) == 4, "changed keys were not collapsed");
+	succeed_if (ksLookupByName (context->pendingReloads, "system/elektra/version/constants", 0), "siblings were not collapsed");
+	succeed_if (ksLookupByName (context->pendingReloads, "system/elektra/other", 0), "changed key missing");
+	succeed_if (ksLookupByName (context->pendingReloads, "user/sw/a/b", 0), "changed key missing");
+	succeed_if (ksLookupByName (context->pendingReloads, "user/sw/c", 0), "key below was not replaced");
+
+	// keys in the root of a namespace are not collapsed
+	changed (context, "user/other");
+	changed (context, "user/more");
+	succeed_if (ksGetSize (context->pendingReloads) == 6, "keys were collapsed to namespace");
+
+	exit_if_fail (testTimer, "reload timer was not added");
+	succeed_if (elektraIoTimerIsEnabled (testTimer), "reload timer was not enabled");
+	succeed_if (elektraIoTimerGetInterval (testTimer) == 10, "reload timer has wrong interval");
+
+	// registered key is unchanged, so the callback is not called again
+	callback_called = 0;
+	elektraIoTimerGetCallback (testTimer) (testTimer);
+	succeed_if (callback_called == 0, "callback was called for unchanged key");
+	succeed_if (ksGetSize (context->pendingReloads) == 0, "pending reloads were not cleared");
+	succeed_if (!elektraIoTimerIsEnabled (testTimer), "reload timer was not disabled");
+
+	changed (context, "system/elektra/version/constants/KDB_VERSION_MAJOR");
+	succeed_if (elektraIoTimerIsEnabled (testTimer), "reload timer was not enabled again");
+
+	// cleanup
+	elektraNotificationClose (kdb);
+	succeed_if (testTimer == NULL, "reload timer was not removed");
+	kdbClose (kdb, key);
+	elektraIoBindingCleanup (binding);
+	keyDel (key);
+	keyDel (valueKey);
+}
+
 int main (int argc, char ** argv)
 {
 	init (argc, argv);
@@ -118,6 +248,9 @@ int main (int argc, char ** argv)
 	// Test elektraNotificationRegisterCallback
 	test_registerCallback ();
 
+	// Test elektraNotificationSetReloadWindow
+	test_coalescedReload ();
+
 	print_result ("libnotification");
 
 	return nbError;
@@ -40,6 +40,11 @@
  * @c ELEKTRA_PLUGIN_SET and optionally
  * @c ELEKTRA_PLUGIN_ERROR.
  *
+ * Storage plugins, which can read a subtree of their file without
+ * reading all of it, additionally export
+ * @c ELEKTRA_PLUGIN_GET_SUBTREE. It is called instead of kdbGet()
+ * if only keys below a mountpoint are requested.
+ *
  * The list is terminated with
  * @c ELEKTRA_PLUGIN_END.
  *
@@ -84,6 +89,9 @@ Plugin * elektraPluginExport (const char * pluginName, ...)
 		case ELEKTRA_PLUGIN_ERROR:
 			returned->kdbError = va_arg (va, kdbErrorPtr);
 			break;
+		case ELEKTRA_PLUGIN_GET_SUBTREE:
+			returned->kdbGetSubtree = va_arg (va, kdbGetSubtreePtr);
+			break;
 		default:
 			ELEKTRA_ASSERT (0, "plugin passed something unexpected");
 		// fallthrough, will end here
@@ -160,3 +168,65 @@ KeySet * elektraPluginGetGlobalKeySet (Plugin * plugin)
 {
 	return plugin->global;
 }
+
+/**
+ * @internal
+ * @brief Appends a file or directory to sync during the group commit of kdbSet()
+ *
+ * @param plugin a pointer to the plugin
+ * @param what `files` or `directories`
+ * @param name the name of the file or directory
+ *
+ * @retval 1 if kdbSet() syncs it
+ * @retval 0 if there is no group commit
+ */
+static int elektraPluginDefer (Plugin * plugin, const char * what, const char * name)
+{
+	if (!plugin->pendingSyncs) return 0;
+
+	Key * key = keyNew ("system", KEY_END);
+	keyAddBaseName (key, what);
+	keyAddBaseName (key, name);
+	ksAppendKey (plugin->pendingSyncs, key);
+	return 1;
+}
+
+/**
+ * @brief Leave the fsync() of a written file to kdbSet().
+ *
+ * If the group commit of kdbSet() is enabled (see elektraGroupCommitEnable()),
+ * the file is synced together with the files of all other backends,
+ * after all backends are prepared and before any is committed.
+ * If the file cannot be synced, kdbSet() fails and rolls back,
+ * like an error of the plugin.
+ *
+ * @param plugin a pointer to the plugin
+ * @param filename the name of the file to sync
+ *
+ * @retval 1 if kdbSet() syncs the file
+ * @retval 0 if the plugin must sync the file itself
+ * @ingroup plugin
+ */
+int elektraPluginDeferSync (Plugin * plugin, const char * filename)
+{
+	return elektraPluginDefer (plugin, "files", filename);
+}
+
+/**
+ * @brief Leave the fsync() of a directory to kdbSet().
+ *
+ * If the group commit of kdbSet() is enabled (see elektraGroupCommitEnable()),
+ * every directory is synced once, after all backends are committed.
+ * If the directory cannot be synced, kdbSet() adds a warning.
+ *
+ * @param plugin a pointer to the plugin
+ * @param dirname the name of the directory to sync
+ *
+ * @retval 1 if kdbSet() syncs the directory
+ * @retval 0 if the plugin must sync the directory itself
+ * @ingroup plugin
+ */
+int elektraPluginDeferDirectorySync (Plugin * plugin, const char * dirname)
+{
+	return elektraPluginDefer (plugin, "directories", dirname);
+}
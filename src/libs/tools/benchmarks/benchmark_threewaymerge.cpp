@@ -0,0 +1,86 @@
+/**
+ * @file
+ *
+ * @brief Benchmark for the three-way merge of large KeySets
+ *
+ * Compares the key by key merge, which is used for cascading parents,
+ * with the merge-join using one and several threads.
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <kdbtimer.hpp>
+#include <merging/threewaymerge.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace kdb;
+using namespace kdb::tools::merging;
+
+long long nrKeys = 1000000LL;
+
+const int benchmarkIterations = 5;
+
+KeySet createKeySet (std::string const & parent, int modulo, int deleteModulo, std::string const & value)
+{
+	KeySet ks (nrKeys + 1, KS_END);
+	ks.append (Key (parent, KEY_END));
+	for (long long i = 0; i < nrKeys; ++i)
+	{
+		if (deleteModulo && i % deleteModulo == 0) continue;
+		std::string name = parent + "/dir" + std::to_string (i % 1000) + "/key" + std::to_string (i);
+		ks.append (Key (name, KEY_VALUE, (modulo && i % modulo == 0 ? value : "value").c_str (), KEY_END));
+	}
+	return ks;
+}
+
+__attribute__ ((noinline)) void benchmark_merge (Timer & t, KeySet & base, KeySet & ours, KeySet & theirs, bool cascading,
+						 unsigned int threads)
+{
+	ThreeWayMerge merger;
+	merger.setThreads (threads);
+	Key mergeRoot ("user/merged", KEY_END);
+
+	t.start ();
+	MergeResult result = cascading ? merger.mergeKeySet (MergeTask (BaseMergeKeys (base, Key ("/base", KEY_END)),
+									OurMergeKeys (ours, Key ("/ours", KEY_END)),
+									TheirMergeKeys (theirs, Key ("/theirs", KEY_END)), mergeRoot))
+				       : merger.mergeKeySet (base, ours, theirs, mergeRoot);
+	t.stop ();
+	std::cout << t;
+	std::cerr << t.name << ": " << result.getMergedKeys ().size () << " merged, " << result.getConflictSet ().size () << " conflicts"
+		  << std::endl;
+}
+
+int main (int argc, char ** argv)
+{
+	if (argc > 1)
+	{
+		nrKeys = atoll (argv[1]);
+	}
+	unsigned int threads = std::max (std::thread::hardware_concurrency (), 1u);
+	if (argc > 2)
+	{
+		threads = atoi (argv[2]);
+	}
+
+	KeySet base = createKeySet ("user/base", 0, 0, "");
+	KeySet ours = createKeySet ("user/ours", 3, 7, "ourvalue");
+	KeySet theirs = createKeySet ("user/theirs", 5, 11, "theirvalue");
+
+	Timer keyByKey ("key by key");
+	Timer joined ("merge-join");
+	Timer joinedThreads ("merge-join " + std::to_string (threads) + " threads");
+	for (int i = 0; i < benchmarkIterations; ++i)
+	{
+		std::cout << i << std::endl;
+
+		benchmark_merge (keyByKey, base, ours, theirs, true, 1);
+		benchmark_merge (joined, base, ours, theirs, false, 1);
+		benchmark_merge (joinedThreads, base, ours, theirs, false, threads);
+	}
+}
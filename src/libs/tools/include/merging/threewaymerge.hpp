@@ -69,9 +69,22 @@ public:
 		strategies.push_back (strategy);
 	}
 
+	/**
+	 * Sets the number of threads used for detecting conflicts. KeySets are
+	 * only partitioned if every thread gets several thousand keys.
+	 *
+	 * @param _threads the number of threads, 0 for the number of hardware threads
+	 */
+	void setThreads (unsigned int _threads)
+	{
+		threads = _threads;
+	}
+
 private:
 	std::vector<MergeConflictStrategy *> strategies;
+	unsigned int threads = 0;
 	void detectConflicts (const MergeTask & task, MergeResult & mergeResult, bool reverseConflictMeta);
+	bool detectConflictsJoined (const MergeTask & task, MergeResult & mergeResult);
 };
 } // namespace merging
 } // namespace tools
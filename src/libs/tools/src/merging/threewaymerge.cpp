@@ -11,6 +11,12 @@
 #include <helper/keyhelper.hpp>
 #include <merging/threewaymerge.hpp>
 
+#include <kdbprivate.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
 using namespace std;
 using namespace kdb::tools::helper;
 
@@ -23,6 +29,268 @@ namespace tools
 namespace merging
 {
 
+namespace
+{
+
+/**
+ * The keys of a KeySet, which are below or same as its parent.
+ *
+ * The keys are compared by their unescaped names relative to the parent,
+ * which have the same order in all KeySets, no matter of the parent.
+ */
+struct MergeRange
+{
+	ckdb::KeySet * ks;
+	cursor_t begin;
+	cursor_t end;
+	size_t parentSize; // size of the unescaped name of the parent
+};
+
+enum MergeAction
+{
+	MERGE_NONE,
+	MERGE_KEY,
+	MERGE_CONFLICT
+};
+
+struct MergeDecision
+{
+	MergeAction action;
+	ConflictOperation our;
+	ConflictOperation their;
+};
+
+/**
+ * The decisions for our and their key with the same relative name.
+ */
+struct MergeRecord
+{
+	ckdb::Key * our;
+	ckdb::Key * their;
+	MergeDecision ourDecision;
+	MergeDecision theirDecision;
+};
+
+// at least so many keys are compared by one thread
+const cursor_t minKeysPerThread = 8192;
+
+bool getMergeRange (const KeySet & ks, const Key & parent, MergeRange & range)
+{
+	if (!parent || ckdb::keyGetNamespace (*parent) == KEY_NS_CASCADING) return false;
+
+	range.ks = ks.getKeySet ();
+	range.begin = 0;
+	range.end = ks.size ();
+	range.parentSize = ckdb::keyGetUnescapedNameSize (*parent);
+
+	// keys below the parent are contiguous, so checking the first and the last key suffices
+	return range.begin == range.end || (ckdb::keyIsBelowOrSame (*parent, ckdb::ksAtCursor (range.ks, range.begin)) == 1 &&
+					    ckdb::keyIsBelowOrSame (*parent, ckdb::ksAtCursor (range.ks, range.end - 1)) == 1);
+}
+
+inline int compareRelative (const ckdb::Key * k1, size_t parentSize1, const ckdb::Key * k2, size_t parentSize2)
+{
+	const char * name1 = static_cast<const char *> (ckdb::keyUnescapedName (k1)) + parentSize1;
+	const char * name2 = static_cast<const char *> (ckdb::keyUnescapedName (k2)) + parentSize2;
+	size_t size1 = ckdb::keyGetUnescapedNameSize (k1) - parentSize1;
+	size_t size2 = ckdb::keyGetUnescapedNameSize (k2) - parentSize2;
+
+	int ret = memcmp (name1, name2, std::min (size1, size2));
+	if (ret != 0 || size1 == size2) return ret;
+	return size1 < size2 ? -1 : 1;
+}
+
+cursor_t lowerBound (const MergeRange & range, const ckdb::Key * key, size_t parentSize)
+{
+	cursor_t first = range.begin;
+	cursor_t count = range.end - range.begin;
+	while (count > 0)
+	{
+		cursor_t step = count / 2;
+		if (compareRelative (ckdb::ksAtCursor (range.ks, first + step), range.parentSize, key, parentSize) < 0)
+		{
+			first += step + 1;
+			count -= step + 1;
+		}
+		else
+		{
+			count = step;
+		}
+	}
+	return first;
+}
+
+/*
+ * The following comparisons are the same as keyDataEqual and keyMetaEqual,
+ * but they neither change cursors nor reference counts, so that
+ * partitions can be compared concurrently.
+ */
+
+bool isBinary (const ckdb::Key * key)
+{
+	// keyIsBinary would look up the metadata, which moves the cursor of shared metadata
+	ckdb::KeySet * meta = key->meta;
+	if (!meta) return false;
+	for (cursor_t i = 0; i < ckdb::ksGetSize (meta); ++i)
+	{
+		if (strcmp (ckdb::keyName (ckdb::ksAtCursor (meta, i)), "binary") == 0) return true;
+	}
+	return false;
+}
+
+bool dataEqual (const ckdb::Key * k1, const ckdb::Key * k2)
+{
+	if (!k1 || !k2) return false;
+
+	bool binary = isBinary (k1);
+	if (binary != isBinary (k2)) return false;
+
+	// keyGetValueSize would call keyIsBinary for keys without a value
+	ssize_t size1 = k1->data.v ? k1->dataSize : 0;
+	ssize_t size2 = k2->data.v ? k2->dataSize : 0;
+	if (!binary)
+	{
+		// compare without null terminator, a missing value is the same as an empty string
+		size1 = std::max<ssize_t> (size1 - 1, 0);
+		size2 = std::max<ssize_t> (size2 - 1, 0);
+	}
+	return size1 == size2 && (size1 == 0 || memcmp (k1->data.v, k2->data.v, size1) == 0);
+}
+
+bool metaEqual (const ckdb::Key * k1, const ckdb::Key * k2)
+{
+	if (!k1 || !k2) return false;
+
+	ckdb::KeySet * meta1 = k1->meta;
+	ckdb::KeySet * meta2 = k2->meta;
+	if (meta1 == meta2) return true; // shared metadata
+	size_t size1 = meta1 ? ckdb::ksGetSize (meta1) : 0;
+	size_t size2 = meta2 ? ckdb::ksGetSize (meta2) : 0;
+	if (size1 != size2) return false;
+
+	// metadata is sorted by name
+	for (size_t i = 0; i < size1; ++i)
+	{
+		const ckdb::Key * m1 = ckdb::ksAtCursor (meta1, i);
+		const ckdb::Key * m2 = ckdb::ksAtCursor (meta2, i);
+		if (strcmp (ckdb::keyName (m1), ckdb::keyName (m2)) != 0) return false;
+		if (strcmp (ckdb::keyString (m1), ckdb::keyString (m2)) != 0) return false;
+	}
+	return true;
+}
+
+MergeDecision asymmetricConflict (ConflictOperation our, ConflictOperation their, bool reverse)
+{
+	return !reverse ? MergeDecision{ MERGE_CONFLICT, our, their } : MergeDecision{ MERGE_CONFLICT, their, our };
+}
+
+/**
+ * Decides about a key like ThreeWayMerge::detectConflicts.
+ *
+ * @param key the key of the side to decide for
+ * @param other the key with the same relative name of the other side, if any
+ * @param base the key with the same relative name in base, if any
+ * @param reverse true if the key is from theirs
+ */
+MergeDecision decide (const ckdb::Key * key, const ckdb::Key * other, const ckdb::Key * base, bool reverse)
+{
+	if (dataEqual (key, other))
+	{
+		if (metaEqual (key, other)) return MergeDecision{ MERGE_KEY, CONFLICT_SAME, CONFLICT_SAME };
+		return MergeDecision{ MERGE_CONFLICT, CONFLICT_META, CONFLICT_META };
+	}
+
+	if (base)
+	{
+		if (other)
+		{
+			bool modified = !dataEqual (key, base);
+			bool otherModified = !dataEqual (other, base);
+			if (modified && !otherModified) return asymmetricConflict (CONFLICT_MODIFY, CONFLICT_SAME, reverse);
+			if (modified && otherModified) return MergeDecision{ MERGE_CONFLICT, CONFLICT_MODIFY, CONFLICT_MODIFY };
+			return MergeDecision{ MERGE_NONE, CONFLICT_SAME, CONFLICT_SAME };
+		}
+		if (dataEqual (key, base)) return asymmetricConflict (CONFLICT_SAME, CONFLICT_DELETE, reverse);
+		return asymmetricConflict (CONFLICT_MODIFY, CONFLICT_DELETE, reverse);
+	}
+
+	// the data differs, so keys added on both sides are a conflict
+	if (other) return MergeDecision{ MERGE_CONFLICT, CONFLICT_ADD, CONFLICT_ADD };
+	return asymmetricConflict (CONFLICT_ADD, CONFLICT_SAME, reverse);
+}
+
+/**
+ * Walks the sorted keys of ours, theirs and base simultaneously.
+ */
+void joinRanges (const MergeRange & ours, const MergeRange & theirs, const MergeRange & base, std::vector<MergeRecord> & records)
+{
+	cursor_t o = ours.begin;
+	cursor_t t = theirs.begin;
+	cursor_t b = base.begin;
+	while (o < ours.end || t < theirs.end)
+	{
+		ckdb::Key * our = o < ours.end ? ckdb::ksAtCursor (ours.ks, o) : nullptr;
+		ckdb::Key * their = t < theirs.end ? ckdb::ksAtCursor (theirs.ks, t) : nullptr;
+		int cmp = !our ? 1 : !their ? -1 : compareRelative (our, ours.parentSize, their, theirs.parentSize);
+		if (cmp > 0) our = nullptr;
+		if (cmp < 0) their = nullptr;
+
+		const ckdb::Key * current = our ? our : their;
+		size_t currentParentSize = our ? ours.parentSize : theirs.parentSize;
+		ckdb::Key * baseKey = nullptr;
+		while (b < base.end)
+		{
+			ckdb::Key * candidate = ckdb::ksAtCursor (base.ks, b);
+			int baseCmp = compareRelative (candidate, base.parentSize, current, currentParentSize);
+			if (baseCmp < 0)
+			{
+				// deleted on both sides
+				++b;
+				continue;
+			}
+			if (baseCmp == 0) baseKey = candidate;
+			break;
+		}
+
+		MergeRecord record{ our, their, MergeDecision{ MERGE_NONE, CONFLICT_SAME, CONFLICT_SAME },
+				    MergeDecision{ MERGE_NONE, CONFLICT_SAME, CONFLICT_SAME } };
+		if (our) record.ourDecision = decide (our, their, baseKey, false);
+		if (their) record.theirDecision = decide (their, our, baseKey, true);
+		if (record.ourDecision.action != MERGE_NONE || record.theirDecision.action != MERGE_NONE)
+		{
+			records.push_back (record);
+		}
+
+		if (our) ++o;
+		if (their) ++t;
+	}
+}
+
+void applyDecision (const MergeDecision & decision, ckdb::Key * key, size_t parentNameSize, const std::string & mergeRootName,
+		    bool rebase, MergeResult & mergeResult)
+{
+	if (decision.action == MERGE_NONE) return;
+
+	if (decision.action == MERGE_KEY && !rebase)
+	{
+		// the key was not rebased, we can reuse it (prevents that the key is rewritten)
+		mergeResult.addMergeKey (Key (key));
+		return;
+	}
+
+	Key mergeKey (ckdb::keyDup (key));
+	mergeKey.setName (mergeRootName + (ckdb::keyName (key) + parentNameSize));
+	if (decision.action == MERGE_KEY)
+	{
+		mergeResult.addMergeKey (mergeKey);
+	}
+	else
+	{
+		mergeResult.addConflict (mergeKey, decision.our, decision.their);
+	}
+}
+} // namespace
+
 inline void addAsymmetricConflict (MergeResult & result, Key & key, ConflictOperation our, ConflictOperation their, bool reverse)
 {
 	if (!reverse)
@@ -166,12 +434,72 @@ void ThreeWayMerge::detectConflicts (const MergeTask & task, MergeResult & merge
 }
 
 
+bool ThreeWayMerge::detectConflictsJoined (const MergeTask & task, MergeResult & mergeResult)
+{
+	MergeRange ours, theirs, base;
+	if (!task.mergeRoot || ckdb::keyGetNamespace (*task.mergeRoot) == KEY_NS_CASCADING ||
+	    !getMergeRange (task.ours, task.ourParent, ours) || !getMergeRange (task.theirs, task.theirParent, theirs) ||
+	    !getMergeRange (task.base, task.baseParent, base))
+	{
+		return false;
+	}
+
+	// partition the relative names at keys of the larger side
+	const MergeRange & larger = ours.end - ours.begin >= theirs.end - theirs.begin ? ours : theirs;
+	cursor_t size = larger.end - larger.begin;
+	cursor_t partitions = threads > 0 ? threads : std::max (std::thread::hardware_concurrency (), 1u);
+	partitions = std::max<cursor_t> (std::min (partitions, size / minKeysPerThread), 1);
+
+	std::vector<MergeRange> ourPartitions (partitions, ours);
+	std::vector<MergeRange> theirPartitions (partitions, theirs);
+	std::vector<MergeRange> basePartitions (partitions, base);
+	for (cursor_t i = 1; i < partitions; ++i)
+	{
+		const ckdb::Key * split = ckdb::ksAtCursor (larger.ks, larger.begin + i * size / partitions);
+		ourPartitions[i].begin = ourPartitions[i - 1].end = lowerBound (ours, split, larger.parentSize);
+		theirPartitions[i].begin = theirPartitions[i - 1].end = lowerBound (theirs, split, larger.parentSize);
+		basePartitions[i].begin = basePartitions[i - 1].end = lowerBound (base, split, larger.parentSize);
+	}
+
+	std::vector<std::vector<MergeRecord>> records (partitions);
+	std::vector<std::thread> workers;
+	for (cursor_t i = 1; i < partitions; ++i)
+	{
+		workers.emplace_back (joinRanges, std::cref (ourPartitions[i]), std::cref (theirPartitions[i]), std::cref (basePartitions[i]),
+				      std::ref (records[i]));
+	}
+	joinRanges (ourPartitions[0], theirPartitions[0], basePartitions[0], records[0]);
+	for (auto & worker : workers)
+	{
+		worker.join ();
+	}
+
+	// keys are created and added in the order of the relative names, as the conflict detection of both sides would do
+	const string mergeRootName = task.mergeRoot.getName ();
+	const size_t ourParentNameSize = task.ourParent.getName ().size ();
+	const size_t theirParentNameSize = task.theirParent.getName ().size ();
+	const bool rebaseOurs = task.ourParent.getFullName () != task.mergeRoot.getFullName ();
+	const bool rebaseTheirs = task.theirParent.getFullName () != task.mergeRoot.getFullName ();
+	for (auto const & partition : records)
+	{
+		for (auto const & record : partition)
+		{
+			applyDecision (record.ourDecision, record.our, ourParentNameSize, mergeRootName, rebaseOurs, mergeResult);
+			applyDecision (record.theirDecision, record.their, theirParentNameSize, mergeRootName, rebaseTheirs, mergeResult);
+		}
+	}
+	return true;
+}
+
 MergeResult ThreeWayMerge::mergeKeySet (const MergeTask & task)
 {
 
 	MergeResult result;
-	detectConflicts (task, result);
-	detectConflicts (task.reverse (), result, true);
+	if (!detectConflictsJoined (task, result))
+	{
+		detectConflicts (task, result);
+		detectConflicts (task.reverse (), result, true);
+	}
 
 	if (!result.hasConflicts ()) return result;
 
@@ -185,3 +185,115 @@ TEST_F (ThreeWayMergeTest, SameMetaKeyModifyConflict)
 	EXPECT_EQ (4, merged.size ());
 	compareAllExceptKey1 (merged);
 }
+
+static KeySet createLargeKeySet (std::string const & parent, int modulo, int deleteModulo, std::string const & value)
+{
+	KeySet ks;
+	ks.append (Key (parent, KEY_END));
+	for (int i = 0; i < 40000; ++i)
+	{
+		if (deleteModulo && i % deleteModulo == 0) continue;
+		std::string name = parent + "/config/" + std::to_string (i % 100) + "/key" + std::to_string (i);
+		Key key (name, KEY_VALUE, (modulo && i % modulo == 0 ? value : "value").c_str (), KEY_END);
+		if (modulo && i % (modulo * 13) == 0) key.setMeta<std::string> ("testmeta", value);
+		ks.append (key);
+	}
+	// keys only added on one side
+	for (int i = 0; i < 1000; i += modulo + 1)
+	{
+		ks.append (Key (parent + "/added/key" + std::to_string (i), KEY_VALUE, value.c_str (), KEY_END));
+	}
+	return ks;
+}
+
+static void compareKeySets (KeySet & expected, KeySet & actual)
+{
+	ASSERT_EQ (expected.size (), actual.size ());
+	for (ssize_t i = 0; i < expected.size (); ++i)
+	{
+		Key e = expected.at (i);
+		Key a = actual.at (i);
+		EXPECT_EQ (e.getName (), a.getName ());
+		EXPECT_EQ (e.getString (), a.getString ());
+		EXPECT_EQ (e.getMeta<std::string> ("testmeta"), a.getMeta<std::string> ("testmeta"));
+		EXPECT_EQ (e.getMeta<std::string> ("conflict/operation/our"), a.getMeta<std::string> ("conflict/operation/our"));
+		EXPECT_EQ (e.getMeta<std::string> ("conflict/operation/their"), a.getMeta<std::string> ("conflict/operation/their"));
+	}
+}
+
+TEST_F (ThreeWayMergeTest, PartitionedMergeDetectsSameConflicts)
+{
+	KeySet largeBase = createLargeKeySet ("user/parentb", 0, 0, "");
+	KeySet largeOurs = createLargeKeySet ("user/parento", 3, 7, "ourvalue");
+	KeySet largeTheirs = createLargeKeySet ("user/parentt", 5, 11, "theirvalue");
+
+	// cascading parents are merged key by key
+	MergeResult expected = merger.mergeKeySet (MergeTask (BaseMergeKeys (largeBase, Key ("/parentb", KEY_END)),
+							      OurMergeKeys (largeOurs, Key ("/parento", KEY_END)),
+							      TheirMergeKeys (largeTheirs, Key ("/parentt", KEY_END)), mergeParent));
+	ASSERT_TRUE (expected.hasConflicts ());
+
+	merger.setThreads (4);
+	MergeResult result = merger.mergeKeySet (largeBase, largeOurs, largeTheirs, mergeParent);
+
+	KeySet expectedConflicts = expected.getConflictSet ();
+	KeySet conflicts = result.getConflictSet ();
+	compareKeySets (expectedConflicts, conflicts);
+
+	KeySet expectedMerged = expected.getMergedKeys ();
+	KeySet merged = result.getMergedKeys ();
+	compareKeySets (expectedMerged, merged);
+}
+
+static KeySet createBinaryKeySet (std::string const & parent, int modulo)
+{
+	// the duplicates share the metadata, which contains binary
+	Key binary ("/template", KEY_END);
+	const char value[] = { 'v', 0, 'a', 0 };
+	binary.setBinary (value, sizeof (value));
+	const char modified[] = { 'v', 0, 'b', 0 };
+
+	KeySet ks;
+	ks.append (Key (parent, KEY_END));
+	for (int i = 0; i < 40000; ++i)
+	{
+		Key key (binary.dup ());
+		key.setName (parent + "/config/" + std::to_string (i % 100) + "/key" + std::to_string (i));
+		if (modulo && i % modulo == 0) key.setBinary (modified, sizeof (modified));
+		ks.append (key);
+	}
+	return ks;
+}
+
+TEST_F (ThreeWayMergeTest, PartitionedMergeComparesBinaryKeys)
+{
+	KeySet largeBase = createBinaryKeySet ("user/parentb", 0);
+	KeySet largeOurs = createBinaryKeySet ("user/parento", 3);
+	KeySet largeTheirs = createBinaryKeySet ("user/parentt", 5);
+
+	MergeResult expected = merger.mergeKeySet (MergeTask (BaseMergeKeys (largeBase, Key ("/parentb", KEY_END)),
+							      OurMergeKeys (largeOurs, Key ("/parento", KEY_END)),
+							      TheirMergeKeys (largeTheirs, Key ("/parentt", KEY_END)), mergeParent));
+
+	merger.setThreads (4);
+	MergeResult result = merger.mergeKeySet (largeBase, largeOurs, largeTheirs, mergeParent);
+
+	// keys modified by only one side conflict without a merge strategy
+	KeySet expectedConflicts = expected.getConflictSet ();
+	KeySet conflicts = result.getConflictSet ();
+	EXPECT_EQ (16000, expectedConflicts.size ());
+	EXPECT_EQ (expectedConflicts.size (), conflicts.size ());
+
+	KeySet expectedMerged = expected.getMergedKeys ();
+	KeySet merged = result.getMergedKeys ();
+	ASSERT_EQ (expectedMerged.size (), merged.size ());
+	for (ssize_t i = 0; i < expectedMerged.size (); ++i)
+	{
+		Key e = expectedMerged.at (i);
+		Key a = merged.at (i);
+		EXPECT_EQ (e.getName (), a.getName ());
+		EXPECT_EQ (e.isBinary (), a.isBinary ());
+		ASSERT_EQ (e.getBinarySize (), a.getBinarySize ());
+		EXPECT_EQ (0, memcmp (e.getValue (), a.getValue (), e.getBinarySize ()));
+	}
+}
@@ -28,6 +28,7 @@
 #include "conditionals.h"
 
 #define EPSILON 0.00001
+#define MAX_CACHED_CONDITIONS 1024
 
 #define REGEX_FLAGS_CONDITION (REG_EXTENDED)
 
@@ -59,6 +60,26 @@ typedef enum
 	NOEXPR = -3,
 } CondResult;
 
+/**
+ * A condition split into its parts, so that the regular expressions
+ * only run once for every distinct condition string.
+ */
+typedef struct
+{
+	char * condition;
+	char * thenexpr;
+	char * elseexpr;
+} CompiledCondition;
+
+typedef struct
+{
+	regex_t conditionRegex;
+	regex_t thenRegex;
+	regex_t elseRegex;
+	regex_t singleRegex;
+	KeySet * cache; /*!< compiled conditions, the names are the condition strings, cleared when full */
+} ConditionalsData;
+
 static int isValidSuffix (char * suffix, const Key * suffixList)
 {
 	if (!suffixList) return 0;
@@ -555,20 +576,10 @@ static const char * isAssign (Key * key, char * expr, Key * parentKey, KeySet *
 	}
 }
 
-static CondResult parseCondition (Key * key, const char * condition, const Key * suffixList, KeySet * ks, Key * parentKey)
+static CondResult parseCondition (Key * key, const char * condition, const Key * suffixList, KeySet * ks, Key * parentKey,
+				  const regex_t * regex)
 {
 	CondResult result = FALSE;
-	const char * regexString = "((\\(([^\\(\\)]*)\\)))";
-	regex_t regex;
-
-	if ((regcomp (&regex, regexString, REG_EXTENDED | REG_NEWLINE)))
-	{
-		ELEKTRA_SET_ERROR (87, parentKey, "Couldn't compile regex: most likely out of memory"); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
-	}
 
 	char * localCondition = elektraStrDup (condition);
 	int subMatches = 4;
@@ -576,7 +587,7 @@ static CondResult parseCondition (Key * key, const char * condition, const Key *
 	char * ptr = localCondition;
 	while (1)
 	{
-		int nomatch = regexec (&regex, ptr, subMatches, m, 0);
+		int nomatch = regexec (regex, ptr, subMatches, m, 0);
 		if (nomatch)
 		{
 			break;
@@ -602,105 +613,81 @@ static CondResult parseCondition (Key * key, const char * condition, const Key *
 		elektraFree (singleCondition);
 	}
 	elektraFree (localCondition);
-	regfree (&regex);
 	return result;
 }
 
 
-static CondResult parseConditionString (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static void freeCompiledCondition (CompiledCondition * compiled)
 {
-	const char * conditionString = keyString (meta);
-	const char * regexString1 = "(\\(((.*)?)\\))[[:space:]]*\\?";
-	const char * regexString2 = "\\?[[:space:]]*(\\(((.*)?)\\))";
-	const char * regexString3 = "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))";
-	regex_t regex1, regex2, regex3;
-	CondResult ret;
-	if ((ret = regcomp (&regex1, regexString1, REGEX_FLAGS_CONDITION)))
-	{
-		ELEKTRA_SET_ERROR (87, parentKey, "Couldn't compile regex: most likely out of memory"); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		ksDel (ks);
-		return ERROR;
-	}
-	if ((ret = regcomp (&regex2, regexString2, REGEX_FLAGS_CONDITION)))
+	elektraFree (compiled->condition);
+	elektraFree (compiled->thenexpr);
+	if (compiled->elseexpr) elektraFree (compiled->elseexpr);
+	elektraFree (compiled);
+}
+
+static void clearCache (KeySet * cache)
+{
+	Key * cur;
+	ksRewind (cache);
+	while ((cur = ksNext (cache)) != NULL)
 	{
-		ELEKTRA_SET_ERROR (87, parentKey, "Couldn't compile regex: most likely out of memory"); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		ksDel (ks);
-		return ERROR;
+		freeCompiledCondition (*(CompiledCondition **) keyValue (cur));
 	}
-	if ((ret = regcomp (&regex3, regexString3, REGEX_FLAGS_CONDITION)))
+	ksClear (cache);
+}
+
+static char * copyMatch (const char * string, const regmatch_t * match)
+{
+	int len = match->rm_eo - match->rm_so;
+	char * copy = elektraMalloc (len + 1);
+	strncpy (copy, string + match->rm_so, len);
+	copy[len] = '\0';
+	return copy;
+}
+
+/**
+ * @brief Split a condition string into condition, then and else expression
+ *
+ * @return the cached compiled condition or NULL on syntax errors
+ */
+static const CompiledCondition * compileCondition (ConditionalsData * data, const char * conditionString, Key * parentKey)
+{
+	Key * lookup = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+	keyAddBaseName (lookup, conditionString);
+	Key * cached = ksLookup (data->cache, lookup, KDB_O_NONE);
+	if (cached)
 	{
-		ELEKTRA_SET_ERROR (87, parentKey, "Couldn't compile regex: most likely out of memory"); // the regex compiles so the only
-		// possible error would be out of
-		// memory
-		regfree (&regex1);
-		regfree (&regex2);
-		ksDel (ks);
-		return ERROR;
+		keyDel (lookup);
+		return *(CompiledCondition **) keyValue (cached);
 	}
+	if (ksGetSize (data->cache) >= MAX_CACHED_CONDITIONS) clearCache (data->cache);
+
 	int subMatches = 6;
 	regmatch_t m[subMatches];
-	int nomatch = regexec (&regex1, conditionString, subMatches, m, 0);
-	if (nomatch)
-	{
-		ELEKTRA_SET_ERRORF (134, parentKey, "Invalid syntax: \"%s\". Check kdb info conditionals for additional information",
-				    conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
-		return ERROR;
-	}
-	if (m[1].rm_so == -1)
+	int nomatch = regexec (&data->conditionRegex, conditionString, subMatches, m, 0);
+	if (nomatch || m[1].rm_so == -1)
 	{
 		ELEKTRA_SET_ERRORF (134, parentKey, "Invalid syntax: \"%s\". Check kdb info conditionals for additional information",
 				    conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
-		return ERROR;
+		keyDel (lookup);
+		return NULL;
 	}
-	int startPos = m[1].rm_so;
-	int endPos = m[1].rm_eo;
-	char * condition = elektraMalloc (endPos - startPos + 1);
-	char * thenexpr = NULL;
-	char * elseexpr = NULL;
-	strncpy (condition, conditionString + startPos, endPos - startPos);
-	condition[endPos - startPos] = '\0';
-	nomatch = regexec (&regex2, conditionString, subMatches, m, 0);
-	if (nomatch)
-	{
-		ELEKTRA_SET_ERRORF (134, parentKey, "Invalid syntax: \"%s\". Check kdb info conditionals for additional information",
-				    conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
-		return ERROR;
-	}
-	if (m[1].rm_so == -1)
+	CompiledCondition * compiled = elektraCalloc (sizeof (CompiledCondition));
+	compiled->condition = copyMatch (conditionString, &m[1]);
+
+	nomatch = regexec (&data->thenRegex, conditionString, subMatches, m, 0);
+	if (nomatch || m[1].rm_so == -1)
 	{
 		ELEKTRA_SET_ERRORF (134, parentKey, "Invalid syntax: \"%s\". Check kdb info conditionals for additional information",
 				    conditionString);
-		regfree (&regex1);
-		regfree (&regex2);
-		regfree (&regex3);
-		ksDel (ks);
-		return ERROR;
+		elektraFree (compiled->condition);
+		elektraFree (compiled);
+		keyDel (lookup);
+		return NULL;
 	}
+	compiled->thenexpr = copyMatch (conditionString, &m[1]);
 
-	startPos = m[1].rm_so;
-	endPos = m[1].rm_eo;
-	thenexpr = elektraMalloc (endPos - startPos + 1);
-	strncpy (thenexpr, conditionString + startPos, endPos - startPos);
-	thenexpr[endPos - startPos] = '\0';
-
-	nomatch = regexec (&regex3, conditionString, subMatches, m, 0);
+	nomatch = regexec (&data->elseRegex, conditionString, subMatches, m, 0);
 	if (!nomatch)
 	{
 		if (m[1].rm_so == -1)
@@ -708,26 +695,42 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 			ELEKTRA_SET_ERRORF (134, parentKey,
 					    "Invalid syntax: \"%s\". Check kdb info conditionals for additional information",
 					    conditionString);
-			regfree (&regex1);
-			regfree (&regex2);
-			regfree (&regex3);
-			ksDel (ks);
-			return ERROR;
+			freeCompiledCondition (compiled);
+			keyDel (lookup);
+			return NULL;
 		}
-		thenexpr[strlen (thenexpr) - ((m[0].rm_eo - m[0].rm_so))] = '\0';
-		startPos = m[1].rm_so;
-		endPos = m[1].rm_eo;
-		elseexpr = elektraMalloc (endPos - startPos + 1);
-		strncpy (elseexpr, conditionString + startPos, endPos - startPos);
-		elseexpr[endPos - startPos] = '\0';
+		compiled->thenexpr[strlen (compiled->thenexpr) - ((m[0].rm_eo - m[0].rm_so))] = '\0';
+		compiled->elseexpr = copyMatch (conditionString, &m[1]);
 	}
 
-	ret = parseCondition (key, condition, suffixList, ks, parentKey);
+	keySetBinary (lookup, &compiled, sizeof (compiled));
+	ksAppendKey (data->cache, lookup);
+	return compiled;
+}
+
+static CondResult parseConditionString (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op,
+					ConditionalsData * data)
+{
+	const char * conditionString = keyString (meta);
+	const CompiledCondition * compiled = compileCondition (data, conditionString, parentKey);
+	if (!compiled)
+	{
+		return ERROR;
+	}
+	const char * condition = compiled->condition;
+	const char * thenexpr = compiled->thenexpr;
+	const char * elseexpr = compiled->elseexpr;
+	CondResult ret;
+	char * assignExpr = NULL;
+
+	ret = parseCondition (key, condition, suffixList, ks, parentKey, &data->singleRegex);
 	if (ret == TRUE)
 	{
 		if (op == ASSIGN)
 		{
-			const char * assign = isAssign (key, thenexpr, parentKey, ks);
+			// isAssign terminates the expression in place
+			assignExpr = elektraStrDup (thenexpr);
+			const char * assign = isAssign (key, assignExpr, parentKey, ks);
 			if (assign != NULL)
 			{
 				keySetString (key, assign);
@@ -742,7 +745,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 		}
 		else
 		{
-			ret = parseCondition (key, thenexpr, suffixList, ks, parentKey);
+			ret = parseCondition (key, thenexpr, suffixList, ks, parentKey, &data->singleRegex);
 			if (ret == FALSE)
 			{
 				ELEKTRA_SET_ERRORF (135, parentKey, "Validation of Key %s: %s failed. (%s failed)",
@@ -762,7 +765,8 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 		{
 			if (op == ASSIGN)
 			{
-				const char * assign = isAssign (key, elseexpr, parentKey, ks);
+				assignExpr = elektraStrDup (elseexpr);
+				const char * assign = isAssign (key, assignExpr, parentKey, ks);
 				if (assign != NULL)
 				{
 					keySetString (key, assign);
@@ -777,7 +781,7 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 			}
 			else
 			{
-				ret = parseCondition (key, elseexpr, suffixList, ks, parentKey);
+				ret = parseCondition (key, elseexpr, suffixList, ks, parentKey, &data->singleRegex);
 
 				if (ret == FALSE)
 				{
@@ -804,20 +808,18 @@ static CondResult parseConditionString (const Key * meta, const Key * suffixList
 	}
 
 CleanUp:
-	elektraFree (condition);
-	elektraFree (thenexpr);
-	if (elseexpr) elektraFree (elseexpr);
-	regfree (&regex1);
-	regfree (&regex2);
-	regfree (&regex3);
-	ksDel (ks);
+	if (assignExpr) elektraFree (assignExpr);
 	return ret;
 }
 
-static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op)
+static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * parentKey, Key * key, KeySet * ks, Operation op,
+			       ConditionalsData * data)
 {
 	CondResult result;
-	result = parseConditionString (meta, suffixList, parentKey, key, ksDup (ks), op);
+	// lookups move the cursor of the KeySet we are iterating
+	cursor_t cursor = ksGetCursor (ks);
+	result = parseConditionString (meta, suffixList, parentKey, key, ks, op, data);
+	ksSetCursor (ks, cursor);
 	if (result == ERROR)
 	{
 		return ERROR;
@@ -837,7 +839,8 @@ static CondResult evaluateKey (const Key * meta, const Key * suffixList, Key * p
 	return TRUE;
 }
 
-static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key * suffixList, Key * parentKey, KeySet * returned)
+static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key * suffixList, Key * parentKey, KeySet * returned,
+					  ConditionalsData * data)
 {
 	int countSucceeded = 0;
 	int countFailed = 0;
@@ -848,7 +851,7 @@ static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key
 	while ((c = ksNext (condKS)) != NULL)
 	{
 		if (!keyCmp (c, meta)) continue;
-		result = evaluateKey (c, suffixList, parentKey, key, returned, CONDITION);
+		result = evaluateKey (c, suffixList, parentKey, key, returned, CONDITION, data);
 		if (result == TRUE)
 			++countSucceeded;
 		else if (result == ERROR)
@@ -883,13 +886,62 @@ static CondResult evalMultipleConditions (Key * key, const Key * meta, const Key
 	}
 }
 
-int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+static void freeConditionalsData (ConditionalsData * data)
+{
+	clearCache (data->cache);
+	ksDel (data->cache);
+	regfree (&data->conditionRegex);
+	regfree (&data->thenRegex);
+	regfree (&data->elseRegex);
+	regfree (&data->singleRegex);
+	elektraFree (data);
+}
+
+static ConditionalsData * getConditionalsData (Plugin * handle, Key * parentKey)
+{
+	ConditionalsData * data = elektraPluginGetData (handle);
+	if (data) return data;
+
+	data = elektraCalloc (sizeof (ConditionalsData));
+	int compiled = 0;
+	if (!regcomp (&data->conditionRegex, "(\\(((.*)?)\\))[[:space:]]*\\?", REGEX_FLAGS_CONDITION)) ++compiled;
+	if (compiled == 1 && !regcomp (&data->thenRegex, "\\?[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION)) ++compiled;
+	if (compiled == 2 && !regcomp (&data->elseRegex, "[[:space:]]*:[[:space:]]*(\\(((.*)?)\\))", REGEX_FLAGS_CONDITION)) ++compiled;
+	if (compiled == 3 && !regcomp (&data->singleRegex, "((\\(([^\\(\\)]*)\\)))", REG_EXTENDED | REG_NEWLINE)) ++compiled;
+	if (compiled != 4)
+	{
+		// the regex compiles so the only possible error would be out of memory
+		ELEKTRA_SET_ERROR (87, parentKey, "Couldn't compile regex: most likely out of memory");
+		if (compiled > 0) regfree (&data->conditionRegex);
+		if (compiled > 1) regfree (&data->thenRegex);
+		if (compiled > 2) regfree (&data->elseRegex);
+		elektraFree (data);
+		return NULL;
+	}
+	data->cache = ksNew (0, KS_END);
+	elektraPluginSetData (handle, data);
+	return data;
+}
+
+int elektraConditionalsClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	ConditionalsData * data = elektraPluginGetData (handle);
+	if (data)
+	{
+		freeConditionalsData (data);
+		elektraPluginSetData (handle, NULL);
+	}
+	return 1; /* success */
+}
+
+int elektraConditionalsGet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
 	if (!strcmp (keyName (parentKey), "system/elektra/modules/conditionals"))
 	{
 		KeySet * contract = ksNew (
 			30, keyNew ("system/elektra/modules/conditionals", KEY_VALUE, "conditionals plugin waits for your orders", KEY_END),
 			keyNew ("system/elektra/modules/conditionals/exports", KEY_END),
+			keyNew ("system/elektra/modules/conditionals/exports/close", KEY_FUNC, elektraConditionalsClose, KEY_END),
 			keyNew ("system/elektra/modules/conditionals/exports/get", KEY_FUNC, elektraConditionalsGet, KEY_END),
 			keyNew ("system/elektra/modules/conditionals/exports/set", KEY_FUNC, elektraConditionalsSet, KEY_END),
 #include ELEKTRA_README
@@ -899,6 +951,8 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 
 		return 1; /* success */
 	}
+	ConditionalsData * data = getConditionalsData (handle, parentKey);
+	if (!data) return -1;
 	Key * cur;
 	ksRewind (returned);
 	CondResult ret = FALSE;
@@ -915,7 +969,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION, data);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -928,19 +982,19 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 
@@ -953,7 +1007,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN, data);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -972,7 +1026,7 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN, data);
 			}
 		}
 	}
@@ -981,8 +1035,10 @@ int elektraConditionalsGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 }
 
 
-int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey ELEKTRA_UNUSED)
+int elektraConditionalsSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
+	ConditionalsData * data = getConditionalsData (handle, parentKey);
+	if (!data) return -1;
 	Key * cur;
 	ksRewind (returned);
 	CondResult ret = FALSE;
@@ -999,7 +1055,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		{
 			CondResult result;
 
-			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION);
+			result = evaluateKey (conditionMeta, suffixList, parentKey, cur, returned, CONDITION, data);
 			if (result == NOEXPR)
 			{
 				ret |= TRUE;
@@ -1012,19 +1068,19 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 		else if (allConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, allConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 		else if (anyConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, anyConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 		else if (noneConditionMeta)
 		{
 			CondResult result;
-			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned);
+			result = evalMultipleConditions (cur, noneConditionMeta, suffixList, parentKey, returned, data);
 			ret |= result;
 		}
 
@@ -1037,7 +1093,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 				while ((a = ksNext (assignKS)) != NULL)
 				{
 					if (keyCmp (a, assignMeta) == 0) continue;
-					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN);
+					CondResult result = evaluateKey (a, suffixList, parentKey, cur, returned, ASSIGN, data);
 					if (result == TRUE)
 					{
 						ret |= TRUE;
@@ -1056,7 +1112,7 @@ int elektraConditionalsSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned EL
 			}
 			else
 			{
-				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN);
+				ret |= evaluateKey (assignMeta, suffixList, parentKey, cur, returned, ASSIGN, data);
 			}
 		}
 	}
@@ -1070,5 +1126,6 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
     return elektraPluginExport ("conditionals",
 	    ELEKTRA_PLUGIN_GET, &elektraConditionalsGet,
 	    ELEKTRA_PLUGIN_SET, &elektraConditionalsSet,
+	    ELEKTRA_PLUGIN_CLOSE, &elektraConditionalsClose,
 	    ELEKTRA_PLUGIN_END);
 }
@@ -13,6 +13,7 @@
 #include <kdbplugin.h>
 
 
+int elektraConditionalsClose (Plugin * handle, Key * errorKey);
 int elektraConditionalsGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraConditionalsSet (Plugin * handle, KeySet * ks, Key * parentKey);
 
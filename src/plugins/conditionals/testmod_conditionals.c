@@ -653,6 +653,63 @@ static void test_multiAssign3 (void)
 	PLUGIN_CLOSE ();
 }
 
+static void test_cachedCondition (void)
+{
+	Key * parentKey = keyNew ("user/tests/conditionals", KEY_VALUE, "", KEY_END);
+	const char * condition = "(../limit > '10') ? (./ < '100')";
+	KeySet * ks = ksNew (5, keyNew ("user/tests/conditionals/a/limit", KEY_VALUE, "20", KEY_END),
+			     keyNew ("user/tests/conditionals/a/value", KEY_VALUE, "50", KEY_META, "check/condition", condition, KEY_END),
+			     keyNew ("user/tests/conditionals/b/limit", KEY_VALUE, "20", KEY_END),
+			     keyNew ("user/tests/conditionals/b/value", KEY_VALUE, "70", KEY_META, "check/condition", condition, KEY_END),
+			     KS_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("conditionals");
+	ksRewind (ks);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == 1, "error");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "error on second evaluation");
+
+	// every key must be checked, not only the first one with this condition
+	keySetString (ksLookupByName (ks, "user/tests/conditionals/b/value", 0), "200");
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "validation of cached condition should fail");
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_manyConditions (void)
+{
+	Key * parentKey = keyNew ("user/tests/conditionals", KEY_VALUE, "", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	char condition[64];
+	// more distinct conditions than the plugin caches
+	for (int i = 0; i < 1500; ++i)
+	{
+		snprintf (name, sizeof (name), "user/tests/conditionals/%d", i);
+		snprintf (condition, sizeof (condition), "(./ == '%d') ? (./ < '%d')", i, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "-1", KEY_META, "check/condition", condition, KEY_END));
+	}
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("conditionals");
+	for (int run = 0; run < 2; ++run)
+	{
+		ksRewind (ks);
+		succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "validation of many conditions failed");
+	}
+
+	keySetString (ksLookupByName (ks, "user/tests/conditionals/1499", 0), "1499");
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "validation of last condition should fail");
+	keySetString (ksLookupByName (ks, "user/tests/conditionals/1499", 0), "-1");
+	keySetString (ksLookupByName (ks, "user/tests/conditionals/5", 0), "5");
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "validation of evicted condition should fail");
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("CONDITIONALS     TESTS\n");
@@ -694,6 +751,8 @@ int main (int argc, char ** argv)
 	test_multiCond2NoFail ();
 	test_multiAssign2 ();
 	test_multiAssign3 ();
+	test_cachedCondition ();
+	test_manyConditions ();
 	print_result ("testmod_conditionals");
 
 	return nbError;
@@ -14,6 +14,7 @@
 
 #include "csvstorage.h"
 #include <errno.h>
+#include <fcntl.h>
 #include <kdbassert.h>
 #include <kdbease.h>
 #include <kdberrors.h>
@@ -22,6 +23,9 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 
 #define PARSE 1
@@ -172,22 +176,6 @@ static char * parseLine (char * origLine, char delim, unsigned long offset, Key
 	return line;
 }
 
-static unsigned long getLineLength (FILE * fp)
-{
-	int startPos = ftell (fp);
-	char c;
-	while ((c = fgetc (fp)) && (!feof (fp)))
-	{
-		if (c == '\n') break;
-	}
-	int endPos = ftell (fp);
-	fseek (fp, startPos, SEEK_SET);
-	if ((endPos - startPos) == 0)
-		return 0;
-	else
-		return (endPos - startPos) + 1;
-}
-
 // count columns in lineBuffer
 // ignore record and field separators in quoted fields
 
@@ -211,56 +199,150 @@ static unsigned long getColumnCount (char * lineBuffer, char delim)
 	return counter;
 }
 
+/**
+ * The whole file is mapped (or read) once and records are copied from it
+ * into a buffer that is reused for every record, so parsing a line needs
+ * neither seeking nor an allocation.
+ */
+typedef struct
+{
+	char * data;	   /*!< content of the file */
+	size_t size;	   /*!< size of the file */
+	size_t pos;	   /*!< offset of the next line in data */
+	int mapped;	   /*!< data is a mapping of the file */
+	char * buffer;	   /*!< current record */
+	size_t bufferSize; /*!< allocated size of buffer */
+	size_t failedSize; /*!< size of the buffer, which could not be allocated */
+} CsvReader;
+
+static int openReader (CsvReader * reader, const char * fileName)
+{
+	memset (reader, 0, sizeof (CsvReader));
+	int fd = open (fileName, O_RDONLY);
+	if (fd == -1) return -1;
+	struct stat fileStat;
+	if (fstat (fd, &fileStat) == -1)
+	{
+		close (fd);
+		return -1;
+	}
+	reader->size = fileStat.st_size;
+	if (reader->size == 0)
+	{
+		close (fd);
+		return 0;
+	}
+
+	void * data = mmap (NULL, reader->size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (data != MAP_FAILED)
+	{
+		reader->data = data;
+		reader->mapped = 1;
+		close (fd);
+		return 0;
+	}
+
+	reader->data = elektraMalloc (reader->size);
+	size_t done = 0;
+	while (done < reader->size)
+	{
+		ssize_t rd = read (fd, reader->data + done, reader->size - done);
+		if (rd == -1 && errno == EINTR) continue;
+		if (rd <= 0)
+		{
+			elektraFree (reader->data);
+			close (fd);
+			return -1;
+		}
+		done += rd;
+	}
+	close (fd);
+	return 0;
+}
+
+static void closeReader (CsvReader * reader)
+{
+	if (reader->mapped)
+	{
+		munmap (reader->data, reader->size);
+	}
+	else if (reader->data)
+	{
+		elektraFree (reader->data);
+	}
+	if (reader->buffer) elektraFree (reader->buffer);
+}
+
 // reads next record from file according to RFC 4180
 // if EOL is reached with unbalanced quotes, assume record continues at the next
 // line. append succeeding lines until quotes are balanced or EOF is reached
+// @returns the record, which is only valid until the next call,
+// or NULL at the end of the file and if the buffer could not be grown (failedSize is set)
 
-static char * readNextLine (FILE * fp, char delim, int * lastLine, int * linesRead)
+static char * readNextLine (CsvReader * reader, char delim, int * lastLine, int * linesRead)
 {
 	int done = 0;
-	unsigned long bufLen = 0;
-	unsigned long offset = 0;
-	*linesRead = 0;
-	char * lineBuffer = NULL;
+	size_t len = 0;
 	*linesRead = 0;
 	int isQuoted = 0;
 	int isCol = 0;
 	while (!done)
 	{
-
-		unsigned long len = getLineLength (fp);
-		if (!len)
+		if (reader->pos >= reader->size)
 		{
-			if (!lineBuffer)
+			if (!len)
 			{
 				*lastLine = 0;
 				return NULL;
 			}
 			else
-				return lineBuffer;
+				return reader->buffer;
 		}
 		else
 		{
 			++(*linesRead);
 		}
-		char buffer[len];
-		fgets (buffer, len, fp);
-		char * ptr = buffer;
+		const char * line = reader->data + reader->pos;
+		const char * newline = memchr (line, '\n', reader->size - reader->pos);
+		size_t lineLen = newline ? (size_t) (newline - line) + 1 : reader->size - reader->pos;
+		reader->pos += lineLen;
+
+		if (len + lineLen + 1 > reader->bufferSize)
+		{
+			size_t newSize = reader->bufferSize * 2;
+			if (newSize < len + lineLen + 1) newSize = len + lineLen + 1;
+			if (elektraRealloc ((void **) &reader->buffer, newSize) == -1)
+			{
+				reader->failedSize = newSize;
+				return NULL;
+			}
+			reader->bufferSize = newSize;
+		}
+		memcpy (reader->buffer + len, line, lineLen);
+		reader->buffer[len + lineLen] = '\0';
+
+		char * ptr = reader->buffer + len;
 		while (*ptr)
 		{
 			parseRecord (&ptr, delim, &isQuoted, &isCol, &(int){ 0 }, &(unsigned long){ 0 }, COLCOUNT);
 		}
-		len = elektraStrLen (buffer);
-		bufLen += len;
-		lineBuffer = realloc (lineBuffer, bufLen);
-
-		memcpy (lineBuffer + offset, buffer, len);
-		offset += (len - 1);
+		len += lineLen;
 		if (!isCol && !isQuoted) done = 1;
 	}
-	return lineBuffer;
+	return reader->buffer;
 }
 
+// @returns 1 if the column should be materialized when reading
+
+static int isImportColumn (const char * name, KeySet * importKS)
+{
+	if (!importKS) return 1;
+	Key * lookupKey = keyNew ("/import", KEY_CASCADING_NAME, KEY_END);
+	keyAddBaseName (lookupKey, name);
+	int found = ksLookup (importKS, lookupKey, KDB_O_NONE) != NULL;
+	keyDel (lookupKey);
+	return found;
+}
 
 /// @returns a newly allocated keyset with the column names
 static KeySet * createHeaders (Key * parentKey, int columns, const char ** colNames)
@@ -305,7 +387,6 @@ static KeySet * readHeaders (Key * parentKey, char * lineBuffer, char delim, int
 		offset += elektraStrLen (col);
 		if (elektraArrayIncName (orderKey) == -1)
 		{
-			elektraFree (lineBuffer);
 			keyDel (orderKey);
 			ksDel (header);
 			return NULL;
@@ -327,22 +408,27 @@ static KeySet * readHeaders (Key * parentKey, char * lineBuffer, char delim, int
 }
 
 static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsParent, short useHeader, unsigned long fixColumnCount,
-		    const char ** colNames)
+		    const char ** colNames, KeySet * importKS)
 {
 	const char * fileName;
 	fileName = keyString (parentKey);
-	FILE * fp = fopen (fileName, "rb");
-	if (!fp)
+	CsvReader reader;
+	if (openReader (&reader, fileName) == -1)
 	{
 		ELEKTRA_SET_ERRORF (116, parentKey, "couldn't open file %s", fileName);
 		return -1;
 	}
 	int lastLine = 0;
 	int linesRead = 0;
-	char * lineBuffer = readNextLine (fp, delim, &lastLine, &linesRead);
+	char * lineBuffer = readNextLine (&reader, delim, &lastLine, &linesRead);
 	if (!lineBuffer)
 	{
-		fclose (fp);
+		closeReader (&reader);
+		if (reader.failedSize)
+		{
+			ELEKTRA_MALLOC_ERROR (parentKey, reader.failedSize);
+			return -1;
+		}
 		return 0;
 	}
 	unsigned long columns = 0;
@@ -353,8 +439,7 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		{
 			ELEKTRA_SET_ERRORF (117, parentKey, "illegal number of columns (%lu - %lu) in Header line: %s", columns,
 					    fixColumnCount, lineBuffer);
-			elektraFree (lineBuffer);
-			fclose (fp);
+			closeReader (&reader);
 			return -1;
 		}
 	}
@@ -370,10 +455,10 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		header = readHeaders (parentKey, lineBuffer, delim, lineCounter, lastLine, colNames);
 		if (!header)
 		{
-			fclose (fp);
+			closeReader (&reader);
 			return -1;
 		}
-		fseek (fp, 0, SEEK_SET);
+		reader.pos = 0;
 		lineCounter += linesRead;
 	}
 	else
@@ -381,13 +466,12 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		header = createHeaders (parentKey, columns, colNames);
 		if (!header)
 		{
-			elektraFree (lineBuffer);
-			fclose (fp);
+			closeReader (&reader);
 			return -1;
 		}
 		if (useHeader == 0)
 		{
-			fseek (fp, 0, SEEK_SET);
+			reader.pos = 0;
 		}
 		lineCounter += 1;
 	}
@@ -395,25 +479,41 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 	Key * cur;
 	dirKey = keyDup (parentKey);
 	keyAddName (dirKey, "#");
-	elektraFree (lineBuffer);
+
+	// decide once per column if it is materialized, the index column is always needed
+	size_t headerSize = ksGetSize (header);
+	char * importColumn = elektraMalloc (headerSize + 1);
+	ksRewind (header);
+	for (size_t i = 0; (cur = ksNext (header)) != NULL; ++i)
+	{
+		importColumn[i] = isImportColumn (keyString (cur), importKS) ||
+				  (colAsParent && !strcmp (keyString (cur), keyString (colAsParent)));
+	}
+
 	ksRewind (header);
 	while (1)
 	{
-		lineBuffer = readNextLine (fp, delim, &lastLine, &linesRead);
+		lineBuffer = readNextLine (&reader, delim, &lastLine, &linesRead);
 		if (!lineBuffer)
 		{
-			fclose (fp);
+			closeReader (&reader);
 			keyDel (dirKey);
 			ksDel (header);
+			elektraFree (importColumn);
+			if (reader.failedSize)
+			{
+				ELEKTRA_MALLOC_ERROR (parentKey, reader.failedSize);
+				return -1;
+			}
 			return (lineCounter > 0) ? 1 : 0;
 		}
 
 		if (elektraArrayIncName (dirKey) == -1)
 		{
-			elektraFree (lineBuffer);
 			keyDel (dirKey);
 			ksDel (header);
-			fclose (fp);
+			elektraFree (importColumn);
+			closeReader (&reader);
 			return -1;
 		}
 		++nr_keys;
@@ -427,6 +527,12 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 		{
 			cur = ksNext (header);
 			offset += elektraStrLen (col);
+			if (colCounter < headerSize && !importColumn[colCounter])
+			{
+				lastIndex = (char *) keyBaseName (cur);
+				++colCounter;
+				continue;
+			}
 			key = keyDup (dirKey);
 			if (col[0] == '"')
 			{
@@ -481,25 +587,25 @@ static int csvRead (KeySet * returned, Key * parentKey, char delim, Key * colAsP
 			{
 				ELEKTRA_SET_ERRORF (117, parentKey, "illegal number of columns (%lu - %lu) in line %lu: %s", colCounter,
 						    columns, lineCounter, lineBuffer);
-				elektraFree (lineBuffer);
-				fclose (fp);
+				closeReader (&reader);
 				keyDel (dirKey);
 				ksDel (header);
+				elektraFree (importColumn);
 				return -1;
 			}
 			ELEKTRA_ADD_WARNINGF (118, parentKey, "illegal number of columns (%lu - %lu)  in line %lu: %s", colCounter, columns,
 					      lineCounter, lineBuffer);
 		}
 		lineCounter += linesRead;
-		elektraFree (lineBuffer);
 		ksDel (tmpKs);
 	}
 	key = keyDup (parentKey);
 	keySetString (key, keyBaseName (dirKey));
 	ksAppendKey (returned, key);
 	keyDel (dirKey);
-	fclose (fp);
+	closeReader (&reader);
 	ksDel (header);
+	elektraFree (importColumn);
 	return 1;
 }
 
@@ -588,9 +694,18 @@ int elektraCsvstorageGet (Plugin * handle, KeySet * returned, Key * parentKey)
 			ksDel (namesKS);
 		}
 	}
+	Key * importKey = ksLookupByName (config, "/import", 0);
+	KeySet * importKS = NULL;
+	if (importKey)
+	{
+		importKS = ksCut (config, importKey);
+		ksAppend (config, importKS);
+		keyDel (ksLookup (importKS, importKey, KDB_O_POP));
+	}
 	int nr_keys;
-	nr_keys = csvRead (returned, parentKey, delim, colAsParent, useHeader, fixColumnCount, (const char **) colNames);
+	nr_keys = csvRead (returned, parentKey, delim, colAsParent, useHeader, fixColumnCount, (const char **) colNames, importKS);
 	if (colNames) elektraFree (colNames);
+	ksDel (importKS);
 	if (nr_keys == -1) return -1;
 	return 1;
 }
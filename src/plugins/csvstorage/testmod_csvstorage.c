@@ -36,6 +36,51 @@ static void testread (const char * file)
 
 	PLUGIN_CLOSE ();
 }
+static void testreadimport (const char * file)
+{
+	Key * parentKey = keyNew ("user/tests/csvstorage", KEY_VALUE, srcdir_file (file), KEY_END);
+	KeySet * conf = ksNew (20, keyNew ("system/delimiter", KEY_VALUE, ";", KEY_END),
+			       keyNew ("system/header", KEY_VALUE, "colname", KEY_END), keyNew ("system/import", KEY_VALUE, "", KEY_END),
+			       keyNew ("system/import/col2", KEY_VALUE, "", KEY_END), KS_END);
+	PLUGIN_OPEN ("csvstorage");
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) >= 1, "call to kdbGet was not successful");
+	Key * key;
+	key = ksLookupByName (ks, "user/tests/csvstorage/#1/col2", 0);
+	exit_if_fail (key, "key not found");
+	succeed_if (strcmp (keyString (key), "l2c2") == 0, "wrong key");
+	succeed_if (!ksLookupByName (ks, "user/tests/csvstorage/#1/col1", 0), "column not imported but found");
+	succeed_if (!ksLookupByName (ks, "user/tests/csvstorage/#2/col1", 0), "column not imported but found");
+	key = ksLookupByName (ks, "user/tests/csvstorage/#2", 0);
+	exit_if_fail (key, "record not found");
+	succeed_if (strcmp (keyString (key), "#1") == 0, "wrong last index of record");
+
+	ksDel (ks);
+	keyDel (parentKey);
+
+	PLUGIN_CLOSE ();
+}
+static void testreadimportescaped (const char * file)
+{
+	Key * parentKey = keyNew ("user/tests/csvstorage", KEY_VALUE, srcdir_file (file), KEY_END);
+	KeySet * conf = ksNew (20, keyNew ("system/delimiter", KEY_VALUE, ";", KEY_END),
+			       keyNew ("system/header", KEY_VALUE, "colname", KEY_END), keyNew ("system/import", KEY_VALUE, "", KEY_END),
+			       keyNew ("system/import/a\\/b", KEY_VALUE, "", KEY_END), KS_END);
+	PLUGIN_OPEN ("csvstorage");
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) >= 1, "call to kdbGet was not successful");
+	Key * key;
+	key = ksLookupByName (ks, "user/tests/csvstorage/#1/a/b", 0);
+	exit_if_fail (key, "column with / in its name not imported");
+	succeed_if (strcmp (keyString (key), "l1c1") == 0, "wrong key");
+	succeed_if (!ksLookupByName (ks, "user/tests/csvstorage/#1/a", 0), "column not imported but found");
+	succeed_if (!ksLookupByName (ks, "user/tests/csvstorage/#1/c", 0), "column not imported but found");
+
+	ksDel (ks);
+	keyDel (parentKey);
+
+	PLUGIN_CLOSE ();
+}
 static void testreadfixcolcount (const char * file)
 {
 	Key * parentKey = keyNew ("user/tests/csvstorage", KEY_VALUE, srcdir_file (file), KEY_END);
@@ -200,6 +245,8 @@ int main (int argc, char ** argv)
 
 	testread ("csvstorage/valid.csv");
 	testread ("csvstorage/validDos.csv");
+	testreadimport ("csvstorage/valid.csv");
+	testreadimportescaped ("csvstorage/slash_header.csv");
 	testreadfixcolcount ("csvstorage/valid.csv");
 	testreadwriteinvalid ("csvstorage/invalid_columns.csv");
 	testwriteinvalidheader ("csvstorage/invalid_columns_header2.csv");
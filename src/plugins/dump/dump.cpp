@@ -104,6 +104,9 @@ int unserialise (std::istream & is, ckdb::Key * errorKey, ckdb::KeySet * ks)
 	size_t namesize;
 	size_t valuesize;
 
+	// keys are allocated from an arena, which is freed once all keys are deleted
+	ckdb::ElektraArena * arena = ckdb::elektraArenaNew (0);
+
 	while (std::getline (is, line))
 	{
 		std::stringstream ss (line);
@@ -116,6 +119,7 @@ int unserialise (std::istream & is, ckdb::Key * errorKey, ckdb::KeySet * ks)
 			if (version != "1")
 			{
 				ELEKTRA_SET_ERROR (50, errorKey, version.c_str ());
+				ckdb::elektraArenaDel (arena);
 				return -1;
 			}
 		}
@@ -127,21 +131,24 @@ int unserialise (std::istream & is, ckdb::Key * errorKey, ckdb::KeySet * ks)
 		}
 		else if (command == "keyNew")
 		{
-			cur = ckdb::keyNew (nullptr);
-
 			ss >> namesize;
 			ss >> valuesize;
 
 			if (namesize > namebuffer.size ()) namebuffer.resize (namesize + 1);
 			is.read (&namebuffer[0], namesize);
 			namebuffer[namesize] = 0;
-			ckdb::keySetName (cur, &namebuffer[0]);
 
 			if (valuesize > valuebuffer.size ()) valuebuffer.resize (valuesize + 1);
 			is.read (&valuebuffer[0], valuesize);
 			valuebuffer[valuesize] = 0;
 
-			ckdb::keySetRaw (cur, &valuebuffer[0], valuesize);
+			cur = ckdb::elektraArenaKeyNew (arena, &namebuffer[0], &valuebuffer[0], valuesize);
+			if (!cur)
+			{
+				ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, errorKey, "Could not create key '%s'", &namebuffer[0]);
+				ckdb::elektraArenaDel (arena);
+				return -1;
+			}
 			std::getline (is, line);
 		}
 		else if (command == "keyMeta")
@@ -189,9 +196,12 @@ int unserialise (std::istream & is, ckdb::Key * errorKey, ckdb::KeySet * ks)
 		else
 		{
 			ELEKTRA_SET_ERROR (49, errorKey, command.c_str ());
+			ckdb::keyDel (cur);
+			ckdb::elektraArenaDel (arena);
 			return -1;
 		}
 	}
+	ckdb::elektraArenaDel (arena);
 	return 1;
 }
 
@@ -18,6 +18,7 @@
 #include <ctype.h>  // isspace()
 #include <errno.h>  // errno
 #include <stdlib.h> // strto* functions
+#include <string.h> // memcmp()
 
 /**
  * Structure for registered key variable pairs
@@ -45,6 +46,8 @@ struct _PluginState
 	KeyRegistration * last;
 	ElektraNotificationConversionErrorCallback conversionErrorCallback;
 	void * conversionErrorCallbackContext;
+	/** copies of the keys below registrations for a key or below, as seen by the last update */
+	KeySet * lastKeys;
 };
 typedef struct _PluginState PluginState;
 
@@ -168,7 +171,7 @@ void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationC
 
 	if (kdbChanged)
 	{
-		context->kdbUpdate (context->kdb, changedKey);
+		context->kdbUpdate (context, changedKey);
 	}
 	keyDel (changedKey);
 }
@@ -219,20 +222,100 @@ static KeyRegistration * elektraInternalnotificationAddNewRegistration (PluginSt
 
 /**
  * @internal
- * Check if a key set contains a key that is same or below a given key.
+ * Check if two keys have the same value.
  *
- * @param  key  key
- * @param  ks   key set
- * @retval 1 if the key set contains the key
+ * @param  key   key
+ * @param  check check
+ * @retval 1 if the values are equal
+ * @retval 0 otherwise
+ */
+static int keyValueIsSame (Key * key, Key * check)
+{
+	ssize_t size = keyGetValueSize (key);
+	return keyGetValueSize (check) == size && (size <= 0 || memcmp (keyValue (key), keyValue (check), size) == 0);
+}
+
+/**
+ * @internal
+ * Check if a key was reloaded by an update.
+ *
+ * @param  key       key
+ * @param  parentKey key below which all keys were reloaded, NULL if all keys were reloaded
+ * @retval 1 if the key was reloaded
  * @retval 0 otherwise
  */
-static int keySetContainsSameOrBelow (Key * check, KeySet * ks)
+static int keyWasReloaded (Key * key, Key * parentKey)
+{
+	return parentKey == NULL || keyIsBelowOrSame (parentKey, key) == 1;
+}
+
+/**
+ * @internal
+ * Check if a key set contains a changed key that is same or below a given key.
+ *
+ * Keys are compared to the keys seen by previous updates.
+ * Keys missing in the key set are removed, if they were reloaded.
+ * Other keys are kept, since a reload of a part of the hierarchy
+ * only returns the keys of this part.
+ *
+ * @param  check     key
+ * @param  ks        key set
+ * @param  lastKeys  keys seen by previous updates
+ * @param  parentKey key below which all keys were reloaded, NULL if all keys were reloaded
+ * @retval 1 if a key was added, changed or removed
+ * @retval 0 otherwise
+ */
+static int keySetContainsChangedSameOrBelow (Key * check, KeySet * ks, KeySet * lastKeys, Key * parentKey)
 {
 	Key * current;
 	ksRewind (ks);
 	while ((current = ksNext (ks)) != NULL)
 	{
-		if (checkKeyIsBelowOrSame (check, current))
+		if (!checkKeyIsBelowOrSame (check, current))
+		{
+			continue;
+		}
+
+		Key * last = ksLookup (lastKeys, current, 0);
+		if (last == NULL || !keyValueIsSame (last, current))
+		{
+			return 1;
+		}
+	}
+
+	ksRewind (lastKeys);
+	while ((current = ksNext (lastKeys)) != NULL)
+	{
+		if (checkKeyIsBelowOrSame (check, current) && keyWasReloaded (current, parentKey) && ksLookup (ks, current, 0) == NULL)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @internal
+ * Check if a key is same or below a registration for a key or below.
+ *
+ * @param  pluginState plugin state
+ * @param  key         key
+ * @retval 1 if key is same or below such a registration
+ * @retval 0 otherwise
+ */
+static int keyIsRegisteredSameOrBelow (PluginState * pluginState, Key * key)
+{
+	for (KeyRegistration * registeredKey = pluginState->head; registeredKey != NULL; registeredKey = registeredKey->next)
+	{
+		if (!registeredKey->sameOrBelow)
+		{
+			continue;
+		}
+
+		Key * checkKey = keyNew (registeredKey->name, KEY_END);
+		int result = checkKeyIsBelowOrSame (checkKey, key);
+		keyDel (checkKey);
+		if (result)
 		{
 			return 1;
 		}
@@ -240,6 +323,48 @@ static int keySetContainsSameOrBelow (Key * check, KeySet * ks)
 	return 0;
 }
 
+/**
+ * @internal
+ * Remember the keys of an update, which are below registrations for a key or below.
+ *
+ * Only keys that were added or changed are copied.
+ *
+ * @param  pluginState plugin state
+ * @param  ks          key set
+ * @param  parentKey   key below which all keys were reloaded, NULL if all keys were reloaded
+ */
+static void updateLastKeys (PluginState * pluginState, KeySet * ks, Key * parentKey)
+{
+	KeySet * lastKeys = pluginState->lastKeys;
+	Key * current;
+
+	// remove reloaded keys that are gone
+	for (cursor_t it = 0; it < ksGetSize (lastKeys);)
+	{
+		current = ksAtCursor (lastKeys, it);
+		if (keyWasReloaded (current, parentKey) && ksLookup (ks, current, 0) == NULL)
+		{
+			keyDel (ksLookup (lastKeys, current, KDB_O_POP));
+			continue;
+		}
+		++it;
+	}
+
+	ksRewind (ks);
+	while ((current = ksNext (ks)) != NULL)
+	{
+		Key * last = ksLookup (lastKeys, current, 0);
+		if (last != NULL && keyValueIsSame (last, current))
+		{
+			continue;
+		}
+		if (last != NULL || keyIsRegisteredSameOrBelow (pluginState, current))
+		{
+			ksAppendKey (lastKeys, keyDup (current));
+		}
+	}
+}
+
 /**
  * Updates all KeyRegistrations according to data from the given KeySet
  * @internal
@@ -247,9 +372,12 @@ static int keySetContainsSameOrBelow (Key * check, KeySet * ks)
  * @param plugin    internal plugin handle
  * @param keySet    key set retrieved from hooks
  *                  e.g. elektraInternalnotificationGet or elektraInternalnotificationSet)
+ * @param parentKey key below which all keys are contained in the key set,
+ *                  keys missing there are removed.
+ *                  NULL if the key set contains all keys
  *
  */
-void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet * keySet)
+void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet * keySet, Key * parentKey)
 {
 	PluginState * pluginState = elektraPluginGetData (plugin);
 	ELEKTRA_ASSERT (pluginState != NULL, "plugin state was not initialized properly");
@@ -262,7 +390,7 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 		if (registeredKey->sameOrBelow)
 		{
 			Key * checkKey = keyNew (registeredKey->name, KEY_END);
-			if (keySetContainsSameOrBelow (checkKey, keySet))
+			if (keySetContainsChangedSameOrBelow (checkKey, keySet, pluginState->lastKeys, parentKey))
 			{
 				changed = 1;
 				key = checkKey;
@@ -323,6 +451,8 @@ void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet *
 		// proceed with next registered key
 		registeredKey = registeredKey->next;
 	}
+
+	updateLastKeys (pluginState, keySet, parentKey);
 }
 
 // Generate register and conversion functions
@@ -559,7 +689,7 @@ int elektraInternalnotificationGet (Plugin * handle, KeySet * returned, Key * pa
 		return 1;
 	}
 
-	elektraInternalnotificationUpdateRegisteredKeys (handle, returned);
+	elektraInternalnotificationUpdateRegisteredKeys (handle, returned, parentKey);
 
 	return 1;
 }
@@ -575,9 +705,9 @@ int elektraInternalnotificationGet (Plugin * handle, KeySet * returned, Key * pa
  * @retval 1 on success
  * @retval -1 on failure
  */
-int elektraInternalnotificationSet (Plugin * handle, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
+int elektraInternalnotificationSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
-	elektraInternalnotificationUpdateRegisteredKeys (handle, returned);
+	elektraInternalnotificationUpdateRegisteredKeys (handle, returned, parentKey);
 
 	return 1;
 }
@@ -609,6 +739,7 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * parentKey ELEKTRA_UN
 		pluginState->last = NULL;
 		pluginState->conversionErrorCallback = NULL;
 		pluginState->conversionErrorCallbackContext = NULL;
+		pluginState->lastKeys = ksNew (0, KS_END);
 	}
 
 	return 1;
@@ -649,6 +780,8 @@ int elektraInternalnotificationClose (Plugin * handle, Key * parentKey ELEKTRA_U
 			current = next;
 		}
 
+		ksDel (pluginState->lastKeys);
+
 		// Free list pointer
 		elektraFree (pluginState);
 		elektraPluginSetData (handle, NULL);
@@ -22,7 +22,7 @@ int elektraInternalnotificationOpen (Plugin * handle, Key * errorKey);
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
 // Not exported by plugin; used for testing
-void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet * keySet);
+void elektraInternalnotificationUpdateRegisteredKeys (Plugin * plugin, KeySet * keySet, Key * parentKey);
 void elektraInternalnotificationDoUpdate (Key * changedKey, ElektraNotificationCallbackContext * context);
 
 #define INTERNALNOTIFICATION_REGISTER_NAME(TYPE_NAME) elektraInternalnotificationRegister##TYPE_NAME
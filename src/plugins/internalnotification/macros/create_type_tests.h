@@ -67,7 +67,7 @@ TEST_CASE_UPDATE_SIGNATURE (TYPE_NAME)
 	char * valueStr = elektraFormat (FORMAT_STRING, TEST_VALUE);
 	Key * valueKey = keyNew ("user/test/internalnotification/value", KEY_VALUE, valueStr, KEY_END);
 	KeySet * ks = ksNew (1, valueKey, KS_END);
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 	succeed_if (CHECK_VALUE, "registered value was not updated");
 	free (valueStr);
 	keyDel (registeredKey);
@@ -86,7 +86,7 @@ TEST_CASE_NO_UPDATE_SIGNATURE (TYPE_NAME)
 	TYPE value = 0;
 	succeed_if (REGISTER_FUNC_NAME (TYPE_NAME) (plugin, valueKey, &value) == 1, "registration was not successful");
 	keySetString (valueKey, INVALID_VALUE);
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 	succeed_if (CHECK_INVALID, "registered value was updated");
 	ksDel (ks);
 	PLUGIN_CLOSE ();
@@ -201,7 +201,7 @@ static void test_intUpdateWithCascadingKey (void)
 	Key * valueKey = keyNew ("user/test/internalnotification/value", KEY_VALUE, "42", KEY_END);
 	KeySet * ks = ksNew (1, valueKey, KS_END);
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == 42, "registered value was not updated");
 
@@ -227,7 +227,7 @@ static void test_intNoUpdateWithInvalidValue (void)
 	keySetString (valueKey, "42abcd");
 
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == 123, "registered value was updated");
 
@@ -257,7 +257,7 @@ static void test_conversionError (void)
 	callback_called = 0;
 	callback_keyName = NULL;
 	callback_keyValue = NULL;
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == 123, "registered value was updated");
 	succeed_if (callback_called, "conversion error callback was not called");
@@ -286,7 +286,7 @@ static void test_intUpdateWithValueNotYetExceedingIntMax (void)
 	keySetString (valueKey, stringValue);
 
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == INT_MAX, "registered value was not updated");
 
@@ -314,7 +314,7 @@ static void test_intNoUpdateWithValueExceedingIntMax (void)
 	keySetString (valueKey, stringValue);
 
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == 123, "registered value was updated");
 
@@ -343,7 +343,7 @@ static void test_intUpdateWithValueNotYetExceedingIntMin (void)
 	keySetString (valueKey, stringValue);
 
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == INT_MIN, "registered value was not updated");
 
@@ -370,7 +370,7 @@ static void test_intNoUpdateWithValueExceedingIntMin (void)
 	char * stringValue = convertLongLongToString (exceedsInt);
 	keySetString (valueKey, stringValue);
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (value == 123, "registered value was updated");
 
@@ -393,7 +393,7 @@ static void test_callbackCalledWithKey (void)
 	succeed_if (internalnotificationRegisterCallback (plugin, valueKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) == 1,
 		    "call to elektraInternalnotificationRegisterCallback was not successful");
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (callback_called, "registered value was not updated");
 	succeed_if_same_string (callback_keyName, keyName (valueKey));
@@ -417,19 +417,75 @@ static void test_callbackCalledWithChangeDetection (void)
 	succeed_if (internalnotificationRegisterCallback (plugin, valueKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) == 1,
 		    "call to elektraInternalnotificationRegisterCallback was not successful");
 
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 
 	succeed_if (callback_called, "registered value was not updated");
 
 	callback_called = 0;
-	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks);
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
 	succeed_if (callback_called == 0, "registered value was updated but value has not changed");
 
 	ksDel (ks);
 	PLUGIN_CLOSE ();
 }
 
-static void test_doUpdate_callback (KDB * kdb ELEKTRA_UNUSED, Key * changedKey ELEKTRA_UNUSED)
+static void test_callbackSameOrBelowWithChangeDetection (void)
+{
+	printf ("test callback for key or below is not called when no key has changed\n");
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("internalnotification");
+
+	Key * registeredKey = keyNew ("user/test/internalnotification", KEY_END);
+	Key * valueKey = keyNew ("user/test/internalnotification/value", KEY_VALUE, "foo", KEY_END);
+	KeySet * ks = ksNew (2, keyNew ("user/test/internalnotification/other", KEY_VALUE, "bar", KEY_END), valueKey, KS_END);
+
+	succeed_if (internalnotificationRegisterCallbackSameOrBelow (plugin, registeredKey, test_callback, CALLBACK_CONTEXT_MAGIC_NUMBER) ==
+			    1,
+		    "call to elektraInternalnotificationRegisterCallbackSameOrBelow was not successful");
+
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
+	succeed_if (callback_called, "callback was not called for new keys");
+
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
+	succeed_if (callback_called == 0, "callback was called but no key has changed");
+
+	// a reload of a part of the hierarchy is no change
+	KeySet * part = ksNew (1, keyDup (valueKey), KS_END);
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, part, valueKey);
+	succeed_if (callback_called == 0, "callback was called for a subset of unchanged keys");
+	ksDel (part);
+
+	keySetString (valueKey, "changed");
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, NULL);
+	succeed_if (callback_called, "callback was not called for changed key");
+
+	// removed keys are changes, if their part of the hierarchy was reloaded
+	keyDel (ksLookupByName (ks, "user/test/internalnotification/other", KDB_O_POP));
+	Key * valueParentKey = keyNew ("user/test/internalnotification/value", KEY_END);
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, valueParentKey);
+	succeed_if (callback_called == 0, "callback was called for a key outside of the reloaded part");
+	keyDel (valueParentKey);
+
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, registeredKey);
+	succeed_if (callback_called, "callback was not called for removed key");
+
+	callback_called = 0;
+	elektraInternalnotificationUpdateRegisteredKeys (plugin, ks, registeredKey);
+	succeed_if (callback_called == 0, "callback was called again for removed key");
+
+	ksDel (ks);
+	keyDel (registeredKey);
+	PLUGIN_CLOSE ();
+}
+
+static void test_doUpdate_callback (ElektraNotificationCallbackContext * context ELEKTRA_UNUSED, Key * changedKey ELEKTRA_UNUSED)
 {
 	doUpdate_callback_called = 1;
 }
@@ -737,6 +793,7 @@ int main (int argc, char ** argv)
 	printf ("\nregisterCallback\n----------------\n");
 	test_callbackCalledWithKey ();
 	test_callbackCalledWithChangeDetection ();
+	test_callbackSameOrBelowWithChangeDetection ();
 
 	RUN_TYPE_TESTS (UnsignedInt)
 	RUN_TYPE_TESTS (Long)
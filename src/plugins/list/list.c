@@ -89,18 +89,17 @@ static char lastIndex[ELEKTRA_MAX_ARRAY_SIZE];
 
 static int listParseConfiguration (Placements * placements, KeySet * config)
 {
-	Key * cur;
 	Key * key = ksLookupByName (config, "/plugins", 0);
-	KeySet * cutKS = ksCut (config, key);
-	ksRewind (cutKS);
-	if (ksGetSize (cutKS) < 2)
+	size_t end;
+	ssize_t start = ksFindHierarchy (config, key, &end);
+	if (start < 0 || end - start < 2)
 	{
-		ksDel (cutKS);
 		return 0;
 	}
 	int rc = 0;
-	while ((cur = ksNext (cutKS)) != NULL)
+	for (size_t it = start; it < end; ++it)
 	{
+		Key * cur = ksAtCursor (config, it);
 		if (keyRel (key, cur) != 1)
 		{
 			continue;
@@ -116,7 +115,7 @@ static int listParseConfiguration (Placements * placements, KeySet * config)
 		Key * lookup = keyDup (cur);
 		keyAddBaseName (lookup, "placements");
 		keyAddBaseName (lookup, "set");
-		sub = ksLookup (cutKS, lookup, 0);
+		sub = ksLookup (config, lookup, 0);
 		if (sub)
 		{
 			const char * setString = keyString (sub);
@@ -132,7 +131,7 @@ static int listParseConfiguration (Placements * placements, KeySet * config)
 			}
 		}
 		keySetBaseName (lookup, "get");
-		sub = ksLookup (cutKS, lookup, 0);
+		sub = ksLookup (config, lookup, 0);
 		if (sub)
 		{
 			const char * getString = keyString (sub);
@@ -148,7 +147,7 @@ static int listParseConfiguration (Placements * placements, KeySet * config)
 			}
 		}
 		keySetBaseName (lookup, "error");
-		sub = ksLookup (cutKS, lookup, 0);
+		sub = ksLookup (config, lookup, 0);
 		if (sub)
 		{
 			const char * errString = keyString (sub);
@@ -165,7 +164,6 @@ static int listParseConfiguration (Placements * placements, KeySet * config)
 		}
 		keyDel (lookup);
 	}
-	ksDel (cutKS);
 	return rc;
 }
 
@@ -23,6 +23,7 @@
 #include <string.h>
 
 #define MIN_VALID_STACK 3
+#define MAX_CACHED_EXPRESSIONS 1024
 #define EPSILON 0.00001
 
 typedef enum
@@ -59,6 +60,7 @@ int elektraMathcheckGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKT
 		KeySet * contract = ksNew (
 			30, keyNew ("system/elektra/modules/mathcheck", KEY_VALUE, "mathcheck plugin waits for your orders", KEY_END),
 			keyNew ("system/elektra/modules/mathcheck/exports", KEY_END),
+			keyNew ("system/elektra/modules/mathcheck/exports/close", KEY_FUNC, elektraMathcheckClose, KEY_END),
 			keyNew ("system/elektra/modules/mathcheck/exports/get", KEY_FUNC, elektraMathcheckGet, KEY_END),
 			keyNew ("system/elektra/modules/mathcheck/exports/set", KEY_FUNC, elektraMathcheckSet, KEY_END),
 #include ELEKTRA_README
@@ -195,33 +197,108 @@ static PNElem doPrefixCalculation (PNElem * stack, PNElem * stackPtr)
 	result.value = stackPtr->value;
 	return result;
 }
-static PNElem parsePrefixString (const char * prefixString, Key * curKey, KeySet * ks, Key * parentKey)
+typedef enum
+{
+	NO_REFERENCE = 0,
+	ABSOLUTE_REFERENCE = 1,
+	PARENT_REFERENCE = 2,
+	RELATIVE_REFERENCE = 3
+} ReferenceKind;
+
+/**
+ * A reference to another key. Absolute references are resolved to a
+ * lookup key when the expression is compiled, the keys of absolute and
+ * parent references are looked up once per kdbSet.
+ */
+typedef struct
+{
+	ReferenceKind kind;
+	char * name;  /*!< name below the parent key or the current key */
+	Key * lookup; /*!< name to look up, NULL if the reference is not a valid name */
+	Key * found;  /*!< key of absolute and parent references in the current kdbSet */
+} Reference;
+
+/**
+ * A prefix expression split into its tokens.
+ */
+typedef struct
+{
+	PNElem * stack;		 /*!< stack with values, operations and placeholders for references */
+	Reference * references;	 /*!< reference for every stack element */
+	size_t size;		 /*!< number of elements in stack (without END) */
+	unsigned long generation; /*!< kdbSet in which the references were looked up */
+	Operation resultOp;
+} CompiledExpression;
+
+typedef struct
 {
-	const char * regexString =
-		"(((((\\.)|(\\.\\.\\/)*|(@)|(\\/))([[:alnum:]]*/)*[[:alnum:]]+))|('[0-9]*[.,]{0,1}[0-9]*')|(==)|([-+:/<>=!{*]))";
-	char * ptr = (char *) prefixString;
 	regex_t regex;
-	Key * key;
+	KeySet * cache;		  /*!< compiled expressions, the names are the expression strings, cleared when full */
+	unsigned long generation; /*!< incremented for every kdbSet */
+} MathcheckData;
 
-	PNElem * stack = elektraMalloc (MIN_VALID_STACK * sizeof (PNElem));
+static void freeCompiledExpression (CompiledExpression * compiled)
+{
+	for (size_t i = 0; i < compiled->size; ++i)
+	{
+		if (compiled->references[i].name) elektraFree (compiled->references[i].name);
+		if (compiled->references[i].lookup) keyDel (compiled->references[i].lookup);
+	}
+	elektraFree (compiled->references);
+	elektraFree (compiled->stack);
+	elektraFree (compiled);
+}
 
-	PNElem * stackPtr = stack;
-	PNElem result;
-	Operation resultOp = ERROR;
-	result.op = ERROR;
-	int ret;
-	if ((ret = regcomp (&regex, regexString, REG_EXTENDED | REG_NEWLINE)))
+static void compileReference (Reference * reference, char * subString)
+{
+	if (subString[0] == '@')
+	{
+		reference->kind = PARENT_REFERENCE;
+		reference->name = elektraStrDup (subString + 2);
+		reference->lookup = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+		elektraFree (subString);
+	}
+	else if (subString[0] == '.')
 	{
-		ksDel (ks);
-		return result;
+		reference->kind = RELATIVE_REFERENCE;
+		reference->name = subString;
+		reference->lookup = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
 	}
+	else
+	{
+		reference->kind = ABSOLUTE_REFERENCE;
+		reference->lookup = keyNew (subString, KEY_CASCADING_NAME, KEY_END);
+		elektraFree (subString);
+	}
+}
+
+static CompiledExpression * compilePrefixString (const char * prefixString, const regex_t * regex, Key * parentKey)
+{
+	char * ptr = (char *) prefixString;
+	CompiledExpression * compiled = elektraCalloc (sizeof (CompiledExpression));
+	size_t alloc = MIN_VALID_STACK;
+	compiled->stack = elektraMalloc (alloc * sizeof (PNElem));
+	compiled->references = elektraMalloc (alloc * sizeof (Reference));
+	compiled->resultOp = ERROR;
 	regmatch_t match;
-	char * searchKey = NULL;
 	while (1)
 	{
+		if (compiled->size + 1 >= alloc)
+		{
+			alloc *= 2;
+			if (elektraRealloc ((void **) &compiled->stack, alloc * sizeof (PNElem)) < 0 ||
+			    elektraRealloc ((void **) &compiled->references, alloc * sizeof (Reference)) < 0)
+			{
+				ELEKTRA_SET_ERROR (87, parentKey, "Out of memory");
+				freeCompiledExpression (compiled);
+				return NULL;
+			}
+		}
+		PNElem * stackPtr = compiled->stack + compiled->size;
 		stackPtr->op = ERROR;
 		stackPtr->value = 0;
-		int nomatch = regexec (&regex, ptr, 1, &match, 0);
+		memset (compiled->references + compiled->size, 0, sizeof (Reference));
+		int nomatch = regexec (regex, ptr, 1, &match, 0);
 		if (nomatch)
 		{
 			break;
@@ -230,7 +307,7 @@ static PNElem parsePrefixString (const char * prefixString, Key * curKey, KeySet
 		int start = match.rm_so + (ptr - prefixString);
 		if (!strncmp (prefixString + start, "==", 2))
 		{
-			resultOp = EQU;
+			compiled->resultOp = EQU;
 		}
 		else if (len == 1 && !isalpha (prefixString[start]) && prefixString[start] != '\'' && prefixString[start] != '.' &&
 			 prefixString[start] != '@')
@@ -252,54 +329,35 @@ static PNElem parsePrefixString (const char * prefixString, Key * curKey, KeySet
 				stackPtr->op = MUL;
 				break;
 			case ':':
-				resultOp = SET;
+				compiled->resultOp = SET;
 				break;
 			case '=':
-				if (resultOp == LT)
+				if (compiled->resultOp == LT)
 				{
-					resultOp = LE;
+					compiled->resultOp = LE;
 				}
-				else if (resultOp == GT)
+				else if (compiled->resultOp == GT)
 				{
-					resultOp = GE;
+					compiled->resultOp = GE;
 				}
-				else if (resultOp == ERROR)
+				else if (compiled->resultOp == ERROR)
 				{
-					resultOp = EQU;
-				}
-				else if (resultOp == EQU)
-				{
-					resultOp = EQU;
-				}
-				else if (resultOp == NOT)
-				{
-					resultOp = NOT;
-				}
-				else if (resultOp == SET)
-				{
-					resultOp = SET;
+					compiled->resultOp = EQU;
 				}
 				break;
 			case '<':
-				resultOp = LT;
+				compiled->resultOp = LT;
 				break;
 			case '>':
-				resultOp = GT;
+				compiled->resultOp = GT;
 				break;
 			case '!':
-				resultOp = NOT;
+				compiled->resultOp = NOT;
 				break;
 			default:
 				ELEKTRA_SET_ERRORF (122, parentKey, "%c isn't a valid operation", prefixString[start]);
-				regfree (&regex);
-				if (searchKey)
-				{
-					elektraFree (searchKey);
-				}
-				elektraFree (stack);
-				ksDel (ks);
-				return result;
-				break;
+				freeCompiledExpression (compiled);
+				return NULL;
 			}
 		}
 		else
@@ -312,59 +370,75 @@ static PNElem parsePrefixString (const char * prefixString, Key * curKey, KeySet
 				subString[len - 1] = '\0';
 				char * subPtr = (subString + 1);
 				stackPtr->value = elektraEFtoF (subPtr);
+				stackPtr->op = VAL;
 				elektraFree (subString);
 			}
 			else
 			{
-				ksRewind (ks);
-				if (subString[0] == '@')
-				{
-					searchKey = realloc (searchKey, len + 2 + strlen (keyName (parentKey)));
-					strcpy (searchKey, keyName (parentKey));
-					strcat (searchKey, "/");
-					strcat (searchKey, subString + 2);
-				}
-				else if (subString[0] == '.')
-				{
-					searchKey = realloc (searchKey, len + 2 + strlen (keyName (curKey)));
-					strcpy (searchKey, keyName (curKey));
-					strcat (searchKey, "/");
-					strcat (searchKey, subString);
-				}
-				else
-				{
-					searchKey = realloc (searchKey, len + 1);
-					strcpy (searchKey, subString);
-				}
-				key = ksLookupByName (ks, searchKey, 0);
-				if (!key)
-				{
-					stackPtr->value = 0;
-					stackPtr->op = NA;
-				}
-				else
-				{
-					stackPtr->value = elektraEFtoF (keyString (key));
-				}
-				elektraFree (subString);
+				// looked up by evaluatePrefixString
+				compileReference (compiled->references + compiled->size, subString);
+				stackPtr->op = VAL;
 			}
-			if (stackPtr->op != NA) stackPtr->op = VAL;
 		}
-		++stackPtr;
-		int offset = stackPtr - stack;
-		stack = realloc (stack, (offset + 1) * sizeof (PNElem));
-		stackPtr = stack;
-		stackPtr += offset;
+		++compiled->size;
 		ptr += match.rm_eo;
 	}
-	regfree (&regex);
-	elektraFree (searchKey);
-	ksDel (ks);
-	stackPtr->op = END;
-	result = doPrefixCalculation (stack, stackPtr);
+	return compiled;
+}
+
+static Key * lookupReference (Reference * reference, int lookupAgain, Key * curKey, KeySet * ks, Key * parentKey)
+{
+	switch (reference->kind)
+	{
+	case RELATIVE_REFERENCE:
+		keySetName (reference->lookup, keyName (curKey));
+		keyAddName (reference->lookup, reference->name);
+		return ksLookup (ks, reference->lookup, KDB_O_NONE);
+	case PARENT_REFERENCE:
+		if (lookupAgain)
+		{
+			keySetName (reference->lookup, keyName (parentKey));
+			keyAddName (reference->lookup, reference->name);
+			reference->found = ksLookup (ks, reference->lookup, KDB_O_NONE);
+		}
+		return reference->found;
+	default:
+		if (lookupAgain)
+		{
+			reference->found = reference->lookup ? ksLookup (ks, reference->lookup, KDB_O_NONE) : NULL;
+		}
+		return reference->found;
+	}
+}
+
+static PNElem evaluatePrefixString (CompiledExpression * compiled, unsigned long generation, const char * prefixString, Key * curKey,
+				    KeySet * ks, Key * parentKey)
+{
+	PNElem * stack = elektraMalloc ((compiled->size + 1) * sizeof (PNElem));
+	memcpy (stack, compiled->stack, compiled->size * sizeof (PNElem));
+	int lookupAgain = compiled->generation != generation;
+	compiled->generation = generation;
+	for (size_t i = 0; i < compiled->size; ++i)
+	{
+		if (compiled->references[i].kind == NO_REFERENCE) continue;
+
+		Key * key = lookupReference (compiled->references + i, lookupAgain, curKey, ks, parentKey);
+		if (!key)
+		{
+			stack[i].value = 0;
+			stack[i].op = NA;
+		}
+		else
+		{
+			stack[i].value = elektraEFtoF (keyString (key));
+		}
+	}
+	stack[compiled->size].op = END;
+
+	PNElem result = doPrefixCalculation (stack, stack + compiled->size);
 	if (result.op != ERROR)
 	{
-		result.op = resultOp;
+		result.op = compiled->resultOp;
 	}
 	else
 	{
@@ -374,8 +448,92 @@ static PNElem parsePrefixString (const char * prefixString, Key * curKey, KeySet
 	return result;
 }
 
-int elektraMathcheckSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+static void clearCache (KeySet * cache)
+{
+	Key * cur;
+	ksRewind (cache);
+	while ((cur = ksNext (cache)) != NULL)
+	{
+		freeCompiledExpression (*(CompiledExpression **) keyValue (cur));
+	}
+	ksClear (cache);
+}
+
+static PNElem parsePrefixString (MathcheckData * data, const char * prefixString, Key * curKey, KeySet * ks, Key * parentKey)
+{
+	PNElem result;
+	result.op = ERROR;
+
+	Key * lookup = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+	keyAddBaseName (lookup, prefixString);
+	Key * cached = ksLookup (data->cache, lookup, KDB_O_NONE);
+	CompiledExpression * compiled;
+	if (cached)
+	{
+		compiled = *(CompiledExpression **) keyValue (cached);
+		keyDel (lookup);
+	}
+	else
+	{
+		if (ksGetSize (data->cache) >= MAX_CACHED_EXPRESSIONS) clearCache (data->cache);
+		compiled = compilePrefixString (prefixString, &data->regex, parentKey);
+		if (!compiled)
+		{
+			keyDel (lookup);
+			return result;
+		}
+		keySetBinary (lookup, &compiled, sizeof (compiled));
+		ksAppendKey (data->cache, lookup);
+	}
+
+	// lookups move the cursor of the KeySet we are iterating
+	cursor_t cursor = ksGetCursor (ks);
+	result = evaluatePrefixString (compiled, data->generation, prefixString, curKey, ks, parentKey);
+	ksSetCursor (ks, cursor);
+	return result;
+}
+
+static MathcheckData * getMathcheckData (Plugin * handle)
 {
+	MathcheckData * data = elektraPluginGetData (handle);
+	if (data) return data;
+
+	const char * regexString =
+		"(((((\\.)|(\\.\\.\\/)*|(@)|(\\/))([[:alnum:]]*/)*[[:alnum:]]+))|('[0-9]*[.,]{0,1}[0-9]*')|(==)|([-+:/<>=!{*]))";
+	data = elektraCalloc (sizeof (MathcheckData));
+	if (regcomp (&data->regex, regexString, REG_EXTENDED | REG_NEWLINE))
+	{
+		elektraFree (data);
+		return NULL;
+	}
+	data->cache = ksNew (0, KS_END);
+	elektraPluginSetData (handle, data);
+	return data;
+}
+
+int elektraMathcheckClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	MathcheckData * data = elektraPluginGetData (handle);
+	if (!data) return 1; /* success */
+
+	clearCache (data->cache);
+	ksDel (data->cache);
+	regfree (&data->regex);
+	elektraFree (data);
+	elektraPluginSetData (handle, NULL);
+	return 1; /* success */
+}
+
+int elektraMathcheckSet (Plugin * handle, KeySet * returned, Key * parentKey)
+{
+	MathcheckData * data = getMathcheckData (handle);
+	if (!data)
+	{
+		ELEKTRA_SET_ERROR (120, parentKey, "could not compile the regular expression for prefix expressions");
+		return -1;
+	}
+	// the keys of references are looked up again in every kdbSet
+	++data->generation;
 	Key * cur;
 	PNElem result;
 	while ((cur = ksNext (returned)) != NULL)
@@ -383,7 +541,7 @@ int elektraMathcheckSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		const Key * meta = keyGetMeta (cur, "check/math");
 		if (!meta) continue;
 		ELEKTRA_LOG_DEBUG ("Check key “%s” with value “%s”", keyName (cur), keyString (meta));
-		result = parsePrefixString (keyString (meta), cur, ksDup (returned), parentKey);
+		result = parsePrefixString (data, keyString (meta), cur, returned, parentKey);
 		ELEKTRA_LOG_DEBUG ("Result: “%f”", result.value);
 		char val1[MAX_CHARS_DOUBLE + 1]; // Include storage for trailing `\0` character
 		char val2[MAX_CHARS_DOUBLE];
@@ -456,6 +614,7 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 	return elektraPluginExport("mathcheck",
 			ELEKTRA_PLUGIN_GET,	&elektraMathcheckGet,
 			ELEKTRA_PLUGIN_SET,	&elektraMathcheckSet,
+			ELEKTRA_PLUGIN_CLOSE,	&elektraMathcheckClose,
 			ELEKTRA_PLUGIN_END);
 }
 
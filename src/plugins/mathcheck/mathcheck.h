@@ -13,6 +13,7 @@
 #include <kdbplugin.h>
 
 
+int elektraMathcheckClose (Plugin * handle, Key * errorKey);
 int elektraMathcheckGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraMathcheckSet (Plugin * handle, KeySet * ks, Key * parentKey);
 
@@ -66,6 +66,88 @@ static void test_multiUp (void)
 	ksDel (ks);
 }
 
+static void test_sameExpression (void)
+{
+	Key * parentKey = keyNew ("user/tests/mathcheck", KEY_VALUE, "", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	KeySet * ks = ksNew (5,
+			     keyNew ("user/tests/mathcheck/a/sum", KEY_VALUE, "0", KEY_META, "check/math", ":= + ../val1 '5'", KEY_END),
+			     keyNew ("user/tests/mathcheck/a/val1", KEY_VALUE, "1", KEY_END),
+			     keyNew ("user/tests/mathcheck/b/sum", KEY_VALUE, "0", KEY_META, "check/math", ":= + ../val1 '5'", KEY_END),
+			     keyNew ("user/tests/mathcheck/b/val1", KEY_VALUE, "10", KEY_END), KS_END);
+
+	PLUGIN_OPEN ("mathcheck");
+	ksRewind (ks);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/a/sum", 0)), "6"), "error");
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/b/sum", 0)), "15"), "error");
+
+	keySetString (ksLookupByName (ks, "user/tests/mathcheck/b/val1", 0), "20");
+	ksRewind (ks);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/b/sum", 0)), "25"), "cached expression not reevaluated");
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+	ksDel (ks);
+}
+
+static void test_referencesPerSet (void)
+{
+	Key * parentKey = keyNew ("user/tests/mathcheck", KEY_VALUE, "", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	KeySet * ks = create_ks ("", ":= + @/bla/val1 /tests/mathcheck/bla/val2");
+
+	PLUGIN_OPEN ("mathcheck");
+	ksRewind (ks);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/sum", 0)), "150"), "error");
+
+	// the references are looked up again in the next kdbSet
+	keySetString (ksLookupByName (ks, "user/tests/mathcheck/bla/val2", 0), "20");
+	keyDel (ksLookupByName (ks, "user/tests/mathcheck/bla/val1", KDB_O_POP));
+	ksRewind (ks);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/sum", 0)), "20"), "removed reference still used");
+
+	ksAppendKey (ks, keyNew ("user/tests/mathcheck/bla/val1", KEY_VALUE, "1", KEY_END));
+	ksRewind (ks);
+	plugin->kdbSet (plugin, ks, parentKey);
+	succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/sum", 0)), "21"), "added reference not used");
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+	ksDel (ks);
+}
+
+static void test_manyExpressions (void)
+{
+	Key * parentKey = keyNew ("user/tests/mathcheck", KEY_VALUE, "", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	char expression[64];
+	// more distinct expressions than the plugin caches
+	for (int i = 0; i < 1500; ++i)
+	{
+		snprintf (name, sizeof (name), "user/tests/mathcheck/%d/sum", i);
+		snprintf (expression, sizeof (expression), ":= + ../val '%d'", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "0", KEY_META, "check/math", expression, KEY_END));
+		snprintf (name, sizeof (name), "user/tests/mathcheck/%d/val", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "1", KEY_END));
+	}
+
+	PLUGIN_OPEN ("mathcheck");
+	for (int run = 0; run < 2; ++run)
+	{
+		ksRewind (ks);
+		succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet failed");
+		succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/0/sum", 0)), "1"), "error");
+		succeed_if (!strcmp (keyString (ksLookupByName (ks, "user/tests/mathcheck/1499/sum", 0)), "1500"), "error");
+	}
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("MATHCHECK	   TESTS\n");
@@ -146,6 +228,9 @@ int main (int argc, char ** argv)
 	ksDel (ks);
 
 	test_multiUp ();
+	test_sameExpression ();
+	test_referencesPerSet ();
+	test_manyExpressions ();
 
 	print_result ("testmod_mathcheck");
 
@@ -34,8 +34,8 @@
 /** Magic number used in mmap format */
 #define ELEKTRA_MAGIC_MMAP_NUMBER (0x0A6172746B656C45)
 
-/** Mmap format version */
-#define ELEKTRA_MMAP_FORMAT_VERSION (1)
+/** Mmap format version, must be increased whenever struct _Key or struct _KeySet change */
+#define ELEKTRA_MMAP_FORMAT_VERSION (3)
 
 /** Mmap temp file template */
 #define ELEKTRA_MMAP_TMP_NAME "/tmp/elektraMmapTmpXXXXXX"
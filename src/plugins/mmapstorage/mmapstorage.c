@@ -689,7 +689,8 @@ static KeySet * writeMetaKeySet (Key * key, MmapAddr * mmapAddr, DynArray * dynA
 	KeySet * newMeta = (KeySet *) mmapAddr->metaKsPtr;
 	mmapAddr->metaKsPtr += SIZEOF_KEYSET;
 
-	newMeta->flags = key->meta->flags | KS_FLAG_MMAP_STRUCT | KS_FLAG_MMAP_ARRAY;
+	// the reference counter of shared metadata is not written, every key gets its own meta KeySet
+	newMeta->flags = (key->meta->flags & ~KS_FLAG_SHARED_META) | KS_FLAG_MMAP_STRUCT | KS_FLAG_MMAP_ARRAY;
 	newMeta->array = (Key **) mmapAddr->metaKsArrayPtr;
 	mmapAddr->metaKsArrayPtr += SIZEOF_KEY_PTR * key->meta->alloc;
 
@@ -747,6 +748,7 @@ static void writeKeys (KeySet * keySet, MmapAddr * mmapAddr, DynArray * dynArray
 		Key * mmapKey = (Key *) mmapAddr->keyPtr; // new key location
 		mmapAddr->keyPtr += SIZEOF_KEY;
 		*mmapKey = *cur;
+		clear_bit (mmapKey->flags, KEY_FLAG_ARENA_STRUCT);
 
 		// move Key name
 		if (cur->key)
@@ -917,6 +919,83 @@ static void mmapToKeySet (Plugin * handle, char * mappedRegion, KeySet * returne
 	}
 }
 
+/**
+ * @brief Returns a copy of the struct of a mapped key, with pointers into the mapped region.
+ *
+ * In contrast to updatePointers(), the mapped region itself is not modified.
+ *
+ * @param mappedKey pointer to the key, which was not updated yet
+ * @param base the address of the mapped region
+ *
+ * @return the key struct with updated pointers
+ */
+static Key relocateKey (Key * mappedKey, uintptr_t base)
+{
+	Key key = *(Key *) ((char *) mappedKey + base);
+	if (key.data.c) key.data.c = key.data.c + base;
+	if (key.key) key.key = key.key + base;
+	if (key.meta) key.meta = (KeySet *) ((char *) key.meta + base);
+	return key;
+}
+
+/**
+ * @brief Copies the keys same or below subtreeKey from a mapped keyset to the returned keyset.
+ *
+ * The pointers of the mapped region are not updated, the first key of the subtree is found
+ * with a binary search. So only the keys of the subtree are touched.
+ *
+ * @param mappedRegion pointer to mapped region, holding an already written keyset
+ * @param returned keyset to be replaced by the keys of the subtree
+ * @param subtreeKey the root of the subtree
+ */
+static void mmapSubtreeToKeySet (char * mappedRegion, KeySet * returned, Key * subtreeKey)
+{
+	const uintptr_t base = (uintptr_t) mappedRegion;
+	KeySet * keySet = (KeySet *) (mappedRegion + OFFSET_KEYSET);
+	ksClear (returned);
+	if (!keySet->array) return;
+
+	Key ** array = (Key **) ((char *) keySet->array + base);
+	size_t left = 0;
+	size_t right = keySet->size;
+	while (left < right)
+	{
+		size_t middle = left + (right - left) / 2;
+		Key key = relocateKey (array[middle], base);
+		// the keyset is sorted by name, the meta keys (including the owner) are not updated
+		key.meta = 0;
+		if (keyCmp (&key, subtreeKey) < 0)
+		{
+			left = middle + 1;
+		}
+		else
+		{
+			right = middle;
+		}
+	}
+
+	for (size_t i = left; i < keySet->size; ++i)
+	{
+		Key key = relocateKey (array[i], base);
+		KeySet * meta = key.meta;
+		key.meta = 0;
+		if (!keyIsBelowOrSame (subtreeKey, &key)) break;
+
+		Key * copy = keyDup (&key);
+		if (meta && meta->array)
+		{
+			Key ** metaArray = (Key **) ((char *) meta->array + base);
+			for (size_t j = 0; j < meta->size; ++j)
+			{
+				Key metaKey = relocateKey (metaArray[j], base);
+				keySetMeta (copy, keyName (&metaKey), keyString (&metaKey));
+			}
+		}
+		keyClearSync (copy);
+		ksAppendKey (returned, copy);
+	}
+}
+
 /**
  * @brief Updates pointers of a mapped keyset to a new location in memory.
  *
@@ -1008,21 +1087,18 @@ int ELEKTRA_PLUGIN_FUNCTION (close) (Plugin * handle ELEKTRA_UNUSED, Key * error
 }
 
 /**
- * @brief The mmapstorage get function loads a keyset from a file and returns it.
- *
- * On successful mapping the returned keyset is replaced by the mapped keyset.
- * The returned keyset array then points to a mapped region.
+ * @brief Maps a file and returns the keyset, or only the keys of a subtree.
  *
  * @param handle The plugin handle.
- * @param ks The keyset which is replaced by the mapped keyset.
+ * @param ks The keyset which is replaced by the mapped keyset or the keys of the subtree.
  * @param parentKey Holding the filename or error message.
+ * @param subtreeKey The root of the subtree to return, 0 for the whole keyset.
  *
  * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if the file was mapped successfully.
  * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the file could not be mapped successfully.
  */
-int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks, Key * parentKey)
+static int mmapGet (Plugin * handle, KeySet * ks, Key * parentKey, Key * subtreeKey)
 {
-	// get all keys
 	int errnosave = errno;
 	PluginMode mode = MODE_STORAGE;
 
@@ -1032,18 +1108,6 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 		mode = MODE_GLOBALCACHE;
 	}
 
-	Key * root = keyNew ("system/elektra/modules/" ELEKTRA_PLUGIN_NAME, KEY_END);
-	if (keyRel (root, parentKey) >= 0)
-	{
-		keyDel (root);
-		KeySet * contract =
-#include "contract.h"
-			ksAppend (ks, contract);
-		ksDel (contract);
-		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-	}
-	keyDel (root);
-
 	int fd = -1;
 	char * mappedRegion = MAP_FAILED;
 	Key * initialParent = keyDup (parentKey);
@@ -1056,6 +1120,14 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 	}
 	else if ((fd = openFile (parentKey, O_RDONLY, 0, mode)) == -1)
 	{
+		if (subtreeKey && errno == ENOENT)
+		{
+			// the file was removed since the resolver checked it, so the subtree has no keys
+			ksClear (ks);
+			keyDel (initialParent);
+			errno = errnosave;
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
 		goto error;
 	}
 
@@ -1145,8 +1217,22 @@ int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks,
 		goto error;
 	}
 
-	updatePointers (mmapMetaData, mappedRegion);
-	mmapToKeySet (handle, mappedRegion, ks, mode);
+	if (subtreeKey)
+	{
+		// only called for storage of backends, the global cache always reads all keys
+		// the keys are copied, so the region is not needed anymore
+		mmapSubtreeToKeySet (mappedRegion, ks, subtreeKey);
+		if (munmap (mappedRegion, sbuf.st_size) != 0)
+		{
+			ELEKTRA_MMAP_LOG_WARNING ("could not munmap");
+		}
+		mappedRegion = MAP_FAILED;
+	}
+	else
+	{
+		updatePointers (mmapMetaData, mappedRegion);
+		mmapToKeySet (handle, mappedRegion, ks, mode);
+	}
 
 	if (close (fd) != 0)
 	{
@@ -1180,6 +1266,60 @@ error:
 	return ELEKTRA_PLUGIN_STATUS_ERROR;
 }
 
+/**
+ * @brief The mmapstorage get function loads a keyset from a file and returns it.
+ *
+ * On successful mapping the returned keyset is replaced by the mapped keyset.
+ * The returned keyset array then points to a mapped region.
+ *
+ * @param handle The plugin handle.
+ * @param ks The keyset which is replaced by the mapped keyset.
+ * @param parentKey Holding the filename or error message.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if the file was mapped successfully.
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the file could not be mapped successfully.
+ */
+int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks, Key * parentKey)
+{
+	Key * root = keyNew ("system/elektra/modules/" ELEKTRA_PLUGIN_NAME, KEY_END);
+	if (keyRel (root, parentKey) >= 0)
+	{
+		keyDel (root);
+		KeySet * contract =
+#include "contract.h"
+			ksAppend (ks, contract);
+		ksDel (contract);
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+	keyDel (root);
+
+	// get all keys
+	return mmapGet (handle, ks, parentKey, 0);
+}
+
+/**
+ * @brief The mmapstorage get function for subtrees returns the keys same or below subtreeKey.
+ *
+ * The file is mapped, but in contrast to the get function only the keys of the
+ * subtree are copied to the returned keyset. So the cost is proportional to the size
+ * of the subtree and not to the size of the file.
+ *
+ * @param handle The plugin handle.
+ * @param ks The keyset which is replaced by the keys of the subtree.
+ * @param parentKey Holding the filename or error message.
+ * @param subtreeKey The root of the subtree.
+ *
+ * A missing file contains no keys: the core also reads subtrees of files the
+ * resolver found during an earlier kdbGet(), which may have been removed since.
+ *
+ * @retval ELEKTRA_PLUGIN_STATUS_SUCCESS if the file was mapped successfully.
+ * @retval ELEKTRA_PLUGIN_STATUS_ERROR if the file could not be mapped successfully.
+ */
+int ELEKTRA_PLUGIN_FUNCTION (getSubtree) (Plugin * handle ELEKTRA_UNUSED, KeySet * ks, Key * parentKey, Key * subtreeKey)
+{
+	return mmapGet (handle, ks, parentKey, subtreeKey);
+}
+
 /**
  * @brief The mmapstorage set function writes a keyset to a new file.
  *
@@ -1337,5 +1477,6 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 		ELEKTRA_PLUGIN_CLOSE,	&ELEKTRA_PLUGIN_FUNCTION(close),
 		ELEKTRA_PLUGIN_GET,	&ELEKTRA_PLUGIN_FUNCTION(get),
 		ELEKTRA_PLUGIN_SET,	&ELEKTRA_PLUGIN_FUNCTION(set),
+		ELEKTRA_PLUGIN_GET_SUBTREE,	&ELEKTRA_PLUGIN_FUNCTION(getSubtree),
 		ELEKTRA_PLUGIN_END);
 }
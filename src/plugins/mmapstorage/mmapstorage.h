@@ -16,6 +16,7 @@ int ELEKTRA_PLUGIN_FUNCTION (open) (Plugin * handle, Key * errorKey);
 int ELEKTRA_PLUGIN_FUNCTION (close) (Plugin * handle, Key * errorKey);
 int ELEKTRA_PLUGIN_FUNCTION (get) (Plugin * handle, KeySet * ks, Key * parentKey);
 int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle, KeySet * ks, Key * parentKey);
+int ELEKTRA_PLUGIN_FUNCTION (getSubtree) (Plugin * handle, KeySet * ks, Key * parentKey, Key * subtreeKey);
 
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
@@ -950,6 +950,37 @@ static void test_mmap_unlink (const char * tmpFile)
 	}
 }
 
+typedef int (*getSubtreeFunc) (Plugin * handle, KeySet * returned, Key * parentKey, Key * subtreeKey);
+
+static void test_mmap_subtree_removed_file (const char * tmpFile)
+{
+	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+	Key * subtreeKey = keyNew (TEST_ROOT_KEY "/j", KEY_END);
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("mmapstorage");
+	getSubtreeFunc getSubtree = (getSubtreeFunc) elektraPluginGetFunction (plugin, "getsubtree");
+	exit_if_fail (getSubtree != NULL, "getsubtree not exported");
+
+	KeySet * ks = otherMetaTestKeySet ();
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet was not successful");
+	ksDel (ks);
+	ks = ksNew (0, KS_END);
+	succeed_if (getSubtree (plugin, ks, parentKey, subtreeKey) == 1, "getsubtree was not successful");
+	succeed_if (ksLookupByName (ks, TEST_ROOT_KEY "/j/k/l", 0) != NULL, "key of subtree not found");
+	succeed_if (ksGetSize (ks) == 1, "getsubtree returned keys outside of the subtree");
+
+	// a file removed since the resolver checked it has no keys
+	succeed_if (unlink (tmpFile) == 0, "could not remove file");
+	succeed_if (getSubtree (plugin, ks, parentKey, subtreeKey) == 1, "getsubtree of removed file was not successful");
+	succeed_if (ksGetSize (ks) == 0, "getsubtree of removed file returned keys");
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbGet of removed file was successful");
+
+	keyDel (subtreeKey);
+	keyDel (parentKey);
+	ksDel (ks);
+	PLUGIN_CLOSE ();
+}
+
 static void clearStorage (const char * tmpFile)
 {
 	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
@@ -1070,6 +1101,9 @@ int main (int argc, char ** argv)
 
 	test_mmap_unlink (tmpFile);
 
+	clearStorage (tmpFile);
+	test_mmap_subtree_removed_file (tmpFile);
+
 	printf ("\ntestmod_mmapstorage RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
 
 	return nbError;
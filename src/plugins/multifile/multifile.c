@@ -222,6 +222,44 @@ int elektraMultifileClose (Plugin * handle ELEKTRA_UNUSED, Key * errorKey ELEKTR
 	return 1; // success
 }
 
+static void appendHierarchy (KeySet * result, KeySet * ks, const Key * root)
+{
+	size_t end;
+	ssize_t start = ksFindHierarchy (ks, root, &end);
+	if (start < 0) return;
+	for (size_t it = start; it < end; ++it)
+	{
+		ksAppendKey (result, ksAtCursor (ks, it));
+	}
+}
+
+/**
+ * Like ksCut(), but leaves the keys in @p ks.
+ *
+ * @return a new keyset with the keys of @p ks below or same as @p root,
+ *         for a cascading @p root in all namespaces
+ */
+static KeySet * getHierarchy (KeySet * ks, const Key * root)
+{
+	KeySet * result = ksNew (0, KS_END);
+	if (keyName (root)[0] != '/')
+	{
+		appendHierarchy (result, ks, root);
+		return result;
+	}
+
+	static const char * const namespaces[] = { "/", "spec", "proc", "dir", "user", "system" };
+	Key * nsRoot = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+	for (size_t i = 0; i < sizeof (namespaces) / sizeof (namespaces[0]); ++i)
+	{
+		keySetName (nsRoot, namespaces[i]);
+		keyAddName (nsRoot, keyName (root));
+		appendHierarchy (result, ks, nsRoot);
+	}
+	keyDel (nsRoot);
+	return result;
+}
+
 static MultiConfig * initialize (Plugin * handle, Key * parentKey)
 {
 
@@ -267,10 +305,9 @@ static MultiConfig * initialize (Plugin * handle, Key * parentKey)
 	if (stayAliveKey) mc->stayAlive = 1;
 	if (recursiveKey) mc->recursive = 1;
 	Key * cutKey = keyNew ("/child", KEY_END);
-	KeySet * childConfig = ksCut (config, cutKey);
+	KeySet * childConfig = getHierarchy (config, cutKey);
 	keyDel (cutKey);
 	mc->childConfig = elektraRenameKeys (childConfig, "system");
-	ksAppend (config, childConfig);
 	ksDel (childConfig);
 	mc->childBackends = ksNew (0, KS_END);
 	mc->modules = ksNew (0, KS_END);
@@ -822,7 +859,7 @@ static void flagUpdateBackends (MultiConfig * mc, KeySet * returned)
 	{
 		SingleConfig * s = *(SingleConfig **) keyValue (k);
 		Key * cutKey = keyNew (s->parentString, KEY_END);
-		KeySet * cutKS = ksCut (returned, cutKey);
+		KeySet * cutKS = getHierarchy (returned, cutKey);
 		if (ksGetSize (cutKS) == 0)
 		{
 			s->rcResolver = EMPTY;
@@ -11,7 +11,9 @@
 
 #include <kdbendian.h>
 #include <kdbhelper.h>
+#include <kdbprivate.h>
 
+#include <errno.h>
 #include <kdberrors.h>
 #include <stdio.h>
 
@@ -19,6 +21,13 @@
 
 #define MAGIC_NUMBER_V1 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 1))
 #define MAGIC_NUMBER_V2 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 2))
+#define MAGIC_NUMBER_V3 ((kdb_unsigned_long_long_t) (MAGIC_NUMBER_BASE + 3))
+
+// number of keys in a block, the first key of each block has a full name and is referenced by the index
+#define BLOCK_SIZE 64
+
+// offset of the index and magic number at the end of the file
+#define TRAILER_SIZE (2 * sizeof (kdb_unsigned_long_long_t))
 
 struct metaLink
 {
@@ -41,6 +50,12 @@ struct stringbuffer
 	char * string;
 };
 
+struct output
+{
+	FILE * file;
+	kdb_unsigned_long_long_t offset; // number of bytes written so far
+};
+
 static ssize_t findMetaLink (struct list * list, const Key * meta);
 static void insertMetaLink (struct list * list, size_t index, const Key * meta, Key * key, size_t parentOffset);
 
@@ -54,36 +69,48 @@ static void ensureBufferSize (struct stringbuffer * buffer, size_t minSize);
 #define STDOUT_FILENAME ("/dev/stdout")
 #endif
 
-static inline bool writeUInt64 (FILE * file, kdb_unsigned_long_long_t value, Key * errorKey)
+static inline bool writeUInt64 (struct output * out, kdb_unsigned_long_long_t value, Key * errorKey)
 {
 	kdb_unsigned_long_long_t littleEndian = htole64 (value);
-	if (fwrite (&littleEndian, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	if (fwrite (&littleEndian, sizeof (kdb_unsigned_long_long_t), 1, out->file) < 1)
 	{
-		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey, feof (file) ? "premature end of file" : "unknown error");
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey, feof (out->file) ? "premature end of file" : "unknown error");
 		return false;
 	}
+	out->offset += sizeof (kdb_unsigned_long_long_t);
 	return true;
 }
 
-static inline bool writeData (FILE * file, const char * data, kdb_unsigned_long_long_t size, Key * errorKey)
+static inline bool writeData (struct output * out, const char * data, kdb_unsigned_long_long_t size, Key * errorKey)
 {
-	if (!writeUInt64 (file, size, errorKey))
+	if (!writeUInt64 (out, size, errorKey))
 	{
-		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey, feof (file) ? "premature end of file" : "unknown error");
 		return false;
 	}
 
 	if (size > 0)
 	{
-		if (fwrite (data, sizeof (char), size, file) < size)
+		if (fwrite (data, sizeof (char), size, out->file) < size)
 		{
-			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey, feof (file) ? "premature end of file" : "unknown error");
+			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey,
+					   feof (out->file) ? "premature end of file" : "unknown error");
 			return false;
 		}
+		out->offset += size;
 	}
 	return true;
 }
 
+static inline bool writeChar (struct output * out, char c, Key * errorKey)
+{
+	if (fputc (c, out->file) == EOF)
+	{
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_WRITE_FAILED, errorKey, "unknown error");
+		return false;
+	}
+	++out->offset;
+	return true;
+}
 
 static inline bool readUInt64 (FILE * file, kdb_unsigned_long_long_t * valuePtr, Key * errorKey)
 {
@@ -137,62 +164,126 @@ static inline bool readStringIntoBuffer (FILE * file, struct stringbuffer * buff
 	return true;
 }
 
-#include "readv1.c"
-
-int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+/**
+ * Reads a prefix compressed name into @p buffer. The first @p shared bytes
+ * of the previous name in @p buffer are kept, the rest is read from @p file.
+ *
+ * @param nameSize size of the previous name (without null terminator), updated to the size of the new name
+ */
+static inline bool readNameIntoBuffer (FILE * file, struct stringbuffer * buffer, size_t * nameSize, Key * errorKey)
 {
-	if (!elektraStrCmp (keyName (parentKey), "system/elektra/modules/quickdump"))
+	kdb_unsigned_long_long_t shared;
+	kdb_unsigned_long_long_t size;
+	if (!readUInt64 (file, &shared, errorKey) || !readUInt64 (file, &size, errorKey))
 	{
-		KeySet * contract = ksNew (
-			30, keyNew ("system/elektra/modules/quickdump", KEY_VALUE, "quickdump plugin waits for your orders", KEY_END),
-			keyNew ("system/elektra/modules/quickdump/exports", KEY_END),
-			keyNew ("system/elektra/modules/quickdump/exports/get", KEY_FUNC, elektraQuickdumpGet, KEY_END),
-			keyNew ("system/elektra/modules/quickdump/exports/set", KEY_FUNC, elektraQuickdumpSet, KEY_END),
-#include ELEKTRA_README
-			keyNew ("system/elektra/modules/quickdump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
-		ksAppend (returned, contract);
-		ksDel (contract);
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, errorKey, feof (file) ? "premature end of file" : "unknown error");
+		return false;
+	}
 
-		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	if (shared > *nameSize)
+	{
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, errorKey, "invalid key name prefix");
+		return false;
 	}
-	// get all keys
 
-	FILE * file = fopen (keyString (parentKey), "rb");
+	size_t newSize = buffer->offset + shared + size + 1;
+	ensureBufferSize (buffer, newSize);
 
-	if (file == NULL)
+	if (fread (&buffer->string[buffer->offset + shared], sizeof (char), size, file) < size)
 	{
-		ELEKTRA_SET_ERROR_GET (parentKey);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, errorKey, feof (file) ? "premature end of file" : "unknown error");
+		return false;
+	}
+	buffer->string[newSize - 1] = '\0';
+	*nameSize = shared + size;
+	return true;
+}
+
+#include "readv1.c"
+#include "readv2.c"
+
+/**
+ * Positions @p file at the start of the block, which contains the first key of @p subtreeKey
+ * (or the key following it), by a binary search over the index at the end of the file.
+ *
+ * @retval 1 if the file was positioned
+ * @retval 0 if @p file cannot be seeked, the position was not changed
+ * @retval -1 on errors
+ */
+static int seekSubtree (FILE * file, Key * parentKey, Key * subtreeKey, struct stringbuffer * nameBuffer)
+{
+	if (fseek (file, -(long) TRAILER_SIZE, SEEK_END) != 0)
+	{
+		return 0;
 	}
 
+	kdb_unsigned_long_long_t indexOffset;
 	kdb_unsigned_long_long_t magic;
-	if (fread (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	if (!readUInt64 (file, &indexOffset, parentKey) || fread (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1 ||
+	    be64toh (magic) != MAGIC_NUMBER_V3 || fseek (file, indexOffset, SEEK_SET) != 0 || fgetc (file) != 'i')
 	{
-		if (feof (file) && ftell (file) == 0)
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "invalid index");
+		return -1;
+	}
+
+	kdb_unsigned_long_long_t blocks;
+	if (!readUInt64 (file, &blocks, parentKey))
+	{
+		return -1;
+	}
+
+	Key * blockKey = keyNew ("/", KEY_END);
+	kdb_unsigned_long_long_t left = 0;
+	kdb_unsigned_long_long_t right = blocks;
+	// the first block follows the magic number
+	kdb_unsigned_long_long_t blockOffset = blocks > 0 ? sizeof (kdb_unsigned_long_long_t) : indexOffset;
+	while (left < right)
+	{
+		kdb_unsigned_long_long_t middle = left + (right - left) / 2;
+		kdb_unsigned_long_long_t offset;
+		size_t nameSize = 0;
+		if (fseek (file, indexOffset + 1 + (middle + 1) * sizeof (kdb_unsigned_long_long_t), SEEK_SET) != 0 ||
+		    !readUInt64 (file, &offset, parentKey) || fseek (file, offset, SEEK_SET) != 0 || fgetc (file) != 'k' ||
+		    !readNameIntoBuffer (file, nameBuffer, &nameSize, parentKey) || keySetName (blockKey, nameBuffer->string) == -1)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "invalid index");
+			keyDel (blockKey);
+			return -1;
+		}
+
+		if (keyCmp (blockKey, subtreeKey) <= 0)
+		{
+			// first key of block is before or at the subtree
+			blockOffset = offset;
+			left = middle + 1;
 		}
 		else
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			right = middle;
 		}
 	}
-	magic = be64toh (magic); // magic number is written big endian so EKDB magic string is readable
+	keyDel (blockKey);
 
-	switch (magic)
+	if (fseek (file, blockOffset, SEEK_SET) != 0)
 	{
-	case MAGIC_NUMBER_V1:
-		return readVersion1 (file, returned, parentKey);
-	case MAGIC_NUMBER_V2:
-		// break, current version implemented below
-		break;
-	default:
-		fclose (file);
-		ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown magic number " ELEKTRA_UNSIGNED_LONG_LONG_F, magic);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "invalid index");
+		return -1;
 	}
+	return 1;
+}
+
+/**
+ * Reads the keys of a file in version 3 of the format.
+ *
+ * @param subtreeKey if not NULL, only the keys same or below this key are read,
+ *                   must be below @p parentKey
+ */
+static int readVersion3 (FILE * file, KeySet * returned, Key * parentKey, Key * subtreeKey)
+{
+	// keys are allocated from an arena, which is freed once all keys are deleted
+	ElektraArena * arena = elektraArenaNew (0);
+	Key * k = NULL;
+	Key * scratch = NULL;
 
 	// setup buffers
 	struct stringbuffer valueBuffer;
@@ -201,44 +292,70 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	struct stringbuffer metaNameBuffer;
 	setupBuffer (&metaNameBuffer, 4);
 
-	// setup name buffer with parent key
+	// setup name buffers with parent key
 	struct stringbuffer nameBuffer;
+	struct stringbuffer copyNameBuffer;
 
 	size_t parentSize = keyGetNameSize (parentKey); // includes null terminator
 	setupBuffer (&nameBuffer, parentSize + 4);
+	setupBuffer (&copyNameBuffer, parentSize + 4);
 
 	keyGetName (parentKey, nameBuffer.string, parentSize);
 	nameBuffer.string[parentSize - 1] = '/'; // replaces null terminator
 	nameBuffer.string[parentSize] = '\0';    // set new null terminator
 	nameBuffer.offset = parentSize;		 // set offset to null terminator
-
-	char c;
-	while ((c = fgetc (file)) != EOF)
+	memcpy (copyNameBuffer.string, nameBuffer.string, parentSize + 1);
+	copyNameBuffer.offset = parentSize;
+
+	// name of the subtree relative to the parent key
+	const char * subtreeName = NULL;
+	size_t subtreeNameSize = 0;
+	bool inSubtree = false;
+	if (subtreeKey != NULL)
 	{
-		ungetc (c, file);
+		subtreeName = keyName (subtreeKey) + parentSize;
+		subtreeNameSize = keyGetNameSize (subtreeKey) - 1 - parentSize;
+		scratch = keyNew ("/", KEY_END);
 
-		if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+		if (seekSubtree (file, parentKey, subtreeKey, &nameBuffer) == -1)
 		{
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto error;
 		}
+	}
 
-		char type = fgetc (file);
-		if (type == EOF)
+	size_t nameSize = 0;
+	int c;
+	while ((c = fgetc (file)) == 'k')
+	{
+		if (!readNameIntoBuffer (file, &nameBuffer, &nameSize, parentKey))
 		{
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
-			fclose (file);
-			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "missing key type");
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto error;
 		}
 
-		Key * k;
+		bool load = true;
+		if (subtreeName != NULL)
+		{
+			const char * name = &nameBuffer.string[nameBuffer.offset];
+			load = strncmp (name, subtreeName, subtreeNameSize) == 0 &&
+			       (nameSize == subtreeNameSize || (nameSize > subtreeNameSize && name[subtreeNameSize] == '/'));
+
+			if (load)
+			{
+				inSubtree = true;
+			}
+			else if (inSubtree)
+			{
+				// keys of a subtree are stored consecutively
+				break;
+			}
+			else if (keySetName (scratch, nameBuffer.string) == -1 || keyCmp (scratch, subtreeKey) > 0)
+			{
+				// passed the subtree, it is empty
+				break;
+			}
+		}
 
+		int type = fgetc (file);
 		switch (type)
 		{
 		case 'b':
@@ -247,30 +364,19 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			kdb_unsigned_long_long_t valueSize;
 			if (!readUInt64 (file, &valueSize, parentKey))
 			{
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto error;
 			}
 
-			if (valueSize == 0)
+			ensureBufferSize (&valueBuffer, valueSize + 1);
+			if (fread (valueBuffer.string, sizeof (char), valueSize, file) < valueSize)
 			{
-				k = keyNew (nameBuffer.string, KEY_BINARY, KEY_SIZE, valueSize, KEY_END);
+				ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "premature end of file");
+				goto error;
 			}
-			else
+			if (load)
 			{
-				void * value = elektraMalloc (valueSize);
-				if (fread (value, sizeof (char), valueSize, file) < valueSize)
-				{
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					fclose (file);
-					ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "");
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-				k = keyNew (nameBuffer.string, KEY_BINARY, KEY_SIZE, (size_t) valueSize, KEY_VALUE, value, KEY_END);
-				elektraFree (value);
+				k = elektraArenaKeyNew (arena, nameBuffer.string, valueBuffer.string, valueSize);
+				if (k != NULL) keySetMeta (k, "binary", "");
 			}
 			break;
 		}
@@ -279,309 +385,409 @@ int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			// string key value
 			if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
 			{
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				goto error;
+			}
+			if (load)
+			{
+				k = elektraArenaKeyNew (arena, nameBuffer.string, valueBuffer.string, elektraStrLen (valueBuffer.string));
 			}
-			k = keyNew (nameBuffer.string, KEY_VALUE, valueBuffer.string, KEY_END);
 			break;
 		}
+		case EOF:
+			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "missing key type");
+			goto error;
 		default:
-			elektraFree (nameBuffer.string);
-			elektraFree (metaNameBuffer.string);
-			elektraFree (valueBuffer.string);
-			fclose (file);
 			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown key type %c", type);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			goto error;
 		}
 
-		while ((c = fgetc (file)) != 0)
+		if (load && k == NULL)
 		{
-			if (c == EOF)
-			{
-				keyDel (k);
-				fclose (file);
-				ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "Missing key end");
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
+			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Could not create key '%s'", nameBuffer.string);
+			goto error;
+		}
 
+		while ((c = fgetc (file)) != 0)
+		{
 			switch (c)
 			{
 			case 'm':
-			{
 				// meta key
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey) ||
+				    !readStringIntoBuffer (file, &valueBuffer, parentKey))
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto error;
 				}
 
-				if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
+				if (load)
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					keySetMeta (k, metaNameBuffer.string, valueBuffer.string);
 				}
-				const char * metaValue = valueBuffer.string;
-
-				keySetMeta (k, metaNameBuffer.string, metaValue);
 				break;
-			}
 			case 'c':
 			{
-				// copy meta
-				if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+				// copy meta, the value is used, if the other key was not read
+				if (!readStringIntoBuffer (file, &copyNameBuffer, parentKey) ||
+				    !readStringIntoBuffer (file, &metaNameBuffer, parentKey) ||
+				    !readStringIntoBuffer (file, &valueBuffer, parentKey))
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					goto error;
 				}
 
-				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				if (!load)
 				{
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					break;
 				}
 
-				const Key * sourceKey = ksLookupByName (returned, nameBuffer.string, 0);
+				const Key * sourceKey = ksLookupByName (returned, copyNameBuffer.string, 0);
 				if (sourceKey == NULL)
 				{
-					ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_WRITE_FAILED, parentKey,
-							    "Could not copy meta data from key '%s': Key not found", nameBuffer.string);
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+					keySetMeta (k, metaNameBuffer.string, valueBuffer.string);
 				}
-
-				if (keyCopyMeta (k, sourceKey, metaNameBuffer.string) != 1)
+				else if (keyCopyMeta (k, sourceKey, metaNameBuffer.string) != 1)
 				{
-					ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_WRITE_FAILED, parentKey,
+					ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey,
 							    "Could not copy meta data from key '%s': Error during copy",
-							    &nameBuffer.string[nameBuffer.offset]);
-					keyDel (k);
-					elektraFree (nameBuffer.string);
-					elektraFree (metaNameBuffer.string);
-					elektraFree (valueBuffer.string);
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
+							    copyNameBuffer.string);
+					goto error;
 				}
 				break;
 			}
+			case EOF:
+				ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "Missing key end");
+				goto error;
 			default:
-				keyDel (k);
-				elektraFree (nameBuffer.string);
-				elektraFree (metaNameBuffer.string);
-				elektraFree (valueBuffer.string);
-				fclose (file);
-				ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown meta type %c", type);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown meta type %c", c);
+				goto error;
 			}
 		}
 
-		ksAppendKey (returned, k);
+		if (load)
+		{
+			ksAppendKey (returned, k);
+			k = NULL;
+		}
+	}
+
+	if (c != 'i' && c != 'k')
+	{
+		// the keys end with the index
+		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "missing index");
+		goto error;
 	}
 
+	keyDel (scratch);
 	elektraFree (nameBuffer.string);
+	elektraFree (copyNameBuffer.string);
 	elektraFree (metaNameBuffer.string);
 	elektraFree (valueBuffer.string);
-
+	elektraArenaDel (arena);
 	fclose (file);
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
-}
 
-int elektraQuickdumpSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
-{
-	cursor_t cursor = ksGetCursor (returned);
-	ksRewind (returned);
+error:
+	keyDel (k);
+	keyDel (scratch);
+	elektraFree (nameBuffer.string);
+	elektraFree (copyNameBuffer.string);
+	elektraFree (metaNameBuffer.string);
+	elektraFree (valueBuffer.string);
+	elektraArenaDel (arena);
+	fclose (file);
 
-	FILE * file;
+	return ELEKTRA_PLUGIN_STATUS_ERROR;
+}
 
-	// cannot open stdout for writing, because its already open
-	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
+/**
+ * Reads the file of @p parentKey into @p returned.
+ *
+ * @param subtreeKey if not NULL, only the keys same or below this key are read
+ * @param missingIsEmpty if true, a missing file contains no keys instead of being an error
+ */
+static int readFile (KeySet * returned, Key * parentKey, Key * subtreeKey, bool missingIsEmpty)
+{
+	if (subtreeKey != NULL && (keyGetNamespace (subtreeKey) == KEY_NS_CASCADING || keyIsBelowOrSame (subtreeKey, parentKey)))
 	{
-		file = stdout;
+		// the whole file is requested, for cascading keys we also read the whole file
+		subtreeKey = NULL;
 	}
-	else
+	else if (subtreeKey != NULL && !keyIsBelow (parentKey, subtreeKey))
 	{
-		file = fopen (keyString (parentKey), "wb");
+		// no key of the file is requested
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
 	}
 
+	int errnosave = errno;
+	FILE * file = fopen (keyString (parentKey), "rb");
+
 	if (file == NULL)
 	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
+		if (missingIsEmpty && errno == ENOENT)
+		{
+			errno = errnosave;
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+		ELEKTRA_SET_ERROR_GET (parentKey);
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
-	// magic number is written big endian so EKDB magic string is readable
-	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V2);
-	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
+	kdb_unsigned_long_long_t magic;
+	if (fread (&magic, sizeof (kdb_unsigned_long_long_t), 1, file) < 1)
 	{
+		if (feof (file) && ftell (file) == 0)
+		{
+			fclose (file);
+			return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+		}
+		else
+		{
+			fclose (file);
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+	}
+	magic = be64toh (magic); // magic number is written big endian so EKDB magic string is readable
+
+	if (magic == MAGIC_NUMBER_V3)
+	{
+		return readVersion3 (file, returned, parentKey, subtreeKey);
+	}
+
+	// older versions have no index, we read the whole file and keep the subtree
+	KeySet * keys = subtreeKey == NULL ? returned : ksNew (0, KS_END);
+	int result;
+	switch (magic)
+	{
+	case MAGIC_NUMBER_V1:
+		result = readVersion1 (file, keys, parentKey);
+		break;
+	case MAGIC_NUMBER_V2:
+		result = readVersion2 (file, keys, parentKey);
+		break;
+	default:
 		fclose (file);
-		return ELEKTRA_PLUGIN_STATUS_ERROR;
+		ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown magic number " ELEKTRA_UNSIGNED_LONG_LONG_F, magic);
+		result = ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
-	struct list metaKeys;
-	metaKeys.alloc = 16;
-	metaKeys.size = 0;
-	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+	if (keys != returned)
+	{
+		KeySet * subtree = ksCut (keys, subtreeKey);
+		ksAppend (returned, subtree);
+		ksDel (subtree);
+		ksDel (keys);
+	}
+	return result;
+}
 
-	// we assume all keys in returned are below parentKey
-	size_t parentOffset = keyGetNameSize (parentKey);
+int elektraQuickdumpGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+{
+	if (!elektraStrCmp (keyName (parentKey), "system/elektra/modules/quickdump"))
+	{
+		KeySet * contract = ksNew (
+			30, keyNew ("system/elektra/modules/quickdump", KEY_VALUE, "quickdump plugin waits for your orders", KEY_END),
+			keyNew ("system/elektra/modules/quickdump/exports", KEY_END),
+			keyNew ("system/elektra/modules/quickdump/exports/get", KEY_FUNC, elektraQuickdumpGet, KEY_END),
+			keyNew ("system/elektra/modules/quickdump/exports/set", KEY_FUNC, elektraQuickdumpSet, KEY_END),
+			keyNew ("system/elektra/modules/quickdump/exports/getsubtree", KEY_FUNC, elektraQuickdumpGetSubtree, KEY_END),
+#include ELEKTRA_README
+			keyNew ("system/elektra/modules/quickdump/infos/version", KEY_VALUE, PLUGINVERSION, KEY_END), KS_END);
+		ksAppend (returned, contract);
+		ksDel (contract);
 
-	Key * cur;
-	while ((cur = ksNext (returned)) != NULL)
+		return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	}
+	// get all keys
+
+	return readFile (returned, parentKey, NULL, false);
+}
+
+/**
+ * Like elektraQuickdumpGet(), but only reads the keys same or below @p subtreeKey.
+ *
+ * Files in the current format are read starting at the block found in their
+ * index, older files are read completely. For a cascading @p subtreeKey all keys
+ * are read.
+ *
+ * The core also calls this function when the resolver checked the file during
+ * an earlier kdbGet(), so a file that was removed since then contains no keys.
+ */
+int elektraQuickdumpGetSubtree (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey, Key * subtreeKey)
+{
+	return readFile (returned, parentKey, subtreeKey, true);
+}
+
+/**
+ * Writes a single key, its name is prefix compressed with the name of the previous key in the same block.
+ */
+static bool writeKey (struct output * out, Key * cur, const char * previousName, size_t previousNameSize, struct list * metaKeys,
+		      size_t parentOffset, Key * errorKey)
+{
+	size_t fullNameSize = keyGetNameSize (cur);
+	if (fullNameSize < parentOffset)
 	{
-		size_t fullNameSize = keyGetNameSize (cur);
-		if (fullNameSize < parentOffset)
+		ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_WRITE_FAILED, errorKey, "Key '%s' is not below the parent key", keyName (cur));
+		return false;
+	}
+
+	const char * name = keyName (cur) + parentOffset;
+	kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
+	kdb_unsigned_long_long_t shared = 0;
+	while (shared < nameSize && shared < previousNameSize && name[shared] == previousName[shared])
+	{
+		++shared;
+	}
+
+	if (!writeChar (out, 'k', errorKey) || !writeUInt64 (out, shared, errorKey) ||
+	    !writeData (out, name + shared, nameSize - shared, errorKey))
+	{
+		return false;
+	}
+
+	if (keyIsBinary (cur))
+	{
+		if (!writeChar (out, 'b', errorKey))
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			return false;
 		}
 
-		kdb_unsigned_long_long_t nameSize = fullNameSize == parentOffset ? 0 : fullNameSize - 1 - parentOffset;
-		if (!writeData (file, keyName (cur) + parentOffset, nameSize, parentKey))
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
+		if (!writeData (out, keyValue (cur), valueSize, errorKey))
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			return false;
 		}
-
-		if (keyIsBinary (cur))
+	}
+	else
+	{
+		kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
+		if (!writeChar (out, 's', errorKey) || !writeData (out, keyString (cur), valueSize, errorKey))
 		{
-			if (fputc ('b', file) == EOF)
-			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
+			return false;
+		}
+	}
 
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur);
+	keyRewindMeta (cur);
+	const Key * meta;
+	while ((meta = keyNextMeta (cur)) != NULL)
+	{
+		kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1;
+		kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
 
-			char * value = NULL;
-			if (valueSize > 0)
+		ssize_t result = findMetaLink (metaKeys, meta);
+		if (result < 0)
+		{
+			if (!writeChar (out, 'm', errorKey) || !writeData (out, keyName (meta), metaNameSize, errorKey) ||
+			    !writeData (out, keyString (meta), metaValueSize, errorKey))
 			{
-				value = elektraMalloc (valueSize);
-				if (keyGetBinary (cur, value, valueSize) == -1)
-				{
-					fclose (file);
-					elektraFree (value);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+				return false;
 			}
 
-			if (!writeData (file, value, valueSize, parentKey))
-			{
-				fclose (file);
-				elektraFree (value);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
-			elektraFree (value);
+			insertMetaLink (metaKeys, -result - 1, meta, cur, parentOffset);
 		}
 		else
 		{
-			if (fputc ('s', file) == EOF)
+			// the value is needed, if the other key is not read
+			struct metaLink * link = metaKeys->array[result];
+			if (!writeChar (out, 'c', errorKey) || !writeData (out, link->keyName, link->keyNameSize, errorKey) ||
+			    !writeData (out, keyName (meta), metaNameSize, errorKey) ||
+			    !writeData (out, keyString (meta), metaValueSize, errorKey))
 			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
-			}
-
-			kdb_unsigned_long_long_t valueSize = keyGetValueSize (cur) - 1;
-			if (!writeData (file, keyString (cur), valueSize, parentKey))
-			{
-				fclose (file);
-				return ELEKTRA_PLUGIN_STATUS_ERROR;
+				return false;
 			}
 		}
+	}
 
-		keyRewindMeta (cur);
-		const Key * meta;
-		while ((meta = keyNextMeta (cur)) != NULL)
-		{
-			ssize_t result = findMetaLink (&metaKeys, meta);
-			if (result < 0)
-			{
-				if (fputc ('m', file) == EOF)
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	return writeChar (out, 0, errorKey);
+}
 
-				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1;
-				if (!writeData (file, keyName (meta), metaNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+int elektraQuickdumpSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+{
+	cursor_t cursor = ksGetCursor (returned);
+	ksRewind (returned);
 
-				kdb_unsigned_long_long_t metaValueSize = keyGetValueSize (meta) - 1;
-				if (!writeData (file, keyString (meta), metaValueSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	struct output out = { NULL, 0 };
 
-				insertMetaLink (&metaKeys, -result - 1, meta, cur, parentOffset);
-			}
-			else
-			{
-				if (fputc ('c', file) == EOF)
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	// cannot open stdout for writing, because its already open
+	if (elektraStrCmp (keyString (parentKey), STDOUT_FILENAME) == 0)
+	{
+		out.file = stdout;
+	}
+	else
+	{
+		out.file = fopen (keyString (parentKey), "wb");
+	}
 
-				kdb_unsigned_long_long_t keyNameSize = metaKeys.array[result]->keyNameSize;
-				if (!writeData (file, metaKeys.array[result]->keyName, keyNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
+	if (out.file == NULL)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
 
-				kdb_unsigned_long_long_t metaNameSize = keyGetNameSize (meta) - 1;
-				if (!writeData (file, keyName (meta), metaNameSize, parentKey))
-				{
-					fclose (file);
-					return ELEKTRA_PLUGIN_STATUS_ERROR;
-				}
-			}
-		}
+	// magic number is written big endian so EKDB magic string is readable
+	kdb_unsigned_long_long_t magic = htobe64 (MAGIC_NUMBER_V3);
+	if (fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, out.file) < 1)
+	{
+		fclose (out.file);
+		return ELEKTRA_PLUGIN_STATUS_ERROR;
+	}
+	out.offset = sizeof (kdb_unsigned_long_long_t);
+
+	struct list metaKeys;
+	metaKeys.alloc = 16;
+	metaKeys.size = 0;
+	metaKeys.array = elektraMalloc (metaKeys.alloc * sizeof (struct metaLink *));
+
+	// the index is written after the keys, so the file can be written as a stream
+	size_t blocks = 0;
+	kdb_unsigned_long_long_t * index = elektraMalloc ((ksGetSize (returned) / BLOCK_SIZE + 1) * sizeof (kdb_unsigned_long_long_t));
+
+	// we assume all keys in returned are below parentKey
+	size_t parentOffset = keyGetNameSize (parentKey);
 
-		if (fputc (0, file) == EOF)
+	bool success = true;
+	const char * previousName = NULL;
+	size_t previousNameSize = 0;
+	size_t count = 0;
+	Key * cur;
+	while (success && (cur = ksNext (returned)) != NULL)
+	{
+		if (count++ % BLOCK_SIZE == 0)
 		{
-			fclose (file);
-			return ELEKTRA_PLUGIN_STATUS_ERROR;
+			// the first key of a block has a full name
+			index[blocks++] = out.offset;
+			previousNameSize = 0;
 		}
+
+		success = writeKey (&out, cur, previousName, previousNameSize, &metaKeys, parentOffset, parentKey);
+
+		size_t fullNameSize = keyGetNameSize (cur);
+		previousName = keyName (cur) + parentOffset;
+		previousNameSize = fullNameSize <= parentOffset ? 0 : fullNameSize - 1 - parentOffset;
+	}
+
+	kdb_unsigned_long_long_t indexOffset = out.offset;
+	success = success && writeChar (&out, 'i', parentKey) && writeUInt64 (&out, blocks, parentKey);
+	for (size_t i = 0; success && i < blocks; ++i)
+	{
+		success = writeUInt64 (&out, index[i], parentKey);
 	}
 
+	// the trailer locates the index, the magic number marks a complete file
+	success = success && writeUInt64 (&out, indexOffset, parentKey) &&
+		  fwrite (&magic, sizeof (kdb_unsigned_long_long_t), 1, out.file) == 1;
+
 	for (size_t i = 0; i < metaKeys.size; ++i)
 	{
 		elektraFree (metaKeys.array[i]);
 	}
 	elektraFree (metaKeys.array);
+	elektraFree (index);
 
-	fclose (file);
+	fclose (out.file);
 
 	ksSetCursor (returned, cursor);
 
-	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+	return success ? ELEKTRA_PLUGIN_STATUS_SUCCESS : ELEKTRA_PLUGIN_STATUS_ERROR;
 }
 
 ssize_t findMetaLink (struct list * list, const Key * meta)
@@ -677,6 +883,7 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 	return elektraPluginExport ("quickdump",
 				    ELEKTRA_PLUGIN_GET,	&elektraQuickdumpGet,
 				    ELEKTRA_PLUGIN_SET,	&elektraQuickdumpSet,
+				    ELEKTRA_PLUGIN_GET_SUBTREE,	&elektraQuickdumpGetSubtree,
 				    ELEKTRA_PLUGIN_END);
 	// clang-format on
 }
@@ -15,6 +15,7 @@
 
 int elektraQuickdumpGet (Plugin * handle, KeySet * ks, Key * parentKey);
 int elektraQuickdumpSet (Plugin * handle, KeySet * ks, Key * parentKey);
+int elektraQuickdumpGetSubtree (Plugin * handle, KeySet * ks, Key * parentKey, Key * subtreeKey);
 
 Plugin * ELEKTRA_PLUGIN_EXPORT;
 
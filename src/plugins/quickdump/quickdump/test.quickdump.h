@@ -22,8 +22,12 @@ static KeySet * test_quickdump_expected (void)
 		      keyNew ("dir/tests/bench/__868", KEY_VALUE, "UVM0OPTf68yNXij", KEY_END), k8, KS_END);
 }
 
-static unsigned char test_quickdump_parentKeyValue_data[] = { 0x45, 0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00,
-							      0x00, 0x00, 0x00, 0x00, 0x00, 0x73, 0x05, 0x00, 0x00, 0x00, 0x00,
-							      0x00, 0x00, 0x00, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00 };
+static unsigned char test_quickdump_parentKeyValue_data[] = { 0x45, 0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x03, 0x6b, 0x00, 0x00,
+							      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+							      0x00, 0x00, 0x00, 0x73, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+							      0x00, 0x76, 0x61, 0x6c, 0x75, 0x65, 0x00, 0x69, 0x01, 0x00, 0x00,
+							      0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00,
+							      0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x45,
+							      0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x03 };
 
-static size_t test_quickdump_parentKeyValue_dataSize = 31;
+static size_t test_quickdump_parentKeyValue_dataSize = 73;
@@ -0,0 +1,248 @@
+/**
+ * @file
+ *
+ * @brief Source for quickdump plugin
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+static int readVersion2 (FILE * file, KeySet * returned, Key * parentKey)
+{
+	// keys are allocated from an arena, which is freed once all keys are deleted
+	ElektraArena * arena = elektraArenaNew (0);
+
+	// setup buffers
+	struct stringbuffer valueBuffer;
+	setupBuffer (&valueBuffer, 4);
+
+	struct stringbuffer metaNameBuffer;
+	setupBuffer (&metaNameBuffer, 4);
+
+	// setup name buffer with parent key
+	struct stringbuffer nameBuffer;
+
+	size_t parentSize = keyGetNameSize (parentKey); // includes null terminator
+	setupBuffer (&nameBuffer, parentSize + 4);
+
+	keyGetName (parentKey, nameBuffer.string, parentSize);
+	nameBuffer.string[parentSize - 1] = '/'; // replaces null terminator
+	nameBuffer.string[parentSize] = '\0';    // set new null terminator
+	nameBuffer.offset = parentSize;		 // set offset to null terminator
+
+	char c;
+	while ((c = fgetc (file)) != EOF)
+	{
+		ungetc (c, file);
+
+		if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+		{
+			elektraFree (nameBuffer.string);
+			elektraFree (metaNameBuffer.string);
+			elektraFree (valueBuffer.string);
+			elektraArenaDel (arena);
+			fclose (file);
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
+		char type = fgetc (file);
+		if (type == EOF)
+		{
+			elektraFree (nameBuffer.string);
+			elektraFree (metaNameBuffer.string);
+			elektraFree (valueBuffer.string);
+			elektraArenaDel (arena);
+			fclose (file);
+			ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "missing key type");
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
+		Key * k;
+
+		switch (type)
+		{
+		case 'b':
+		{
+			// binary key value
+			kdb_unsigned_long_long_t valueSize;
+			if (!readUInt64 (file, &valueSize, parentKey))
+			{
+				elektraFree (nameBuffer.string);
+				elektraFree (metaNameBuffer.string);
+				elektraFree (valueBuffer.string);
+				elektraArenaDel (arena);
+				fclose (file);
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+
+			ensureBufferSize (&valueBuffer, valueSize + 1);
+			if (fread (valueBuffer.string, sizeof (char), valueSize, file) < valueSize)
+			{
+				elektraFree (nameBuffer.string);
+				elektraFree (metaNameBuffer.string);
+				elektraFree (valueBuffer.string);
+				elektraArenaDel (arena);
+				fclose (file);
+				ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "");
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+			k = elektraArenaKeyNew (arena, nameBuffer.string, valueBuffer.string, valueSize);
+			if (k != NULL) keySetMeta (k, "binary", "");
+			break;
+		}
+		case 's':
+		{
+			// string key value
+			if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
+			{
+				elektraFree (nameBuffer.string);
+				elektraFree (metaNameBuffer.string);
+				elektraFree (valueBuffer.string);
+				elektraArenaDel (arena);
+				fclose (file);
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+			k = elektraArenaKeyNew (arena, nameBuffer.string, valueBuffer.string, elektraStrLen (valueBuffer.string));
+			break;
+		}
+		default:
+			elektraFree (nameBuffer.string);
+			elektraFree (metaNameBuffer.string);
+			elektraFree (valueBuffer.string);
+			elektraArenaDel (arena);
+			fclose (file);
+			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown key type %c", type);
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
+		if (k == NULL)
+		{
+			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Could not create key '%s'", nameBuffer.string);
+			elektraFree (nameBuffer.string);
+			elektraFree (metaNameBuffer.string);
+			elektraFree (valueBuffer.string);
+			elektraArenaDel (arena);
+			fclose (file);
+			return ELEKTRA_PLUGIN_STATUS_ERROR;
+		}
+
+		while ((c = fgetc (file)) != 0)
+		{
+			if (c == EOF)
+			{
+				keyDel (k);
+				elektraArenaDel (arena);
+				fclose (file);
+				ELEKTRA_SET_ERROR (ELEKTRA_ERROR_READ_FAILED, parentKey, "Missing key end");
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+
+			switch (c)
+			{
+			case 'm':
+			{
+				// meta key
+				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				{
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+
+				if (!readStringIntoBuffer (file, &valueBuffer, parentKey))
+				{
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+				const char * metaValue = valueBuffer.string;
+
+				keySetMeta (k, metaNameBuffer.string, metaValue);
+				break;
+			}
+			case 'c':
+			{
+				// copy meta
+				if (!readStringIntoBuffer (file, &nameBuffer, parentKey))
+				{
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+
+				if (!readStringIntoBuffer (file, &metaNameBuffer, parentKey))
+				{
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+
+				const Key * sourceKey = ksLookupByName (returned, nameBuffer.string, 0);
+				if (sourceKey == NULL)
+				{
+					ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_WRITE_FAILED, parentKey,
+							    "Could not copy meta data from key '%s': Key not found", nameBuffer.string);
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+
+				if (keyCopyMeta (k, sourceKey, metaNameBuffer.string) != 1)
+				{
+					ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_WRITE_FAILED, parentKey,
+							    "Could not copy meta data from key '%s': Error during copy",
+							    &nameBuffer.string[nameBuffer.offset]);
+					keyDel (k);
+					elektraFree (nameBuffer.string);
+					elektraFree (metaNameBuffer.string);
+					elektraFree (valueBuffer.string);
+					elektraArenaDel (arena);
+					fclose (file);
+					return ELEKTRA_PLUGIN_STATUS_ERROR;
+				}
+				break;
+			}
+			default:
+				keyDel (k);
+				elektraFree (nameBuffer.string);
+				elektraFree (metaNameBuffer.string);
+				elektraFree (valueBuffer.string);
+				elektraArenaDel (arena);
+				fclose (file);
+				ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_READ_FAILED, parentKey, "Unknown meta type %c", type);
+				return ELEKTRA_PLUGIN_STATUS_ERROR;
+			}
+		}
+
+		ksAppendKey (returned, k);
+	}
+
+	elektraFree (nameBuffer.string);
+	elektraFree (metaNameBuffer.string);
+	elektraFree (valueBuffer.string);
+	elektraArenaDel (arena);
+
+	fclose (file);
+
+	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
+}
@@ -121,13 +121,13 @@ static void test_basics (void)
 	ksDel (ks);
 }
 
-static void test_updateV1ToV2 (void)
+static void test_updateV1ToV3 (void)
 {
-	printf ("test update v1 to v2\n");
+	printf ("test update v1 to v3\n");
 
 	KeySet * ks = ksNew (0, KS_END);
 	char * infile = elektraStrDup (srcdir_file ("quickdump/test.v1.quickdump"));
-	char * infileV2 = elektraStrDup (srcdir_file ("quickdump/test.quickdump"));
+	char * infileV3 = elektraStrDup (srcdir_file ("quickdump/test.quickdump"));
 	char * outfile = elektraStrDup (srcdir_file ("quickdump/test.quickdump.out"));
 
 	{
@@ -159,7 +159,7 @@ static void test_updateV1ToV2 (void)
 
 		succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
 
-		succeed_if (compare_binary_files (infileV2, outfile) == 0, "files differ");
+		succeed_if (compare_binary_files (infileV3, outfile) == 0, "files differ");
 		remove (outfile);
 
 		keyDel (setKey);
@@ -167,7 +167,58 @@ static void test_updateV1ToV2 (void)
 	}
 
 	elektraFree (infile);
-	elektraFree (infileV2);
+	elektraFree (infileV3);
+	elektraFree (outfile);
+	ksDel (ks);
+}
+
+static void test_updateV2ToV3 (void)
+{
+	printf ("test update v2 to v3\n");
+
+	KeySet * ks = ksNew (0, KS_END);
+	char * infile = elektraStrDup (srcdir_file ("quickdump/test.v2.quickdump"));
+	char * infileV3 = elektraStrDup (srcdir_file ("quickdump/test.quickdump"));
+	char * outfile = elektraStrDup (srcdir_file ("quickdump/test.quickdump.out"));
+
+	{
+		Key * getKey = keyNew ("dir/tests/bench", KEY_VALUE, infile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("quickdump");
+
+		KeySet * expected = test_quickdump_expected ();
+
+		succeed_if (plugin->kdbGet (plugin, ks, getKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+		compare_keyset (expected, ks);
+
+		Key * k1 = ksLookupByName (ks, "dir/tests/bench/__112", 0);
+		Key * k8 = ksLookupByName (ks, "dir/tests/bench/__911", 0);
+		succeed_if (keyGetMeta (k1, "meta/_35") == keyGetMeta (k8, "meta/_35"), "copy meta failed");
+
+		ksDel (expected);
+
+		keyDel (getKey);
+		PLUGIN_CLOSE ();
+	}
+
+	{
+		Key * setKey = keyNew ("dir/tests/bench", KEY_VALUE, outfile, KEY_END);
+
+		KeySet * conf = ksNew (0, KS_END);
+		PLUGIN_OPEN ("quickdump");
+
+		succeed_if (plugin->kdbSet (plugin, ks, setKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+		succeed_if (compare_binary_files (infileV3, outfile) == 0, "files differ");
+		remove (outfile);
+
+		keyDel (setKey);
+		PLUGIN_CLOSE ();
+	}
+
+	elektraFree (infile);
+	elektraFree (infileV3);
 	elektraFree (outfile);
 	ksDel (ks);
 }
@@ -218,6 +269,99 @@ static void test_parentKeyValue (void)
 	ksDel (expected);
 }
 
+typedef int (*getSubtreeFunc) (Plugin * handle, KeySet * returned, Key * parentKey, Key * subtreeKey);
+
+static void check_subtree (Plugin * plugin, KeySet * ks, Key * parentKey, const char * subtreeName)
+{
+	getSubtreeFunc getSubtree = (getSubtreeFunc) elektraPluginGetFunction (plugin, "getsubtree");
+	exit_if_fail (getSubtree != NULL, "getsubtree not exported");
+
+	Key * subtreeKey = keyNew (subtreeName, KEY_END);
+	KeySet * copy = ksDup (ks);
+	KeySet * expected = ksCut (copy, subtreeKey);
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (getSubtree (plugin, actual, parentKey, subtreeKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "call to getsubtree was not successful");
+	compare_keyset (expected, actual);
+
+	ksDel (actual);
+	ksDel (expected);
+	ksDel (copy);
+	keyDel (subtreeKey);
+}
+
+static void test_subtree (void)
+{
+	printf ("test subtree\n");
+
+	// several blocks with subtrees crossing block borders and names, whose order differs from strcmp
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 300; ++i)
+	{
+		snprintf (name, sizeof (name), "dir/tests/bench/%c/key%03d", 'a' + i / 50, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "value", KEY_END));
+		snprintf (name, sizeof (name), "dir/tests/bench/%c-x/key%03d", 'a' + i / 50, i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "value", KEY_META, "meta", "other", KEY_END));
+	}
+	ksAppendKey (ks, keyNew ("dir/tests/bench/c", KEY_VALUE, "c", KEY_END));
+	ksAppendKey (ks, keyNew ("dir/tests/bench/d\\/e", KEY_BINARY, KEY_SIZE, 4, KEY_VALUE, "bin", KEY_END));
+
+	// metadata copied from a key outside of the subtree
+	Key * first = ksLookupByName (ks, "dir/tests/bench/a/key000", 0);
+	keySetMeta (first, "meta", "shared");
+	keyCopyMeta (ksLookupByName (ks, "dir/tests/bench/c/key120", 0), first, "meta");
+
+	char * outfile = elektraStrDup (srcdir_file ("quickdump/test.quickdump.out"));
+	Key * parentKey = keyNew ("dir/tests/bench", KEY_VALUE, outfile, KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("quickdump");
+
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbSet was not successful");
+
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/c");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/c-x");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/a");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/f-x");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/b/key070");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/d\\/e");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/d");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/0");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench/z");
+	check_subtree (plugin, ks, parentKey, "dir/tests/bench");
+	check_subtree (plugin, ks, parentKey, "dir/tests");
+	check_subtree (plugin, ks, parentKey, "user/tests/bench/c");
+
+	KeySet * actual = ksNew (0, KS_END);
+	Key * subtreeKey = keyNew ("dir/tests/bench/c", KEY_END);
+	getSubtreeFunc getSubtree = (getSubtreeFunc) elektraPluginGetFunction (plugin, "getsubtree");
+	succeed_if (getSubtree (plugin, actual, parentKey, subtreeKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "call to getsubtree was not successful");
+	succeed_if_same_string (keyString (keyGetMeta (ksLookupByName (actual, "dir/tests/bench/c/key120", 0), "meta")), "shared");
+	keyDel (subtreeKey);
+	ksDel (actual);
+
+	remove (outfile);
+
+	// a file removed since the resolver checked it has no keys
+	actual = ksNew (0, KS_END);
+	subtreeKey = keyNew ("dir/tests/bench/c", KEY_END);
+	succeed_if (getSubtree (plugin, actual, parentKey, subtreeKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "getsubtree of removed file was not successful");
+	succeed_if (ksGetSize (actual) == 0, "getsubtree of removed file returned keys");
+	succeed_if (plugin->kdbGet (plugin, actual, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbGet of removed file was successful");
+	keyDel (subtreeKey);
+	ksDel (actual);
+
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+
+	elektraFree (outfile);
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("QUICKDUMP     TESTS\n");
@@ -226,8 +370,10 @@ int main (int argc, char ** argv)
 	init (argc, argv);
 
 	test_basics ();
-	test_updateV1ToV2 ();
+	test_updateV1ToV3 ();
+	test_updateV2ToV3 ();
 	test_parentKeyValue ();
+	test_subtree ();
 
 	print_result ("testmod_quickdump");
 
@@ -998,7 +998,7 @@ static void elektraUpdateFileTime (resolverHandle * pk, int fd, Key * parentKey)
  * @retval 0 on success
  * @retval -1 on error
  */
-static int elektraSetCommit (resolverHandle * pk, Key * parentKey)
+static int elektraSetCommit (Plugin * handle, resolverHandle * pk, Key * parentKey)
 {
 	int ret = 0;
 
@@ -1076,13 +1076,17 @@ static int elektraSetCommit (resolverHandle * pk, Key * parentKey)
 	// file is present now!
 	pk->isMissing = 0;
 
-	DIR * dirp = opendir (pk->dirname);
-	// checking dirp not needed, fsync will have EBADF
-	if (fsync (dirfd (dirp)) == -1)
+	// kdbSet() syncs every directory once after all backends are committed
+	if (!elektraPluginDeferDirectorySync (handle, pk->dirname))
 	{
-		ELEKTRA_ADD_WARNINGF (88, parentKey, "Could not sync directory \"%s\", because %s", pk->dirname, strerror (errno));
+		DIR * dirp = opendir (pk->dirname);
+		// checking dirp not needed, fsync will have EBADF
+		if (fsync (dirfd (dirp)) == -1)
+		{
+			ELEKTRA_ADD_WARNINGF (88, parentKey, "Could not sync directory \"%s\", because %s", pk->dirname, strerror (errno));
+		}
+		closedir (dirp);
 	}
-	closedir (dirp);
 
 	elektraUnlockFile (pk->fd, parentKey);
 	elektraCloseFile (pk->fd, parentKey);
@@ -1151,7 +1155,7 @@ int ELEKTRA_PLUGIN_FUNCTION (set) (Plugin * handle, KeySet * ks, Key * parentKey
 		keySetString (parentKey, pk->filename);
 
 		/* we have an fd, so we are in second phase*/
-		if (elektraSetCommit (pk, parentKey) == -1)
+		if (elektraSetCommit (handle, pk, parentKey) == -1)
 		{
 			ret = -1;
 		}
@@ -16,6 +16,7 @@
 #include <kdbhelper.h>
 #include <kdblogger.h>
 #include <kdbmeta.h>
+#include <kdbproposal.h>
 #include <kdbtypes.h>
 
 #include <fnmatch.h>
@@ -373,6 +374,52 @@ static bool isArraySpec (const Key * key)
 	return false;
 }
 
+/**
+ * Collects all keys directly below @p parent. If @p parent is cascading,
+ * keys of all namespaces are collected.
+ *
+ * Only the range of @p ks below @p parent is visited, @p ks itself is
+ * neither copied nor modified.
+ */
+static KeySet * getDirectBelow (KeySet * ks, Key * parent)
+{
+	static const char * const namespaces[] = { "", "spec", "proc", "dir", "user", "system", NULL };
+
+	KeySet * result = ksNew (0, KS_END);
+	bool cascading = keyGetNamespace (parent) == KEY_NS_CASCADING;
+	for (const char * const * ns = namespaces; *ns != NULL; ++ns)
+	{
+		Key * root = parent;
+		if (cascading && **ns != '\0')
+		{
+			char * name = elektraFormat ("%s%s", *ns, keyName (parent));
+			root = keyNew (name, KEY_END);
+			elektraFree (name);
+		}
+
+		size_t end;
+		for (ssize_t it = ksFindHierarchy (ks, root, &end); it >= 0 && (size_t) it < end; ++it)
+		{
+			Key * cur = ksAtCursor (ks, it);
+			if (keyIsDirectBelow (parent, cur))
+			{
+				ksAppendKey (result, cur);
+			}
+		}
+
+		if (root != parent)
+		{
+			keyDel (root);
+		}
+
+		if (!cascading)
+		{
+			break;
+		}
+	}
+	return result;
+}
+
 static bool validateArraySize (Key * arrayParent, Key * spec)
 {
 	const Key * arrayActualKey = keyGetMeta (arrayParent, "array");
@@ -406,10 +453,7 @@ static void validateEmptyArray (KeySet * ks, Key * arraySpec, Key * parentKey, O
 		arrayParent = keyNew (keyName (parentLookup), KEY_END);
 	}
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parentLookup);
-	ksDel (ksCopy);
+	KeySet * subKeys = getDirectBelow (ks, parentLookup);
 
 	bool haveConflict = false;
 	Key * cur;
@@ -463,10 +507,7 @@ static void validateArrayMembers (KeySet * ks, Key * arraySpec)
 		return;
 	}
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parentLookup);
-	ksDel (ksCopy);
+	KeySet * subKeys = getDirectBelow (ks, parentLookup);
 
 	Key * cur;
 	ksRewind (subKeys);
@@ -584,13 +625,18 @@ static KeySet * instantiateArraySpec (KeySet * ks, Key * arraySpec, Key * parent
 
 	keyDel (specCur);
 
+	// the instantiated keys have no metadata yet, so they can share the same metadata
+	Key * metaKey = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+	keySetMeta (metaKey, "internal/spec/array", "");
+	copyMeta (metaKey, arraySpec);
+
 	Key * k;
 	ksRewind (newKeys);
 	while ((k = ksNext (newKeys)) != NULL)
 	{
-		keySetMeta (k, "internal/spec/array", "");
-		copyMeta (k, arraySpec);
+		keyCopyAllMeta (k, metaKey);
 	}
+	keyDel (metaKey);
 
 	ksSetCursor (ks, cursor);
 	return newKeys;
@@ -643,10 +689,7 @@ static void validateWildcardSubs (KeySet * ks, Key * key)
 	Key * parent = keyDup (key);
 	keySetBaseName (parent, NULL);
 
-	// TODO: [improvement] ksExtract?, like ksCut, but doesn't remove -> no need for ksDup
-	KeySet * ksCopy = ksDup (ks);
-	KeySet * subKeys = ksCut (ksCopy, parent);
-	ksDel (ksCopy);
+	KeySet * subKeys = getDirectBelow (ks, parent);
 
 	Key * cur;
 	while ((cur = ksNext (subKeys)) != NULL)
@@ -671,8 +714,25 @@ static void validateWildcardSubs (KeySet * ks, Key * key)
  */
 static void copyMeta (Key * dest, Key * src)
 {
+	keyRewindMeta (dest);
+	bool copyAll = keyNextMeta (dest) == NULL;
+
 	keyRewindMeta (src);
 	const Key * meta;
+	while (copyAll && (meta = keyNextMeta (src)) != NULL)
+	{
+		const char * name = keyName (meta);
+		copyAll = strncmp (name, "internal/", 9) != 0 && strncmp (name, "conflict/", 9) != 0;
+	}
+
+	if (copyAll)
+	{
+		// nothing to skip and nothing to overwrite: the keys share their metadata
+		keyCopyAllMeta (dest, src);
+		return;
+	}
+
+	keyRewindMeta (src);
 	while ((meta = keyNextMeta (src)) != NULL)
 	{
 		const char * name = keyName (meta);
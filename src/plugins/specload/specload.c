@@ -15,9 +15,13 @@
 #include <kdbease.h>
 #include <kdbinvoke.h>
 #include <kdbmodule.h>
+#include <kdbprivate.h>
 #include <kdbproposal.h>
+#include <dirent.h>
+#include <inttypes.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <utime.h>
 
@@ -47,6 +51,7 @@ static struct change allowedChanges[] = { { "description", true, true, true },
 
 static bool getAppAndArgs (KeySet * conf, char ** appPtr, char *** argvPtr, Key * errorKey);
 static bool loadSpec (KeySet * returned, const char * app, char * argv[], Key * parentKey, ElektraInvokeHandle * quickDump);
+static bool loadSpecCached (KeySet * returned, Specload * specload, Key * parentKey);
 static int isChangeAllowed (Key * oldKey, Key * newKey);
 static KeySet * calculateMetaDiff (Key * oldKey, Key * newKey);
 
@@ -101,6 +106,12 @@ int elektraSpecloadOpen (Plugin * handle, Key * errorKey)
 		return ELEKTRA_PLUGIN_STATUS_ERROR;
 	}
 
+	Key * cacheKey = ksLookupByName (conf, "/cache", 0);
+	specload->cacheDirectory = cacheKey != NULL && strlen (keyString (cacheKey)) > 0 ? elektraStrDup (keyString (cacheKey)) : NULL;
+	specload->cachedSpec = NULL;
+	specload->cachedConfigId = 0;
+	specload->cachedBinaryId = 0;
+
 	elektraPluginSetData (handle, specload);
 
 	return ELEKTRA_PLUGIN_STATUS_SUCCESS;
@@ -117,6 +128,8 @@ int elektraSpecloadClose (Plugin * handle, Key * errorKey)
 		ksDel (specload->quickDumpConfig);
 		elektraFree (specload->app);
 		freeArgv (specload->argv);
+		if (specload->cacheDirectory != NULL) elektraFree (specload->cacheDirectory);
+		if (specload->cachedSpec != NULL) ksDel (specload->cachedSpec);
 
 		elektraFree (specload);
 		elektraPluginSetData (handle, NULL);
@@ -188,7 +201,7 @@ int elektraSpecloadGet (Plugin * handle, KeySet * returned, Key * parentKey)
 
 	KeySet * spec = ksNew (0, KS_END);
 
-	if (!loadSpec (spec, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!loadSpecCached (spec, specload, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_SPECLOAD, parentKey,
@@ -234,7 +247,7 @@ int elektraSpecloadSet (Plugin * handle, KeySet * returned, Key * parentKey)
 	Specload * specload = elektraPluginGetData (handle);
 
 	KeySet * spec = ksNew (0, KS_END);
-	if (!loadSpec (spec, specload->app, specload->argv, parentKey, specload->quickDump))
+	if (!loadSpecCached (spec, specload, parentKey))
 	{
 		ksDel (spec);
 		ELEKTRA_SET_ERROR (ELEKTRA_ERROR_SPECLOAD, parentKey,
@@ -475,6 +488,242 @@ bool loadSpec (KeySet * returned, const char * app, char * argv[], Key * parentK
 	return result;
 }
 
+#define SPECLOAD_HASH_INIT 14695981039346656037ULL
+
+// FNV-1a
+static uint64_t hashBytes (uint64_t hash, const void * data, size_t size)
+{
+	const unsigned char * bytes = data;
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+	return hash;
+}
+
+/**
+ * Calculates the identity of the spec @p specload would load for @p parentKey.
+ *
+ * @p configId changes, whenever a different app, parent key or different
+ * arguments are used. @p binaryId changes, whenever the app binary is replaced
+ * or modified (device, inode, size, modification time).
+ *
+ * @retval true  if @p configId and @p binaryId were set
+ * @retval false if the app could not be stat'ed
+ */
+static bool getSpecIdentity (Specload * specload, Key * parentKey, uint64_t * configId, uint64_t * binaryId)
+{
+	struct stat buf;
+	if (stat (specload->app, &buf) != 0)
+	{
+		return false;
+	}
+
+	uint64_t hash = SPECLOAD_HASH_INIT;
+	hash = hashBytes (hash, keyName (parentKey), strlen (keyName (parentKey)) + 1);
+	hash = hashBytes (hash, specload->app, strlen (specload->app) + 1);
+	for (size_t index = 0; specload->argv[index] != NULL; ++index)
+	{
+		hash = hashBytes (hash, specload->argv[index], strlen (specload->argv[index]) + 1);
+	}
+	*configId = hash;
+
+	hash = SPECLOAD_HASH_INIT;
+	hash = hashBytes (hash, &buf.st_dev, sizeof (buf.st_dev));
+	hash = hashBytes (hash, &buf.st_ino, sizeof (buf.st_ino));
+	hash = hashBytes (hash, &buf.st_size, sizeof (buf.st_size));
+	int64_t seconds = ELEKTRA_STAT_SECONDS (buf);
+	int64_t nanoSeconds = ELEKTRA_STAT_NANO_SECONDS (buf);
+	hash = hashBytes (hash, &seconds, sizeof (seconds));
+	hash = hashBytes (hash, &nanoSeconds, sizeof (nanoSeconds));
+	*binaryId = hash;
+
+	return true;
+}
+
+/**
+ * Checks that @p path is owned by the current user or root and cannot be
+ * modified by anyone else. Symlinks are never trusted.
+ *
+ * @retval true  if @p path is a directory (@p directory is true) or a regular file and can be trusted
+ * @retval false otherwise
+ */
+static bool isCacheTrusted (const char * path, bool directory)
+{
+	struct stat buf;
+	if (lstat (path, &buf) != 0)
+	{
+		return false;
+	}
+
+	if (directory ? !S_ISDIR (buf.st_mode) : !S_ISREG (buf.st_mode))
+	{
+		return false;
+	}
+
+	if (buf.st_uid != geteuid () && buf.st_uid != 0)
+	{
+		return false;
+	}
+
+	return (buf.st_mode & (S_IWGRP | S_IWOTH)) == 0;
+}
+
+/**
+ * Removes the cache files of older versions of the app from the cache directory.
+ */
+static void removeStaleCacheFiles (Specload * specload, uint64_t configId, const char * cacheFile)
+{
+	DIR * dir = opendir (specload->cacheDirectory);
+	if (dir == NULL)
+	{
+		return;
+	}
+
+	char * prefix = elektraFormat ("specload-%016" PRIx64 "-", configId);
+	size_t prefixSize = strlen (prefix);
+	const char * cacheName = strrchr (cacheFile, '/') + 1;
+
+	struct dirent * entry;
+	while ((entry = readdir (dir)) != NULL)
+	{
+		if (strncmp (entry->d_name, prefix, prefixSize) != 0 || strcmp (entry->d_name, cacheName) == 0)
+		{
+			continue;
+		}
+
+		char * staleFile = elektraFormat ("%s/%s", specload->cacheDirectory, entry->d_name);
+		unlink (staleFile);
+		elektraFree (staleFile);
+	}
+
+	elektraFree (prefix);
+	closedir (dir);
+}
+
+/**
+ * Stores @p spec as cache file in the cache directory.
+ *
+ * The file is written to a temporary file first, so that other processes
+ * never read a partial cache, and is made read-only for everyone except
+ * its owner.
+ */
+static void writeCacheFile (Specload * specload, KeySet * spec, Key * parentKey, const char * cacheFile)
+{
+	char * tmpFile = elektraFormat ("%s.%d.tmp", cacheFile, (int) getpid ());
+	Key * cacheParent = keyNew (keyName (parentKey), KEY_VALUE, tmpFile, KEY_END);
+	if (elektraInvoke2Args (specload->quickDump, "set", spec, cacheParent) != ELEKTRA_PLUGIN_STATUS_SUCCESS ||
+	    chmod (tmpFile, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH) != 0 || rename (tmpFile, cacheFile) != 0)
+	{
+		// caching is optional, the spec was loaded successfully anyway
+		unlink (tmpFile);
+	}
+	keyDel (cacheParent);
+	elektraFree (tmpFile);
+}
+
+/**
+ * Loads the base specification, but only calls the app, if its spec isn't cached yet.
+ *
+ * The spec of the last call is kept in memory. If the config key `cache` is set,
+ * it is also stored as quickdump file in this directory, so that other processes
+ * can use it as well. The file name contains the identity of the app binary, so
+ * both caches are invalidated, when the app binary changes. Cache files of older
+ * binaries are removed, when a new one is written.
+ *
+ * The cache directory and the cache files must be owned by the current user or
+ * root and must not be writable by anyone else, otherwise they are ignored.
+ */
+static bool loadSpecCached (KeySet * returned, Specload * specload, Key * parentKey)
+{
+	uint64_t configId;
+	uint64_t binaryId;
+	if (!getSpecIdentity (specload, parentKey, &configId, &binaryId))
+	{
+		return loadSpec (returned, specload->app, specload->argv, parentKey, specload->quickDump);
+	}
+
+	if (specload->cachedSpec != NULL && specload->cachedConfigId == configId && specload->cachedBinaryId == binaryId)
+	{
+		KeySet * dup = ksDeepDup (specload->cachedSpec);
+		ksAppend (returned, dup);
+		ksDel (dup);
+		return true;
+	}
+
+	char * cacheFile = NULL;
+	if (specload->cacheDirectory != NULL)
+	{
+		if (isCacheTrusted (specload->cacheDirectory, true))
+		{
+			cacheFile = elektraFormat ("%s/specload-%016" PRIx64 "-%016" PRIx64 ".quickdump", specload->cacheDirectory, configId,
+						   binaryId);
+		}
+		else
+		{
+			ELEKTRA_ADD_WARNINGF (ELEKTRA_WARNING_SPECLOAD_CACHE, parentKey,
+					      "The cache directory '%s' is not owned by the current user or root or is writable by others. "
+					      "The cache is not used.",
+					      specload->cacheDirectory);
+		}
+	}
+
+	KeySet * spec = ksNew (0, KS_END);
+	bool loaded = false;
+	if (cacheFile != NULL && access (cacheFile, F_OK) == 0)
+	{
+		if (isCacheTrusted (cacheFile, false))
+		{
+			Key * cacheParent = keyNew (keyName (parentKey), KEY_VALUE, cacheFile, KEY_END);
+			loaded = elektraInvoke2Args (specload->quickDump, "get", spec, cacheParent) == ELEKTRA_PLUGIN_STATUS_SUCCESS;
+			keyDel (cacheParent);
+			if (!loaded)
+			{
+				// broken cache file, call the app instead
+				ksClear (spec);
+			}
+		}
+		else
+		{
+			ELEKTRA_ADD_WARNINGF (ELEKTRA_WARNING_SPECLOAD_CACHE, parentKey,
+					      "The cache file '%s' is not owned by the current user or root or is writable by others. "
+					      "It is replaced.",
+					      cacheFile);
+		}
+	}
+
+	if (!loaded)
+	{
+		loaded = loadSpec (spec, specload->app, specload->argv, parentKey, specload->quickDump);
+
+		if (loaded && cacheFile != NULL)
+		{
+			writeCacheFile (specload, spec, parentKey, cacheFile);
+			removeStaleCacheFiles (specload, configId, cacheFile);
+		}
+	}
+
+	if (cacheFile != NULL)
+	{
+		elektraFree (cacheFile);
+	}
+
+	if (loaded)
+	{
+		if (specload->cachedSpec != NULL)
+		{
+			ksDel (specload->cachedSpec);
+		}
+		specload->cachedSpec = ksDeepDup (spec);
+		specload->cachedConfigId = configId;
+		specload->cachedBinaryId = binaryId;
+		ksAppend (returned, spec);
+	}
+
+	ksDel (spec);
+	return loaded;
+}
+
 /**
  * Checks whether the @p oldKey can be changed into @p newKey safely.
  *
@@ -13,12 +13,18 @@
 #include <kdbinvoke.h>
 #include <kdbplugin.h>
 
+#include <stdint.h>
+
 typedef struct
 {
 	char * app;
 	char ** argv;
 	KeySet * quickDumpConfig;
 	ElektraInvokeHandle * quickDump;
+	char * cacheDirectory;   /*!< directory for persistent spec caches, or NULL */
+	KeySet * cachedSpec;     /*!< spec from last call of the app, or NULL */
+	uint64_t cachedConfigId; /*!< identity of app, arguments and parent key cachedSpec was loaded for */
+	uint64_t cachedBinaryId; /*!< identity of the app binary cachedSpec was loaded from */
 } Specload;
 
 int elektraSpecloadOpen (Plugin * handle, Key * errorKey);
@@ -14,10 +14,13 @@
 
 #define DEFAULT_SPEC ksNew (50, keyNew (PARENT_KEY "/mykey", KEY_META, "default", "7", KEY_END), KS_END)
 
-unsigned char default_spec_expected[] = { 0x45, 0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x02, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00,
-					  0x00, 0x00, 0x6d, 0x79, 0x6b, 0x65, 0x79, 0x73, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-					  0x00, 0x00, 0x6d, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66,
-					  0x61, 0x75, 0x6c, 0x74, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x37, 0x00 };
-unsigned int default_spec_expected_size = 56;
+unsigned char default_spec_expected[] = { 0x45, 0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x03, 0x6b, 0x00, 0x00, 0x00, 0x00, 0x00,
+					  0x00, 0x00, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6d, 0x79, 0x6b,
+					  0x65, 0x79, 0x73, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x6d, 0x07, 0x00,
+					  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66, 0x61, 0x75, 0x6c, 0x74, 0x01,
+					  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x37, 0x00, 0x69, 0x01, 0x00, 0x00, 0x00,
+					  0x00, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x41, 0x00,
+					  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x45, 0x4b, 0x44, 0x42, 0x00, 0x00, 0x00, 0x03 };
+unsigned int default_spec_expected_size = 98;
 
 #endif // ELEKTRA_SPECLOAD_TESTDATA_H
@@ -19,6 +19,8 @@
 
 #include "testdata.h"
 
+#include <dirent.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
 static FILE * backupFile (const char * filename)
@@ -288,6 +290,120 @@ static void test_remove (void)
 	PLUGIN_CLOSE ();
 }
 
+static char * findCacheFile (const char * directory)
+{
+	DIR * dir = opendir (directory);
+	if (dir == NULL) return NULL;
+
+	char * result = NULL;
+	struct dirent * entry;
+	while ((entry = readdir (dir)) != NULL)
+	{
+		if (strncmp (entry->d_name, "specload-", 9) == 0)
+		{
+			result = elektraFormat ("%s/%s", directory, entry->d_name);
+			break;
+		}
+	}
+	closedir (dir);
+	return result;
+}
+
+static void checkCachedSpec (const char * cacheDir, Key * parentKey, KeySet * expected)
+{
+	KeySet * conf = ksNew (2, keyNew ("/app", KEY_VALUE, TESTAPP_PATH, KEY_END), keyNew ("/cache", KEY_VALUE, cacheDir, KEY_END), KS_END);
+	PLUGIN_OPEN ("specload");
+
+	KeySet * ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (expected, ks);
+	ksDel (ks);
+
+	PLUGIN_CLOSE ();
+}
+
+static void test_cache (void)
+{
+	printf ("test cache\n");
+
+	char cacheDir[] = "/tmp/elektra-test-specload.XXXXXX";
+	exit_if_fail (mkdtemp (cacheDir) != NULL, "couldn't create cache directory");
+
+	Key * parentKey = keyNew (PARENT_KEY, KEY_VALUE, srcdir_file ("specload/basics.quickdump"), KEY_END);
+	KeySet * conf = ksNew (2, keyNew ("/app", KEY_VALUE, TESTAPP_PATH, KEY_END), keyNew ("/cache", KEY_VALUE, cacheDir, KEY_END), KS_END);
+	PLUGIN_OPEN ("specload");
+
+	KeySet * ks = ksNew (0, KS_END);
+	KeySet * defaultSpec = DEFAULT_SPEC;
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (defaultSpec, ks);
+	ksDel (ks);
+
+	// second call uses the in-memory cache and must not return the same keys
+	ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (defaultSpec, ks);
+	keySetMeta (ksLookupByName (ks, PARENT_KEY "/mykey", 0), "default", "8");
+	ksDel (ks);
+
+	ks = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "call to kdbGet was not successful");
+	compare_keyset (defaultSpec, ks);
+	ksDel (ks);
+
+	PLUGIN_CLOSE ();
+
+	char * cacheFile = findCacheFile (cacheDir);
+	exit_if_fail (cacheFile != NULL, "cache file not created");
+
+	// a new instance has to use the persistent cache instead of calling the app
+	KeySet * quickDumpConf = ksNew (0, KS_END);
+	ElektraInvokeHandle * quickDump = elektraInvokeOpen ("quickdump", quickDumpConf, parentKey);
+	Key * cacheParent = keyNew (PARENT_KEY, KEY_VALUE, cacheFile, KEY_END);
+	KeySet * cachedSpec = ksNew (1, keyNew (PARENT_KEY "/mykey", KEY_META, "default", "8", KEY_END), KS_END);
+	succeed_if (elektraInvoke2Args (quickDump, "set", cachedSpec, cacheParent) == ELEKTRA_PLUGIN_STATUS_SUCCESS,
+		    "couldn't write cache file");
+	elektraInvokeClose (quickDump, parentKey);
+	ksDel (quickDumpConf);
+	keyDel (cacheParent);
+
+	chmod (cacheFile, 0644);
+
+	checkCachedSpec (cacheDir, parentKey, cachedSpec);
+
+	// a cache file writable by others is ignored and replaced
+	chmod (cacheFile, 0666);
+	checkCachedSpec (cacheDir, parentKey, defaultSpec);
+	checkCachedSpec (cacheDir, parentKey, defaultSpec);
+	struct stat buf;
+	succeed_if (stat (cacheFile, &buf) == 0 && (buf.st_mode & 0777) == 0644, "cache file not replaced");
+
+	// cache files of older app binaries are removed
+	char * staleFile = elektraStrDup (cacheFile);
+	memset (staleFile + strlen (staleFile) - strlen ("0000000000000000.quickdump"), '0', 16);
+	succeed_if (rename (cacheFile, staleFile) == 0, "couldn't create stale cache file");
+	checkCachedSpec (cacheDir, parentKey, defaultSpec);
+	succeed_if (access (staleFile, F_OK) != 0, "stale cache file not removed");
+	succeed_if (access (cacheFile, F_OK) == 0, "cache file not created");
+	elektraFree (staleFile);
+
+	// a cache directory writable by others is not used
+	unlink (cacheFile);
+	chmod (cacheDir, 0777);
+	checkCachedSpec (cacheDir, parentKey, defaultSpec);
+	succeed_if (access (cacheFile, F_OK) != 0, "cache file created in insecure directory");
+	chmod (cacheDir, 0700);
+
+	unlink (cacheFile);
+	elektraFree (cacheFile);
+	rmdir (cacheDir);
+
+	ksDel (cachedSpec);
+	ksDel (defaultSpec);
+	keyDel (parentKey);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -301,6 +417,7 @@ int main (int argc, char ** argv)
 	test_edit ();
 	test_remove ();
 	test_newfile ();
+	test_cache ();
 
 	print_result ("testmod_specload");
 
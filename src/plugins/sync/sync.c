@@ -44,11 +44,15 @@ int elektraSyncGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UN
 	return 1; /* success */
 }
 
-int elektraSyncSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned ELEKTRA_UNUSED, Key * parentKey)
+int elektraSyncSet (Plugin * handle, KeySet * returned ELEKTRA_UNUSED, Key * parentKey)
 {
 	/* set all keys */
 	const char * configFile = keyString (parentKey);
 	if (!strcmp (configFile, "")) return 0; // no underlying config file
+
+	// kdbSet() syncs the files of all backends together before they are committed
+	if (elektraPluginDeferSync (handle, configFile)) return 1;
+
 	int fd = open (configFile, O_RDWR);
 	if (fd == -1)
 	{
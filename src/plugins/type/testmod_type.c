@@ -313,6 +313,43 @@ void test_wstring (void)
 }
 
 
+static void test_sharedMeta (void)
+{
+	Key * parentKey = keyNew ("user/tests/type/shared", KEY_VALUE, "", KEY_END);
+	Key * spec = keyNew ("spec/tests/type/shared", KEY_META, "check/type", "short", KEY_END);
+	Key * k1 = keyNew ("user/tests/type/shared/a", KEY_VALUE, "1", KEY_END);
+	Key * k2 = keyNew ("user/tests/type/shared/b", KEY_VALUE, "2", KEY_META, "check/type", "short", KEY_END);
+	Key * k3 = keyNew ("user/tests/type/shared/c", KEY_VALUE, "3", KEY_END);
+	Key * k4 = keyNew ("user/tests/type/shared/d", KEY_VALUE, "4", KEY_END);
+	keyCopyMeta (k1, spec, "check/type");
+	keyCopyMeta (k3, spec, "check/type");
+	keyCopyMeta (k4, spec, "check/type");
+
+	KeySet * conf = ksNew (0, KS_END);
+	KeySet * ks = ksNew (5, k1, k2, k3, k4, KS_END);
+	PLUGIN_OPEN ("type");
+
+	succeed_if (plugin->kdbGet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbGet failed");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbSet failed");
+
+	keySetString (k4, "x");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR,
+		    "kdbSet should fail for last key, even with cached types");
+
+	// types are cached by name, so changed metadata is never mistaken for the cached type
+	keySetString (k4, "4");
+	keyCopyMeta (k3, k2, "check/type");
+	keySetMeta (k4, "check/type", "boolean");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_ERROR, "kdbSet should fail for '4' as boolean");
+	keySetMeta (k4, "check/type", "short");
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == ELEKTRA_PLUGIN_STATUS_SUCCESS, "kdbSet failed after type changes");
+
+	keyDel (spec);
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 static void test_enum (void)
 {
 	Key * parentKey = keyNew ("user/tests/type/enum", KEY_VALUE, "", KEY_END);
@@ -788,6 +825,8 @@ int main (int argc, char ** argv)
 	test_string ();
 	test_wstring ();
 
+	test_sharedMeta ();
+
 	test_enum ();
 	test_enumMulti ();
 
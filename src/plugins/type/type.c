@@ -80,6 +80,33 @@ static const char * getTypeName (const Key * key)
 	return strlen (type) == 0 ? NULL : type;
 }
 
+/**
+ * @brief Remembers the last resolved type during a single kdbGet/kdbSet
+ *
+ * Consecutive keys very often have the same type (e.g. when their
+ * metadata was copied from a specification). In this case the lookup in
+ * elektraTypesList is replaced by a single comparison of the type names.
+ */
+typedef struct
+{
+	const Type * type;
+} TypeCache;
+
+static const Type * findCachedType (TypeCache * cache, const char * typeName)
+{
+	if (cache->type != NULL && strcmp (cache->type->name, typeName) == 0)
+	{
+		return cache->type;
+	}
+
+	const Type * type = findType (typeName);
+	if (type != NULL)
+	{
+		cache->type = type;
+	}
+	return type;
+}
+
 bool elektraTypeCheckType (const Key * key)
 {
 	const char * typeName = getTypeName (key);
@@ -288,6 +315,7 @@ int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 
 	ksRewind (returned);
 
+	TypeCache cache = { NULL };
 	Key * cur = NULL;
 	while ((cur = ksNext (returned)))
 	{
@@ -297,7 +325,7 @@ int elektraTypeGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 			return true;
 		}
 
-		const Type * type = findType (typeName);
+		const Type * type = findCachedType (&cache, typeName);
 		if (type == NULL)
 		{
 			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_TYPE, parentKey, "Unknown type '%s' for key '%s'", typeName, keyName (cur));
@@ -347,6 +375,7 @@ int elektraTypeSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 
 	ksRewind (returned);
 
+	TypeCache cache = { NULL };
 	Key * cur = NULL;
 	while ((cur = ksNext (returned)))
 	{
@@ -356,7 +385,7 @@ int elektraTypeSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 			return true;
 		}
 
-		const Type * type = findType (typeName);
+		const Type * type = findCachedType (&cache, typeName);
 		if (type == NULL)
 		{
 			ELEKTRA_SET_ERRORF (ELEKTRA_ERROR_TYPE, parentKey, "Unknown type '%s' for key '%s'", typeName, keyName (cur));
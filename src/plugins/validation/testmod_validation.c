@@ -246,6 +246,35 @@ void icase_test (void)
 	PLUGIN_CLOSE ();
 }
 
+void cache_test (void)
+{
+	Key * parentKey = keyNew ("user/tests/validation", KEY_VALUE, "", KEY_END);
+	Key * k1 = keyNew ("user/tests/validation/valid1", KEY_VALUE, "abc", KEY_META, "check/validation", "^abc$", KEY_END);
+	Key * k2 = keyNew ("user/tests/validation/valid2", KEY_VALUE, "abc", KEY_META, "check/validation", "^abc$", KEY_END);
+	Key * k3 = keyNew ("user/tests/validation/valid3", KEY_VALUE, "ABC", KEY_META, "check/validation", "^abc$", KEY_META,
+			   "check/validation/ignorecase", "", KEY_END);
+
+	KeySet * conf = ksNew (0, KS_END);
+	PLUGIN_OPEN ("validation");
+
+	KeySet * ks = ksNew (3, k1, k2, k3, KS_END);
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == (1), "kdbSet failed");
+
+	// the same expression is taken from the cache, the flags still have to apply
+	keySetString (k2, "ABC");
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == (-1), "kdbSet should fail, ignorecase is only set for valid3");
+
+	keySetString (k2, "abc");
+	ksRewind (ks);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == (1), "kdbSet failed");
+
+	ksDel (ks);
+	keyDel (parentKey);
+	PLUGIN_CLOSE ();
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -261,6 +290,7 @@ int main (int argc, char ** argv)
 	line_test ();
 	icase_test ();
 	invert_test ();
+	cache_test ();
 	print_result ("testmod_validation");
 
 	return nbError;
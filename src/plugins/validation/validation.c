@@ -28,6 +28,7 @@ int elektraValidationGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 			     keyNew ("system/elektra/modules/validation/exports", KEY_END),
 			     keyNew ("system/elektra/modules/validation/exports/get", KEY_FUNC, elektraValidationGet, KEY_END),
 			     keyNew ("system/elektra/modules/validation/exports/set", KEY_FUNC, elektraValidationSet, KEY_END),
+			     keyNew ("system/elektra/modules/validation/exports/close", KEY_FUNC, elektraValidationClose, KEY_END),
 			     keyNew ("system/elektra/modules/validation/exports/ksLookupRE", KEY_FUNC, ksLookupRE, KEY_END),
 			     keyNew ("system/elektra/modules/validation/exports/validateKey", KEY_FUNC, validateKey, KEY_END),
 #include "readme_validation.c"
@@ -36,7 +37,59 @@ int elektraValidationGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 	return 1;
 }
 
-static int validateKey (Key * key, Key * parentKey)
+static void freeRegex (regex_t * regex)
+{
+	regfree (regex);
+	elektraFree (regex);
+}
+
+/**
+ * @brief Compile a regular expression or take it from the cache
+ *
+ * @param cache the compiled expressions of the plugin instance, or NULL to
+ *        compile an expression the caller has to free with freeRegex()
+ *
+ * @return the compiled expression or NULL on errors (set in parentKey)
+ */
+static regex_t * compileRegex (KeySet * cache, const char * regexString, int cflags, Key * parentKey)
+{
+	Key * lookup = NULL;
+	if (cache)
+	{
+		char flags[32];
+		snprintf (flags, sizeof (flags), "%d", cflags);
+		lookup = keyNew ("/", KEY_CASCADING_NAME, KEY_END);
+		keyAddBaseName (lookup, flags);
+		keyAddBaseName (lookup, regexString);
+		Key * cached = ksLookup (cache, lookup, KDB_O_NONE);
+		if (cached)
+		{
+			keyDel (lookup);
+			return *(regex_t **) keyValue (cached);
+		}
+	}
+
+	regex_t * regex = elektraMalloc (sizeof (regex_t));
+	int ret = regcomp (regex, regexString, cflags);
+	if (ret != 0)
+	{
+		char buffer[1000];
+		regerror (ret, regex, buffer, 999);
+		ELEKTRA_SET_ERROR (41, parentKey, buffer);
+		freeRegex (regex);
+		keyDel (lookup);
+		return NULL;
+	}
+
+	if (cache)
+	{
+		keySetBinary (lookup, &regex, sizeof (regex));
+		ksAppendKey (cache, lookup);
+	}
+	return regex;
+}
+
+static int validateKeyCached (Key * key, Key * parentKey, KeySet * cache)
 {
 	const Key * regexMeta = keyGetMeta (key, "check/validation");
 
@@ -103,23 +156,19 @@ static int validateKey (Key * key, Key * parentKey)
 		regexString = (char *) keyString (regexMeta);
 	}
 
-	regex_t regex;
-	regmatch_t offsets;
-	int ret = regcomp (&regex, regexString, cflags);
-
-	if (ret != 0)
+	regex_t * regex = compileRegex (cache, regexString, cflags, parentKey);
+	if (freeString) elektraFree (regexString);
+	if (!regex)
 	{
-		char buffer[1000];
-		regerror (ret, &regex, buffer, 999);
-		ELEKTRA_SET_ERROR (41, parentKey, buffer);
-		regfree (&regex);
-		if (freeString) elektraFree (regexString);
 		return 0;
 	}
+
+	regmatch_t offsets;
+	int ret = REG_NOMATCH;
 	int match = 0;
 	if (!wordValidation)
 	{
-		ret = regexec (&regex, keyString (key), 1, &offsets, 0);
+		ret = regexec (regex, keyString (key), 1, &offsets, 0);
 		if (ret == 0) match = 1;
 	}
 	else
@@ -129,7 +178,7 @@ static int validateKey (Key * key, Key * parentKey)
 		char * string = (char *) keyString (key);
 		while ((token = strtok_r (string, " \t\n", &savePtr)) != NULL)
 		{
-			ret = regexec (&regex, token, 1, &offsets, 0);
+			ret = regexec (regex, token, 1, &offsets, 0);
 			if (ret == 0)
 			{
 				match = 1;
@@ -146,28 +195,50 @@ static int validateKey (Key * key, Key * parentKey)
 		if (msg)
 		{
 			ELEKTRA_SET_ERROR (42, parentKey, keyString (msg));
-			regfree (&regex);
-			if (freeString) elektraFree (regexString);
-			return 0;
 		}
 		else
 		{
 			char buffer[1000];
-			regerror (ret, &regex, buffer, 999);
+			regerror (ret, regex, buffer, 999);
 			ELEKTRA_SET_ERROR (42, parentKey, buffer);
-			regfree (&regex);
-			if (freeString) elektraFree (regexString);
-			return 0;
 		}
 	}
 
-	regfree (&regex);
-	if (freeString) elektraFree (regexString);
-	return 1;
+	if (!cache) freeRegex (regex);
+	return match;
+}
+
+static int validateKey (Key * key, Key * parentKey)
+{
+	return validateKeyCached (key, parentKey, NULL);
+}
+
+int elektraValidationClose (Plugin * handle, Key * errorKey ELEKTRA_UNUSED)
+{
+	KeySet * cache = elektraPluginGetData (handle);
+	if (cache)
+	{
+		Key * cur;
+		ksRewind (cache);
+		while ((cur = ksNext (cache)) != NULL)
+		{
+			freeRegex (*(regex_t **) keyValue (cur));
+		}
+		ksDel (cache);
+		elektraPluginSetData (handle, NULL);
+	}
+	return 1; /* success */
 }
 
-int elektraValidationSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey)
+int elektraValidationSet (Plugin * handle, KeySet * returned, Key * parentKey)
 {
+	KeySet * cache = elektraPluginGetData (handle);
+	if (!cache)
+	{
+		cache = ksNew (0, KS_END);
+		elektraPluginSetData (handle, cache);
+	}
+
 	Key * cur = 0;
 
 	while ((cur = ksNext (returned)) != 0)
@@ -175,7 +246,7 @@ int elektraValidationSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key
 		const Key * regexMeta = keyGetMeta (cur, "check/validation");
 
 		if (!regexMeta) continue;
-		int rc = validateKey (cur, parentKey);
+		int rc = validateKeyCached (cur, parentKey, cache);
 		if (!rc) return -1;
 	}
 
@@ -188,6 +259,7 @@ Plugin * ELEKTRA_PLUGIN_EXPORT
 	return elektraPluginExport("validation",
 			ELEKTRA_PLUGIN_GET,	&elektraValidationGet,
 			ELEKTRA_PLUGIN_SET,	&elektraValidationSet,
+			ELEKTRA_PLUGIN_CLOSE,	&elektraValidationClose,
 			ELEKTRA_PLUGIN_END);
 }
 
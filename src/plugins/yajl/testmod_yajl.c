@@ -17,6 +17,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <tests_internal.h>
 
@@ -678,6 +679,46 @@ void test_writing (void)
 	elektraPluginClose (plugin, 0);
 }
 
+void test_writeError (void)
+{
+	// every write to /dev/full fails with ENOSPC
+	if (access ("/dev/full", W_OK) != 0) return;
+
+	KeySet * conf = ksNew (0, KS_END);
+	Key * parentKey = keyNew ("user/tests/yajl", KEY_VALUE, "/dev/full", KEY_END);
+
+	Plugin * plugin = elektraPluginOpen ("yajl", modules, conf, 0);
+	exit_if_fail (plugin != 0, "could not open plugin");
+
+	// small documents fail when the file is closed
+	KeySet * ks = getStringKeys ();
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "kdbSet should fail on full disk");
+	succeed_if (keyGetMeta (parentKey, "error") != 0, "no error for full disk");
+	ksDel (ks);
+
+	keySetMeta (parentKey, "error", 0);
+	ks = ksNew (1, keyNew ("user/tests/yajl", KEY_VALUE, "top level value", KEY_END), KS_END);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "kdbSet of single value should fail on full disk");
+	succeed_if (keyGetMeta (parentKey, "error") != 0, "no error for full disk");
+	ksDel (ks);
+
+	// large documents fail while they are streamed
+	keySetMeta (parentKey, "error", 0);
+	ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 10000; ++i)
+	{
+		snprintf (name, sizeof (name), "user/tests/yajl/large/key%d", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "a value of the large document", KEY_END));
+	}
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == -1, "kdbSet of large document should fail on full disk");
+	succeed_if (keyGetMeta (parentKey, "error") != 0, "no error for full disk");
+	ksDel (ks);
+
+	keyDel (parentKey);
+	elektraPluginClose (plugin, 0);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("YAJL       TESTS\n");
@@ -692,6 +733,7 @@ int main (int argc, char ** argv)
 	test_reverseLevel ();
 	test_countLevel ();
 	test_writing ();
+	test_writeError ();
 
 	test_json ("yajl/testdata_null.json", getNullKeys (), ksNew (0, KS_END));
 	test_json ("yajl/testdata_boolean.json", getBooleanKeys (), ksNew (0, KS_END));
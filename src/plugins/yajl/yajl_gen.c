@@ -226,28 +226,25 @@ int elektraGenEmpty (yajl_gen g, KeySet * returned, Key * parentKey)
 	return did_something;
 }
 
-int elektraGenWriteFile (yajl_gen g, Key * parentKey)
+/**
+ * @brief Write the generated text to the file
+ *
+ * @param g the generator whose buffer should be written
+ * @param fp the file to write to
+ * @param force write even if the buffer is still small
+ *
+ * @retval 0 on success
+ * @retval -1 if the text could not be written, errno is set
+ */
+static int elektraGenFlush (yajl_gen g, FILE * fp, int force)
 {
-	int errnosave = errno;
-	FILE * fp = fopen (keyString (parentKey), "w");
-
-	if (!fp)
-	{
-		ELEKTRA_SET_ERROR_SET (parentKey);
-		errno = errnosave;
-		return -1;
-	}
-
 	const unsigned char * buf;
 	yajl_size_type len;
 	yajl_gen_get_buf (g, &buf, &len);
-	fwrite (buf, 1, len, fp);
+	if (!force && len < ELEKTRA_YAJL_FLUSH_SIZE) return 0;
+	if (fwrite (buf, 1, len, fp) != len) return -1;
 	yajl_gen_clear (g);
-
-	fclose (fp);
-
-	errno = errnosave;
-	return 1; /* success */
+	return 0;
 }
 
 static void elektraCheckForEmptyArray (KeySet * ks)
@@ -288,55 +285,75 @@ int elektraYajlSet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 
 	elektraCheckForEmptyArray (returned);
 
+	Key * cur = 0;
 	if (ksGetSize (returned) == 1 && !strcmp (keyName (parentKey), keyName (ksHead (returned))) &&
 	    keyGetValueSize (ksHead (returned)) > 1)
 	{
 		elektraGenValue (g, parentKey, ksHead (returned));
-		int ret = elektraGenWriteFile (g, parentKey);
-		yajl_gen_free (g);
-		return ret;
 	}
-
-	if (elektraGenEmpty (g, returned, parentKey))
+	else if (!elektraGenEmpty (g, returned, parentKey))
 	{
-		int ret = elektraGenWriteFile (g, parentKey);
-		yajl_gen_free (g);
-		return ret;
+		ksRewind (returned);
+		cur = elektraNextNotBelow (returned);
+		if (!cur)
+		{
+			// empty config should be handled by resolver
+			// (e.g. remove file)
+			yajl_gen_free (g);
+			return 0;
+		}
 	}
 
-	ksRewind (returned);
-	Key * cur = elektraNextNotBelow (returned);
-	if (!cur)
+	int errnosave = errno;
+	FILE * fp = fopen (keyString (parentKey), "w");
+	if (!fp)
 	{
-		// empty config should be handled by resolver
-		// (e.g. remove file)
+		ELEKTRA_SET_ERROR_SET (parentKey);
 		yajl_gen_free (g);
-		return 0;
+		errno = errnosave;
+		return -1;
 	}
 
-	ELEKTRA_LOG_DEBUG ("parentKey: %s, cur: %s", keyName (parentKey), keyName (cur));
-	elektraGenOpenInitial (g, parentKey, cur);
-
-	Key * next = 0;
-	while ((next = elektraNextNotBelow (returned)) != 0)
+	int ret = 0;
+	if (cur)
 	{
-		elektraGenValue (g, parentKey, cur);
-		elektraGenClose (g, cur, next);
+		ELEKTRA_LOG_DEBUG ("parentKey: %s, cur: %s", keyName (parentKey), keyName (cur));
+		elektraGenOpenInitial (g, parentKey, cur);
 
-		ELEKTRA_LOG_DEBUG ("ITERATE: %s next: %s", keyName (cur), keyName (next));
-		elektraGenOpen (g, cur, next);
+		Key * next = 0;
+		while (ret == 0 && (next = elektraNextNotBelow (returned)) != 0)
+		{
+			elektraGenValue (g, parentKey, cur);
+			elektraGenClose (g, cur, next);
 
-		cur = next;
-	}
+			ELEKTRA_LOG_DEBUG ("ITERATE: %s next: %s", keyName (cur), keyName (next));
+			elektraGenOpen (g, cur, next);
 
-	ELEKTRA_LOG_DEBUG ("leaving loop: %s", keyName (cur));
+			// stream the document instead of keeping all of it in memory
+			ret = elektraGenFlush (g, fp, 0);
 
-	elektraGenValue (g, parentKey, cur);
+			cur = next;
+		}
 
-	elektraGenCloseFinally (g, cur, parentKey);
+		ELEKTRA_LOG_DEBUG ("leaving loop: %s", keyName (cur));
 
-	int ret = elektraGenWriteFile (g, parentKey);
+		elektraGenValue (g, parentKey, cur);
+
+		elektraGenCloseFinally (g, cur, parentKey);
+	}
+
+	if (ret == 0) ret = elektraGenFlush (g, fp, 1);
+	// fclose writes what is still buffered, so its errors count too
+	if (fclose (fp) != 0) ret = -1;
 	yajl_gen_free (g);
 
-	return ret;
+	if (ret == -1)
+	{
+		ELEKTRA_SET_ERROR_SET (parentKey);
+		errno = errnosave;
+		return -1;
+	}
+
+	errno = errnosave;
+	return 1; /* success */
 }
@@ -24,6 +24,11 @@
 #include "iterator.h"
 #include "name.h"
 
+/**
+ * Size of generated text after which it is written to the file
+ */
+#define ELEKTRA_YAJL_FLUSH_SIZE 65536
+
 typedef enum
 {
 	/**
@@ -9,8 +9,12 @@
 #include "yajl.h"
 
 #include <errno.h>
+#include <fcntl.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <kdbconfig.h>
 #include <kdbease.h>
@@ -253,41 +257,41 @@ static int elektraYajlParseStartArray (void * ctx)
 /**
  * @brief Remove all non-leaf keys except for arrays
  *
+ * Decides for every key by looking at its direct successor only, so
+ * the KeySet is rebuilt in a single pass. The kept keys are already
+ * sorted, thus appending them to the pre-sized result never moves
+ * memory.
+ *
  * @param returned to remove the keys from
  */
 static void elektraYajlParseSuppressNonLeafKeys (KeySet * returned)
 {
-	ksRewind (returned);
-	Key * cur = ksNext (returned);
-	while (cur != NULL)
-	{
-		cursor_t cursor = ksGetCursor (returned);
+	const cursor_t size = ksGetSize (returned);
+	KeySet * leaves = ksNew (size, KS_END);
 
-		if (ksNext (returned) == NULL) break;
-
-		Key * peekDup = keyDup (ksCurrent (returned));
-		keySetBaseName (peekDup, 0);
+	for (cursor_t it = 0; it < size; ++it)
+	{
+		Key * cur = ksAtCursor (returned, it);
+		Key * next = it + 1 < size ? ksAtCursor (returned, it + 1) : NULL;
 
-		if (!strcmp (keyName (peekDup), keyName (cur)))
+		if (next && keyIsDirectBelow (cur, next) == 1)
 		{
-			const char * baseName = keyBaseName (ksCurrent (returned));
 			// TODO: Add test for empty array check
-			if (strcmp (baseName, "#0"))
+			if (strcmp (keyBaseName (next), "#0"))
 			{
 				ELEKTRA_LOG_DEBUG ("Removing non-leaf key %s", keyName (cur));
-				keyDel (ksLookup (returned, cur, KDB_O_POP));
-				ksSetCursor (returned, cursor);
-			}
-			else
-			{
-				// Set array key to NULL to avoid empty ___dirdata entries
-				keySetBinary (cur, NULL, 0);
+				continue;
 			}
+
+			// Set array key to NULL to avoid empty ___dirdata entries
+			keySetBinary (cur, NULL, 0);
 		}
 
-		keyDel (peekDup);
-		cur = ksCurrent (returned);
+		ksAppendKey (leaves, cur);
 	}
+
+	ksCopy (returned, leaves);
+	ksDel (leaves);
 }
 
 /**
@@ -331,6 +335,64 @@ static void elektraYajlParseSuppressEmptyMap (KeySet * returned, Key * parentKey
 	}
 }
 
+/**
+ * @brief Make the content of a file available in one buffer
+ *
+ * The parse callbacks temporarily terminate tokens in place, so the
+ * buffer must be writable and must have one more byte after its end.
+ * A private mapping provides both (the rest of the last page is zero)
+ * unless the file ends exactly at a page boundary, in which case the
+ * file is read into memory instead.
+ *
+ * @param fd the file to read
+ * @param size the size of the file
+ * @param[out] mapped set to 1 if the buffer was mapped
+ *
+ * @return the buffer to be freed with elektraYajlFreeFile() or NULL on error
+ */
+static unsigned char * elektraYajlReadFile (int fd, size_t size, int * mapped)
+{
+	long pageSize = sysconf (_SC_PAGESIZE);
+	if (size > 0 && pageSize > 0 && size % pageSize != 0)
+	{
+		void * data = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		if (data != MAP_FAILED)
+		{
+			*mapped = 1;
+			return data;
+		}
+	}
+
+	*mapped = 0;
+	unsigned char * data = elektraMalloc (size + 1);
+	size_t done = 0;
+	while (done < size)
+	{
+		ssize_t rd = read (fd, data + done, size - done);
+		if (rd == -1 && errno == EINTR) continue;
+		if (rd <= 0)
+		{
+			elektraFree (data);
+			return NULL;
+		}
+		done += rd;
+	}
+	data[size] = 0;
+	return data;
+}
+
+static void elektraYajlFreeFile (unsigned char * data, size_t size, int mapped)
+{
+	if (mapped)
+	{
+		munmap (data, size);
+	}
+	else
+	{
+		elektraFree (data);
+	}
+}
+
 static inline KeySet * elektraGetModuleConfig (void)
 {
 	return ksNew (30, keyNew ("system/elektra/modules/yajl", KEY_VALUE, "yajl plugin waits for your orders", KEY_END),
@@ -377,64 +439,65 @@ int elektraYajlGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * par
 #endif
 
 	int errnosave = errno;
-	unsigned char fileData[65536];
-	int done = 0;
-	FILE * fileHandle = fopen (keyString (parentKey), "r");
-	if (!fileHandle)
+	int fd = open (keyString (parentKey), O_RDONLY);
+	struct stat fileStat;
+	if (fd == -1 || fstat (fd, &fileStat) == -1)
 	{
-		yajl_free (hand);
 		ELEKTRA_SET_ERROR_GET (parentKey);
+		if (fd != -1) close (fd);
+		yajl_free (hand);
 		errno = errnosave;
 		return -1;
 	}
 
-	while (!done)
+	int mapped = 0;
+	size_t fileSize = fileStat.st_size;
+	unsigned char * fileData = elektraYajlReadFile (fd, fileSize, &mapped);
+	close (fd);
+	if (!fileData)
 	{
-		yajl_size_type rd = fread ((void *) fileData, 1, sizeof (fileData) - 1, fileHandle);
-		if (rd == 0)
-		{
-			if (!feof (fileHandle))
-			{
-				ELEKTRA_SET_ERROR (76, parentKey, keyString (parentKey));
-				fclose (fileHandle);
-				yajl_free (hand);
-				return -1;
-			}
-			done = 1;
-		}
-		fileData[rd] = 0;
+		ELEKTRA_SET_ERROR (76, parentKey, keyString (parentKey));
+		yajl_free (hand);
+		errno = errnosave;
+		return -1;
+	}
 
-		yajl_status stat;
-		if (done)
-		{
+	// the whole document is fed at once, so yajl never has to buffer tokens across chunks
+	yajl_status stat = yajl_status_ok;
+	if (fileSize > 0)
+	{
+		stat = yajl_parse (hand, fileData, fileSize);
+	}
+	int test_status = (stat != yajl_status_ok);
 #if YAJL_MAJOR == 1
-			stat = yajl_parse_complete (hand);
-#else
-			stat = yajl_complete_parse (hand);
+	test_status = test_status && (stat != yajl_status_insufficient_data);
 #endif
-		}
-		else
-		{
-			stat = yajl_parse (hand, fileData, rd);
-		}
-		int test_status = (stat != yajl_status_ok);
+	if (!test_status)
+	{
 #if YAJL_MAJOR == 1
-		test_status = test_status && (stat != yajl_status_insufficient_data);
+		stat = yajl_parse_complete (hand);
+		test_status = (stat != yajl_status_ok) && (stat != yajl_status_insufficient_data);
+#else
+		stat = yajl_complete_parse (hand);
+		test_status = (stat != yajl_status_ok);
 #endif
-		if (test_status)
-		{
-			unsigned char * str = yajl_get_error (hand, 1, fileData, rd);
-			ELEKTRA_SET_ERROR (77, parentKey, (char *) str);
-			yajl_free_error (hand, str);
-			yajl_free (hand);
-			fclose (fileHandle);
+	}
 
-			return -1;
-		}
+	if (test_status)
+	{
+		unsigned char * str = yajl_get_error (hand, 1, fileData, fileSize);
+		ELEKTRA_SET_ERROR (77, parentKey, (char *) str);
+		yajl_free_error (hand, str);
+		yajl_free (hand);
+		elektraYajlFreeFile (fileData, fileSize, mapped);
+		errno = errnosave;
+
+		return -1;
 	}
 
 	yajl_free (hand);
-	fclose (fileHandle);
+	elektraYajlFreeFile (fileData, fileSize, mapped);
+	errno = errnosave;
 	elektraYajlParseSuppressNonLeafKeys (returned);
 	elektraYajlParseSuppressEmptyMap (returned, parentKey);
 
@@ -15,6 +15,7 @@
 
 #include "cmdline.hpp"
 #include <kdb.hpp>
+#include <kdbproposal.h>
 #include <keysetio.hpp>
 
 using namespace kdb;
@@ -272,6 +273,28 @@ bool CompleteCommand::shallShowNextLevel (string const & argument)
 	return it != argument.rend () && (*it) == '/' && ((++it) == argument.rend () || (*it) != '\\');
 }
 
+bool CompleteCommand::hasKeysBelow (KeySet const & ks, Key const & key)
+{
+	// like cut, a cascading key stands for the keys of all namespaces
+	vector<string> names{ key.getName () };
+	if (key.isCascading ())
+	{
+		for (string ns : { "spec", "proc", "dir", "user", "system" })
+		{
+			names.push_back (ns + key.getName ());
+		}
+	}
+
+	for (string const & name : names)
+	{
+		Key root (name, KEY_END);
+		size_t end;
+		ssize_t start = ckdb::ksFindHierarchy (ks.getKeySet (), root.getKey (), &end);
+		if (start >= 0 && static_cast<size_t> (start) < end) return true;
+	}
+	return false;
+}
+
 void CompleteCommand::addMountpoints (KeySet & ks, Key const & root, Cmdline const & cl)
 {
 	KDB kdb;
@@ -288,7 +311,7 @@ void CompleteCommand::addMountpoints (KeySet & ks, Key const & root, Cmdline con
 			const string actualName = mountpoints.lookup (mountpoint.getFullName () + "/mountpoint").getString ();
 			Key mountpointKey (actualName, KEY_END);
 			// If the mountpoint already has some contents, its expanded with a namespace, so leave it out then
-			if (mountpointKey.isBelow (root) && !KeySet (ks).cut (mountpointKey).size ())
+			if (mountpointKey.isBelow (root) && !hasKeysBelow (ks, mountpointKey))
 			{
 				ks.append (mountpointKey);
 			}
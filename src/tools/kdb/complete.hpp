@@ -62,6 +62,7 @@ private:
 	const kdb::Key getParentKey (kdb::Key const & key);
 	kdb::KeySet getKeys (kdb::Key root, bool cutAtRoot, Cmdline const & cl);
 	bool shallShowNextLevel (std::string const & argument);
+	bool hasKeysBelow (kdb::KeySet const & ks, kdb::Key const & key);
 
 	void addMountpoints (kdb::KeySet & ks, kdb::Key const & root, Cmdline const & cl);
 	void addNamespaces (std::map<kdb::Key, std::pair<int, int>> & hierarchy, Cmdline const & cl);
@@ -54,6 +54,7 @@
 #include <sget.hpp>
 #include <shell.hpp>
 #include <specmount.hpp>
+#include <stats.hpp>
 #include <test.hpp>
 #include <umount.hpp>
 #include <validation.hpp>
@@ -121,6 +122,7 @@ public:
 		m_factory.insert (std::make_pair ("gumount", std::make_shared<Cnstancer<GlobalUmountCommand>> ()));
 		m_factory.insert (std::make_pair ("list-commands", std::make_shared<Cnstancer<ListCommandsCommand>> ()));
 		m_factory.insert (std::make_pair ("gen", std::make_shared<Cnstancer<GenCommand>> ()));
+		m_factory.insert (std::make_pair ("stats", std::make_shared<Cnstancer<StatsCommand>> ()));
 	}
 
 	std::vector<std::string> getPrettyCommands () const
@@ -35,16 +35,16 @@ int FindCommand::execute (Cmdline const & cl)
 	if (cl.verbose) cout << "size of all keys: " << ks.size () << endl;
 
 	KeySet part;
-	std::smatch match;
 
 	try
 	{
-		std::regex reg (cl.arguments[0]);
+		// the expression is matched against every key, so spend more time on compiling it
+		std::regex reg (cl.arguments[0], std::regex::ECMAScript | std::regex::optimize | std::regex::nosubs);
 
 		for (const auto & it : ks)
 		{
-			std::string name = it.getName ();
-			if (std::regex_search (name, match, reg))
+			const char * name = ckdb::keyName (it.getKey ());
+			if (std::regex_search (name, reg))
 			{
 				part.append (it);
 			}
@@ -0,0 +1,79 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <stats.hpp>
+
+#include <cmdline.hpp>
+#include <kdb.hpp>
+#include <kdbproposal.h>
+
+#include <iostream>
+
+using namespace std;
+using namespace kdb;
+
+StatsCommand::StatsCommand ()
+{
+}
+
+int StatsCommand::execute (Cmdline const & cl)
+{
+	if (cl.arguments.size () < 1 || cl.arguments.size () > 2)
+	{
+		throw invalid_argument ("Need 1 or 2 argument(s)");
+	}
+
+	Key root = cl.createKey (0);
+	size_t repeat = 1;
+	if (cl.arguments.size () == 2)
+	{
+		repeat = stoul (cl.arguments[1]);
+	}
+
+	Key errorKey (root.getName (), KEY_END);
+	ckdb::KDB * handle = ckdb::kdbOpen (errorKey.getKey ());
+	if (!handle)
+	{
+		throw KDBException (errorKey);
+	}
+
+	ckdb::elektraStatsEnable (handle, 1);
+
+	for (size_t i = 0; i < repeat; ++i)
+	{
+		KeySet ks;
+		if (ckdb::kdbGet (handle, ks.getKeySet (), root.getKey ()) == -1)
+		{
+			ckdb::kdbClose (handle, errorKey.getKey ());
+			throw KDBException (root);
+		}
+	}
+
+	KeySet stats;
+	Key statsRoot ("system/elektra/stats", KEY_END);
+	int ret = ckdb::kdbGet (handle, stats.getKeySet (), statsRoot.getKey ());
+	ckdb::kdbClose (handle, errorKey.getKey ());
+	if (ret == -1)
+	{
+		throw KDBException (statsRoot);
+	}
+
+	printWarnings (cerr, root, cl.verbose, cl.debug);
+
+	for (Key k : stats.cut (statsRoot))
+	{
+		if (k == statsRoot || k.getString ().empty ()) continue;
+		cout << k.getName ().substr (statsRoot.getName ().size () + 1) << " = " << k.getString () << endl;
+	}
+
+	return 0;
+}
+
+StatsCommand::~StatsCommand ()
+{
+}
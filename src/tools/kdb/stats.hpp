@@ -0,0 +1,50 @@
+/**
+ * @file
+ *
+ * @brief
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#ifndef STATS_HPP
+#define STATS_HPP
+
+#include "coloredkdbio.hpp"
+#include <command.hpp>
+
+class StatsCommand : public Command
+{
+public:
+	StatsCommand ();
+	~StatsCommand ();
+
+	virtual std::string getShortOptions () override
+	{
+		return "v";
+	}
+
+	virtual std::string getSynopsis () override
+	{
+		return "<name> [<repeat>]";
+	}
+
+	virtual std::string getShortHelpText () override
+	{
+		return "Print where kdbGet spends its time.";
+	}
+
+	virtual std::string getLongHelpText () override
+	{
+		return "Calls kdbGet for the given name (repeat times, default 1)\n"
+		       "with statistics enabled and prints the statistics\n"
+		       "of every backend and plugin.\n"
+		       "\n"
+		       "E.g.\n"
+		       "Print the statistics of ten kdbGet of user:\n"
+		       " kdb stats user 10\n";
+	}
+
+	virtual int execute (Cmdline const & cmdline) override;
+};
+
+#endif
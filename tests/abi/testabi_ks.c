@@ -3207,6 +3207,93 @@ static void test_ksAppend3 (void)
 	ksDel (ks);
 }
 
+static void test_ksAppendMerge (void)
+{
+	printf ("Test appending large keysets\n");
+
+	char name[64];
+	KeySet * ks = ksNew (0, KS_END);
+	KeySet * toAppend = ksNew (0, KS_END);
+	for (int i = 0; i < 100; i += 2)
+	{
+		snprintf (name, sizeof (name), "user/merge/%03d", i);
+		ksAppendKey (ks, keyNew (name, KEY_VALUE, "ks", KEY_END));
+	}
+	for (int i = 3; i < 100; i += 3)
+	{
+		snprintf (name, sizeof (name), "user/merge/%03d", i);
+		ksAppendKey (toAppend, keyNew (name, KEY_VALUE, "toAppend", KEY_END));
+	}
+	Key * same = ksLookupByName (ks, "user/merge/000", 0);
+	ksAppendKey (toAppend, same);
+	Key * replaced = ksLookupByName (ks, "user/merge/006", 0);
+	keyIncRef (replaced);
+
+	succeed_if (ksAppend (ks, toAppend) == 67, "wrong size after merge");
+	succeed_if (ksGetSize (toAppend) == 34, "toAppend was modified");
+	succeed_if_same_string (keyName (ksCurrent (ks)), "user/merge/099");
+	succeed_if (ksLookupByName (ks, "user/merge/000", 0) == same, "same key was replaced");
+	succeed_if (keyGetRef (same) == 2, "ref of same key wrong");
+	succeed_if (keyGetRef (replaced) == 1, "ref of replaced key wrong");
+	keyDecRef (replaced);
+	keyDel (replaced);
+
+	int expected = 0;
+	for (cursor_t c = 0; c < ksGetSize (ks); ++c)
+	{
+		Key * cur = ksAtCursor (ks, c);
+		while (expected % 2 != 0 && expected % 3 != 0)
+			++expected;
+		snprintf (name, sizeof (name), "user/merge/%03d", expected);
+		succeed_if_same_string (keyName (cur), name);
+		succeed_if_same_string (keyString (cur), expected % 3 == 0 && expected != 0 ? "toAppend" : "ks");
+		succeed_if (keyGetRef (cur) == (expected % 3 == 0 ? 2 : 1), "ref wrong");
+		++expected;
+	}
+	succeed_if (ksAtCursor (ks, ksGetSize (ks)) == 0, "keyset not null terminated");
+	succeed_if (ksLookupByName (ks, "user/merge/051", 0) != 0, "merged key not found by lookup");
+
+	ksDel (toAppend);
+	ksDel (ks);
+}
+
+static void test_ksAppendSameCursor (void)
+{
+	printf ("Test cursor after appending the same keys again\n");
+
+	char name[64];
+	KeySet * ks = ksNew (0, KS_END);
+	for (int i = 0; i < 40; ++i)
+	{
+		snprintf (name, sizeof (name), "user/same/%03d", i);
+		ksAppendKey (ks, keyNew (name, KEY_END));
+	}
+	Key * last = ksLookupByName (ks, "user/same/030", 0);
+
+	ksRewind (ks);
+	succeed_if (ksAppendKey (ks, last) == 40, "wrong size after appending the same key");
+	succeed_if (ksCurrent (ks) == last, "cursor not set to the same key");
+
+	// large enough to be merged
+	KeySet * toAppend = ksNew (0, KS_END);
+	for (int i = 10; i <= 30; ++i)
+	{
+		snprintf (name, sizeof (name), "user/same/%03d", i);
+		ksAppendKey (toAppend, ksLookupByName (ks, name, 0));
+	}
+	ksRewind (ks);
+	succeed_if (ksAppend (ks, toAppend) == 40, "wrong size after merging the same keys");
+	succeed_if (ksCurrent (ks) == last, "cursor not set to the last merged key");
+
+	ksAppendKey (toAppend, keyNew ("user/same/005/sub", KEY_END));
+	ksRewind (ks);
+	succeed_if (ksAppend (ks, toAppend) == 41, "wrong size after merge");
+	succeed_if (ksCurrent (ks) == last, "cursor not set to the last merged key");
+
+	ksDel (toAppend);
+	ksDel (ks);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -3263,6 +3350,8 @@ int main (int argc, char ** argv)
 	test_nsLookup ();
 	test_ksAppend2 ();
 	test_ksAppend3 ();
+	test_ksAppendMerge ();
+	test_ksAppendSameCursor ();
 
 	// BUGS:
 	// test_ksLookupValue();
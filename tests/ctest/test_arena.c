@@ -0,0 +1,170 @@
+/**
+ * @file
+ *
+ * @brief Tests for arena allocation of keys
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <tests_internal.h>
+
+static void test_arenaName (void)
+{
+	printf ("Test names of arena keys\n");
+
+	const char * names[] = { "user",	   "user/a",	   "system/a/b/c",   "/cascading/key", "spec/#0/x", "dir/a b/%",
+				 "user/a/../b", "user//a/./b/", "user/esc\\/aped", "user:owner/a",   "proc/.a",   0 };
+
+	ElektraArena * arena = elektraArenaNew (0);
+	for (size_t i = 0; names[i]; ++i)
+	{
+		Key * expected = keyNew (names[i], KEY_END);
+		Key * k = elektraArenaKeyNew (arena, names[i], 0, 0);
+		exit_if_fail (k, "could not create arena key");
+
+		succeed_if_same_string (keyName (k), keyName (expected));
+		succeed_if (keyGetUnescapedNameSize (k) == keyGetUnescapedNameSize (expected), "unescaped size differs");
+		succeed_if (!memcmp (keyUnescapedName (k), keyUnescapedName (expected), keyGetUnescapedNameSize (k)),
+			    "unescaped name differs");
+		succeed_if (keyCmp (k, expected) == 0, "keys do not compare equal");
+
+		keyDel (expected);
+		keyDel (k);
+	}
+	elektraArenaDel (arena);
+}
+
+static void test_arenaKeySet (void)
+{
+	printf ("Test keyset of arena keys\n");
+
+	ElektraArena * arena = elektraArenaNew (64);
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	char value[64];
+	for (int i = 0; i < 1000; ++i)
+	{
+		snprintf (name, sizeof (name), "user/arena/%04d", i);
+		snprintf (value, sizeof (value), "value %d", i);
+		ksAppendKey (ks, elektraArenaKeyNew (arena, name, value, strlen (value) + 1));
+	}
+	Key * big = elektraArenaKeyNew (arena, "user/arena/big", 0, 0);
+	char * bigValue = elektraCalloc (10000);
+	memset (bigValue, 'x', 9999);
+	keySetString (big, bigValue);
+	ksAppendKey (ks, big);
+	elektraArenaDel (arena);
+
+	succeed_if (ksGetSize (ks) == 1001, "wrong size");
+	succeed_if_same_string (keyString (ksLookupByName (ks, "user/arena/0042", 0)), "value 42");
+	succeed_if_same_string (keyString (big), bigValue);
+	elektraFree (bigValue);
+
+	Key * k = ksLookupByName (ks, "user/arena/0100", 0);
+	keySetString (k, "a much longer value than before");
+	succeed_if_same_string (keyString (k), "a much longer value than before");
+	keySetMeta (k, "meta", "data");
+	succeed_if_same_string (keyString (keyGetMeta (k, "meta")), "data");
+
+	// keys outlive the keyset they were created for
+	Key * kept = ksLookupByName (ks, "user/arena/0500", 0);
+	keyIncRef (kept);
+	Key * dup = keyDup (ksLookupByName (ks, "user/arena/0501", 0));
+	ksDel (ks);
+
+	succeed_if_same_string (keyName (kept), "user/arena/0500");
+	succeed_if_same_string (keyString (kept), "value 500");
+	succeed_if_same_string (keyName (dup), "user/arena/0501");
+	succeed_if_same_string (keyString (dup), "value 501");
+	keyDecRef (kept);
+	keyDel (kept);
+	keyDel (dup);
+}
+
+static void test_arenaBlocks (void)
+{
+	printf ("Test keys of different blocks\n");
+
+	ElektraArena * arena = elektraArenaNew (256);
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 10000; ++i)
+	{
+		snprintf (name, sizeof (name), "user/arena/%05d", i);
+		ksAppendKey (ks, elektraArenaKeyNew (arena, name, name, strlen (name) + 1));
+	}
+
+	// keys of the first and the last block outlive the others
+	Key * first = ksLookupByName (ks, "user/arena/00000", 0);
+	Key * last = ksLookupByName (ks, "user/arena/09999", 0);
+	keyIncRef (first);
+	keyIncRef (last);
+	ksDel (ks);
+
+	Key * late = elektraArenaKeyNew (arena, "user/arena/late", "late", sizeof ("late"));
+	elektraArenaDel (arena);
+
+	succeed_if_same_string (keyString (first), "user/arena/00000");
+	succeed_if_same_string (keyString (last), "user/arena/09999");
+	succeed_if_same_string (keyString (late), "late");
+
+	keyDecRef (last);
+	keyDel (last);
+	succeed_if_same_string (keyName (late), "user/arena/late");
+	keyDel (late);
+	keyDecRef (first);
+	keyDel (first);
+}
+
+static void test_arenaRename (void)
+{
+	printf ("Test renaming arena keys\n");
+
+	ElektraArena * arena = elektraArenaNew (0);
+
+	Key * k = elektraArenaKeyNew (arena, "user/tests/rename", "value", sizeof ("value"));
+	keyAddBaseName (k, "base");
+	succeed_if_same_string (keyName (k), "user/tests/rename/base");
+	keyDel (k);
+
+	k = elektraArenaKeyNew (arena, "user/tests/rename", 0, 0);
+	keyAddName (k, "more/levels");
+	succeed_if_same_string (keyName (k), "user/tests/rename/more/levels");
+	keyDel (k);
+
+	k = elektraArenaKeyNew (arena, "user/tests/rename/a_long_base_name", 0, 0);
+	keySetBaseName (k, "b");
+	succeed_if_same_string (keyName (k), "user/tests/rename/b");
+	keySetName (k, "system/other");
+	succeed_if_same_string (keyName (k), "system/other");
+	keyDel (k);
+
+	k = elektraArenaKeyNew (arena, "user/tests/copy", "value", sizeof ("value"));
+	Key * source = keyNew ("user/tests/source", KEY_VALUE, "source", KEY_END);
+	keyCopy (k, source);
+	succeed_if_same_string (keyName (k), "user/tests/source");
+	succeed_if_same_string (keyString (k), "source");
+	keyDel (source);
+	keyDel (k);
+
+	succeed_if (elektraArenaKeyNew (arena, "invalid", 0, 0) == 0, "invalid name should fail");
+
+	elektraArenaDel (arena);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("ARENA      TESTS\n");
+	printf ("==================\n\n");
+
+	init (argc, argv);
+
+	test_arenaName ();
+	test_arenaKeySet ();
+	test_arenaBlocks ();
+	test_arenaRename ();
+
+	printf ("\ntest_arena RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
+
+	return nbError;
+}
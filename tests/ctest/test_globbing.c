@@ -161,6 +161,42 @@ static void test_keyset (void)
 	ksDel (actual);
 }
 
+static void test_keyset_prefix (void)
+{
+	printf ("keyset prefix\n");
+
+	KeySet * test = ksNew (7, keyNew (BASE_KEY, KEY_END), keyNew (BASE_KEY "/yes", KEY_END), keyNew (BASE_KEY "/yes/a", KEY_END),
+			       keyNew (BASE_KEY "/yes/b/c", KEY_END), keyNew (BASE_KEY "x/yes/a", KEY_END),
+			       keyNew ("system/tests/globbing/yes/a", KEY_END), keyNew ("user/tests/a", KEY_END), KS_END);
+
+	KeySet * actual = ksNew (0, KS_END);
+	succeed_if (elektraKsGlob (actual, test, BASE_KEY "/yes/__") == 3, "wrong number of keys for prefix pattern");
+	succeed_if (ksLookupByName (actual, BASE_KEY "/yes", 0) != NULL, "key of prefix not found");
+	succeed_if (ksLookupByName (actual, BASE_KEY "/yes/b/c", 0) != NULL, "key below prefix not found");
+	ksDel (actual);
+
+	actual = ksNew (0, KS_END);
+	succeed_if (elektraKsGlob (actual, test, BASE_KEY "/__") == 4, "wrong number of keys for prefix pattern");
+	succeed_if (ksLookupByName (actual, BASE_KEY, 0) != NULL, "key of prefix not found");
+	ksDel (actual);
+
+	actual = ksNew (0, KS_END);
+	succeed_if (elektraKsGlob (actual, test, "*/tests/globbing/yes/a") == 2, "wrong number of keys for wildcard namespace");
+	succeed_if (ksLookupByName (actual, "system/tests/globbing/yes/a", 0) != NULL, "system key not found");
+	ksDel (actual);
+
+	actual = ksNew (0, KS_END);
+	succeed_if (elektraKsGlob (actual, test, "user/tests/_") == 2, "wrong number of keys for underscore");
+	succeed_if (ksLookupByName (actual, "user/tests/a", 0) != NULL, "key not found");
+	ksDel (actual);
+
+	actual = ksNew (0, KS_END);
+	succeed_if (elektraKsGlob (actual, test, BASE_KEY "/no/*") == 0, "should not match anything");
+	ksDel (actual);
+
+	ksDel (test);
+}
+
 int main (int argc, char ** argv)
 {
 	printf (" GLOBBING   TESTS\n");
@@ -174,6 +210,7 @@ int main (int argc, char ** argv)
 	test_underscore ();
 	test_prefix ();
 	test_keyset ();
+	test_keyset_prefix ();
 
 	print_result ("test_globbing");
 
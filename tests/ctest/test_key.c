@@ -1644,6 +1644,58 @@ static void test_keyFlags (void)
 	keyDel (key2);
 }
 
+static void test_keyCanonicalName (void)
+{
+	printf ("test canonical key names\n");
+
+	succeed_if (elektraCanonicalKeyNameSize ("user") == sizeof ("user"), "namespace is canonical");
+	succeed_if (elektraCanonicalKeyNameSize ("system/a/b") == sizeof ("system/a/b"), "plain name is canonical");
+	succeed_if (elektraCanonicalKeyNameSize ("/a/#0/b c") == sizeof ("/a/#0/b c"), "cascading name is canonical");
+	succeed_if (elektraCanonicalKeyNameSize ("spec/a/.b/c..") == sizeof ("spec/a/.b/c.."), "dots in parts are canonical");
+
+	const char * notCanonical[] = { "",	    "/",	  "user/",	 "user//a",   "user/a/",  "user/./a",   "user/a/..",
+					"user/a\\/b", "user/%",	  "user:owner/a", "users/a",   "usr/a",	"dir/a\\", "meta",
+					"system/a//b",  "proc/a/%b/c", 0 };
+	for (size_t i = 0; notCanonical[i]; ++i)
+	{
+		succeed_if (elektraCanonicalKeyNameSize (notCanonical[i]) == 0, "name should not be canonical");
+	}
+
+	// the fast path must produce the same names as the general one (which the trailing / forces)
+	const char * names[] = { "user", "system/a/b", "/a/#0/b c", "spec/a/.b/c..", "dir/x", "proc/a/b/c/d/e", 0 };
+	char slowName[64];
+	for (size_t i = 0; names[i]; ++i)
+	{
+		snprintf (slowName, sizeof (slowName), "%s/", names[i]);
+		Key * fast = keyNew (names[i], KEY_END);
+		Key * slow = keyNew (slowName, KEY_END);
+
+		succeed_if_same_string (keyName (fast), keyName (slow));
+		succeed_if (keyGetNameSize (fast) == keyGetNameSize (slow), "name size differs");
+		succeed_if (keyGetUnescapedNameSize (fast) == keyGetUnescapedNameSize (slow), "unescaped size differs");
+		succeed_if (!memcmp (keyUnescapedName (fast), keyUnescapedName (slow), keyGetUnescapedNameSize (fast)),
+			    "unescaped name differs");
+
+		succeed_if (keyAddName (fast, "x/y") == keyAddName (slow, "x/y/"), "keyAddName returned different sizes");
+		succeed_if_same_string (keyName (fast), keyName (slow));
+		succeed_if (keyGetUnescapedNameSize (fast) == keyGetUnescapedNameSize (slow), "unescaped size differs");
+		succeed_if (!memcmp (keyUnescapedName (fast), keyUnescapedName (slow), keyGetUnescapedNameSize (fast)),
+			    "unescaped name differs");
+
+		keyDel (fast);
+		keyDel (slow);
+	}
+
+	Key * key = keyNew ("/", KEY_END);
+	succeed_if (keyAddName (key, "a/b") == sizeof ("/a/b"), "wrong size for cascading root");
+	succeed_if_same_string (keyName (key), "/a/b");
+	keySetName (key, "user/esc\\/aped");
+	succeed_if (keyAddName (key, "a") == sizeof ("user/esc\\/aped/a"), "wrong size for escaped name");
+	succeed_if_same_string (keyName (key), "user/esc\\/aped/a");
+	succeed_if_same_string (keyBaseName (key), "a");
+	keyDel (key);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KEY      TESTS\n");
@@ -1668,6 +1720,7 @@ int main (int argc, char ** argv)
 	test_elektraKeySetName ();
 	test_keyLock ();
 	test_keyAddName ();
+	test_keyCanonicalName ();
 	test_keyNeedSync ();
 	test_keyCopy ();
 	test_keyFixedNew ();
@@ -348,6 +348,33 @@ void test_Invalidate (void)
 	}
 }
 
+void test_largeKeySet (void)
+{
+	// large enough to be built by several threads
+	const size_t n = 4 * KDB_OPMPHM_PARALLEL_MIN_N;
+	KeySet * ks = ksNew (n, KS_END);
+	char name[64];
+	for (size_t i = 0; i < n; ++i)
+	{
+		snprintf (name, sizeof (name), "/large/dir%zu/key%zu", i % 100, i);
+		ksAppendKey (ks, keyNew (name, KEY_END));
+	}
+
+	Key * found = ksLookupByName (ks, "/large/nothere", KDB_O_OPMPHM);
+	succeed_if (!found, "key found");
+	exit_if_fail (ks->opmphm, "build opmphm");
+	succeed_if (opmphmIsBuild (ks->opmphm), "build opmphm");
+
+	size_t notFound = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (ksLookup (ks, ks->array[i], KDB_O_OPMPHM) != ks->array[i]) ++notFound;
+	}
+	succeed_if (notFound == 0, "key not found");
+
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KS OPMPHM      TESTS\n");
@@ -358,6 +385,7 @@ int main (int argc, char ** argv)
 	test_keyNotFound ();
 	test_Copy ();
 	test_Invalidate ();
+	test_largeKeySet ();
 
 	print_result ("test_ks_opmphm");
 
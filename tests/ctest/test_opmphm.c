@@ -61,29 +61,29 @@ static void test_opmphmGraphNew (void)
 				opmphm->hashFunctionSeeds[r] = 0;
 				succeed_if (opmphm->hashFunctionSeeds[r] == 0, "check access opmphm->hashFunctionSeeds");
 			}
-			// check access OpmphmEdge->vertices ,OpmphmEdge->nextEdge and graph->removeSequence
+			// check access OpmphmEdge->vertices, graph->removeSequence and graph->removed
 			for (size_t i = 0; i < n; ++i)
 			{
 				for (uint8_t r = 0; r < rUniPar; ++r)
 				{
 					graph->edges[i].vertices[r] = i * r;
-					graph->edges[i].nextEdge[r] = i * r;
 				}
 				graph->removeSequence[i] = i;
+				graph->removed[i] = i % 2;
 			}
 			for (size_t i = 0; i < n; ++i)
 			{
 				for (uint8_t r = 0; r < rUniPar; ++r)
 				{
 					succeed_if (graph->edges[i].vertices[r] == i * r, "check access OpmphmEdge->vertices");
-					succeed_if (graph->edges[i].nextEdge[r] == i * r, "check access OpmphmEdge->nextEdge");
 				}
 				succeed_if (graph->removeSequence[i] == i, "check access graph->removeSequence");
+				succeed_if (graph->removed[i] == i % 2, "check access graph->removed");
 			}
 			// check vertices initialization
 			for (size_t i = 0; i < componentSize * rUniPar; ++i)
 			{
-				succeed_if (graph->vertices[i].firstEdge == 0, "check vertices initialization");
+				succeed_if (graph->vertices[i].edgesXor == 0, "check vertices initialization");
 				succeed_if (graph->vertices[i].degree == 0, "check vertices initialization");
 			}
 
@@ -377,6 +377,64 @@ static void test_acyclicReverseOrder (void)
 	}
 }
 
+static void test_acyclicLarge (void)
+{
+	/**
+	 * Test random graphs large enough to be peeled off by several threads:
+	 * * cycle of multiple edge
+	 * * assignment (reverse order)
+	 * * lookup
+	 */
+	const uint8_t rUniPar = 3;
+	const size_t n = 4 * KDB_OPMPHM_PARALLEL_MIN_N;
+	// prep
+	Opmphm * opmphm = opmphmNew ();
+	exit_if_fail (opmphm, "opmphmNew");
+	OpmphmGraph * graph = opmphmGraphNew (opmphm, rUniPar, n, opmphmMinC (rUniPar) + opmphmOptC (n));
+	exit_if_fail (graph, "opmphmGraphNew");
+	OpmphmInit opmphmInit;
+	// dummy data
+	opmphmInit.getName = test_opmphm_getName;
+	opmphmInit.initSeed = (int32_t) 1;
+	opmphmInit.data = (void **) 1;
+	// fill
+	int32_t seed = 4711;
+	for (size_t i = 0; i < n; ++i)
+	{
+		for (uint8_t r = 0; r < rUniPar; ++r)
+		{
+			elektraRand (&seed);
+			graph->edges[i].vertices[r] = seed % opmphm->componentSize;
+		}
+		graph->edges[i].order = n - 1 - i;
+	}
+	// save element last and create multiple edge
+	uint32_t data[rUniPar];
+	for (uint8_t r = 0; r < rUniPar; ++r)
+	{
+		data[r] = graph->edges[n - 1].vertices[r];
+		graph->edges[n - 1].vertices[r] = graph->edges[0].vertices[r];
+	}
+	// check
+	succeed_if (opmphmMapping (opmphm, graph, &opmphmInit, n), "graph with cycles marked as acyclic");
+	// restore last element
+	for (uint8_t r = 0; r < rUniPar; ++r)
+	{
+		graph->edges[n - 1].vertices[r] = data[r];
+	}
+	exit_if_fail (!opmphmMapping (opmphm, graph, &opmphmInit, n), "acyclic graph marked as cyclic");
+	exit_if_fail (opmphmAssignment (opmphm, graph, n, 0) == 0, "opmphmAssignment");
+	size_t wrong = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		if (opmphmLookup (opmphm, n, graph->edges[i].vertices) != n - 1 - i) ++wrong;
+	}
+	succeed_if (wrong == 0, "lookup");
+	// cleanup
+	opmphmDel (opmphm);
+	opmphmGraphDel (graph);
+}
+
 
 int main (int argc, char ** argv)
 {
@@ -393,6 +451,7 @@ int main (int argc, char ** argv)
 	test_cyclicCountDownEdges ();
 	test_acyclicDefaultOrder ();
 	test_acyclicReverseOrder ();
+	test_acyclicLarge ();
 
 	print_result ("test_opmphm");
 
@@ -230,6 +230,94 @@ static void test_keyRel2 (void)
 	keyDel (metaUnrelated);
 }
 
+static void test_ksFindHierarchy (void)
+{
+	KeySet * ks = ksNew (10, keyNew ("/a/b", KEY_END), keyNew ("/a/b/c", KEY_END), keyNew ("user/a", KEY_END),
+			     keyNew ("user/a/b", KEY_END), keyNew ("user/a/b/c", KEY_END), keyNew ("user/a/b/d/e", KEY_END),
+			     keyNew ("user/a/b-c", KEY_END), keyNew ("user/a/c", KEY_END), keyNew ("system/a/b", KEY_END), KS_END);
+	size_t end;
+
+	Key * root = keyNew ("user/a/b", KEY_END);
+	ssize_t start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start >= 0 && end - (size_t) start == 3, "wrong size of hierarchy");
+	succeed_if_same_string (keyName (ksAtCursor (ks, start)), "user/a/b");
+	succeed_if_same_string (keyName (ksAtCursor (ks, end - 1)), "user/a/b/d/e");
+	succeed_if_same_string (keyName (ksAtCursor (ks, end)), "user/a/b-c");
+	keyDel (root);
+
+	root = keyNew ("user/a/b/x", KEY_END);
+	start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start >= 0 && (size_t) start == end, "hierarchy should be empty");
+	keyDel (root);
+
+	root = keyNew ("/a/b", KEY_CASCADING_NAME, KEY_END);
+	start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start >= 0 && end - (size_t) start == 2, "cascading root should only find cascading keys");
+	succeed_if_same_string (keyName (ksAtCursor (ks, start)), "/a/b");
+	succeed_if_same_string (keyName (ksAtCursor (ks, start + 1)), "/a/b/c");
+	keyDel (root);
+
+	root = keyNew ("user", KEY_END);
+	start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start >= 0 && end - (size_t) start == 6, "wrong size of namespace hierarchy");
+	keyDel (root);
+
+	root = keyNew ("system/z", KEY_END);
+	start = ksFindHierarchy (ks, root, &end);
+	succeed_if (start >= 0 && (size_t) start == end, "hierarchy after last key should be empty");
+
+	succeed_if (ksFindHierarchy (ks, 0, &end) == -1, "should fail on NULL root");
+	succeed_if (ksFindHierarchy (0, root, &end) == -1, "should fail on NULL keyset");
+	keyDel (root);
+
+	ksDel (ks);
+}
+
+static void test_ksGetGeneration (void)
+{
+	KeySet * ks = ksNew (10, keyNew ("user/a", KEY_END), keyNew ("user/b", KEY_END), KS_END);
+	KeySet * other = ksDup (ks);
+	succeed_if (ksGetGeneration (ks) != ksGetGeneration (other), "keysets should have different generations");
+	succeed_if (ksGetGeneration (0) == 0, "should return 0 on NULL keyset");
+
+	uint64_t generation = ksGetGeneration (ks);
+	succeed_if (ksLookupByName (ks, "user/a", 0) != 0, "should find key");
+	keySetString (ksLookupByName (ks, "user/a", 0), "value");
+	succeed_if (ksGetGeneration (ks) == generation, "lookups and values should not change the generation");
+
+	ksAppendKey (ks, keyNew ("user/a", KEY_END));
+	succeed_if (ksGetGeneration (ks) != generation, "replacing a key should change the generation");
+
+	generation = ksGetGeneration (ks);
+	keyDel (ksLookupByName (ks, "user/a", KDB_O_POP));
+	ksAppendKey (ks, keyNew ("user/c", KEY_END));
+	succeed_if (ksGetGeneration (ks) != generation, "removing and adding a key should change the generation");
+
+	generation = ksGetGeneration (ks);
+	ksAppend (ks, other);
+	succeed_if (ksGetGeneration (ks) != generation, "appending keys should change the generation");
+
+	generation = ksGetGeneration (ks);
+	ksAppend (ks, other);
+	succeed_if (ksGetGeneration (ks) == generation, "appending the same keys again should not change the generation");
+
+	KeySet * copy = ksDeepDup (other);
+	ksAppend (ks, copy);
+	succeed_if (ksGetGeneration (ks) != generation, "appending replaced keys should change the generation");
+	ksDel (copy);
+
+	generation = ksGetGeneration (ks);
+	ksDel (ksCut (ks, ksLookupByName (other, "user/b", 0)));
+	succeed_if (ksGetGeneration (ks) != generation, "cutting keys should change the generation");
+
+	generation = ksGetGeneration (ks);
+	ksClear (ks);
+	succeed_if (ksGetGeneration (ks) != generation, "clearing should change the generation");
+
+	ksDel (other);
+	ksDel (ks);
+}
+
 int main (int argc, char ** argv)
 {
 	printf ("KEY PROPOSAL TESTS\n");
@@ -239,6 +327,8 @@ int main (int argc, char ** argv)
 
 	test_ksPopAtCursor ();
 	test_ksToArray ();
+	test_ksFindHierarchy ();
+	test_ksGetGeneration ();
 
 	test_keyAsCascading ();
 	test_keyGetLevelsBelow ();
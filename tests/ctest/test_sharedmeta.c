@@ -0,0 +1,143 @@
+/**
+ * @file
+ *
+ * @brief Tests for metadata shared by keys
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <kdbproposal.h>
+#include <tests_internal.h>
+
+static void test_sharedDup (void)
+{
+	printf ("Test shared metadata of duplicated keys\n");
+
+	Key * k = keyNew ("user/tests/shared", KEY_META, "type", "long", KEY_META, "default", "5", KEY_END);
+	Key * dup = keyDup (k);
+
+	succeed_if (k->meta == dup->meta, "metadata of duplicated key not shared");
+	succeed_if (keyGetMeta (k, "type") == keyGetMeta (dup, "type"), "meta keys differ");
+
+	// copy on write
+	keySetMeta (dup, "type", "string");
+	succeed_if (k->meta != dup->meta, "changed metadata still shared");
+	succeed_if_same_string (keyString (keyGetMeta (k, "type")), "long");
+	succeed_if_same_string (keyString (keyGetMeta (dup, "type")), "string");
+	succeed_if (keyGetMeta (k, "default") == keyGetMeta (dup, "default"), "unchanged meta keys differ");
+
+	keyDel (k);
+	succeed_if_same_string (keyString (keyGetMeta (dup, "default")), "5");
+	keyDel (dup);
+
+	// deleting the original first
+	k = keyNew ("user/tests/shared", KEY_META, "type", "long", KEY_END);
+	dup = keyDup (k);
+	Key * copy = keyNew ("user/tests/copy", KEY_META, "other", "x", KEY_END);
+	keyCopy (copy, k);
+	succeed_if (k->meta == copy->meta, "metadata of copied key not shared");
+	succeed_if (keyGetMeta (copy, "other") == 0, "old metadata not removed");
+	keyDel (k);
+	succeed_if_same_string (keyString (keyGetMeta (dup, "type")), "long");
+	succeed_if_same_string (keyString (keyGetMeta (copy, "type")), "long");
+	keySetMeta (copy, "type", 0);
+	succeed_if (keyGetMeta (copy, "type") == 0, "metadata not removed");
+	succeed_if_same_string (keyString (keyGetMeta (dup, "type")), "long");
+	keyDel (copy);
+	keyDel (dup);
+}
+
+static void test_sharedCopyAll (void)
+{
+	printf ("Test shared metadata of keyCopyAllMeta\n");
+
+	Key * spec = keyNew ("spec/tests/shared", KEY_META, "type", "long", KEY_META, "check/range", "0-10", KEY_END);
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 100; ++i)
+	{
+		snprintf (name, sizeof (name), "user/tests/shared/#%d", i);
+		Key * k = keyNew (name, KEY_END);
+		succeed_if (keyCopyAllMeta (k, spec) == 1, "could not copy metadata");
+		ksAppendKey (ks, k);
+	}
+	keyDel (spec);
+
+	Key * first = ksAtCursor (ks, 0);
+	Key * last = ksAtCursor (ks, 99);
+	succeed_if (first->meta == last->meta, "metadata not shared");
+	succeed_if_same_string (keyString (keyGetMeta (last, "check/range")), "0-10");
+
+	// copying into existing metadata merges
+	Key * other = keyNew ("user/tests/other", KEY_META, "type", "string", KEY_META, "description", "text", KEY_END);
+	keyCopyAllMeta (other, first);
+	succeed_if (other->meta != first->meta, "merged metadata shared");
+	succeed_if_same_string (keyString (keyGetMeta (other, "type")), "long");
+	succeed_if_same_string (keyString (keyGetMeta (other, "description")), "text");
+	succeed_if (keyGetMeta (first, "description") == 0, "merge changed the source");
+	keyDel (other);
+
+	// keyCopyMeta of an already present meta key keeps the metadata shared
+	succeed_if (keyCopyMeta (last, first, "type") == 1, "could not copy meta key");
+	succeed_if (first->meta == last->meta, "keyCopyMeta copied shared metadata");
+
+	// iterating one key is not disturbed by lookups of the other one
+	keyRewindMeta (first);
+	size_t count = 0;
+	while (keyNextMeta (first) != 0)
+	{
+		succeed_if (keyGetMeta (last, "type") != 0, "meta key not found");
+		++count;
+	}
+	succeed_if (count == 2, "iteration disturbed by keyGetMeta");
+
+	ksDel (ks);
+}
+
+static void test_sharedKeySet (void)
+{
+	printf ("Test ksShareMeta\n");
+
+	KeySet * ks = ksNew (0, KS_END);
+	char name[64];
+	for (int i = 0; i < 1000; ++i)
+	{
+		snprintf (name, sizeof (name), "user/tests/shared/%04d", i);
+		ksAppendKey (ks, keyNew (name, KEY_META, "type", i % 2 ? "long" : "string", KEY_META, "default", "1", KEY_END));
+	}
+	ksAppendKey (ks, keyNew ("user/tests/shared/none", KEY_END));
+	ksAppendKey (ks, keyNew ("user/tests/shared/prefix", KEY_META, "type", "lon", KEY_META, "default", "1", KEY_END));
+
+	succeed_if (ksShareMeta (ks) == 998, "wrong number of replaced meta keysets");
+	succeed_if (ksShareMeta (ks) == 0, "metadata shared twice");
+
+	Key * even = ksLookupByName (ks, "user/tests/shared/0000", 0);
+	Key * odd = ksLookupByName (ks, "user/tests/shared/0001", 0);
+	succeed_if (even->meta == ksLookupByName (ks, "user/tests/shared/0998", 0)->meta, "equal metadata not shared");
+	succeed_if (odd->meta == ksLookupByName (ks, "user/tests/shared/0999", 0)->meta, "equal metadata not shared");
+	succeed_if (even->meta != odd->meta, "different metadata shared");
+	succeed_if (ksLookupByName (ks, "user/tests/shared/prefix", 0)->meta != odd->meta, "different values shared");
+	succeed_if (ksLookupByName (ks, "user/tests/shared/none", 0)->meta == 0, "metadata added");
+	succeed_if_same_string (keyString (keyGetMeta (odd, "type")), "long");
+
+	keySetMeta (odd, "type", "double");
+	succeed_if_same_string (keyString (keyGetMeta (ksLookupByName (ks, "user/tests/shared/0003", 0), "type")), "long");
+
+	ksDel (ks);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("SHARED META TESTS\n");
+	printf ("==================\n\n");
+
+	init (argc, argv);
+
+	test_sharedDup ();
+	test_sharedCopyAll ();
+	test_sharedKeySet ();
+
+	printf ("\ntest_sharedmeta RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
+
+	return nbError;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file
+ *
+ * @brief Tests for statistics of kdbGet() and kdbSet()
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ */
+
+#include <../../src/libs/elektra/backend.c>
+#include <../../src/libs/elektra/mount.c>
+#include <../../src/libs/elektra/split.c>
+#include <../../src/libs/elektra/trie.c>
+#include <tests_internal.h>
+
+static int counterGet (Plugin * handle ELEKTRA_UNUSED, KeySet * returned, Key * parentKey ELEKTRA_UNUSED)
+{
+	ksAppendKey (returned, keyNew ("user/tests/stats/key", KEY_END));
+	return 1;
+}
+
+static const char * statsValue (KeySet * stats, const char * name)
+{
+	Key * key = ksLookupByName (stats, name, 0);
+	return key ? keyString (key) : "(missing)";
+}
+
+static void test_stats (void)
+{
+	printf ("Test statistics\n");
+
+	KDB * handle = elektraCalloc (sizeof (struct _KDB));
+	handle->split = splitNew ();
+	handle->global = ksNew (0, KS_END);
+
+	Plugin * counter = elektraCalloc (sizeof (struct _Plugin));
+	counter->name = "counter";
+	counter->kdbGet = counterGet;
+	counter->refcounter = 1;
+	handle->globalPlugins[POSTGETSTORAGE][MAXONCE] = counter;
+
+	Key * errorKey = keyNew ("", KEY_END);
+	Backend * backend = backendOpenStats (handle, errorKey);
+	exit_if_fail (backend, "could not open stats backend");
+	splitAppend (handle->split, backend, keyDup (backend->mountpoint), 0);
+	Plugin * statsPlugin = backend->getplugins[0];
+	Key * statsParent = keyNew ("system/elektra/stats", KEY_END);
+
+	// disabled statistics record nothing
+	KeySet * ks = ksNew (0, KS_END);
+	elektraGlobalGet (handle, ks, errorKey, POSTGETSTORAGE, MAXONCE);
+	succeed_if (ksGetSize (ks) == 1, "plugin was not called");
+	succeed_if (counter->stats == NULL, "counters without enabled statistics");
+
+	KeySet * stats = ksNew (0, KS_END);
+	succeed_if (elektraStatsPluginGet (statsPlugin, stats, statsParent) == 1, "could not get statistics");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/enabled"), "0");
+	succeed_if (ksGetSize (stats) == 2, "disabled statistics should only have the enabled key");
+	ksDel (stats);
+
+	succeed_if (elektraStatsEnable (handle, 1) == 0, "could not enable statistics");
+	succeed_if (counter->stats != NULL, "counters not allocated");
+	succeed_if (statsPlugin->stats != NULL, "counters of backend not allocated");
+
+	elektraGlobalGet (handle, ks, errorKey, POSTGETSTORAGE, MAXONCE);
+	elektraGlobalGet (handle, ks, errorKey, POSTGETSTORAGE, MAXONCE);
+	elektraStatsStop (handle, ELEKTRA_STATS_SPLIT, elektraStatsStart (handle));
+
+	stats = ksNew (0, KS_END);
+	succeed_if (elektraStatsPluginGet (statsPlugin, stats, statsParent) == 1, "could not get statistics");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/enabled"), "1");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/global/counter/get/calls"), "2");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/global/counter/get/keys/in"), "2");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/global/counter/get/keys/out"), "2");
+	succeed_if (ksLookupByName (stats, "system/elektra/stats/global/counter/get/time/total", 0), "no total time");
+	succeed_if (ksLookupByName (stats, "system/elektra/stats/global/counter/get/time/max", 0), "no maximum time");
+	succeed_if (ksLookupByName (stats, "system/elektra/stats/global/counter/set", 0) == NULL, "set was never called");
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/phases/split/calls"), "1");
+	succeed_if (ksLookupByName (stats, "system/elektra/stats/phases/cache", 0) == NULL, "cache was never used");
+	succeed_if (ksLookupByName (stats, "system/elektra/stats/backends/system/elektra/stats", 0), "backend missing");
+
+	size_t histogram = 0;
+	Key * cur;
+	ksRewind (stats);
+	while ((cur = ksNext (stats)))
+	{
+		if (!strncmp (keyName (cur), "system/elektra/stats/global/counter/get/histogram/",
+			      sizeof ("system/elektra/stats/global/counter/get/histogram/") - 1))
+		{
+			histogram += atoi (keyString (cur));
+		}
+	}
+	succeed_if (histogram == 2, "histogram does not count all calls");
+	ksDel (stats);
+
+	// the stats plugin was called once before
+	stats = ksNew (0, KS_END);
+	elektraStatsPluginGet (statsPlugin, stats, statsParent);
+	succeed_if_same_string (statsValue (stats, "system/elektra/stats/backends/system/elektra/stats/plugins/stats/get/calls"), "1");
+
+	// the statistics are read only
+	succeed_if (statsPlugin->kdbSet (statsPlugin, stats, statsParent) == 0, "unmodified statistics should be accepted");
+	succeed_if (keyGetMeta (statsParent, "error") == NULL, "error for unmodified statistics");
+	keySetString (ksLookupByName (stats, "system/elektra/stats/enabled", 0), "0");
+	succeed_if (statsPlugin->kdbSet (statsPlugin, stats, statsParent) == -1, "modified statistics should be rejected");
+	succeed_if_same_string (keyString (keyGetMeta (statsParent, "error/number")), "84");
+	ksDel (stats);
+
+	succeed_if (elektraStatsEnable (handle, 0) == 0, "could not disable statistics");
+	succeed_if (counter->stats == NULL, "counters not freed");
+	succeed_if (handle->stats == NULL, "statistics not freed");
+
+	ksDel (ks);
+	keyDel (statsParent);
+	splitDel (handle->split);
+	backendClose (backend, errorKey);
+	elektraPluginClose (counter, errorKey);
+	keyDel (errorKey);
+	ksDel (handle->global);
+	elektraFree (handle);
+}
+
+int main (int argc, char ** argv)
+{
+	printf ("STATS      TESTS\n");
+	printf ("==================\n\n");
+
+	init (argc, argv);
+
+	test_stats ();
+
+	printf ("\ntest_stats RESULTS: %d test(s) done. %d error(s).\n", nbTest, nbError);
+
+	return nbError;
+}
@@ -311,6 +311,56 @@ static void test_ksCut (const size_t storagePlugin, const char * tmpFile)
 	closeStoragePlugin (storagePlugin);
 }
 
+static void test_getSubtree (const size_t storagePlugin, const char * tmpFile)
+{
+	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
+	open_storage_plugin (storagePlugin);
+	Plugin * plugin = plugins[storagePlugin];
+	if (!plugin->kdbGetSubtree)
+	{
+		keyDel (parentKey);
+		closeStoragePlugin (storagePlugin);
+		return;
+	}
+
+	KeySet * ks = metaTestKeySet ();
+	KeySet * other = ksNew (10, keyNew ("user/tests/storage/other", KEY_VALUE, "other key", KEY_META, "a", "other meta", KEY_END),
+				keyNew ("user/tests/storage/other/a", KEY_VALUE, "other a value", KEY_END),
+				keyNew ("user/tests/storage/other/b", KEY_VALUE, "other b value", KEY_META, "b", "b meta", KEY_END),
+				keyNew ("user/tests/storage/other-c", KEY_VALUE, "other-c value", KEY_END), KS_END);
+	ksAppend (ks, other);
+	succeed_if (plugin->kdbSet (plugin, ks, parentKey) == 1, "kdbSet was not successful");
+
+	Key * subtreeKey = keyNew ("user/tests/storage/other", KEY_END);
+	KeySet * expected = ksCut (other, subtreeKey);
+	KeySet * returned = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGetSubtree (plugin, returned, parentKey, subtreeKey) == 1, "kdbGetSubtree was not successful");
+	compare_keyset (expected, returned);
+	ksDel (returned);
+	ksDel (expected);
+
+	keySetName (subtreeKey, "user/tests/storage/a");
+	returned = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGetSubtree (plugin, returned, parentKey, subtreeKey) == 1, "kdbGetSubtree was not successful");
+	succeed_if (ksGetSize (returned) == 1, "subtree without children not read");
+	succeed_if_same_string (keyString (ksLookupByName (returned, "user/tests/storage/a", 0)), "a value");
+	succeed_if_same_string (keyString (keyGetMeta (ksLookupByName (returned, "user/tests/storage/a", 0), "ab")),
+				"other metadata for a key");
+	ksDel (returned);
+
+	keySetName (subtreeKey, "user/tests/storage/missing");
+	returned = ksNew (0, KS_END);
+	succeed_if (plugin->kdbGetSubtree (plugin, returned, parentKey, subtreeKey) == 1, "kdbGetSubtree was not successful");
+	succeed_if (ksGetSize (returned) == 0, "missing subtree not empty");
+	ksDel (returned);
+
+	keyDel (subtreeKey);
+	ksDel (other);
+	keyDel (parentKey);
+	ksDel (ks);
+	closeStoragePlugin (storagePlugin);
+}
+
 static void test_ksPop (const size_t storagePlugin, const char * tmpFile)
 {
 	Key * parentKey = keyNew (TEST_ROOT_KEY, KEY_VALUE, tmpFile, KEY_END);
@@ -969,6 +1019,9 @@ int main (int argc, char ** argv)
 		clearStorage (plugin, tmpFile);
 		test_ksCut (plugin, tmpFile);
 
+		clearStorage (plugin, tmpFile);
+		test_getSubtree (plugin, tmpFile);
+
 		clearStorage (plugin, tmpFile);
 		test_ksPop (plugin, tmpFile);
 
@@ -0,0 +1,272 @@
+/**
+ * @file
+ *
+ * @brief Tests for KDB with kdbSet() of many backends, which are synced together
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <kdbproposal.h>
+
+#include <gtest/gtest-elektra.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+#ifdef __linux__
+namespace
+{
+std::vector<std::string> syncedFiles;
+}
+
+/**
+ * @brief Records the names of synced files, for all callers in the process
+ */
+extern "C" int fsync (int fd)
+{
+	char path[PATH_MAX];
+	std::string link = "/proc/self/fd/" + std::to_string (fd);
+	ssize_t size = readlink (link.c_str (), path, sizeof (path));
+	if (size > 0) syncedFiles.push_back (std::string (path, size));
+	return syscall (SYS_fsync, fd);
+}
+#endif
+
+
+class GroupCommit : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const size_t backends = 3;
+
+	std::string systemRoot;
+
+	GroupCommit () : systemRoot ("system" + testRoot)
+	{
+	}
+
+	static std::string mountpoint (size_t i)
+	{
+		return testRoot + "/b" + std::to_string (i);
+	}
+
+	virtual void SetUp () override
+	{
+		using namespace kdb;
+		using namespace kdb::tools;
+
+		KeySet mountpoints;
+		KDB mountKdb;
+		Key parentKey ("system/elektra/mountpoints", KEY_END);
+		mountKdb.get (mountpoints, parentKey);
+		for (size_t i = 0; i < backends; ++i)
+		{
+			Backend b;
+			b.setMountpoint (Key (mountpoint (i), KEY_END), KeySet (0, KS_END));
+			b.addPlugin (PluginSpec (KDB_RESOLVER));
+			b.useConfigFile ("kdbFileGroupCommit" + std::to_string (i) + ".dump");
+			b.addPlugin (PluginSpec ("dump"));
+			b.addPlugin (PluginSpec ("sync"));
+			b.addPlugin (PluginSpec ("error"));
+			b.serialize (mountpoints);
+		}
+		mountKdb.set (mountpoints, parentKey);
+	}
+
+	virtual void TearDown () override
+	{
+		using namespace kdb;
+		for (size_t i = 0; i < backends; ++i)
+		{
+			Key parent ("system" + mountpoint (i), KEY_END);
+			KeySet ks;
+			KDB kdb;
+			kdb.get (ks, parent);
+			unlink (parent.getString ().c_str ());
+			testing::Mountpoint::umount (mountpoint (i));
+		}
+	}
+
+	/**
+	 * @brief The real path of the config file of a backend
+	 */
+	static std::string configFile (size_t i)
+	{
+		using namespace kdb;
+		KDB kdb;
+		KeySet ks;
+		Key parent ("system" + mountpoint (i), KEY_END);
+		kdb.get (ks, parent);
+		std::string file = parent.getString ();
+		char * dir = realpath (directory (file).c_str (), nullptr);
+		std::string path = std::string (dir ? dir : "") + file.substr (file.rfind ('/'));
+		free (dir);
+		return path;
+	}
+
+	static std::string directory (std::string const & file)
+	{
+		return file.substr (0, file.rfind ('/'));
+	}
+
+	static size_t countSynced (std::vector<std::string> const & files, std::string const & name, bool prefix)
+	{
+		return std::count_if (files.begin (), files.end (), [&](std::string const & synced) {
+			return prefix ? synced.compare (0, name.size (), name) == 0 && synced != directory (name) : synced == name;
+		});
+	}
+
+	/**
+	 * @brief Enables the group commit, which is disabled after kdbOpen()
+	 */
+	void enableGroupCommit (kdb::KDB & kdb)
+	{
+		using namespace kdb;
+		KeySet contract (1, *Key ("system/elektra/ensure/groupcommit", KEY_VALUE, "1", KEY_END), KS_END);
+		Key parent (systemRoot, KEY_END);
+		kdb.ensure (contract, parent);
+	}
+
+	kdb::KeySet values (std::string value)
+	{
+		using namespace kdb;
+		KeySet ks;
+		for (size_t i = 0; i < backends; ++i)
+		{
+			ks.append (Key ("system" + mountpoint (i) + "/key", KEY_VALUE, value.c_str (), KEY_END));
+		}
+		return ks;
+	}
+};
+
+const std::string GroupCommit::testRoot = "/tests/kdb/groupcommit";
+const size_t GroupCommit::backends;
+
+
+TEST_F (GroupCommit, SetAllBackends)
+{
+	using namespace kdb;
+	{
+		KDB kdb;
+		enableGroupCommit (kdb);
+		KeySet ks;
+		kdb.get (ks, systemRoot);
+		ks.append (values ("first"));
+		ASSERT_EQ (kdb.set (ks, systemRoot), 1);
+		ks.append (values ("second"));
+		ASSERT_EQ (kdb.set (ks, systemRoot), 1);
+	}
+
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, systemRoot), 1);
+	for (size_t i = 0; i < backends; ++i)
+	{
+		Key found = ks.lookup ("system" + mountpoint (i) + "/key");
+		ASSERT_TRUE (found) << "key of backend " << i << " was not written" << ks;
+		EXPECT_EQ (found.getString (), "second");
+	}
+	Key parent ("system" + mountpoint (0), KEY_END);
+	kdb.get (ks, parent);
+	struct stat buf;
+	EXPECT_EQ (stat (parent.getString ().c_str (), &buf), 0) << "file not committed";
+}
+
+TEST_F (GroupCommit, RollbackAllBackends)
+{
+	using namespace kdb;
+	{
+		KDB kdb;
+		KeySet ks;
+		kdb.get (ks, systemRoot);
+		ks.append (values ("first"));
+		ASSERT_EQ (kdb.set (ks, systemRoot), 1);
+	}
+
+	{
+		KDB kdb;
+		enableGroupCommit (kdb);
+		KeySet ks;
+		kdb.get (ks, systemRoot);
+		ks.append (values ("second"));
+		ks.append (Key ("system" + mountpoint (backends - 1) + "/error", KEY_VALUE, "x", KEY_META, "trigger/error", "10", KEY_END));
+		EXPECT_THROW (kdb.set (ks, systemRoot), kdb::KDBException);
+	}
+
+	KDB kdb;
+	KeySet ks;
+	kdb.get (ks, systemRoot);
+	for (size_t i = 0; i < backends; ++i)
+	{
+		Key found = ks.lookup ("system" + mountpoint (i) + "/key");
+		ASSERT_TRUE (found) << "key of backend " << i << " got lost" << ks;
+		EXPECT_EQ (found.getString (), "first") << "backend " << i << " was committed despite the error";
+	}
+}
+
+TEST_F (GroupCommit, MalformedContract)
+{
+	using namespace ckdb;
+	Key * parentKey = keyNew (systemRoot.c_str (), KEY_END);
+	KDB * handle = kdbOpen (parentKey);
+	KeySet * contract = ksNew (1, keyNew ("system/elektra/ensure/groupcommit", KEY_VALUE, "yes", KEY_END), KS_END);
+	EXPECT_EQ (kdbEnsure (handle, contract, parentKey), -1);
+	EXPECT_NE (keyGetMeta (parentKey, "error/number"), nullptr);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+}
+
+#ifdef __linux__
+TEST_F (GroupCommit, SyncsEveryFile)
+{
+	using namespace kdb;
+	KDB kdb;
+	enableGroupCommit (kdb);
+	KeySet ks;
+	kdb.get (ks, systemRoot);
+	ks.append (values ("synced"));
+	syncedFiles.clear ();
+	ASSERT_EQ (kdb.set (ks, systemRoot), 1);
+	std::vector<std::string> synced = syncedFiles;
+
+	for (size_t i = 0; i < backends; ++i)
+	{
+		std::string file = configFile (i);
+		// the temporary files have the name of the config file as prefix
+		EXPECT_EQ (countSynced (synced, file, true), 1) << "temporary file of backend " << i << " was not synced once";
+		EXPECT_EQ (countSynced (synced, directory (file), false), 1) << "directory of backend " << i << " was not synced once";
+	}
+}
+
+TEST_F (GroupCommit, SyncsEveryFileWithoutGroupCommit)
+{
+	using namespace ckdb;
+	Key * parentKey = keyNew (systemRoot.c_str (), KEY_END);
+	KDB * handle = kdbOpen (parentKey);
+	// the group commit is disabled by default
+	KeySet * ks = ksNew (0, KS_END);
+	kdbGet (handle, ks, parentKey);
+	ksAppend (ks, values ("synced").getKeySet ());
+	syncedFiles.clear ();
+	ASSERT_EQ (kdbSet (handle, ks, parentKey), 1);
+	ksDel (ks);
+	kdbClose (handle, parentKey);
+	keyDel (parentKey);
+	std::vector<std::string> synced = syncedFiles;
+
+	for (size_t i = 0; i < backends; ++i)
+	{
+		std::string file = configFile (i);
+		EXPECT_EQ (countSynced (synced, file, true), 1) << "temporary file of backend " << i << " was not synced once";
+		// every backend syncs its directory on its own
+		EXPECT_EQ (countSynced (synced, directory (file), false), backends) << "directory of backend " << i << " was not synced";
+	}
+}
+#endif
@@ -467,6 +467,81 @@ TEST_F (Highlevel, ArrayGetters)
 #endif
 }
 
+TEST_F (Highlevel, WholeArrayGetters)
+{
+	setValues ({ makeKey (KDB_TYPE_LONG, "longkey", "7") });
+	setArrays ({
+		makeArray (KDB_TYPE_STRING, "stringarraykey", { "String 1", "String 2" }),
+		makeArray (KDB_TYPE_LONG, "longarraykey", { "1", "-1", "3" }),
+		makeArray (KDB_TYPE_DOUBLE, "doublearraykey", { "1.1", "-2.1" }),
+	});
+	setValues ({ kdb::Key ("user" + testRoot + "mixedarraykey", KEY_META, "array", "#1", KEY_END),
+		     makeKey (KDB_TYPE_LONG, "mixedarraykey/#0", "1"), makeKey (KDB_TYPE_STRING, "mixedarraykey/#1", "a") });
+
+	createElektra ();
+
+	kdb_long_long_t size = -1;
+	const char * const * strings = elektraGetStringArray (elektra, "stringarraykey", &size);
+	ASSERT_EQ (size, 2) << "Wrong array size";
+	EXPECT_STREQ (strings[0], "String 1") << "Wrong key value.";
+	EXPECT_STREQ (strings[1], "String 2") << "Wrong key value.";
+
+	const kdb_long_t * longs = elektraGetLongArray (elektra, "longarraykey", &size);
+	ASSERT_EQ (size, 3) << "Wrong array size";
+	EXPECT_EQ (longs[0], 1) << "Wrong key value.";
+	EXPECT_EQ (longs[1], -1) << "Wrong key value.";
+	EXPECT_EQ (longs[2], 3) << "Wrong key value.";
+
+	const kdb_double_t * doubles = elektraGetDoubleArray (elektra, "doublearraykey", &size);
+	ASSERT_EQ (size, 2) << "Wrong array size";
+	EXPECT_EQ (doubles[0], 1.1) << "Wrong key value.";
+	EXPECT_EQ (doubles[1], -2.1) << "Wrong key value.";
+
+	EXPECT_EQ (elektraGetLongArray (elektra, "nonexistentarraykey", &size), nullptr) << "Array should be empty";
+	EXPECT_EQ (size, 0) << "Wrong array size";
+
+	EXPECT_THROW (elektraGetLongArray (elektra, "doublearraykey", &size), std::runtime_error);
+	EXPECT_THROW (elektraGetLongArray (elektra, "mixedarraykey", &size), std::runtime_error);
+	EXPECT_EQ (elektraGetLongArrayElement (elektra, "mixedarraykey", 0), 1) << "Wrong key value.";
+	EXPECT_STREQ (elektraGetStringArrayElement (elektra, "mixedarraykey", 1), "a") << "Wrong key value.";
+
+	// setters update the decoded values
+	ElektraError * error = nullptr;
+	EXPECT_EQ (elektraGetLong (elektra, "longkey"), 7) << "Wrong key value.";
+	elektraSetLong (elektra, "longkey", 8, &error);
+	elektraSetLongArrayElement (elektra, "longarraykey", 1, 5, &error);
+	elektraSetLongArrayElement (elektra, "longarraykey", 2, 6, &error);
+	ASSERT_EQ (error, nullptr) << "elektraSet* failed: " << &error << std::endl;
+
+	EXPECT_EQ (elektraGetLong (elektra, "longkey"), 8) << "Wrong key value.";
+	longs = elektraGetLongArray (elektra, "longarraykey", &size);
+	ASSERT_EQ (size, 3) << "Wrong array size";
+	EXPECT_EQ (longs[1], 5) << "Wrong key value.";
+	EXPECT_EQ (longs[2], 6) << "Wrong key value.";
+	EXPECT_EQ (elektraGetLongArrayElement (elektra, "longarraykey", 2), 6) << "Wrong key value.";
+}
+
+TEST_F (Highlevel, CascadingLookup)
+{
+	setValues ({ makeKey (KDB_TYPE_LONG, "longkey", "2"), kdb::Key ("user" + testRoot + "untypedkey", KEY_VALUE, "5", KEY_END) });
+
+	ckdb::KeySet * defaults =
+		ksNew (5, ckdb::keyNew ("/longkey", KEY_VALUE, "1", KEY_META, "type", KDB_TYPE_LONG, KEY_END),
+		       ckdb::keyNew ("/otherkey", KEY_VALUE, "3", KEY_META, "type", KDB_TYPE_LONG, KEY_END),
+		       ckdb::keyNew ("/untypedkey", KEY_VALUE, "4", KEY_META, "type", KDB_TYPE_LONG, KEY_END), KS_END);
+
+	ElektraError * error = nullptr;
+	elektra = elektraOpen (testRoot.c_str (), defaults, &error);
+	ckdb::ksDel (defaults);
+	ASSERT_NE (elektra, nullptr) << "elektraOpen failed" << &error << std::endl;
+	elektraFatalErrorHandler (elektra, &fatalErrorHandler);
+
+	EXPECT_EQ (elektraGetLong (elektra, "longkey"), 2) << "Wrong key value.";
+	EXPECT_EQ (elektraGetLong (elektra, "otherkey"), 3) << "Wrong key value.";
+	// the user key without type metadata hides the default value
+	EXPECT_THROW (elektraGetLong (elektra, "untypedkey"), std::runtime_error);
+}
+
 TEST_F (Highlevel, PrimitiveSetters)
 {
 	setValues ({
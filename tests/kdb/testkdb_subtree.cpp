@@ -0,0 +1,181 @@
+/**
+ * @file
+ *
+ * @brief Tests for KDB with storage plugins reading subtrees
+ *
+ * @copyright BSD License (see LICENSE.md or https://www.libelektra.org)
+ *
+ */
+
+#include <keysetio.hpp>
+
+#include <gtest/gtest-elektra.h>
+
+
+class Subtree : public ::testing::Test
+{
+protected:
+	static const std::string testRoot;
+	static const std::string configFile;
+
+	std::string userRoot;
+
+	Subtree () : userRoot ("user" + testRoot)
+	{
+	}
+
+	virtual void SetUp () override
+	{
+		using namespace kdb;
+		using namespace kdb::tools;
+
+		Backend b;
+		b.setMountpoint (Key (testRoot, KEY_END), KeySet (0, KS_END));
+		b.addPlugin (PluginSpec (KDB_RESOLVER));
+		b.useConfigFile (configFile);
+		b.addPlugin (PluginSpec ("quickdump"));
+		KeySet mountpoints;
+		KDB mountKdb;
+		Key parentKey ("system/elektra/mountpoints", KEY_END);
+		mountKdb.get (mountpoints, parentKey);
+		b.serialize (mountpoints);
+		mountKdb.set (mountpoints, parentKey);
+
+		KDB kdb;
+		KeySet ks;
+		kdb.get (ks, userRoot);
+		ks.append (Key (userRoot + "/a/x", KEY_VALUE, "ax", KEY_END));
+		ks.append (Key (userRoot + "/a/y", KEY_VALUE, "ay", KEY_META, "m", "my", KEY_END));
+		ks.append (Key (userRoot + "/b/z", KEY_VALUE, "bz", KEY_END));
+		ASSERT_EQ (kdb.set (ks, userRoot), 1);
+	}
+
+	virtual void TearDown () override
+	{
+		using namespace kdb;
+		Key parent (userRoot, KEY_END);
+		KeySet ks;
+		KDB kdb;
+		kdb.get (ks, parent);
+		unlink (parent.getString ().c_str ());
+		testing::Mountpoint::umount (testRoot);
+	}
+};
+
+const std::string Subtree::testRoot = "/tests/kdb/subtree";
+const std::string Subtree::configFile = "kdbFileSubtree.quickdump";
+
+
+TEST_F (Subtree, GetOnlySubtree)
+{
+	using namespace kdb;
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, userRoot + "/a"), 1);
+	ASSERT_EQ (ks.size (), 2) << "should only read the subtree" << ks;
+	EXPECT_EQ (ks.lookup (userRoot + "/a/x").getString (), "ax");
+	EXPECT_EQ (ks.lookup (userRoot + "/a/y").getMeta<std::string> ("m"), "my");
+
+	ASSERT_EQ (kdb.get (ks, userRoot + "/a/x"), 0) << "subtree was read already";
+	ASSERT_EQ (ks.size (), 2) << ks;
+
+	ASSERT_EQ (kdb.get (ks, userRoot + "/b"), 1) << "other subtree of unchanged file was not read";
+	ASSERT_EQ (ks.size (), 1) << ks;
+	EXPECT_EQ (ks.lookup (userRoot + "/b/z").getString (), "bz");
+
+	ASSERT_EQ (kdb.get (ks, userRoot), 1) << "whole file was not read";
+	ASSERT_EQ (ks.size (), 3) << ks;
+
+	ASSERT_EQ (kdb.get (ks, userRoot + "/b"), 0) << "subtree was read already";
+	ASSERT_EQ (ks.size (), 3) << ks;
+}
+
+TEST_F (Subtree, SetKeepsOtherKeys)
+{
+	using namespace kdb;
+	{
+		KDB kdb;
+		KeySet ks;
+		ASSERT_EQ (kdb.get (ks, userRoot + "/a"), 1);
+		ks.lookup (userRoot + "/a/x").setString ("changed");
+		ks.append (Key (userRoot + "/c", KEY_VALUE, "c", KEY_END));
+		ASSERT_EQ (kdb.set (ks, userRoot + "/a"), 1);
+		ASSERT_EQ (kdb.set (ks, userRoot + "/a"), 0) << "nothing changed";
+	}
+
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, userRoot), 1);
+	ASSERT_EQ (ks.size (), 4) << ks;
+	EXPECT_EQ (ks.lookup (userRoot + "/a/x").getString (), "changed");
+	EXPECT_EQ (ks.lookup (userRoot + "/a/y").getMeta<std::string> ("m"), "my");
+	EXPECT_EQ (ks.lookup (userRoot + "/b/z").getString (), "bz");
+	EXPECT_EQ (ks.lookup (userRoot + "/c").getString (), "c");
+}
+
+TEST_F (Subtree, SetRemovesFromSubtree)
+{
+	using namespace kdb;
+	{
+		KDB kdb;
+		KeySet ks;
+		ASSERT_EQ (kdb.get (ks, userRoot + "/a"), 1);
+		ks.lookup (userRoot + "/a/y", KDB_O_POP);
+		ASSERT_EQ (kdb.set (ks, userRoot + "/a"), 1);
+	}
+
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, userRoot), 1);
+	ASSERT_EQ (ks.size (), 2) << ks;
+	EXPECT_EQ (ks.lookup (userRoot + "/a/x").getString (), "ax");
+	EXPECT_EQ (ks.lookup (userRoot + "/b/z").getString (), "bz");
+}
+
+TEST_F (Subtree, CascadingGet)
+{
+	using namespace kdb;
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, testRoot + "/b"), 1);
+	ASSERT_EQ (ks.size (), 1) << "should only read the subtree" << ks;
+	EXPECT_EQ (ks.lookup (testRoot + "/b/z").getString (), "bz");
+}
+
+TEST_F (Subtree, RemovedFile)
+{
+	using namespace kdb;
+	{
+		KDB kdb;
+		KeySet ks;
+		Key parent (userRoot + "/a", KEY_END);
+		ASSERT_EQ (kdb.get (ks, parent), 1);
+		ASSERT_EQ (unlink (parent.getString ().c_str ()), 0);
+
+		ASSERT_EQ (kdb.get (ks, userRoot + "/b"), 1) << "other subtree of removed file was not read";
+		ASSERT_EQ (ks.size (), 0) << ks;
+
+		ks.append (Key (userRoot + "/a/x", KEY_VALUE, "new", KEY_END));
+		ASSERT_EQ (kdb.set (ks, userRoot + "/a"), 1);
+	}
+
+	KDB kdb;
+	KeySet ks;
+	ASSERT_EQ (kdb.get (ks, userRoot), 1);
+	ASSERT_EQ (ks.size (), 1) << ks;
+	EXPECT_EQ (ks.lookup (userRoot + "/a/x").getString (), "new");
+}
+
+TEST_F (Subtree, RemovedFileConflict)
+{
+	using namespace kdb;
+	KDB kdb;
+	KeySet ks;
+	Key parent (userRoot + "/a", KEY_END);
+	ASSERT_EQ (kdb.get (ks, parent), 1);
+	ASSERT_EQ (unlink (parent.getString ().c_str ()), 0);
+
+	ks.lookup (userRoot + "/a/x").setString ("changed");
+	EXPECT_THROW (kdb.set (ks, parent), KDBException);
+	EXPECT_EQ (parent.getMeta<int> ("error/number"), 30) << "removed file should be a conflict";
+}